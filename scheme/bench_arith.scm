@@ -0,0 +1,42 @@
+;;; Benchmarks of the arithmetic and numeric comparison builtins, which
+;;; are the most called procedures in most programs.
+;;;
+;;; Run it on either engine:
+;;; $ cozenage scheme/bench_arith.scm
+;;; $ cozenage -e vm scheme/bench_arith.scm
+;;;
+;;; Each benchmark prints its result and the elapsed time in milliseconds.
+
+(import (base time))
+
+(define (fib n)
+  (if (< n 2)
+      n
+      (+ (fib (- n 1)) (fib (- n 2)))))
+
+(define (fib-real n)
+  (if (< n 2.0)
+      n
+      (+ (fib-real (- n 1.0)) (fib-real (- n 2.0)))))
+
+(define (tak x y z)
+  (if (not (< y x))
+      z
+      (tak (tak (- x 1) y z)
+           (tak (- y 1) z x)
+           (tak (- z 1) x y))))
+
+(define (time-it name thunk)
+  (let* ((start (current-jiffy))
+         (result (thunk))
+         (ms (quotient (* (- (current-jiffy) start) 1000) (jiffies-per-second))))
+    (display name)
+    (display ": ")
+    (display result)
+    (display " in ")
+    (display ms)
+    (displayln " ms")))
+
+(time-it "(fib 25)" (lambda () (fib 25)))
+(time-it "(fib-real 22.0)" (lambda () (fib-real 22.0)))
+(time-it "(tak 18 12 6)" (lambda () (tak 18 12 6)))
@@ -0,0 +1,67 @@
+;;; Benchmarks of hash table throughput: inserting, looking up, and
+;;; deleting keys, with integer and string keys.
+;;;
+;;; Run it on either engine:
+;;; $ cozenage scheme/bench_hash.scm
+;;; $ cozenage -e vm scheme/bench_hash.scm
+;;;
+;;; Each benchmark prints its result and the elapsed time in milliseconds.
+
+(import (base time))
+
+(define n 200000)
+
+;; Keys are made up front, so only the table operations are timed. Integer
+;; keys are scattered, rather than 0 to n - 1, so they don't arrive in the
+;; order of their hashes.
+(define int-keys
+  (let ((v (make-vector n)))
+    (do ((i 0 (+ i 1))) ((= i n) v)
+      (vector-set! v i (modulo (* i 2654435761) 4294967296)))))
+
+(define string-keys
+  (let ((v (make-vector n)))
+    (do ((i 0 (+ i 1))) ((= i n) v)
+      (vector-set! v i (string-append "key-" (number->string i))))))
+
+(define (insert-all! h keys)
+  (do ((i 0 (+ i 1))) ((= i n) (length (hash-keys h)))
+    (hash-add! h (vector-ref keys i) i)))
+
+;; Looks up every key, and counts how many are found.
+(define (lookup-all h keys)
+  (do ((i 0 (+ i 1))
+       (found 0 (if (hash-get h (vector-ref keys i) #f) (+ found 1) found)))
+      ((= i n) found)))
+
+;; Looks up n keys which are not in the table.
+(define (lookup-misses h)
+  (do ((i 0 (+ i 1))
+       (found 0 (if (hash-get h (- -1 i) #f) (+ found 1) found)))
+      ((= i n) found)))
+
+(define (delete-all! h keys)
+  (do ((i 0 (+ i 1))) ((= i n) (length (hash-keys h)))
+    (hash-remove! h (vector-ref keys i))))
+
+(define (time-it name thunk)
+  (let* ((start (current-jiffy))
+         (result (thunk))
+         (ms (quotient (* (- (current-jiffy) start) 1000) (jiffies-per-second))))
+    (display name)
+    (display ": ")
+    (display result)
+    (display " in ")
+    (display ms)
+    (displayln " ms")))
+
+(define ih (hash))
+(time-it "insert integers" (lambda () (insert-all! ih int-keys)))
+(time-it "lookup integers" (lambda () (lookup-all ih int-keys)))
+(time-it "lookup misses" (lambda () (lookup-misses ih)))
+(time-it "delete integers" (lambda () (delete-all! ih int-keys)))
+
+(define sh (hash))
+(time-it "insert strings" (lambda () (insert-all! sh string-keys)))
+(time-it "lookup strings" (lambda () (lookup-all sh string-keys)))
+(time-it "delete strings" (lambda () (delete-all! sh string-keys)))
@@ -4,7 +4,7 @@
 ;
 ; --- EXPECTED OUTPUT ---
 ; Test 2.1 (Simple 'lambda'): 25
-; Test 2.2 ('let' scope): 78.53975
+; Test 2.2 ('let' scope): 78.539749999999999994
 ; Test 2.3 ('let*' sequential): 35
 ; -------------------------
 
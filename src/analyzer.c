@@ -0,0 +1,779 @@
+/*
+ * 'src/analyzer.c'
+ * This file is part of Cozenage - https://github.com/DarrenKirby/cozenage
+ * Copyright © 2025 - 2026 Darren Kirby <darren@dragonbyte.ca>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* This file implements a one-time analysis pass which runs over the output
+ * of expand(), and turns each expression into a tree of Nodes. Each Node
+ * carries a handler which has already been specialised for the shape of the
+ * expression (constant, variable reference, if, let, procedure call, etc.),
+ * so that repeated evaluation of the same code (most importantly, lambda
+ * bodies) no longer re-checks type masks, re-dispatches special forms, or
+ * copies argument s-expressions before evaluating them.
+ *
+ * coz_exec() is the trampoline which runs a Node tree. Handlers that end in
+ * tail position hand back the next Node (and possibly a new environment)
+ * instead of recursing, so tail calls run in constant C stack space.
+ *
+ * Anything the analyzer does not understand, such as malformed special forms,
+ * is wrapped in a 'raw' Node which hands the expression to coz_eval(), so that
+ * the error messages stay exactly as the tree-walker reports them.
+ *
+ * Expressions are analyzed in a scope: a Lex whose local frames have the same
+ * layout as the frames the code will run in (see lex_resolve()). Variable
+ * references to locals are resolved to a (depth, slot) lexical address, and
+ * free variables go straight to the global table. A null scope means the
+ * enclosing frames are unknown, and references are looked up by name.
+ */
+
+#include "analyzer.h"
+#include "eval.h"
+#include "fold.h"
+#include "special_forms.h"
+#include "symbols.h"
+#include "transforms.h"
+#include "types.h"
+#include "repr.h"
+
+#include <gc/gc.h>
+#include <string.h>
+
+
+/* set! needs to know if we're in the REPL. */
+extern int is_repl;
+
+
+/* Allocate a Node with room for 'count' sub-nodes. */
+static Node* make_node(const node_handler_t exec, Cell* expr, Cell* value, const int count)
+{
+    Node* n = GC_MALLOC(sizeof(Node));
+    n->exec = exec;
+    n->expr = expr;
+    n->value = value;
+    n->count = count;
+    n->kids = count > 0 ? GC_MALLOC(sizeof(Node*) * count) : nullptr;
+    n->depth = 0;
+    n->slot = -1;
+    n->cache = nullptr;
+    n->macro = nullptr;
+    n->expansion = nullptr;
+    n->captures = false;
+    n->pool_frame = false;
+    return n;
+}
+
+
+/* Allocate an argument s-expr of exactly 'count' slots. */
+static Cell* make_arg_sexpr(const int count)
+{
+    Cell* args = make_cell_sexpr();
+    args->count = count;
+    if (count > 0) {
+        args->cell = GC_MALLOC(sizeof(Cell*) * count);
+        args->capacity = count;
+    }
+    return args;
+}
+
+
+/* Run a Node tree to completion. Pooled frames entered by tail calls and
+ * let forms are released when the tree returns, or as soon as a tail call
+ * leaves them behind. Frames from env upward belong to the caller. */
+Cell* coz_exec(Lex* env, const Node* n)
+{
+    const Ch_Env* floor = env->local;
+    while (true) {
+        const Node* next = nullptr;
+        Lex* prev = env;
+        Cell* result = n->exec(n, &env, &next);
+        if (result != TCS_Obj) {
+            lex_release_frames(env, floor, nullptr);
+            return result;
+        }
+        /* Anything but entering a child frame leaves the current one dead. */
+        if (env != prev && (!env->local || env->local->parent != prev->local)) {
+            lex_release_frames(prev, floor, env->local);
+        }
+        n = next;
+    }
+}
+
+
+/* -----------------------------*
+ *         Node handlers        *
+ * -----------------------------*/
+
+
+/* Self-evaluating values and quoted data. */
+static Cell* exec_const(const Node* n, Lex** env, const Node** next)
+{
+    (void)env; (void)next;
+    return n->value;
+}
+
+
+/* Expressions the analyzer does not specialise are handed to the tree-walker. */
+static Cell* exec_raw(const Node* n, Lex** env, const Node** next)
+{
+    (void)next;
+    return coz_eval(*env, n->expr);
+}
+
+
+/* Variable reference, in an unknown scope. */
+static Cell* exec_ref(const Node* n, Lex** env, const Node** next)
+{
+    (void)next;
+    /* The symbol may have become a keyword (ie: by importing (base lazy))
+     * since this node was analyzed. */
+    if (n->value->sf_id > 0) {
+        return coz_eval(*env, n->expr);
+    }
+    return lex_get(*env, n->value);
+}
+
+
+/* Reference to a local variable, by lexical address. */
+static Cell* exec_local(const Node* n, Lex** env, const Node** next)
+{
+    (void)next;
+    if (n->value->sf_id > 0) {
+        return coz_eval(*env, n->expr);
+    }
+    return lex_get_at(*env, n->value, n->depth, n->slot);
+}
+
+
+/* Reference to a variable not bound in any enclosing frame. */
+static Cell* exec_global(const Node* n, Lex** env, const Node** next)
+{
+    (void)next;
+    if (n->value->sf_id > 0) {
+        return coz_eval(*env, n->expr);
+    }
+    return lex_get_global(*env, n->value, n->cache);
+}
+
+
+/* (if test consequent [alternate]) */
+static Cell* exec_if(const Node* n, Lex** env, const Node** next)
+{
+    const Cell* test = coz_exec(*env, n->kids[0]);
+    if (cell_type(test) == CELL_ERROR) {
+        return (Cell*)test;
+    }
+    if (!(cell_type(test) == CELL_BOOLEAN && test->boolean_v == 0)) {
+        *next = n->kids[1];
+        return TCS_Obj;
+    }
+    if (n->count == 3) {
+        *next = n->kids[2];
+        return TCS_Obj;
+    }
+    return USP_Obj;
+}
+
+
+/* (define symbol expr) */
+static Cell* exec_define_var(const Node* n, Lex** env, const Node** next)
+{
+    (void)next;
+    Cell* val = coz_exec(*env, n->kids[0]);
+    if (cell_type(val) == CELL_ERROR) {
+        return val;
+    }
+    if (cell_type(val) == CELL_PROC) {
+        /* Grab the name for the un-sugared define lambda. */
+        if (!val->is_builtin) {
+            val->lambda->l_name = n->value->sym;
+        }
+        lex_put_global(*env, n->value, val);
+        return val;
+    }
+    lex_put_global(*env, n->value, val);
+    return n->value;
+}
+
+
+/* (define (name formals) body) - value holds the formals. */
+static Cell* exec_define_proc(const Node* n, Lex** env, const Node** next)
+{
+    (void)next;
+    const Cell* fname = n->expr->cell[1]->cell[0];
+    Cell* lam = lex_make_named_lambda(fname->sym, n->value, n->expr->cell[2], *env);
+    lam->lambda->code = n->kids[0];
+    lex_put_global(*env, fname, lam);
+    return lam;
+}
+
+
+/* (lambda formals body) - value holds the formals. */
+static Cell* exec_lambda(const Node* n, Lex** env, const Node** next)
+{
+    (void)next;
+    Cell* lam = lex_make_lambda(n->value, n->expr->cell[2], *env);
+    lam->lambda->code = n->kids[0];
+    return lam;
+}
+
+
+/* (let bindings body ...) - value holds the bindings, the first
+ * bindings->count kids are the inits, and the rest are the body. */
+static Cell* exec_let(const Node* n, Lex** env, const Node** next)
+{
+    Lex* e = *env;
+    const Cell* bindings = n->value;
+    const int n_bindings = bindings->count;
+
+    Lex* local_env = n->pool_frame ? lex_acquire_frame(e, n_bindings) : new_child_env(e);
+    for (int i = 0; i < n_bindings; i++) {
+        Cell* val = coz_exec(e, n->kids[i]);
+        if (cell_type(val) == CELL_ERROR) return val;
+        lex_put_local(local_env, bindings->cell[i]->cell[0], val);
+    }
+
+    for (int i = n_bindings; i < n->count - 1; i++) {
+        Cell* res = coz_exec(local_env, n->kids[i]);
+        if (cell_type(res) == CELL_ERROR) return res;
+    }
+
+    *env = local_env;
+    *next = n->kids[n->count - 1];
+    return TCS_Obj;
+}
+
+
+/* (letrec bindings body ...) - laid out as for let. */
+static Cell* exec_letrec(const Node* n, Lex** env, const Node** next)
+{
+    const Cell* bindings = n->value;
+    const int n_bindings = bindings->count;
+
+    Lex* local_env = n->pool_frame ? lex_acquire_frame(*env, n_bindings) : new_child_env(*env);
+    for (int i = 0; i < n_bindings; i++) {
+        lex_put_local(local_env, bindings->cell[i]->cell[0], USP_Obj);
+    }
+    for (int i = 0; i < n_bindings; i++) {
+        Cell* init_exp = coz_exec(local_env, n->kids[i]);
+        if (cell_type(init_exp) == CELL_ERROR) return init_exp;
+        lex_put_local(local_env, bindings->cell[i]->cell[0], init_exp);
+    }
+
+    if (n->count == n_bindings) {
+        return USP_Obj;
+    }
+    for (int i = n_bindings; i < n->count - 1; i++) {
+        Cell* result = coz_exec(local_env, n->kids[i]);
+        if (cell_type(result) == CELL_ERROR) return result;
+    }
+
+    *env = local_env;
+    *next = n->kids[n->count - 1];
+    return TCS_Obj;
+}
+
+
+/* (set! symbol expr) */
+static Cell* exec_set(const Node* n, Lex** env, const Node** next)
+{
+    (void)next;
+    Cell* value_to_set = coz_exec(*env, n->kids[0]);
+    if (cell_type(value_to_set) == CELL_ERROR) {
+        return value_to_set;
+    }
+    const bool found = n->slot >= 0
+        ? lex_set_at(*env, n->value, n->depth, n->slot, value_to_set)
+        : lex_set(*env, n->value, value_to_set);
+    if (found) {
+        if (is_repl) {
+            fprintf(stderr, "%s\n", cell_to_string(value_to_set, MODE_REPL));
+        }
+        return USP_Obj;
+    }
+    return make_cell_error(
+        fmt_err("set!: Unbound symbol: '%s'", n->value->sym),
+        TYPE_ERR);
+}
+
+
+/* (begin expr ...) */
+static Cell* exec_begin(const Node* n, Lex** env, const Node** next)
+{
+    for (int i = 0; i < n->count - 1; i++) {
+        Cell* result = coz_exec(*env, n->kids[i]);
+        /* null return will segfault the error check. */
+        if (!result) { continue; }
+        if (cell_type(result) == CELL_ERROR) {
+            return result;
+        }
+    }
+    *next = n->kids[n->count - 1];
+    return TCS_Obj;
+}
+
+
+/* (and test ...) */
+static Cell* exec_and(const Node* n, Lex** env, const Node** next)
+{
+    for (int i = 0; i < n->count - 1; i++) {
+        const Cell* result = coz_exec(*env, n->kids[i]);
+        if (cell_type(result) == CELL_ERROR) {
+            return (Cell*)result;
+        }
+        if (cell_type(result) == CELL_BOOLEAN && result->boolean_v == 0) {
+            return False_Obj;
+        }
+    }
+    *next = n->kids[n->count - 1];
+    return TCS_Obj;
+}
+
+
+/* (%fold value call op ...), from the fold pass: value, unless an op has
+ * been rebound since, in which case the call is run. Each of kids[1..]
+ * holds an op, its original builtin, and a cache of its binding. */
+static Cell* exec_fold(const Node* n, Lex** env, const Node** next)
+{
+    for (int i = 1; i < n->count; i++) {
+        const Node* op = n->kids[i];
+        if (!fold_bound_to(lex_get_global(*env, op->expr, op->cache), op->value)) {
+            *next = n->kids[0];
+            return TCS_Obj;
+        }
+    }
+    return n->value;
+}
+
+
+/* Special forms which operate on their raw arguments (import, defmacro,
+ * delay, etc.) are dispatched through the SF table at runtime, as library
+ * imports may register their handlers after this node was analyzed.
+ * value holds the pre-built argument s-expr. */
+static Cell* exec_sf(const Node* n, Lex** env, const Node** next)
+{
+    const Cell* head = n->expr->cell[0];
+    const special_form_handler_t handler = head->sf_id < SF_MAX ? SF_DISPATCH_TABLE[head->sf_id] : nullptr;
+    if (!handler) {
+        return make_cell_error(
+            fmt_err("special form: '%s' not registered (did you forget to import?)", head->sym),
+            SYNTAX_ERR);
+    }
+    const HandlerResult result = handler(*env, n->value);
+    if (result.action == ACTION_RETURN) {
+        return result.value;
+    }
+    *env = result.env;
+    *next = analyze(result.value, result.env);
+    return TCS_Obj;
+}
+
+
+/* Apply an evaluated procedure to evaluated arguments. Builtins return their
+ * value directly. Lambdas bind their formals, and tail-call their body. */
+static Cell* apply_proc(const Cell* f, Cell* args, Lex** env, const Node** next)
+{
+    while (f->is_builtin) {
+        Cell* result = f->builtin(*env, args);
+        /* 'apply' returns a CELL_TCS of (proc arg ...) whose arguments
+         * are already evaluated, so they must not be evaluated again. */
+        if (cell_type(result) != CELL_TCS) {
+            return result;
+        }
+        f = result->cell[0];
+        args = make_cell_sexpr();
+        args->count = result->count - 1;
+        args->cell = result->cell + 1;
+    }
+
+    if (!f->lambda->code) {
+        f->lambda->code = analyze(f->lambda->body,
+                                  scope_for_formals(f->lambda->env, f->lambda->formals));
+    }
+    Lex* le = build_lambda_env(f->lambda->env, f->lambda->formals, args, !f->lambda->code->captures);
+    if (le == nullptr) {
+        /* We cannot return a specific error message from build_lambda_env(),
+         * so we have to return this generic error. */
+        return make_cell_error(
+            "bad lambda expression",
+            SYNTAX_ERR);
+    }
+    *env = le;
+    *next = f->lambda->code;
+    return TCS_Obj;
+}
+
+
+/* (operator operand ...) - value holds the operator symbol, if it is one. */
+static Cell* exec_app(const Node* n, Lex** env, const Node** next)
+{
+    Lex* e = *env;
+
+    /* The operator may have become a keyword since this node was analyzed. */
+    if (n->value && n->value->sf_id > 0) {
+        return coz_eval(e, n->expr);
+    }
+
+    const Cell* f = coz_exec(e, n->kids[0]);
+    if (cell_type(f) == CELL_ERROR) {
+        return (Cell*)f;
+    }
+
+    if (cell_type(f) == CELL_MACRO) {
+        /* The expansion is memoized in this node, and redone only when the
+         * operator is bound to another macro. Macros are expected to be
+         * pure functions of their arguments, and this call site always runs
+         * in frames of the same shape, so the analysis can be reused. */
+        if (n->macro != f) {
+            /* Transform the macro with its unevaluated arguments. */
+            Cell raw_args = { .type = CELL_SEXPR, .count = n->expr->count - 1, .cell = n->expr->cell + 1 };
+            Cell* result = coz_apply_and_get_val(f, &raw_args, e);
+            if (cell_type(result) == CELL_ERROR) {
+                return result;
+            }
+            Node* site = (Node*)n;
+            site->expansion = analyze(expand(make_sexpr_from_list(result, true)), e);
+            site->macro = f;
+        }
+        /* Tail-call the analyzed result of the transformation. */
+        *next = n->expansion;
+        return TCS_Obj;
+    }
+
+    if (cell_type(f) != CELL_PROC) {
+        return make_cell_error(
+            fmt_err("bad identifier: '%s'. Expression must start with a procedure",
+                cell_to_string(f, MODE_REPL)),
+            TYPE_ERR);
+    }
+
+    /* Evaluate the arguments onto the argument stack, and apply the
+     * procedure to a view of them (see eval.c). */
+    const int argc = n->count - 1;
+    Cell** argv = arg_stack_reserve(argc);
+    for (int i = 0; i < argc; i++) {
+        Cell* result = coz_exec(e, n->kids[i + 1]);
+        if (!result) {
+            result = USP_Obj;
+        } else if (cell_type(result) == CELL_ERROR) {
+            arg_stack_release(argv);
+            return result;
+        }
+        argv[i] = result;
+    }
+
+    Cell args = { .type = CELL_SEXPR, .count = argc, .cell = argv };
+    Cell* result = apply_proc(f, &args, env, next);
+    arg_stack_release(argv);
+    return result;
+}
+
+
+/* -----------------------------*
+ *        Analysis proper       *
+ * -----------------------------*/
+
+
+/* Analyze the elements of c from 'start', into n->kids from 'offset'. */
+static void analyze_into(const Node* n, const int offset, const Cell* c, const int start,
+                         const Lex* scope)
+{
+    for (int i = start; i < c->count; i++) {
+        n->kids[offset + i - start] = analyze(c->cell[i], scope);
+    }
+}
+
+
+static Node* analyze_node(Cell* expr, const Lex* scope);
+
+
+static Node* make_raw(Cell* expr)
+{
+    return make_node(exec_raw, expr, nullptr, 0);
+}
+
+
+/* Build the scope a lambda body runs in: a frame holding the formals, laid
+ * out exactly as build_lambda_env() will bind them. Returns null if the
+ * enclosing scope is unknown, or the formals are malformed. */
+Lex* scope_for_formals(const Lex* scope, const Cell* formals)
+{
+    if (!scope) return nullptr;
+    Lex* s = new_child_env(scope);
+    if (cell_type(formals) == CELL_SYMBOL) {
+        lex_put_local(s, formals, USP_Obj);
+        return s;
+    }
+    if (cell_type(formals) != CELL_SEXPR) return nullptr;
+    for (int i = 0; i < formals->count; i++) {
+        const Cell* f = formals->cell[i];
+        if (cell_type(f) != CELL_SYMBOL) return nullptr;
+        /* Skip the dot of a dotted tail. */
+        if (i == formals->count - 2 && strcmp(f->sym, ".") == 0) continue;
+        lex_put_local(s, f, USP_Obj);
+    }
+    return s;
+}
+
+
+/* The scope of a let or letrec body. */
+Lex* scope_for_bindings(const Lex* scope, const Cell* bindings)
+{
+    if (!scope) return nullptr;
+    Lex* s = new_child_env(scope);
+    for (int i = 0; i < bindings->count; i++) {
+        lex_put_local(s, bindings->cell[i]->cell[0], USP_Obj);
+    }
+    return s;
+}
+
+
+/* Formals must be a symbol, or an s-expr of symbols. */
+static bool formals_ok(const Cell* formals)
+{
+    if (cell_type(formals) == CELL_SYMBOL) return true;
+    if (cell_type(formals) != CELL_SEXPR) return false;
+    for (int i = 0; i < formals->count; i++) {
+        if (cell_type(formals->cell[i]) != CELL_SYMBOL) return false;
+    }
+    return true;
+}
+
+
+/* let and letrec bindings must be ((symbol init) ...). */
+static bool bindings_ok(const Cell* bindings)
+{
+    if (cell_type(bindings) != CELL_SEXPR) return false;
+    for (int i = 0; i < bindings->count; i++) {
+        const Cell* b = bindings->cell[i];
+        if (cell_type(b) != CELL_SEXPR || b->count != 2 || cell_type(b->cell[0]) != CELL_SYMBOL) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+static Node* analyze_ref(Cell* sym, const Lex* scope)
+{
+    if (!scope) {
+        return make_node(exec_ref, sym, sym, 0);
+    }
+    int depth, slot;
+    if (lex_resolve(scope, sym, &depth, &slot)) {
+        Node* n = make_node(exec_local, sym, sym, 0);
+        n->depth = depth;
+        n->slot = slot;
+        return n;
+    }
+    Node* n = make_node(exec_global, sym, sym, 0);
+    n->cache = lex_make_global_cache();
+    return n;
+}
+
+
+static Node* analyze_define(Cell* expr, const Lex* scope)
+{
+    if (expr->count < 3) return make_raw(expr);
+    Cell* target = expr->cell[1];
+
+    if (cell_type(target) == CELL_SYMBOL && !is_syntactic_keyword(target)) {
+        Node* n = make_node(exec_define_var, expr, target, 1);
+        n->kids[0] = analyze(expr->cell[2], scope);
+        return n;
+    }
+
+    if (cell_type(target) == CELL_SEXPR && target->count > 0 &&
+        cell_type(target->cell[0]) == CELL_SYMBOL && !is_syntactic_keyword(target->cell[0])) {
+        Cell* formals = make_arg_sexpr(target->count - 1);
+        for (int i = 1; i < target->count; i++) {
+            if (cell_type(target->cell[i]) != CELL_SYMBOL) return make_raw(expr);
+            formals->cell[i - 1] = target->cell[i];
+        }
+        Node* n = make_node(exec_define_proc, expr, formals, 1);
+        n->kids[0] = analyze(expr->cell[2], scope_for_formals(scope, formals));
+        return n;
+    }
+    return make_raw(expr);
+}
+
+
+static Node* analyze_let(Cell* expr, const node_handler_t exec, const Lex* scope)
+{
+    if (expr->count < 2 || !bindings_ok(expr->cell[1])) return make_raw(expr);
+    /* let needs a body; letrec without one returns unspecified. */
+    if (exec == exec_let && expr->count < 3) return make_raw(expr);
+
+    const Cell* bindings = expr->cell[1];
+    const Lex* body_scope = scope_for_bindings(scope, bindings);
+    /* let inits run in the enclosing scope, letrec inits in the new one. */
+    const Lex* init_scope = exec == exec_let ? scope : body_scope;
+
+    Node* n = make_node(exec, expr, expr->cell[1], bindings->count + expr->count - 2);
+    for (int i = 0; i < bindings->count; i++) {
+        n->kids[i] = analyze(bindings->cell[i]->cell[1], init_scope);
+    }
+    analyze_into(n, bindings->count, expr, 2, body_scope);
+    return n;
+}
+
+
+static Node* analyze_special_form(Cell* expr, const Lex* scope)
+{
+    const Cell* head = expr->cell[0];
+    const int argc = expr->count - 1;
+    Node* n;
+
+    switch (head->sf_id) {
+    case SF_ID_DEFINE:
+        return analyze_define(expr, scope);
+
+    case SF_ID_QUOTE:
+        if (argc != 1) return make_raw(expr);
+        return make_node(exec_const, expr, make_list_from_sexpr(expr->cell[1]), 0);
+
+    case SF_ID_LAMBDA:
+        if (argc < 2 || !formals_ok(expr->cell[1])) return make_raw(expr);
+        n = make_node(exec_lambda, expr, expr->cell[1], 1);
+        n->kids[0] = analyze(expr->cell[2], scope_for_formals(scope, expr->cell[1]));
+        return n;
+
+    case SF_ID_IF:
+        if (argc < 2 || argc > 3) return make_raw(expr);
+        n = make_node(exec_if, expr, nullptr, argc);
+        analyze_into(n, 0, expr, 1, scope);
+        return n;
+
+    case SF_ID_LET:
+        return analyze_let(expr, exec_let, scope);
+
+    case SF_ID_LETREC:
+        return analyze_let(expr, exec_letrec, scope);
+
+    case SF_ID_SET_BANG:
+        if (argc != 2 || cell_type(expr->cell[1]) != CELL_SYMBOL) return make_raw(expr);
+        n = make_node(exec_set, expr, expr->cell[1], 1);
+        n->kids[0] = analyze(expr->cell[2], scope);
+        /* Leaves slot at -1 for globals. */
+        if (scope) lex_resolve(scope, expr->cell[1], &n->depth, &n->slot);
+        return n;
+
+    case SF_ID_BEGIN:
+        if (argc == 0) return make_node(exec_const, expr, USP_Obj, 0);
+        n = make_node(exec_begin, expr, nullptr, argc);
+        analyze_into(n, 0, expr, 1, scope);
+        return n;
+
+    case SF_ID_AND:
+        if (argc == 0) return make_node(exec_const, expr, True_Obj, 0);
+        n = make_node(exec_and, expr, nullptr, argc);
+        analyze_into(n, 0, expr, 1, scope);
+        return n;
+
+    case SF_ID_FOLD:
+        if (!fold_guard_ok(expr)) return make_raw(expr);
+        n = make_node(exec_fold, expr, expr->cell[1], argc - 1);
+        n->kids[0] = analyze(expr->cell[2], scope);
+        for (int i = 1; i < n->count; i++) {
+            Cell* op = expr->cell[i + 2];
+            n->kids[i] = make_node(exec_const, op, fold_builtin(op), 0);
+            n->kids[i]->cache = lex_make_global_cache();
+        }
+        return n;
+
+    default: {
+        Cell* raw_args = make_arg_sexpr(argc);
+        for (int i = 0; i < argc; i++) {
+            raw_args->cell[i] = expr->cell[i + 1];
+        }
+        return make_node(exec_sf, expr, raw_args, 0);
+    }
+    }
+}
+
+
+static Node* analyze_node(Cell* expr, const Lex* scope)
+{
+    if (!expr) {
+        return make_node(exec_const, nullptr, nullptr, 0);
+    }
+
+    /* Self-evaluating types. */
+    if (cell_type(expr) & (CELL_INTEGER|CELL_REAL|CELL_RATIONAL|CELL_COMPLEX|
+                      CELL_BOOLEAN|CELL_CHAR|CELL_STRING|CELL_PAIR|
+                      CELL_VECTOR|CELL_BYTEVECTOR|CELL_NIL|CELL_EOF|
+                      CELL_PROC|CELL_PORT|CELL_ERROR|CELL_UNSPEC|
+                      CELL_BIGINT|CELL_BIGFLOAT|CELL_SET|CELL_HASH|
+                      CELL_PROMISE|CELL_STREAM)) {
+        return make_node(exec_const, expr, expr, 0);
+    }
+
+    if (cell_type(expr) == CELL_SYMBOL) {
+        /* Let the tree-walker scold for using syntax as a variable. */
+        if (is_syntactic_keyword(expr)) {
+            return make_raw(expr);
+        }
+        return analyze_ref(expr, scope);
+    }
+
+    if (cell_type(expr) != CELL_SEXPR || expr->count == 0) {
+        return make_raw(expr);
+    }
+
+    Cell* head = expr->cell[0];
+    if (cell_type(head) == CELL_SYMBOL && head->sf_id > 0) {
+        return analyze_special_form(expr, scope);
+    }
+
+    /* Procedure call or macro use. */
+    Node* n = make_node(exec_app, expr, cell_type(head) == CELL_SYMBOL ? head : nullptr, expr->count);
+    analyze_into(n, 0, expr, 0, scope);
+    return n;
+}
+
+
+/* Analyze an expanded expression into a Node tree, to be run in an
+ * environment whose local frames are laid out as those of scope.
+ *
+ * Each node also records whether running it may capture its environment.
+ * A lambda or let body which cannot gets its frame from the frame pool (see
+ * lex_acquire_frame()). Forms handed to coz_eval() or the SF table count as
+ * capturing, since they are opaque here. Closures and promises made at
+ * runtime anyway (ie: by a macro expansion or eval) mark the frames they
+ * hold as captured, so those frames are never recycled. */
+Node* analyze(Cell* expr, const Lex* scope)
+{
+    Node* n = analyze_node(expr, scope);
+    const node_handler_t exec = n->exec;
+    n->captures = exec == exec_lambda || exec == exec_define_proc ||
+                  exec == exec_sf || exec == exec_raw;
+    if (exec == exec_lambda || exec == exec_define_proc) {
+        /* The kid is the body, which runs in a frame of its own. */
+        return n;
+    }
+
+    bool body_captures = false;
+    for (int i = 0; i < n->count; i++) {
+        if (!n->kids[i]->captures) continue;
+        n->captures = true;
+        /* let inits run in the enclosing frame. */
+        if (exec != exec_let || i >= n->value->count) {
+            body_captures = true;
+        }
+    }
+    n->pool_frame = (exec == exec_let || exec == exec_letrec) && !body_captures;
+    return n;
+}
@@ -0,0 +1,52 @@
+/*
+ * 'src/analyzer.h'
+ * This file is part of Cozenage - https://github.com/DarrenKirby/cozenage
+ * Copyright © 2025 - 2026 Darren Kirby <darren@dragonbyte.ca>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COZENAGE_ANALYZER_H
+#define COZENAGE_ANALYZER_H
+
+#include "cell.h"
+
+
+/* A node handler either returns a final value, or returns TCS_Obj after
+ * setting *next (and possibly *env) to request a tail call. */
+typedef Cell* (*node_handler_t)(const Node* n, Lex** env, const Node** next);
+
+/* One pre-resolved piece of an analyzed expression. */
+struct Node {
+    node_handler_t exec;  /* Specialised handler for this kind of node. */
+    Cell* expr;           /* The source expression this node was built from. */
+    Cell* value;          /* Per-kind payload: constant, symbol, formals, or raw args. */
+    Node** kids;          /* Sub-nodes, in evaluation order. */
+    int count;            /* Number of sub-nodes. */
+    int depth;            /* Lexical address of a local variable: frames up, */
+    int slot;             /* and slot within that frame. */
+    global_cache* cache;  /* Binding cache for a global variable reference. */
+    const Cell* macro;    /* Macro use: the macro which made 'expansion'. */
+    const Node* expansion; /* Memoized, analyzed expansion of a macro use. */
+    bool captures;        /* Running this node may create a closure over its environment. */
+    bool pool_frame;      /* let/letrec: the new frame may come from the frame pool. */
+};
+
+
+Node* analyze(Cell* expr, const Lex* scope);
+Lex* scope_for_formals(const Lex* scope, const Cell* formals);
+Lex* scope_for_bindings(const Lex* scope, const Cell* bindings);
+Cell* coz_exec(Lex* env, const Node* n);
+
+#endif //COZENAGE_ANALYZER_H
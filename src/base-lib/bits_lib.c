@@ -107,11 +107,11 @@ static Cell* bits_right_shift(const Lex* e, const Cell* a)
     const Cell* arg2 = a->cell[1];
 
     bool bs = false;
-    if (arg1->type == CELL_SYMBOL) {
+    if (cell_type(arg1) == CELL_SYMBOL) {
         arg1 = bits_bitstring_to_int(e, make_sexpr_len1(arg1));
         bs = true;
     }
-    if (arg2->type == CELL_SYMBOL) {
+    if (cell_type(arg2) == CELL_SYMBOL) {
         arg2 = bits_bitstring_to_int(e, make_sexpr_len1(arg2));
         bs = true;
     }
@@ -145,11 +145,11 @@ static Cell* bits_left_shift(const Lex* e, const Cell* a)
     const Cell* arg2 = a->cell[1];
 
     bool bs = false;
-    if (arg1->type == CELL_SYMBOL) {
+    if (cell_type(arg1) == CELL_SYMBOL) {
         arg1 = bits_bitstring_to_int(e, make_sexpr_len1(arg1));
         bs = true;
     }
-    if (arg2->type == CELL_SYMBOL) {
+    if (cell_type(arg2) == CELL_SYMBOL) {
         arg2 = bits_bitstring_to_int(e, make_sexpr_len1(arg2));
         bs = true;
     }
@@ -183,12 +183,12 @@ static Cell* bits_bitwise_and(const Lex* e, const Cell* a)
     const Cell* arg2 = a->cell[1];
 
     bool bs = false;
-    if (arg1->type == CELL_SYMBOL) {
+    if (cell_type(arg1) == CELL_SYMBOL) {
         arg1 = bits_bitstring_to_int(e, make_sexpr_len1(arg1));
         bs = true;
     }
 
-    if (arg2->type == CELL_SYMBOL) {
+    if (cell_type(arg2) == CELL_SYMBOL) {
         arg2 = bits_bitstring_to_int(e, make_sexpr_len1(arg2));
         bs = true;
     }
@@ -222,11 +222,11 @@ static Cell* bits_bitwise_or(const Lex* e, const Cell* a)
     const Cell* arg2 = a->cell[1];
 
     bool bs = false;
-    if (arg1->type == CELL_SYMBOL) {
+    if (cell_type(arg1) == CELL_SYMBOL) {
         arg1 = bits_bitstring_to_int(e, make_sexpr_len1(arg1));
         bs = true;
     }
-    if (arg2->type == CELL_SYMBOL) {
+    if (cell_type(arg2) == CELL_SYMBOL) {
         arg2 = bits_bitstring_to_int(e, make_sexpr_len1(arg2));
         bs = true;
     }
@@ -260,11 +260,11 @@ static Cell* bits_bitwise_xor(const Lex* e, const Cell* a)
     const Cell* arg2 = a->cell[1];
 
     bool bs = false;
-    if (arg1->type == CELL_SYMBOL) {
+    if (cell_type(arg1) == CELL_SYMBOL) {
         arg1 = bits_bitstring_to_int(e, make_sexpr_len1(arg1));
         bs = true;
     }
-    if (arg2->type == CELL_SYMBOL) {
+    if (cell_type(arg2) == CELL_SYMBOL) {
         arg2 = bits_bitstring_to_int(e, make_sexpr_len1(arg2));
         bs = true;
     }
@@ -297,7 +297,7 @@ static Cell* bits_bitwise_not(const Lex* e, const Cell* a)
     const Cell* arg1 = a->cell[0];
 
     bool bs = false;
-    if (arg1->type == CELL_SYMBOL) {
+    if (cell_type(arg1) == CELL_SYMBOL) {
         arg1 = bits_bitstring_to_int(e, make_sexpr_len1(arg1));
         bs = true;
     }
@@ -324,7 +324,7 @@ static Cell* bits_add(const Lex* e, const Cell* a)
     const Cell* arg1 = bits_bitstring_to_int(e, make_sexpr_len1(a->cell[0]));
     const Cell* arg2 = bits_bitstring_to_int(e, make_sexpr_len1(a->cell[1]));
 
-    const Cell* result = make_cell_integer(arg1->integer_v + arg2->integer_v);
+    const Cell* result = make_cell_integer(cell_int(arg1) + cell_int(arg2));
     return bits_int_to_bitstring(e, make_sexpr_len1(result));
 }
 
@@ -342,7 +342,7 @@ static Cell* bits_sub(const Lex* e, const Cell* a)
     const Cell* arg1 = bits_bitstring_to_int(e, make_sexpr_len1(a->cell[0]));
     const Cell* arg2 = bits_bitstring_to_int(e, make_sexpr_len1(a->cell[1]));
 
-    const Cell* result = make_cell_integer(arg1->integer_v - arg2->integer_v);
+    const Cell* result = make_cell_integer(cell_int(arg1) - cell_int(arg2));
     return bits_int_to_bitstring(e, make_sexpr_len1(result));
 }
 
@@ -360,7 +360,7 @@ static Cell* bits_mul(const Lex* e, const Cell* a)
     const Cell* arg1 = bits_bitstring_to_int(e, make_sexpr_len1(a->cell[0]));
     const Cell* arg2 = bits_bitstring_to_int(e, make_sexpr_len1(a->cell[1]));
 
-    const Cell* result = make_cell_integer(arg1->integer_v * arg2->integer_v);
+    const Cell* result = make_cell_integer(cell_int(arg1) * cell_int(arg2));
     return bits_int_to_bitstring(e, make_sexpr_len1(result));
 }
 
@@ -378,11 +378,11 @@ static Cell* bits_div(const Lex* e, const Cell* a)
     const Cell* arg1 = bits_bitstring_to_int(e, make_sexpr_len1(a->cell[0]));
     const Cell* arg2 = bits_bitstring_to_int(e, make_sexpr_len1(a->cell[1]));
 
-    if (arg2->integer_v == 0) {
+    if (cell_int(arg2) == 0) {
         return make_cell_error("bs/: division by zero", VALUE_ERR);
     }
 
-    const Cell* result = make_cell_integer(arg1->integer_v / arg2->integer_v);
+    const Cell* result = make_cell_integer(cell_int(arg1) / cell_int(arg2));
     return bits_int_to_bitstring(e, make_sexpr_len1(result));
 }
 
@@ -397,7 +397,7 @@ static Cell* bits_int_to_bitstring(const Lex* e, const Cell* a)
     err = check_arg_types(a, CELL_INTEGER, "int->bitstring");
     if (err) return err;
 
-    char* str = format_twos_complement(a->cell[0]->integer_v);
+    char* str = format_twos_complement(cell_int(a->cell[0]));
     /* 66 = 64 bit max size of long long + '\0' + 'b' prefix */
     char sym_str[66] = "b";
     strlcat(sym_str, str, 66);
@@ -413,7 +413,7 @@ static Cell* bits_bitstring_to_int(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "bitstring->int");
     if (err) return err;
-    if (a->cell[0]->type != CELL_SYMBOL) {
+    if (cell_type(a->cell[0]) != CELL_SYMBOL) {
         return make_cell_error(
             "bitstring->int: invalid bitstring",
             VALUE_ERR);
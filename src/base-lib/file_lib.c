@@ -430,7 +430,7 @@ static Cell* file_stat(const Lex* e, const Cell* a) {
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "stat");
     if (err) { return err; }
-    if (a->cell[0]->type != CELL_STRING) {
+    if (cell_type(a->cell[0]) != CELL_STRING) {
         return make_cell_error(
             "stat: file path must be passed as a string",
             TYPE_ERR);
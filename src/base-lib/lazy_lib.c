@@ -79,6 +79,7 @@ HandlerResult sf_delay_force(Lex* e, Cell* a)
     p->promise->expr   = a->cell[0];
     p->promise->status = LAZY;
     p->promise->env    = e;
+    lex_capture(e);
     return (HandlerResult) { .action = ACTION_RETURN, .value = p, .env = nullptr };
 }
 
@@ -115,7 +116,7 @@ Cell* lazy_force(const Lex* e, const Cell* a)
     if (err) return err;
 
     Cell* p = a->cell[0];
-    if (p->type != CELL_PROMISE) return p;
+    if (cell_type(p) != CELL_PROMISE) return p;
 
     if (p->promise->status == RUNNING) {
         return make_cell_error("force: re-entrant promise", GEN_ERR);
@@ -139,7 +140,7 @@ Cell* lazy_force(const Lex* e, const Cell* a)
 
         if (mode == LAZY) {
             /* delay-force requires that the result MUST be a promise. */
-            if (result->type != CELL_PROMISE) {
+            if (cell_type(result) != CELL_PROMISE) {
                 p->promise->status = DONE; /* Reset state before erroring. */
                 return make_cell_error(
                     "force: expression did not return a promise",
@@ -173,7 +174,7 @@ Cell* lazy_make_promise(const Lex* e, const Cell* a)
     Cell* err = CHECK_ARITY_EXACT(a, 1, "make-promise");
     if (err) return err;
 
-    if (a->cell[0]->type == CELL_PROMISE) {
+    if (cell_type(a->cell[0]) == CELL_PROMISE) {
         return a->cell[0];
     }
 
@@ -192,7 +193,7 @@ Cell* lazy_promise_pred(const Lex* e, const Cell* a)
     Cell* err = CHECK_ARITY_EXACT(a, 1, "promise?");
     if (err) return err;
 
-    if (a->cell[0]->type != CELL_PROMISE) {
+    if (cell_type(a->cell[0]) != CELL_PROMISE) {
         return False_Obj;
     }
     return True_Obj;
@@ -207,7 +208,7 @@ Cell* lazy_stream_pred(const Lex* e, const Cell* a)
     Cell* err = CHECK_ARITY_EXACT(a, 1, "stream?");
     if (err) return err;
 
-    if (a->cell[0]->type != CELL_STREAM) {
+    if (cell_type(a->cell[0]) != CELL_STREAM) {
         return False_Obj;
     }
     return True_Obj;
@@ -220,7 +221,7 @@ Cell* lazy_head(const Lex* e, const Cell* a) {
     Cell* err = CHECK_ARITY_EXACT(a, 1, "head");
     if (err) return err;
 
-    if (a->cell[0]->type != CELL_STREAM) {
+    if (cell_type(a->cell[0]) != CELL_STREAM) {
         return make_cell_error(
             "head: expected a stream",
             TYPE_ERR);
@@ -233,10 +234,10 @@ Cell* lazy_head(const Lex* e, const Cell* a) {
 Cell* lazy_tail(const Lex* e, const Cell* a) {
     Cell* err = CHECK_ARITY_EXACT(a, 1, "tail");
     if (err) return err;
-    if (a->cell[0]->type == CELL_NIL) {
+    if (cell_type(a->cell[0]) == CELL_NIL) {
         return Nil_Obj;
     }
-    if (a->cell[0]->type != CELL_STREAM) {
+    if (cell_type(a->cell[0]) != CELL_STREAM) {
         return make_cell_error(
             "tail: expected a stream",
             TYPE_ERR);
@@ -252,14 +253,14 @@ Cell* lazy_tail(const Lex* e, const Cell* a) {
 Cell* lazy_at(const Lex* e, const Cell* a) {
     Cell* err = CHECK_ARITY_EXACT(a, 2, "at");
     if (err) return err;
-    if (a->cell[0]->type != CELL_INTEGER) {
+    if (cell_type(a->cell[0]) != CELL_INTEGER) {
         return make_cell_error(\
             "at: arg1 must be a positive integer",
             TYPE_ERR);
     }
-    long n = a->cell[0]->integer_v;
+    long n = cell_int(a->cell[0]);
 
-    if (a->cell[1]->type != CELL_STREAM) {
+    if (cell_type(a->cell[1]) != CELL_STREAM) {
         return make_cell_error(
             "at: arg2 must be a stream",
             TYPE_ERR);
@@ -267,7 +268,7 @@ Cell* lazy_at(const Lex* e, const Cell* a) {
     Cell* s = a->cell[1];
 
     while (n > 0) {
-        if (s->type != CELL_STREAM) {
+        if (cell_type(s) != CELL_STREAM) {
             return make_cell_error(
                 "at: expected a stream",
                 TYPE_ERR);
@@ -277,11 +278,11 @@ Cell* lazy_at(const Lex* e, const Cell* a) {
          * The result of forcing the tail MUST be another stream. */
         s = lazy_force(e, make_sexpr_len1(s->tail));
 
-        if (s->type == CELL_ERROR) return s;
+        if (cell_type(s) == CELL_ERROR) return s;
         n--;
     }
 
-    if (s->type != CELL_STREAM) {
+    if (cell_type(s) != CELL_STREAM) {
         return make_cell_error(
             "at: reached end of stream before index",
             INDEX_ERR);
@@ -296,14 +297,14 @@ Cell* lazy_take(const Lex* e, const Cell* a) {
     Cell* err = CHECK_ARITY_EXACT(a, 2, "take");
     if (err) return err;
 
-    if (a->cell[0]->type != CELL_INTEGER) {
+    if (cell_type(a->cell[0]) != CELL_INTEGER) {
         return make_cell_error(\
             "take: arg1 must be a positive integer",
             TYPE_ERR);
     }
-    long n = a->cell[0]->integer_v;
+    long n = cell_int(a->cell[0]);
 
-    if (a->cell[1]->type != CELL_STREAM) {
+    if (cell_type(a->cell[1]) != CELL_STREAM) {
         return make_cell_error(
             "take: arg2 must be a stream",
             TYPE_ERR);
@@ -313,7 +314,7 @@ Cell* lazy_take(const Lex* e, const Cell* a) {
     Cell* head = Nil_Obj;
     Cell* tail = Nil_Obj;
 
-    while (n > 0 && s->type == CELL_STREAM) {
+    while (n > 0 && cell_type(s) == CELL_STREAM) {
         /* Build the result list node. */
         Cell* new_node = make_cell_pair(s->head, Nil_Obj);
 
@@ -325,7 +326,7 @@ Cell* lazy_take(const Lex* e, const Cell* a) {
         if (n > 0) {
             /* Step the stream. */
             s = lazy_tail(e, make_sexpr_len1(s));
-            if (s->type == CELL_ERROR) return s;
+            if (cell_type(s) == CELL_ERROR) return s;
         }
     }
     return head;
@@ -337,21 +338,21 @@ Cell* lazy_drop(const Lex* e, const Cell* a) {
     Cell* err = CHECK_ARITY_EXACT(a, 2, "drop");
     if (err) return err;
 
-    if (a->cell[0]->type != CELL_INTEGER) {
+    if (cell_type(a->cell[0]) != CELL_INTEGER) {
         return make_cell_error(\
             "drop: arg1 must be a positive integer",
             TYPE_ERR);
     }
-    long n = a->cell[0]->integer_v;
+    long n = cell_int(a->cell[0]);
 
-    if (a->cell[1]->type != CELL_STREAM) {
+    if (cell_type(a->cell[1]) != CELL_STREAM) {
         return make_cell_error(
             "drop: arg2 must be a stream",
             TYPE_ERR);
     }
     Cell* s = a->cell[1];
 
-    while (n > 0 && s->type != CELL_NIL) {
+    while (n > 0 && cell_type(s) != CELL_NIL) {
         s = lazy_tail(e, make_sexpr_len1(s));
         n--;
     }
@@ -368,9 +369,9 @@ Cell* lazy_list_to_stream(const Lex* e, const Cell* a) {
 
     Cell* lst = a->cell[0];
 
-    if (lst->type == CELL_NIL) return Nil_Obj;
+    if (cell_type(lst) == CELL_NIL) return Nil_Obj;
 
-    if (lst->type != CELL_PAIR) {
+    if (cell_type(lst) != CELL_PAIR) {
         return make_cell_error(
             "list->stream: arg1 must be a list",
             TYPE_ERR);
@@ -394,9 +395,9 @@ Cell* lazy_list_to_stream(const Lex* e, const Cell* a) {
 static Cell* lazy_list_to_stream_tail(const Lex* e, const Cell* a) {
     Cell* lst = a->cell[0];
 
-    if (lst->type == CELL_NIL) return Nil_Obj;
+    if (cell_type(lst) == CELL_NIL) return Nil_Obj;
 
-    if (lst->type != CELL_PAIR) {
+    if (cell_type(lst) != CELL_PAIR) {
         return make_cell_error(
             "list->stream: tail must be a proper list",
             TYPE_ERR);
@@ -418,7 +419,7 @@ Cell* lazy_iterate(const Lex* e, const Cell* a) {
     Cell* proc = a->cell[0];
     Cell* seed = a->cell[1];
 
-    if (proc->type != CELL_PROC) {
+    if (cell_type(proc) != CELL_PROC) {
         return make_cell_error(
             "iterate: arg1 must be a procedure",
             TYPE_ERR);
@@ -446,7 +447,7 @@ static Cell* lazy_iterate_tail(const Lex* e, const Cell* a) {
 
     /* Apply proc to seed to get the next value. */
     Cell* next = coz_apply_and_get_val(proc, make_sexpr_len1(seed), e);
-    if (next->type == CELL_ERROR) return next;
+    if (cell_type(next) == CELL_ERROR) return next;
 
     Cell* args = make_cell_sexpr();
     cell_add(args, proc);
@@ -464,8 +465,8 @@ static Cell* lazy_select_from_tail(const Lex* e, const Cell* a) {
 
     /* Force the tail to get the next stream node. */
     Cell* next = lazy_force(e, make_sexpr_len1(s->tail));
-    if (next->type == CELL_ERROR) return next;
-    if (next->type == CELL_NIL)   return Nil_Obj;
+    if (cell_type(next) == CELL_ERROR) return next;
+    if (cell_type(next) == CELL_NIL)   return Nil_Obj;
 
     /* Now run select from there. */
     Cell* args = make_cell_sexpr();
@@ -479,12 +480,12 @@ Cell* lazy_select(const Lex* e, const Cell* a) {
     Cell* pred = a->cell[0];
     Cell* s = a->cell[1];
 
-    if (s->type == CELL_NIL) return Nil_Obj;
+    if (cell_type(s) == CELL_NIL) return Nil_Obj;
 
-    while (s->type == CELL_STREAM) {
+    while (cell_type(s) == CELL_STREAM) {
         /* Test the current head */
         Cell* res = coz_apply_and_get_val(pred, make_sexpr_len1(s->head), e);
-        if (res->type == CELL_ERROR) return res;
+        if (cell_type(res) == CELL_ERROR) return res;
 
         if (res == True_Obj) {
             /* We found a match at node 's'...
@@ -507,12 +508,12 @@ Cell* lazy_select(const Lex* e, const Cell* a) {
         /* Force the promise in the tail to get the next stream node */
         s = lazy_force(e, make_sexpr_len1(s->tail));
 
-        if (s->type == CELL_ERROR) return s;
-        if (s->type == CELL_NIL) return Nil_Obj;
+        if (cell_type(s) == CELL_ERROR) return s;
+        if (cell_type(s) == CELL_NIL) return Nil_Obj;
 
-        /* If s->type is not CELL_STREAM here, the user gave us a
+        /* If cell_type(s) is not CELL_STREAM here, the user gave us a
            malformed stream (a promise that doesn't evaluate to a stream). */
-        if (s->type != CELL_STREAM) {
+        if (cell_type(s) != CELL_STREAM) {
             return make_cell_error(
                 "select: stream tail must evaluate to a stream",
                 TYPE_ERR);
@@ -531,9 +532,9 @@ Cell* lazy_collect(const Lex* e, const Cell* a) {
     Cell* proc = a->cell[0];
     Cell* s = a->cell[1];
 
-    if (s->type == CELL_NIL) return Nil_Obj;
+    if (cell_type(s) == CELL_NIL) return Nil_Obj;
 
-    if (s->type != CELL_STREAM) {
+    if (cell_type(s) != CELL_STREAM) {
         return make_cell_error(
             "collect: arg2 must be a stream",
             TYPE_ERR);
@@ -541,7 +542,7 @@ Cell* lazy_collect(const Lex* e, const Cell* a) {
 
     /* Apply proc to the head eagerly. */
     Cell* new_head = coz_apply_and_get_val(proc, make_sexpr_len1(s->head), e);
-    if (new_head->type == CELL_ERROR) return new_head;
+    if (cell_type(new_head) == CELL_ERROR) return new_head;
 
     /* Build a native thunk for the tail. */
     Cell* tail_args = make_cell_sexpr();
@@ -565,10 +566,10 @@ static Cell* lazy_collect_from_tail(const Lex* e, const Cell* a) {
 
     /* Force the tail to get the next stream node. */
     Cell* next = lazy_force(e, make_sexpr_len1(s->tail));
-    if (next->type == CELL_ERROR) return next;
-    if (next->type == CELL_NIL)   return Nil_Obj;
+    if (cell_type(next) == CELL_ERROR) return next;
+    if (cell_type(next) == CELL_NIL)   return Nil_Obj;
 
-    if (next->type != CELL_STREAM) {
+    if (cell_type(next) != CELL_STREAM) {
         return make_cell_error(
             "collect: stream tail must evaluate to a stream",
             TYPE_ERR);
@@ -591,14 +592,14 @@ Cell* lazy_weave(const Lex* e, const Cell* a) {
     Cell* s1 = a->cell[0];
     Cell* s2 = a->cell[1];
 
-    if (s1->type == CELL_NIL || s2->type == CELL_NIL) return Nil_Obj;
+    if (cell_type(s1) == CELL_NIL || cell_type(s2) == CELL_NIL) return Nil_Obj;
 
-    if (s1->type != CELL_STREAM) {
+    if (cell_type(s1) != CELL_STREAM) {
         return make_cell_error(
             "weave: arg1 must be a stream",
             TYPE_ERR);
     }
-    if (s2->type != CELL_STREAM) {
+    if (cell_type(s2) != CELL_STREAM) {
         return make_cell_error(
             "weave: arg2 must be a stream",
             TYPE_ERR);
@@ -629,13 +630,13 @@ static Cell* lazy_weave_tail(const Lex* e, const Cell* a) {
 
     /* Force both tails. */
     Cell* next1 = lazy_force(e, make_sexpr_len1(s1->tail));
-    if (next1->type == CELL_ERROR) return next1;
+    if (cell_type(next1) == CELL_ERROR) return next1;
 
     Cell* next2 = lazy_force(e, make_sexpr_len1(s2->tail));
-    if (next2->type == CELL_ERROR) return next2;
+    if (cell_type(next2) == CELL_ERROR) return next2;
 
     /* If either stream is exhausted, we're done. */
-    if (next1->type == CELL_NIL || next2->type == CELL_NIL) return Nil_Obj;
+    if (cell_type(next1) == CELL_NIL || cell_type(next2) == CELL_NIL) return Nil_Obj;
 
     Cell* args = make_cell_sexpr();
     cell_add(args, next1);
@@ -655,35 +656,35 @@ Cell* lazy_reduce(const Lex* e, const Cell* a) {
     Cell* acc = a->cell[1];
     Cell* s = a->cell[2];
 
-    if (proc->type != CELL_PROC) {
+    if (cell_type(proc) != CELL_PROC) {
         return make_cell_error(
             "reduce: arg1 must be a procedure",
             TYPE_ERR);
     }
-    if (s->type != CELL_STREAM && s->type != CELL_PAIR && s->type != CELL_NIL) {
+    if (cell_type(s) != CELL_STREAM && cell_type(s) != CELL_PAIR && cell_type(s) != CELL_NIL) {
         return make_cell_error(
             "reduce: arg3 must be a stream or list",
             TYPE_ERR);
     }
 
-    while (s->type == CELL_STREAM || s->type == CELL_PAIR) {
+    while (cell_type(s) == CELL_STREAM || cell_type(s) == CELL_PAIR) {
         Cell* args = make_cell_sexpr();
         cell_add(args, acc);
 
-        if (s->type == CELL_STREAM) {
+        if (cell_type(s) == CELL_STREAM) {
             cell_add(args, s->head);
             acc = coz_apply_and_get_val(proc, args, e);
-            if (acc->type == CELL_ERROR) return acc;
+            if (cell_type(acc) == CELL_ERROR) return acc;
             s = lazy_force(e, make_sexpr_len1(s->tail));
         } else {
             /* CELL_PAIR — traverse as a regular list. */
             cell_add(args, s->car);
             acc = coz_apply_and_get_val(proc, args, e);
-            if (acc->type == CELL_ERROR) return acc;
+            if (cell_type(acc) == CELL_ERROR) return acc;
             s = s->cdr;
         }
 
-        if (s->type == CELL_ERROR) return s;
+        if (cell_type(s) == CELL_ERROR) return s;
     }
     return acc;
 }
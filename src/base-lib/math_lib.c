@@ -61,7 +61,7 @@ static Cell* math_cos(const Lex* e, const Cell* a)
     if (err) { return err; }
     if ((err = CHECK_ARITY_EXACT(a, 1, "cos"))) { return err; }
 
-    if (a->cell[0]->type == CELL_COMPLEX)
+    if (cell_type(a->cell[0]) == CELL_COMPLEX)
     {
         const long double complex z = cell_to_c_complex(a->cell[0]);
         const long double complex z_result = ccosl(z);
@@ -84,7 +84,7 @@ static Cell* math_acos(const Lex* e, const Cell* a)
     if (err) { return err; }
     if ((err = CHECK_ARITY_EXACT(a, 1, "acos"))) { return err; }
 
-    if (a->cell[0]->type == CELL_COMPLEX)
+    if (cell_type(a->cell[0]) == CELL_COMPLEX)
     {
         const long double complex z = cell_to_c_complex(a->cell[0]);
         const long double complex z_result = cacosl(z);
@@ -107,7 +107,7 @@ static Cell* math_sin(const Lex* e, const Cell* a)
     if (err) { return err; }
     if ((err = CHECK_ARITY_EXACT(a, 1, "sin"))) { return err; }
 
-    if (a->cell[0]->type == CELL_COMPLEX)
+    if (cell_type(a->cell[0]) == CELL_COMPLEX)
     {
         const long double complex z = cell_to_c_complex(a->cell[0]);
         const long double complex z_result = csinl(z);
@@ -130,7 +130,7 @@ static Cell* math_asin(const Lex* e, const Cell* a)
     if (err) { return err; }
     if ((err = CHECK_ARITY_EXACT(a, 1, "asin"))) { return err; }
 
-    if (a->cell[0]->type == CELL_COMPLEX)
+    if (cell_type(a->cell[0]) == CELL_COMPLEX)
     {
         const long double complex z = cell_to_c_complex(a->cell[0]);
         const long double complex z_result = casinl(z);
@@ -153,7 +153,7 @@ static Cell* math_tan(const Lex* e, const Cell* a)
     if (err) { return err; }
     if ((err = CHECK_ARITY_EXACT(a, 1, "tan"))) { return err; }
 
-    if (a->cell[0]->type == CELL_COMPLEX)
+    if (cell_type(a->cell[0]) == CELL_COMPLEX)
     {
         const long double complex z = cell_to_c_complex(a->cell[0]);
         const long double complex z_result = ctanl(z);
@@ -181,7 +181,7 @@ static Cell* math_atan(const Lex* e, const Cell* a)
 
     if (a->count == 1) {
 
-        if (a->cell[0]->type == CELL_COMPLEX)
+        if (cell_type(a->cell[0]) == CELL_COMPLEX)
         {
             const long double complex z = cell_to_c_complex(a->cell[0]);
             const long double complex z_result = catanl(z);
@@ -195,7 +195,7 @@ static Cell* math_atan(const Lex* e, const Cell* a)
         return result;
     }
     /* Two args. */
-    if (a->cell[0]->type == CELL_COMPLEX) {
+    if (cell_type(a->cell[0]) == CELL_COMPLEX) {
         return make_cell_error(
             "atan: invalid complex arg. Use 'make-polar'",
             TYPE_ERR);
@@ -216,7 +216,7 @@ static Cell* math_exp(const Lex* e, const Cell* a)
     if (err) { return err; }
     if ((err = CHECK_ARITY_EXACT(a, 1, "exp"))) { return err; }
 
-    if (a->cell[0]->type == CELL_COMPLEX)
+    if (cell_type(a->cell[0]) == CELL_COMPLEX)
     {
         const long double complex z = cell_to_c_complex(a->cell[0]);
         const long double complex z_result = cexpl(z);
@@ -243,7 +243,7 @@ static Cell* math_log(const Lex* e, const Cell* a)
 
     if (a->count == 1) {
 
-        if (a->cell[0]->type == CELL_COMPLEX)
+        if (cell_type(a->cell[0]) == CELL_COMPLEX)
         {
             const long double complex z = cell_to_c_complex(a->cell[0]);
             const long double complex z_result = clogl(z);
@@ -257,7 +257,7 @@ static Cell* math_log(const Lex* e, const Cell* a)
         return result;
     }
     /* Two args - will not work with complex. */
-    if (a->cell[0]->type == CELL_COMPLEX) {
+    if (cell_type(a->cell[0]) == CELL_COMPLEX) {
         return make_cell_error(
             "Specifying log base not valid with complex",
             TYPE_ERR);
@@ -330,8 +330,8 @@ static Cell* math_floor_quotient(const Lex* e, const Cell* a)
     if (err) { return err; }
     if ((err = CHECK_ARITY_EXACT(a, 2, "floor-quotient"))) { return err; }
 
-    const long long n1 = a->cell[0]->integer_v ;
-    const long long n2 = a->cell[1]->integer_v ;
+    const long long n1 = cell_int(a->cell[0]) ;
+    const long long n2 = cell_int(a->cell[1]) ;
 
     long long q = n1 / n2;
     const long long r = n1 % n2;
@@ -352,8 +352,8 @@ static Cell* math_floor_div(const Lex* e, const Cell* a)
     if (err) { return err; }
     if ((err = CHECK_ARITY_EXACT(a, 2, "floor/"))) { return err; }
 
-    const long long n1 = a->cell[0]->integer_v;
-    const long long n2 = a->cell[1]->integer_v;
+    const long long n1 = cell_int(a->cell[0]);
+    const long long n2 = cell_int(a->cell[1]);
 
     if (n2 == 0) {
         return make_cell_error(
@@ -386,8 +386,8 @@ static Cell* math_truncate_div(const Lex* e, const Cell* a)
     if (err) { return err; }
     if ((err = CHECK_ARITY_EXACT(a, 2, "truncate/"))) { return err; }
 
-    const long long n1 = a->cell[0]->integer_v ;
-    const long long n2 = a->cell[1]->integer_v ;
+    const long long n1 = cell_int(a->cell[0]) ;
+    const long long n2 = cell_int(a->cell[1]) ;
 
     if (n2 == 0) {
         return make_cell_error(
@@ -412,13 +412,13 @@ static Cell* math_real_part(const Lex* e, const Cell* a)
     Cell* err = CHECK_ARITY_EXACT(a, 1, "real-part");
     if (err) return err;
     Cell* sub = a->cell[0];
-    if (sub->type == CELL_INTEGER ||
-        sub->type == CELL_BIGINT ||
-        sub->type == CELL_REAL ||
-        sub->type == CELL_RATIONAL) {
+    if (cell_type(sub) == CELL_INTEGER ||
+        cell_type(sub) == CELL_BIGINT ||
+        cell_type(sub) == CELL_REAL ||
+        cell_type(sub) == CELL_RATIONAL) {
         return sub;
     }
-    if (sub->type == CELL_COMPLEX) {
+    if (cell_type(sub) == CELL_COMPLEX) {
         return sub->real;
     }
     /* If we didn't return early, we have the wrong arg type. */
@@ -435,13 +435,13 @@ static Cell* math_imag_part(const Lex* e, const Cell* a) {
     Cell* err = CHECK_ARITY_EXACT(a, 1, "imag-part");
     if (err) return err;
     const Cell* sub = a->cell[0];
-    if (sub->type == CELL_INTEGER ||
-        sub->type == CELL_BIGINT ||
-        sub->type == CELL_REAL ||
-        sub->type == CELL_RATIONAL) {
+    if (cell_type(sub) == CELL_INTEGER ||
+        cell_type(sub) == CELL_BIGINT ||
+        cell_type(sub) == CELL_REAL ||
+        cell_type(sub) == CELL_RATIONAL) {
         return make_cell_integer(0);
         }
-    if (sub->type == CELL_COMPLEX) {
+    if (cell_type(sub) == CELL_COMPLEX) {
         return sub->imag;
     }
     /* If we didn't return early, we have the wrong arg type. */
@@ -476,7 +476,7 @@ static Cell* math_angle(const Lex* e, const Cell* a)
     if (err) return err;
 
     const Cell* arg = a->cell[0];
-    switch (arg->type) {
+    switch (cell_type(arg)) {
         case CELL_COMPLEX: {
             const long double r = cell_to_long_double(arg->real);
             const long double i = cell_to_long_double(arg->imag);
@@ -86,7 +86,7 @@ static Cell* random_randint(const Lex* e, const Cell* a)
     (void)e;
     uint32_t limit = UINT32_MAX;
     if (a->count == 1) {
-        limit = a->cell[0]->integer_v;
+        limit = cell_int(a->cell[0]);
     }
     return make_cell_integer(rand_uint(limit));
 }
@@ -140,7 +140,7 @@ static Cell* random_shuffle(const Lex* e, const Cell* a)
 
     Cell* arr;
     bool list = false;
-    if (a->cell[0]->type == CELL_PAIR) {
+    if (cell_type(a->cell[0]) == CELL_PAIR) {
         list = true;
         arr = make_sexpr_from_list(a->cell[0], false);
     } else {
@@ -148,7 +148,7 @@ static Cell* random_shuffle(const Lex* e, const Cell* a)
     }
 
     /* Quoted list. */
-    if (a->cell[0]->type == CELL_SEXPR) {
+    if (cell_type(a->cell[0]) == CELL_SEXPR) {
         list = true;
     }
 
@@ -191,7 +191,7 @@ static Cell* random_choice(const Lex* e, const Cell* a)
     if (err) return err;
 
     Cell* arr;
-    if (a->cell[0]->type == CELL_PAIR) {
+    if (cell_type(a->cell[0]) == CELL_PAIR) {
         arr = make_sexpr_from_list(a->cell[0], false);
     } else {
         arr = a->cell[0];
@@ -220,16 +220,16 @@ static Cell* random_choices(const Lex* e, const Cell* a)
     if (err) return err;
     // ReSharper disable once CppVariableCanBeMadeConstexpr
     const int mask = CELL_PAIR|CELL_VECTOR|CELL_SEXPR;
-    if (!(a->cell[0]->type & mask)) {
+    if (!(cell_type(a->cell[0]) & mask)) {
         return make_cell_error("rand-choices: arg1 must be a list or vector", TYPE_ERR);
     }
-    if (a->cell[1]->type != CELL_INTEGER) {
+    if (cell_type(a->cell[1]) != CELL_INTEGER) {
         return make_cell_error("rand-choices: arg2 must be an integer", TYPE_ERR);
     }
 
     Cell* arr;
     bool list = false;
-    if (a->cell[0]->type == CELL_PAIR) {
+    if (cell_type(a->cell[0]) == CELL_PAIR) {
         list = true;
         arr = make_sexpr_from_list(a->cell[0], false);
     } else {
@@ -237,11 +237,11 @@ static Cell* random_choices(const Lex* e, const Cell* a)
     }
 
     /* Quoted list. */
-    if (a->cell[0]->type == CELL_SEXPR) {
+    if (cell_type(a->cell[0]) == CELL_SEXPR) {
         list = true;
     }
 
-    const int32_t k = (int)a->cell[1]->integer_v;
+    const int32_t k = (int)cell_int(a->cell[1]);
     const int32_t arr_size = arr->count;
     Cell* c_arr[arr_size];
     for (int i = 0; i < arr_size; i++) {
@@ -242,7 +242,7 @@ Cell* system_set_uid(const Lex* e, const Cell* a) {
     err = check_arg_types(a, CELL_INTEGER, "set-uid!");
     if (err) { return err; }
 
-    const uid_t uid = a->cell[0]->integer_v;
+    const uid_t uid = cell_int(a->cell[0]);
     if (setuid(uid) != 0) {
         return make_cell_error(
             fmt_err("set-uid!: %s", strerror(errno)),
@@ -259,7 +259,7 @@ Cell* system_set_gid(const Lex* e, const Cell* a) {
     err = check_arg_types(a, CELL_INTEGER, "set-gid!");
     if (err) { return err; }
 
-    const uid_t uid = a->cell[0]->integer_v;
+    const uid_t uid = cell_int(a->cell[0]);
     if (setuid(uid) != 0) {
         return make_cell_error(fmt_err("set-gid!: %s",
             strerror(errno)),
@@ -401,7 +401,7 @@ static Cell* system_chdir(const Lex* e, const Cell* a) {
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "chdir");
     if (err) { return err; }
-    if (a->cell[0]->type != CELL_STRING) {
+    if (cell_type(a->cell[0]) != CELL_STRING) {
         return make_cell_error(
             "chdir: path argument must be a string",
             TYPE_ERR);
@@ -454,17 +454,17 @@ static Cell* system_chmod(const Lex* e, const Cell* a) {
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 2, "chmod");
     if (err) { return err; }
-    if (a->cell[0]->type != CELL_STRING) {
+    if (cell_type(a->cell[0]) != CELL_STRING) {
         return make_cell_error(
             "chmod: path argument must be a string",
             TYPE_ERR);
     }
-    if (a->cell[1]->type != CELL_INTEGER) {
+    if (cell_type(a->cell[1]) != CELL_INTEGER) {
         return make_cell_error(
             "chmod: mode argument must be an (octal) integer",
             TYPE_ERR);
     }
-    if (chmod(a->cell[0]->str, (mode_t)a->cell[1]->integer_v) != 0) {
+    if (chmod(a->cell[0]->str, (mode_t)cell_int(a->cell[1])) != 0) {
         make_cell_error(
             fmt_err("chmod: %s", strerror(errno)),
             OS_ERR);
@@ -634,7 +634,7 @@ Cell* system_sleep(const Lex* e, const Cell* a) {
 
     /* sleep does not error. It may return non-zero
      * if the sleep is interrupted by a signal. */
-    sleep(a->cell[0]->integer_v);
+    sleep(cell_int(a->cell[0]));
     return USP_Obj;
 }
 
@@ -97,7 +97,7 @@ static Cell* builtin_current_datetime_utc(const Lex* e, const Cell* a)
     if (err) return err;
 
     char* fmt_str;
-    if (a->count > 0 && a->cell[0]->type == CELL_STRING) {
+    if (a->count > 0 && cell_type(a->cell[0]) == CELL_STRING) {
         fmt_str = a->cell[0]->str;
     } else {
         fmt_str = "%Y-%m-%d %H:%M:%S";
@@ -129,7 +129,7 @@ static Cell* builtin_current_datetime_local(const Lex* e, const Cell* a)
     if (err) return err;
 
     char* fmt_str;
-    if (a->count > 0 && a->cell[0]->type == CELL_STRING) {
+    if (a->count > 0 && cell_type(a->cell[0]) == CELL_STRING) {
         fmt_str = a->cell[0]->str;
     } else {
         fmt_str = "%Y-%m-%d %H:%M:%S";
@@ -116,7 +116,7 @@ Cell* bigint_div(Cell* a, const Cell* b) {
 Cell* bigint_quo_rem(Cell* a, Cell* b, const qr_t op) {
     Cell* result = cell_copy(a);
     Cell* d;
-    if (b->type == CELL_INTEGER) {
+    if (cell_type(b) == CELL_INTEGER) {
         d = make_cell_bigint(nullptr, b, 10);
     } else {
         d = b;
@@ -152,8 +152,8 @@ Cell* bigint_exact_int_sqrt(Cell* a) {
 
 Cell* bigint_mod(Cell* a, Cell* b) {
     Cell* result = cell_copy(a);
-    if (b->type == CELL_INTEGER) {
-        mpz_mod_ui(*result->bi, *a->bi, b->integer_v);
+    if (cell_type(b) == CELL_INTEGER) {
+        mpz_mod_ui(*result->bi, *a->bi, cell_int(b));
     } else {
         mpz_mod(*result->bi, *a->bi, *b->bi);
     }
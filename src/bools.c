@@ -33,7 +33,7 @@ Cell* builtin_not(const Lex* e, const Cell* a)
     (void)e;
     Cell* err;
     if ((err = CHECK_ARITY_EXACT(a, 1, "not"))) { return err; }
-    if (a->cell[0]->type == CELL_BOOLEAN && a->cell[0]->boolean_v == 0) {
+    if (cell_type(a->cell[0]) == CELL_BOOLEAN && a->cell[0]->boolean_v == 0) {
         return True_Obj;
     }
     return False_Obj;
@@ -0,0 +1,81 @@
+/* Generated by tools/gen_builtin_hash.c from src/builtins.def - do not edit.
+ * Regenerate with 'make builtin-hash'. */
+
+#ifndef COZENAGE_BUILTIN_HASH_H
+#define COZENAGE_BUILTIN_HASH_H
+
+#include <stdint.h>
+
+#define BUILTIN_HASH_COUNT 318
+#define BUILTIN_HASH_BUCKETS 128
+#define BUILTIN_HASH_SLOTS 512
+
+/* The slot of a name with FNV-1a hash h, in a bucket with displacement d. */
+#define BUILTIN_HASH_SLOT(h, d) \
+    ((((h) >> 20) + (uint64_t)(d) * (((h) >> 40) | 1)) & (BUILTIN_HASH_SLOTS - 1))
+
+/* Displacement of each bucket, indexed by h & (BUILTIN_HASH_BUCKETS - 1). */
+static const uint16_t builtin_hash_disp[BUILTIN_HASH_BUCKETS] = {
+       0,    1,    0,    0,    0,    1,    0,    1,    3,    2,
+       2,    0,    0,    0,    2,    2,    0,    1,    4,    0,
+       0,    1,    0,    0,    1,    1,    2,    2,    0,    3,
+       0,    0,    4,    0,    2,    1,    1,    2,    2,    6,
+       3,    0,    4,    0,    0,    0,    1,    2,    9,    1,
+      12,    4,    0,    0,    1,    1,    0,    3,    0,    1,
+       1,    2,    1,   15,    2,    0,    0,    4,    6,    2,
+       3,    1,    2,    1,    1,    2,    8,    2,    0,    2,
+       3,    3,    8,    2,    9,    0,    0,    0,    0,    0,
+       0,    0,    0,    4,    3,    2,    0,    0,    4,    0,
+      10,    0,   18,    9,    4,    1,    2,    4,    0,    0,
+       4,    3,    1,    1,    1,    2,    0,    0,    0,    4,
+       1,    3,    4,    4,    2,   10,   10,    2,
+};
+
+/* Index into the builtin table of the name in each slot, or -1. */
+static const int16_t builtin_hash_index[BUILTIN_HASH_SLOTS] = {
+     -1,   1, 209,  -1,  -1, 178, 254,   0,  -1, 295,  43,   7,
+    300, 162, 175,  -1,  -1, 223, 265,  -1,  -1, 127,  -1, 227,
+     -1,  74, 136,  -1, 197,  -1,  91,  -1,  -1,  -1,  26,  -1,
+     10,  -1,  -1, 238, 117, 176,  -1,  93,  77,  -1, 188,  -1,
+    312,  87, 249,  -1, 135, 138, 201, 307,  -1,  -1, 253,  86,
+     -1,  -1, 123,  -1, 313, 118,  -1,  -1, 232,  59, 267,  97,
+    247,  -1,  -1, 150,  44,  -1,  -1,  -1, 233,  48,  11, 276,
+    114,  -1,  -1,  78, 316, 113, 191, 226, 308, 220, 208, 129,
+      5, 305, 291, 108,  -1,  -1,  35,  49, 224, 128,  -1, 200,
+     -1, 298, 131, 154, 234,  -1, 103,  30,  -1, 190,  96,  54,
+     -1,  -1, 213, 155,  -1,  -1,  39,  -1,  -1,  23, 288,  90,
+     -1, 161, 231, 273, 279,  -1,  -1, 215,  -1, 257, 100,  -1,
+     -1,  -1,  -1,  -1,  -1, 102, 289,  76, 164,  57,  32,  51,
+     63, 143,  94,  -1,  -1,  -1, 166, 167,  -1, 269, 142, 241,
+     -1,  99, 195, 148,  -1,  -1, 177,  -1, 109, 228,  72, 272,
+    284,  -1,  -1, 222,  -1,  -1, 256,  15, 182,  62,   3, 198,
+     34, 309,  58, 132,  -1, 207,  -1,  -1,  -1,  38, 260,  -1,
+    122,  66,  70, 210,  29, 134, 193, 163, 181,  -1,  -1,   8,
+    264, 185,  -1,  -1,  -1,  -1, 251, 172, 302, 189,  95, 314,
+     -1, 133,   2,  -1, 218, 286,  -1, 111,  18,  -1, 317,  13,
+     -1, 145,  -1,  -1, 229,  -1, 183,  -1, 246,  -1,  -1,  -1,
+     -1, 199,  25, 270, 139,  -1,  -1,  -1,  -1,  14,  -1,  45,
+    282, 204, 262, 112,  -1,  -1, 116,  75, 239,  -1,  -1,  -1,
+     40,  -1, 285,  24, 120,  61,  28,  98,  -1, 124,  -1,  -1,
+     17,  -1,  -1,  12,   6,  -1,  82,  -1, 179, 242,  -1,  -1,
+    258,  -1, 211,  65,  -1, 141,  -1,  -1, 278,  92, 263,  -1,
+    306,  -1, 130, 283, 235, 297,  -1,  -1,  -1,  50, 158, 255,
+    137,  -1,  -1, 292, 225, 261, 237,  -1, 275,  -1, 304,  73,
+    192,  -1,  46, 221, 169, 281,  -1,  -1, 104,  71,  -1, 301,
+     85,  20,  -1, 149, 212,  -1,  27,  21,  -1, 287, 219,  -1,
+     -1,  22,  -1, 296, 243, 147,  -1,  -1, 157,  81,  -1, 217,
+     -1, 140,  36,  -1, 245, 153,  -1, 101,  -1,  -1, 144,  -1,
+     -1,  -1,  -1,  -1,  83,  -1, 214,  -1,  89, 274,  -1, 293,
+    230, 156, 186,  -1,  67,  -1,  -1,   9, 206, 311,  41, 280,
+    303, 151, 168, 115,  -1, 159,  80, 290,  84,  -1,  -1,  -1,
+     69, 119, 248,  -1,  31, 174, 180,  37,  -1,  -1, 152,  79,
+     -1, 121, 266,  -1, 268,  42, 194,  -1, 171, 173, 187,  -1,
+     -1,  -1,  -1, 252, 310, 126,   4, 106,  -1, 160,  -1,  -1,
+     -1,  -1,  -1,  56,  52, 271,  55, 315,  -1,  53,  -1, 250,
+     -1, 259,  -1,  -1, 236, 244,  -1, 165, 105,  60, 184,  19,
+    125, 277, 170,  33, 294, 240, 107,  16,  -1, 299,  68,  -1,
+     64,  -1, 146, 205,  47,  -1, 110,  -1,  -1,  -1, 203, 196,
+     -1,  -1,  88, 202, 216,  -1,  -1,  -1,
+};
+
+#endif //COZENAGE_BUILTIN_HASH_H
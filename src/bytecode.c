@@ -0,0 +1,579 @@
+/*
+ * 'src/bytecode.c'
+ * This file is part of Cozenage - https://github.com/DarrenKirby/cozenage
+ * Copyright © 2025 - 2026 Darren Kirby <darren@dragonbyte.ca>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* This file compiles the output of expand() into bytecode Chunks for the
+ * stack VM in vm.c, and implements the disassembler.
+ *
+ * The compiler handles the same primitive forms as the analyzer: quote, if,
+ * define, lambda, let, letrec, set!, begin, and, and procedure calls. Every
+ * sub-expression is compiled knowing whether it is in tail position, so calls
+ * in tail position become OP_TAIL_CALL and run in constant space.
+ *
+ * Special forms which operate on raw syntax (import, defmacro, delay, etc.)
+ * and malformed forms are analyzed into a Node, and run through the closure
+ * tree with OP_EVAL, so their semantics and error messages are shared with
+ * the tree-walking engine.
+ */
+
+#include "bytecode.h"
+#include "analyzer.h"
+#include "eval.h"
+#include "fold.h"
+#include "special_forms.h"
+#include "symbols.h"
+#include "types.h"
+#include "repr.h"
+
+#include <gc/gc.h>
+
+
+static const char* OP_NAMES[OP_MAX] = {
+    [OP_CONST]      = "CONST",
+    [OP_REF]        = "REF",
+    [OP_LOCAL]      = "LOCAL",
+    [OP_GLOBAL]     = "GLOBAL",
+    [OP_SET]        = "SET",
+    [OP_SET_LOCAL]  = "SET_LOCAL",
+    [OP_DEFINE]     = "DEFINE",
+    [OP_POP]        = "POP",
+    [OP_JUMP]       = "JUMP",
+    [OP_JUMP_FALSE] = "JUMP_FALSE",
+    [OP_AND]        = "AND",
+    [OP_BUILTIN]    = "BUILTIN",
+    [OP_CLOSURE]    = "CLOSURE",
+    [OP_LET]        = "LET",
+    [OP_LETREC]     = "LETREC",
+    [OP_BIND]       = "BIND",
+    [OP_POP_ENV]    = "POP_ENV",
+    [OP_MACRO]      = "MACRO",
+    [OP_MACRO_TAIL] = "MACRO_TAIL",
+    [OP_CALL]       = "CALL",
+    [OP_TAIL_CALL]  = "TAIL_CALL",
+    [OP_EVAL]       = "EVAL",
+    [OP_RETURN]     = "RETURN"
+};
+
+/* Number of operand words following each opcode. */
+static const int OP_ARGS[OP_MAX] = {
+    [OP_CONST] = 1, [OP_REF] = 1, [OP_LOCAL] = 3, [OP_GLOBAL] = 2,
+    [OP_SET] = 1, [OP_SET_LOCAL] = 3, [OP_DEFINE] = 1,
+    [OP_JUMP] = 1, [OP_JUMP_FALSE] = 1, [OP_AND] = 1, [OP_BUILTIN] = 4, [OP_CLOSURE] = 1,
+    [OP_LET] = 1, [OP_LETREC] = 1, [OP_BIND] = 1, [OP_MACRO] = 3,
+    [OP_MACRO_TAIL] = 2, [OP_CALL] = 1, [OP_TAIL_CALL] = 1, [OP_EVAL] = 1
+};
+
+
+/* -----------------------------*
+ *        Chunk building        *
+ * -----------------------------*/
+
+
+static Chunk* new_chunk(Cell* formals, Cell* body, char* name)
+{
+    Chunk* c = GC_MALLOC(sizeof(Chunk));
+    c->capacity = 16;
+    c->code = GC_MALLOC_ATOMIC(sizeof(uint32_t) * c->capacity);
+    c->formals = formals;
+    c->body = body;
+    c->name = name;
+    return c;
+}
+
+
+/* Append a code word, and return its index. */
+static int emit(Chunk* c, const uint32_t word)
+{
+    if (c->count == c->capacity) {
+        c->capacity *= 2;
+        c->code = GC_REALLOC(c->code, sizeof(uint32_t) * c->capacity);
+    }
+    c->code[c->count] = word;
+    return c->count++;
+}
+
+
+static int emit_op(Chunk* c, const opcode_t op, const uint32_t operand)
+{
+    emit(c, op);
+    return emit(c, operand);
+}
+
+
+/* Add a constant, re-using the slot of an identical one. */
+static uint32_t add_const(Chunk* c, Cell* v)
+{
+    for (int i = 0; i < c->n_consts; i++) {
+        if (c->consts[i] == v) return i;
+    }
+    c->consts = GC_REALLOC(c->consts, sizeof(Cell*) * (c->n_consts + 1));
+    c->consts[c->n_consts] = v;
+    return c->n_consts++;
+}
+
+
+static uint32_t add_proto(Chunk* c, Chunk* p)
+{
+    c->protos = GC_REALLOC(c->protos, sizeof(Chunk*) * (c->n_protos + 1));
+    c->protos[c->n_protos] = p;
+    c->captures = true;
+    return c->n_protos++;
+}
+
+
+static uint32_t add_cache(Chunk* c)
+{
+    c->caches = GC_REALLOC(c->caches, sizeof(global_cache) * (c->n_caches + 1));
+    c->caches[c->n_caches] = (global_cache){ .table = nullptr, .generation = 0, .item = nullptr };
+    return c->n_caches++;
+}
+
+
+static uint32_t add_expansion(Chunk* c)
+{
+    c->expansions = GC_REALLOC(c->expansions, sizeof(macro_cache) * (c->n_expansions + 1));
+    c->expansions[c->n_expansions] = (macro_cache){ .macro = nullptr, .chunk = nullptr };
+    return c->n_expansions++;
+}
+
+
+/* Hand an expression to the closure tree. */
+static void emit_eval(Chunk* c, Cell* expr, const Lex* scope)
+{
+    c->nodes = GC_REALLOC(c->nodes, sizeof(Node*) * (c->n_nodes + 1));
+    c->nodes[c->n_nodes] = analyze(expr, scope);
+    c->captures |= c->nodes[c->n_nodes]->captures;
+    emit_op(c, OP_EVAL, c->n_nodes++);
+}
+
+
+/* -----------------------------*
+ *           Compiler           *
+ * -----------------------------*/
+
+
+static void compile_expr(Chunk* c, Cell* expr, const Lex* scope, bool tail);
+
+
+/* Compile a sequence of expressions, keeping only the value of the last. */
+static void compile_body(Chunk* c, const Cell* expr, const int start, const Lex* scope, const bool tail)
+{
+    for (int i = start; i < expr->count; i++) {
+        const bool is_last = i == expr->count - 1;
+        compile_expr(c, expr->cell[i], scope, tail && is_last);
+        if (!is_last) emit(c, OP_POP);
+    }
+}
+
+
+/* Formals must be a symbol, or an s-expr of symbols. */
+static bool formals_ok(const Cell* formals)
+{
+    if (cell_type(formals) == CELL_SYMBOL) return true;
+    if (cell_type(formals) != CELL_SEXPR) return false;
+    for (int i = 0; i < formals->count; i++) {
+        if (cell_type(formals->cell[i]) != CELL_SYMBOL) return false;
+    }
+    return true;
+}
+
+
+/* let and letrec bindings must be ((symbol init) ...). */
+static bool bindings_ok(const Cell* bindings)
+{
+    if (cell_type(bindings) != CELL_SEXPR) return false;
+    for (int i = 0; i < bindings->count; i++) {
+        const Cell* b = bindings->cell[i];
+        if (cell_type(b) != CELL_SEXPR || b->count != 2 || cell_type(b->cell[0]) != CELL_SYMBOL) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/* Variable references use the lexical address of locals, and go straight to
+ * the global table for free variables, unless the scope is unknown. */
+static void compile_ref(Chunk* c, Cell* sym, const Lex* scope)
+{
+    int depth, slot;
+    if (!scope) {
+        emit_op(c, OP_REF, add_const(c, sym));
+    } else if (lex_resolve(scope, sym, &depth, &slot)) {
+        emit_op(c, OP_LOCAL, add_const(c, sym));
+        emit(c, depth);
+        emit(c, slot);
+    } else {
+        emit_op(c, OP_GLOBAL, add_const(c, sym));
+        emit(c, add_cache(c));
+    }
+}
+
+
+static void compile_set(Chunk* c, Cell* sym, const Lex* scope)
+{
+    int depth, slot;
+    if (scope && lex_resolve(scope, sym, &depth, &slot)) {
+        emit_op(c, OP_SET_LOCAL, add_const(c, sym));
+        emit(c, depth);
+        emit(c, slot);
+    } else {
+        emit_op(c, OP_SET, add_const(c, sym));
+    }
+}
+
+
+static void compile_define(Chunk* c, Cell* expr, const Lex* scope)
+{
+    Cell* target = expr->cell[1];
+
+    /* (define symbol expr) */
+    if (cell_type(target) == CELL_SYMBOL && !is_syntactic_keyword(target)) {
+        compile_expr(c, expr->cell[2], scope, false);
+        emit_op(c, OP_DEFINE, add_const(c, target));
+        return;
+    }
+
+    /* (define (name formals) body) */
+    if (cell_type(target) == CELL_SEXPR && target->count > 0 &&
+        cell_type(target->cell[0]) == CELL_SYMBOL && !is_syntactic_keyword(target->cell[0])) {
+        Cell* formals = make_cell_sexpr();
+        for (int i = 1; i < target->count; i++) {
+            if (cell_type(target->cell[i]) != CELL_SYMBOL) {
+                emit_eval(c, expr, scope);
+                return;
+            }
+            cell_add(formals, target->cell[i]);
+        }
+        Cell* fname = target->cell[0];
+        emit_op(c, OP_CLOSURE, add_proto(c, compile_lambda(formals, expr->cell[2], fname->sym, scope)));
+        emit_op(c, OP_DEFINE, add_const(c, fname));
+        return;
+    }
+    emit_eval(c, expr, scope);
+}
+
+
+static void compile_let(Chunk* c, Cell* expr, const Lex* scope, const bool tail)
+{
+    Cell* bindings = expr->cell[1];
+    for (int i = 0; i < bindings->count; i++) {
+        compile_expr(c, bindings->cell[i]->cell[1], scope, false);
+    }
+    emit_op(c, OP_LET, add_const(c, bindings));
+    compile_body(c, expr, 2, scope_for_bindings(scope, bindings), tail);
+    if (!tail) emit(c, OP_POP_ENV);
+}
+
+
+static void compile_letrec(Chunk* c, Cell* expr, const Lex* outer, const bool tail)
+{
+    Cell* bindings = expr->cell[1];
+    const Lex* scope = scope_for_bindings(outer, bindings);
+    emit_op(c, OP_LETREC, add_const(c, bindings));
+    for (int i = 0; i < bindings->count; i++) {
+        compile_expr(c, bindings->cell[i]->cell[1], scope, false);
+        emit_op(c, OP_BIND, add_const(c, bindings->cell[i]->cell[0]));
+    }
+    if (expr->count == 2) {
+        emit_op(c, OP_CONST, add_const(c, USP_Obj));
+    } else {
+        compile_body(c, expr, 2, scope, tail);
+    }
+    if (!tail) emit(c, OP_POP_ENV);
+}
+
+
+static void compile_if(Chunk* c, const Cell* expr, const Lex* scope, const bool tail)
+{
+    compile_expr(c, expr->cell[1], scope, false);
+    const int jump_else = emit_op(c, OP_JUMP_FALSE, 0);
+    compile_expr(c, expr->cell[2], scope, tail);
+    const int jump_end = emit_op(c, OP_JUMP, 0);
+    c->code[jump_else] = c->count;
+    if (expr->count == 4) {
+        compile_expr(c, expr->cell[3], scope, tail);
+    } else {
+        emit_op(c, OP_CONST, add_const(c, USP_Obj));
+    }
+    c->code[jump_end] = c->count;
+}
+
+
+static void compile_and(Chunk* c, const Cell* expr, const Lex* scope, const bool tail)
+{
+    int jumps[expr->count];
+    for (int i = 1; i < expr->count - 1; i++) {
+        compile_expr(c, expr->cell[i], scope, false);
+        jumps[i] = emit_op(c, OP_AND, 0);
+    }
+    compile_expr(c, expr->cell[expr->count - 1], scope, tail);
+    for (int i = 1; i < expr->count - 1; i++) {
+        c->code[jumps[i]] = c->count;
+    }
+}
+
+
+/* (%fold value call op ...): push value if every op is still bound to its
+ * builtin, and otherwise run the call. */
+static void compile_fold(Chunk* c, const Cell* expr, const Lex* scope, const bool tail)
+{
+    int jumps[expr->count];
+    for (int i = 3; i < expr->count; i++) {
+        Cell* op = expr->cell[i];
+        emit_op(c, OP_BUILTIN, add_const(c, op));
+        emit(c, add_const(c, fold_builtin(op)));
+        emit(c, add_cache(c));
+        jumps[i] = emit(c, 0);
+    }
+    emit_op(c, OP_CONST, add_const(c, expr->cell[1]));
+    const int jump_end = emit_op(c, OP_JUMP, 0);
+    for (int i = 3; i < expr->count; i++) {
+        c->code[jumps[i]] = c->count;
+    }
+    compile_expr(c, expr->cell[2], scope, tail);
+    c->code[jump_end] = c->count;
+}
+
+
+/* Procedure call, or macro use. The operator is evaluated first, so that a
+ * macro can be expanded before any of its arguments are evaluated. */
+static void compile_call(Chunk* c, Cell* expr, const Lex* scope, const bool tail)
+{
+    const int argc = expr->count - 1;
+    compile_expr(c, expr->cell[0], scope, false);
+
+    int landing = -1;
+    if (tail) {
+        emit_op(c, OP_MACRO_TAIL, add_const(c, expr));
+        emit(c, add_expansion(c));
+    } else {
+        emit_op(c, OP_MACRO, add_const(c, expr));
+        emit(c, add_expansion(c));
+        landing = emit(c, 0);
+    }
+
+    for (int i = 1; i <= argc; i++) {
+        compile_expr(c, expr->cell[i], scope, false);
+    }
+    emit_op(c, tail ? OP_TAIL_CALL : OP_CALL, argc);
+    if (landing >= 0) {
+        c->code[landing] = c->count;
+    }
+}
+
+
+static void compile_special_form(Chunk* c, Cell* expr, const Lex* scope, const bool tail)
+{
+    const int argc = expr->count - 1;
+
+    switch (expr->cell[0]->sf_id) {
+    case SF_ID_DEFINE:
+        if (argc < 2) break;
+        compile_define(c, expr, scope);
+        return;
+
+    case SF_ID_QUOTE:
+        if (argc != 1) break;
+        emit_op(c, OP_CONST, add_const(c, make_list_from_sexpr(expr->cell[1])));
+        return;
+
+    case SF_ID_LAMBDA:
+        if (argc < 2 || !formals_ok(expr->cell[1])) break;
+        emit_op(c, OP_CLOSURE, add_proto(c, compile_lambda(expr->cell[1], expr->cell[2], nullptr, scope)));
+        return;
+
+    case SF_ID_IF:
+        if (argc < 2 || argc > 3) break;
+        compile_if(c, expr, scope, tail);
+        return;
+
+    case SF_ID_LET:
+        if (argc < 2 || !bindings_ok(expr->cell[1])) break;
+        compile_let(c, expr, scope, tail);
+        return;
+
+    case SF_ID_LETREC:
+        if (argc < 1 || !bindings_ok(expr->cell[1])) break;
+        compile_letrec(c, expr, scope, tail);
+        return;
+
+    case SF_ID_SET_BANG:
+        if (argc != 2 || cell_type(expr->cell[1]) != CELL_SYMBOL) break;
+        compile_expr(c, expr->cell[2], scope, false);
+        compile_set(c, expr->cell[1], scope);
+        return;
+
+    case SF_ID_BEGIN:
+        if (argc == 0) {
+            emit_op(c, OP_CONST, add_const(c, USP_Obj));
+            return;
+        }
+        compile_body(c, expr, 1, scope, tail);
+        return;
+
+    case SF_ID_AND:
+        if (argc == 0) {
+            emit_op(c, OP_CONST, add_const(c, True_Obj));
+            return;
+        }
+        compile_and(c, expr, scope, tail);
+        return;
+
+    case SF_ID_FOLD:
+        if (!fold_guard_ok(expr)) break;
+        compile_fold(c, expr, scope, tail);
+        return;
+
+    default:
+        break;
+    }
+    emit_eval(c, expr, scope);
+}
+
+
+static void compile_expr(Chunk* c, Cell* expr, const Lex* scope, const bool tail)
+{
+    if (!expr) {
+        emit_eval(c, expr, scope);
+        return;
+    }
+
+    /* Self-evaluating types. */
+    if (cell_type(expr) & (CELL_INTEGER|CELL_REAL|CELL_RATIONAL|CELL_COMPLEX|
+                      CELL_BOOLEAN|CELL_CHAR|CELL_STRING|CELL_PAIR|
+                      CELL_VECTOR|CELL_BYTEVECTOR|CELL_NIL|CELL_EOF|
+                      CELL_PROC|CELL_PORT|CELL_ERROR|CELL_UNSPEC|
+                      CELL_BIGINT|CELL_BIGFLOAT|CELL_SET|CELL_HASH|
+                      CELL_PROMISE|CELL_STREAM)) {
+        emit_op(c, OP_CONST, add_const(c, expr));
+        return;
+    }
+
+    if (cell_type(expr) == CELL_SYMBOL && !is_syntactic_keyword(expr)) {
+        compile_ref(c, expr, scope);
+        return;
+    }
+
+    if (cell_type(expr) != CELL_SEXPR || expr->count == 0) {
+        emit_eval(c, expr, scope);
+        return;
+    }
+
+    const Cell* head = expr->cell[0];
+    if (cell_type(head) == CELL_SYMBOL && head->sf_id > 0) {
+        compile_special_form(c, expr, scope, tail);
+        return;
+    }
+    compile_call(c, expr, scope, tail);
+}
+
+
+/* Compile a top-level expression, to be run in an environment whose local
+ * frames are laid out as those of scope (see analyze()). */
+Chunk* compile(Cell* expr, const Lex* scope)
+{
+    Chunk* c = new_chunk(nullptr, nullptr, nullptr);
+    compile_expr(c, expr, scope, true);
+    emit(c, OP_RETURN);
+    return c;
+}
+
+
+/* Compile the body of a lambda which closes over scope. */
+Chunk* compile_lambda(Cell* formals, Cell* body, char* name, const Lex* scope)
+{
+    Chunk* c = new_chunk(formals, body, name);
+    compile_expr(c, body, scope_for_formals(scope, formals), true);
+    emit(c, OP_RETURN);
+    return c;
+}
+
+
+/* -----------------------------*
+ *         Disassembler         *
+ * -----------------------------*/
+
+
+void disassemble_chunk(const Chunk* c, FILE* out)
+{
+    fprintf(out, "== %s", c->name ? c->name : "lambda");
+    if (c->formals) {
+        fprintf(out, " %s", cell_to_string(c->formals, MODE_WRITE));
+    }
+    fprintf(out, " ==\n");
+
+    for (int i = 0; i < c->count; ) {
+        const opcode_t op = c->code[i];
+        fprintf(out, OP_ARGS[op] ? "%04d  %-12s" : "%04d  %s", i, OP_NAMES[op]);
+        for (int j = 1; j <= OP_ARGS[op]; j++) {
+            fprintf(out, " %4u", c->code[i + j]);
+        }
+
+        const uint32_t k = c->code[i + 1];
+        switch (op) {
+        case OP_CONST: case OP_REF: case OP_LOCAL: case OP_GLOBAL: case OP_BUILTIN:
+        case OP_SET: case OP_SET_LOCAL: case OP_DEFINE:
+        case OP_LET: case OP_LETREC: case OP_BIND: case OP_MACRO: case OP_MACRO_TAIL:
+            fprintf(out, "    ; %s", cell_to_string(c->consts[k], MODE_WRITE));
+            break;
+        case OP_CLOSURE:
+            fprintf(out, "    ; <%s>", c->protos[k]->name ? c->protos[k]->name : "lambda");
+            break;
+        case OP_EVAL:
+            if (c->nodes[k]->expr) {
+                fprintf(out, "    ; %s", cell_to_string(c->nodes[k]->expr, MODE_WRITE));
+            }
+            break;
+        default:
+            break;
+        }
+        fprintf(out, "\n");
+        i += 1 + OP_ARGS[op];
+    }
+
+    for (int i = 0; i < c->n_protos; i++) {
+        fprintf(out, "\n");
+        disassemble_chunk(c->protos[i], out);
+    }
+}
+
+
+/* (disassemble proc)
+ * Prints the bytecode compiled for the lambda procedure proc, and any lambdas
+ * nested within it. The procedure is compiled first if it has not yet been
+ * run by the bytecode VM. */
+Cell* builtin_disassemble(const Lex* e, const Cell* a)
+{
+    (void)e;
+    Cell* err = CHECK_ARITY_EXACT(a, 1, "disassemble");
+    if (err) return err;
+
+    const Cell* proc = a->cell[0];
+    if (!(cell_type(proc) & (CELL_PROC|CELL_MACRO)) || proc->is_builtin) {
+        return make_cell_error(
+            "disassemble: arg must be a lambda procedure",
+            TYPE_ERR);
+    }
+    if (!proc->lambda->chunk) {
+        proc->lambda->chunk = compile_lambda(proc->lambda->formals, proc->lambda->body,
+                                             proc->lambda->l_name, proc->lambda->env);
+    }
+    disassemble_chunk(proc->lambda->chunk, stdout);
+    return USP_Obj;
+}
@@ -0,0 +1,96 @@
+/*
+ * 'src/bytecode.h'
+ * This file is part of Cozenage - https://github.com/DarrenKirby/cozenage
+ * Copyright © 2025 - 2026 Darren Kirby <darren@dragonbyte.ca>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COZENAGE_BYTECODE_H
+#define COZENAGE_BYTECODE_H
+
+#include "cell.h"
+
+#include <stdint.h>
+
+
+/* Opcodes. Operands follow the opcode as extra code words.
+ * This needs to be kept in sync with the dispatch table in vm.c,
+ * and the OP_NAMES table in bytecode.c */
+typedef enum Opcode_t : uint32_t {
+    OP_CONST,       /* k       push consts[k]. */
+    OP_REF,         /* k       push the value of symbol consts[k], found by name. */
+    OP_LOCAL,       /* k d s   push the local consts[k], d frames up at slot s. */
+    OP_GLOBAL,      /* k c     push the value of the free symbol consts[k], via caches[c]. */
+    OP_SET,         /* k       pop, and set! symbol consts[k]; push unspecified. */
+    OP_SET_LOCAL,   /* k d s   as above, for the local consts[k] at (d, s). */
+    OP_DEFINE,      /* k       pop, and define symbol consts[k] globally; push result. */
+    OP_POP,         /*         discard top of stack. */
+    OP_JUMP,        /* a       jump to a. */
+    OP_JUMP_FALSE,  /* a       pop; jump to a if it was #f. */
+    OP_AND,         /* a       if top is #f jump to a, else pop it. */
+    OP_BUILTIN,     /* k b c a jump to a unless the free symbol consts[k] is still
+                                  bound, via caches[c], to the builtin consts[b]. */
+    OP_CLOSURE,     /* p       push a new lambda over protos[p] in the current env. */
+    OP_LET,         /* k       bind the top consts[k]->count values in a new child env. */
+    OP_LETREC,      /* k       enter a new child env with consts[k] bound unspecified. */
+    OP_BIND,        /* k       pop, and bind symbol consts[k] in the current env. */
+    OP_POP_ENV,     /*         leave the env entered by the matching OP_LET/OP_LETREC. */
+    OP_MACRO,       /* k m a   if top is a macro, run the expansion of call consts[k],
+                                  memoized in expansions[m], in its place. */
+    OP_MACRO_TAIL,  /* k m     as above, but the expansion replaces the current frame. */
+    OP_CALL,        /* n       call the procedure below the top n values. */
+    OP_TAIL_CALL,   /* n       as above, replacing the current frame. */
+    OP_EVAL,        /* k       push the result of running nodes[k] (see analyzer.h). */
+    OP_RETURN,      /*         pop, leave the frame, and push the value to the caller. */
+    OP_MAX
+} opcode_t;
+
+
+/* The memoized expansion of a macro use, compiled. It is redone when the
+ * operator is bound to another macro. */
+typedef struct {
+    const Cell* macro;    /* The macro which made the expansion. */
+    const Chunk* chunk;   /* The compiled expansion. */
+} macro_cache;
+
+
+/* A compiled lambda body or top-level expression. */
+struct Chunk {
+    uint32_t* code;       /* Opcodes and their operands. */
+    int count;            /* Number of code words used. */
+    int capacity;         /* Number of code words allocated. */
+    Cell** consts;        /* Constants, symbols, binding lists, and call sites. */
+    int n_consts;
+    Chunk** protos;       /* Compiled bodies of nested lambdas. */
+    int n_protos;
+    Node** nodes;         /* Analyzed forms the compiler hands to the closure tree. */
+    int n_nodes;
+    global_cache* caches; /* One binding cache per global variable reference. */
+    int n_caches;
+    macro_cache* expansions; /* One expansion cache per possible macro use. */
+    int n_expansions;
+    Cell* formals;        /* Formals for lambda chunks, null for top-level. */
+    Cell* body;           /* Source body for lambda chunks. */
+    char* name;           /* Name for named lambdas, used by disassemble. */
+    bool captures;        /* May create closures, so its frames are never pooled. */
+};
+
+
+Chunk* compile(Cell* expr, const Lex* scope);
+Chunk* compile_lambda(Cell* formals, Cell* body, char* name, const Lex* scope);
+void disassemble_chunk(const Chunk* c, FILE* out);
+Cell* builtin_disassemble(const Lex* e, const Cell* a);
+
+#endif //COZENAGE_BYTECODE_H
@@ -24,6 +24,12 @@
 #include <string.h>
 #include <gc/gc.h>
 #include <inttypes.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 
 DEFINE_BV_TYPE(u8,  uint8_t,  "%u")
@@ -34,6 +40,8 @@ DEFINE_BV_TYPE(u32, uint32_t, "%u")
 DEFINE_BV_TYPE(s32, int32_t,  "%d")
 DEFINE_BV_TYPE(u64, uint64_t, "%u")
 DEFINE_BV_TYPE(s64, int64_t,  "%d")
+DEFINE_BV_FLOAT_TYPE(f32, float,  uint32_t, true)
+DEFINE_BV_FLOAT_TYPE(f64, double, uint64_t, false)
 
 #define INVALID 255
 
@@ -47,6 +55,8 @@ const bv_ops_t BV_OPS[] = {
     [BV_S32] = { get_s32, set_s32, repr_s32, append_s32, sizeof(int32_t)  },
     [BV_U64] = { get_u64, set_u64, repr_u64, append_u64, sizeof(uint64_t) },
     [BV_S64] = { get_s64, set_s64, repr_s64, append_s64, sizeof(int64_t)  },
+    [BV_F32] = { get_f32, set_f32, repr_f32, append_f32, sizeof(float)    },
+    [BV_F64] = { get_f64, set_f64, repr_f64, append_f64, sizeof(double)   },
 };
 
 
@@ -94,6 +104,8 @@ static bv_t get_type(const Cell* t_sym)
     else if (t_sym == make_cell_symbol("s32")) { type = BV_S32; }
     else if (t_sym == make_cell_symbol("u64")) { type = BV_U64; }
     else if (t_sym == make_cell_symbol("s64")) { type = BV_S64; }
+    else if (t_sym == make_cell_symbol("f32")) { type = BV_F32; }
+    else if (t_sym == make_cell_symbol("f64")) { type = BV_F64; }
     else { type = INVALID; }
     return type;
 }
@@ -111,12 +123,44 @@ static char* get_type_string(const bv_t type)
         case BV_S32: {t_string = "s32"; break; }
         case BV_U64: {t_string = "u64"; break; }
         case BV_S64: {t_string = "s64"; break; }
+        case BV_F32: {t_string = "f32"; break; }
+        case BV_F64: {t_string = "f64"; break; }
         default: { t_string = "unknown"; break; }
     }
     return t_string;
 }
 
 
+/* Value of element i of bv, as an integer or, for the float types, a real. */
+Cell* bv_elem_ref(const Cell* bv, const int i)
+{
+    if (bv_is_float(bv->bv->type)) {
+        return make_cell_real(bv_real_ref(bv, i));
+    }
+    return make_cell_integer(BV_OPS[bv->bv->type].get(bv, i));
+}
+
+
+/* Check that x can be stored in an element of a float bytevector. */
+static bool is_real_value(const Cell* x)
+{
+    return cell_type(x) & (CELL_INTEGER|CELL_RATIONAL|CELL_REAL);
+}
+
+
+/* Returns an error if bv may not be written to, eg: it is a slice of a
+ * read-only file mapping, else nullptr. */
+Cell* bv_check_writable(const Cell* bv, const char* name)
+{
+    if (bv->bv->read_only) {
+        return make_cell_error(
+            fmt_err("%s: bytevector is read-only", name),
+            VALUE_ERR);
+    }
+    return nullptr;
+}
+
+
 /*------------------------------------------------------------*
  *     Byte vector constructors, selectors, and procedures    *
  * -----------------------------------------------------------*/
@@ -137,7 +181,7 @@ Cell* builtin_bytevector(const Lex* e, const Cell* a)
     /* See if there's a type argument. */
     int32_t num_bytes = a->count;
     bv_t type = BV_U8;
-    if (a->cell[num_bytes - 1]->type == CELL_SYMBOL)
+    if (cell_type(a->cell[num_bytes - 1]) == CELL_SYMBOL)
     {
         type = get_type(a->cell[num_bytes - 1]);
         if (type == INVALID) {
@@ -153,14 +197,24 @@ Cell* builtin_bytevector(const Lex* e, const Cell* a)
 
     Cell* bv = make_cell_bytevector(type, num_bytes);
     for (int i = 0; i < num_bytes; i++) {
-        if (a->cell[i]->type != CELL_INTEGER) {
+        if (bv_is_float(type)) {
+            if (!is_real_value(a->cell[i])) {
+                return make_cell_error(
+                    fmt_err("bytevector: args must be real numbers for %s bytevector",
+                        get_type_string(type)),
+                    VALUE_ERR);
+            }
+            byte_add(bv, bv_real_bits(type, (double)cell_to_long_double(a->cell[i])));
+            continue;
+        }
+        if (cell_type(a->cell[i]) != CELL_INTEGER) {
             return make_cell_error(
                 "bytevector: args must be integers",
                 VALUE_ERR);
         }
-        const int64_t byte = a->cell[i]->integer_v;
+        const int64_t byte = cell_int(a->cell[i]);
         Cell* check_if = byte_fits(type, byte);
-        if (check_if->type == CELL_ERROR) { return check_if; }
+        if (cell_type(check_if) == CELL_ERROR) { return check_if; }
         byte_add(bv, byte);
     }
     return bv;
@@ -188,18 +242,18 @@ Cell* builtin_bytevector_ref(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 2, "bytevector-ref");
     if (err) return err;
-    if (a->cell[0]->type != CELL_BYTEVECTOR) {
+    if (cell_type(a->cell[0]) != CELL_BYTEVECTOR) {
         return make_cell_error(
             "bytevector-ref: arg 1 must be a bytevector",
             TYPE_ERR);
     }
-    if (a->cell[1]->type != CELL_INTEGER) {
+    if (cell_type(a->cell[1]) != CELL_INTEGER) {
         return make_cell_error(
             "bytevector-ref: arg 2 must be an integer",
             TYPE_ERR);
     }
     const Cell* bv = a->cell[0];
-    const int i = (int)a->cell[1]->integer_v;
+    const int i = (int)cell_int(a->cell[1]);
     if (i < 0) {
         return make_cell_error(
             "bytevector-ref: indice cannot be negative",
@@ -211,7 +265,7 @@ Cell* builtin_bytevector_ref(const Lex* e, const Cell* a)
             "bytevector-ref: index out of bounds",
             INDEX_ERR);
     }
-    return make_cell_integer(BV_OPS[bv->bv->type].get(bv, i));
+    return bv_elem_ref(bv, i);
 }
 
 
@@ -223,29 +277,45 @@ Cell* builtin_bytevector_set_bang(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 3, "bytevector-set!");
     if (err) return err;
-    if (a->cell[0]->type != CELL_BYTEVECTOR) {
+    if (cell_type(a->cell[0]) != CELL_BYTEVECTOR) {
         return make_cell_error(
             "bytevector-set!: arg 1 must be a vector",
             TYPE_ERR);
     }
-    if (a->cell[1]->type != CELL_INTEGER) {
+    if (cell_type(a->cell[1]) != CELL_INTEGER) {
         return make_cell_error(
             "bytevector-set!: arg 2 must be an exact non-negative integer",
             TYPE_ERR);
     }
 
-    const int idx = (int)a->cell[1]->integer_v;
+    const int idx = (int)cell_int(a->cell[1]);
     Cell* bv = a->cell[0];
+    err = bv_check_writable(bv, "bytevector-set!");
+    if (err) return err;
     const uint8_t type = bv->bv->type;
-    if (a->cell[2]->type != CELL_INTEGER) {
+    if (bv_is_float(type)) {
+        if (!is_real_value(a->cell[2])) {
+            return make_cell_error(
+                "bytevector-set!: value arg must be a real number",
+                VALUE_ERR);
+        }
+        if (idx < 0 || idx >= bv->count) {
+            return make_cell_error(
+                "bytevector-set!: index out of range",
+                INDEX_ERR);
+        }
+        bv_real_set(bv, idx, (double)cell_to_long_double(a->cell[2]));
+        return USP_Obj;
+    }
+    if (cell_type(a->cell[2]) != CELL_INTEGER) {
         return make_cell_error(
             "bytevector-set: byte arg must be an integer",
             VALUE_ERR);
     }
-    const int byte = (int)a->cell[2]->integer_v;
+    const int byte = (int)cell_int(a->cell[2]);
     /* Check the range. */
     Cell* check_if = byte_fits(type, byte);
-    if (check_if->type == CELL_ERROR) {
+    if (cell_type(check_if) == CELL_ERROR) {
         return check_if;
     }
 
@@ -265,29 +335,34 @@ Cell* builtin_bytevector_set_bang(const Lex* e, const Cell* a)
  * (make-bytevector k byte symbol)
  * The make-bytevector procedure returns a newly allocated bytevector of length k. If byte is given,
  * then all elements of the bytevector are initialized to byte, otherwise the contents of each
- * element are set to 0. The optional third symbol argument is one of 'u8 's8 'u16 's16 'u32 or 's32,
- * the default is a regular u8 bytevector.*/
+ * element are set to 0. The optional third symbol argument is one of 'u8 's8 'u16 's16 'u32 's32
+ * 'u64 's64 'f32 or 'f64, the default is a regular u8 bytevector.*/
 Cell* builtin_make_bytevector(const Lex* e, const Cell* a)
 {
     (void)e;
     Cell* err = CHECK_ARITY_RANGE(a, 1, 3, "make-bytevector");
     if (err) return err;
-    if (a->cell[0]->type != CELL_INTEGER) {
+    if (cell_type(a->cell[0]) != CELL_INTEGER) {
         return make_cell_error(
             "make-bytevector: arg 1 must be an integer",
             TYPE_ERR);
     }
-    const long long n = a->cell[0]->integer_v;
+    const long long n = cell_int(a->cell[0]);
     if (n < 0) {
         return make_cell_error(
             "make-bytevector: arg 1 must be non-negative",
             VALUE_ERR);
     }
+    if (n > INT_MAX) {
+        return make_cell_error(
+            "make-bytevector: arg 1 is too large",
+            VALUE_ERR);
+    }
     /* Check for bv type. */
     bv_t type;
     if (a->count == 3) {
         const Cell* t_sym = a->cell[2];
-        if (t_sym->type != CELL_SYMBOL) {
+        if (cell_type(t_sym) != CELL_SYMBOL) {
             return make_cell_error(
                 "make-bytevector: arg 3 must be a symbol",
                 TYPE_ERR);
@@ -295,7 +370,7 @@ Cell* builtin_make_bytevector(const Lex* e, const Cell* a)
         type = get_type(t_sym);
         if (type == INVALID) {
             return make_cell_error(
-                "arg 3 must be one of 'u8, 's8, 'u16, 's16, 'u32, 's32', 'u64', or 's64' ",
+                "arg 3 must be one of 'u8, 's8, 'u16, 's16, 'u32, 's32', 'u64', 's64', 'f32, or 'f64 ",
                 VALUE_ERR);
         }
     } else {
@@ -303,16 +378,23 @@ Cell* builtin_make_bytevector(const Lex* e, const Cell* a)
     }
 
     int64_t fill;
-    if (a->count > 1) {
-        if (a->cell[1]->type != CELL_INTEGER) {
+    if (a->count > 1 && bv_is_float(type)) {
+        if (!is_real_value(a->cell[1])) {
+            return make_cell_error(
+                "make-bytevector: arg 2 must be a real number",
+                TYPE_ERR);
+        }
+        fill = bv_real_bits(type, (double)cell_to_long_double(a->cell[1]));
+    } else if (a->count > 1) {
+        if (cell_type(a->cell[1]) != CELL_INTEGER) {
             return make_cell_error(
                 "make-bytevector: arg 2 must be an integer",
                 TYPE_ERR);
         }
-        fill = a->cell[1]->integer_v;
+        fill = cell_int(a->cell[1]);
         /* Check the range. */
         Cell* check_if = byte_fits(type, fill);
-        if (check_if->type == CELL_ERROR) {
+        if (cell_type(check_if) == CELL_ERROR) {
             return check_if;
         }
     } else {
@@ -335,7 +417,7 @@ Cell* builtin_bytevector_copy(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_RANGE(a, 1, 3, "bytevector-copy");
     if (err) return err;
-    if (a->cell[0]->type != CELL_BYTEVECTOR) {
+    if (cell_type(a->cell[0]) != CELL_BYTEVECTOR) {
         return make_cell_error(
             "bytevector-copy: arg 1 must be a bytevector",
             TYPE_ERR);
@@ -344,24 +426,24 @@ Cell* builtin_bytevector_copy(const Lex* e, const Cell* a)
     int start = 0;
     int end = a->cell[0]->count;
     if (a->count == 2) {
-        if (a->cell[1]->type != CELL_INTEGER) {
+        if (cell_type(a->cell[1]) != CELL_INTEGER) {
             return make_cell_error(
                 "bytevector-copy: arg 2 must be an integer",
                 TYPE_ERR);
         }
-        start = (int)a->cell[1]->integer_v;
+        start = (int)cell_int(a->cell[1]);
     }
 
     const Cell* bv = a->cell[0];
     const bv_t type = bv->bv->type;
     if (a->count == 3) {
-        if (a->cell[1]->type != CELL_INTEGER || a->cell[2]->type != CELL_INTEGER) {
+        if (cell_type(a->cell[1]) != CELL_INTEGER || cell_type(a->cell[2]) != CELL_INTEGER) {
             return make_cell_error(
                 "bytevector-copy: start/end args must be integers",
                 TYPE_ERR);
         }
-        start = (int)a->cell[1]->integer_v;
-        end = (int)a->cell[2]->integer_v;
+        start = (int)cell_int(a->cell[1]);
+        end = (int)cell_int(a->cell[2]);
     }
 
     if (start < 0) {
@@ -374,12 +456,16 @@ Cell* builtin_bytevector_copy(const Lex* e, const Cell* a)
             "bytevector-copy: end index out of range",
             VALUE_ERR);
     }
+    if (start > end) {
+        return make_cell_error(
+            "bytevector-copy: start index cannot be greater than end index",
+            VALUE_ERR);
+    }
 
+    const size_t elem_size = BV_OPS[type].elem_size;
     Cell* vec = make_cell_bytevector(type, end - start);
-    for (int i = start; i < end; i++) {
-        const int64_t byte = BV_OPS[type].get(bv, i);
-        byte_add(vec, byte);
-    }
+    memcpy(vec->bv->data, (char*)bv->bv->data + (size_t)start * elem_size, (size_t)(end - start) * elem_size);
+    vec->count = end - start;
     return vec;
 }
 
@@ -397,23 +483,25 @@ Cell* builtin_bytevector_copy_bang(const Lex* e, const Cell* a)
     if (err) return err;
 
     /* Validate arg types. */
-    if (a->cell[0]->type != CELL_BYTEVECTOR)
+    if (cell_type(a->cell[0]) != CELL_BYTEVECTOR)
         return make_cell_error(
             "bytevector-copy!: arg 1 must be a bytevector (to)",
             TYPE_ERR);
-    if (a->cell[1]->type != CELL_INTEGER)
+    if (cell_type(a->cell[1]) != CELL_INTEGER)
         return make_cell_error(
             "bytevector-copy!: arg 2 must be an integer (at)",
             TYPE_ERR);
-    if (a->cell[2]->type != CELL_BYTEVECTOR)
+    if (cell_type(a->cell[2]) != CELL_BYTEVECTOR)
         return make_cell_error(
             "bytevector-copy!: arg 3 must be a bytevector (from)",
             TYPE_ERR);
 
     /* Get 'to' bytevector and 'at' index. */
     Cell* to_bv = a->cell[0];
+    err = bv_check_writable(to_bv, "bytevector-copy!");
+    if (err) return err;
     const int32_t to_bv_len = to_bv->count;
-    const int32_t to_start_idx = (int32_t)a->cell[1]->integer_v;
+    const int32_t to_start_idx = (int32_t)cell_int(a->cell[1]);
 
     /* Get 'from' bytevector and 'start'/'end' indices. */
     const Cell* from_bv = a->cell[2];
@@ -433,18 +521,18 @@ Cell* builtin_bytevector_copy_bang(const Lex* e, const Cell* a)
     }
 
     if (a->count >= 4) {
-        if (a->cell[3]->type != CELL_INTEGER)
+        if (cell_type(a->cell[3]) != CELL_INTEGER)
             return make_cell_error(
                 "bytevector-copy!: arg 4 must be an integer (start)",
                 TYPE_ERR);
-        from_start_idx = (int32_t)a->cell[3]->integer_v;
+        from_start_idx = (int32_t)cell_int(a->cell[3]);
     }
     if (a->count == 5) {
-        if (a->cell[4]->type != CELL_INTEGER)
+        if (cell_type(a->cell[4]) != CELL_INTEGER)
             return make_cell_error(
                 "bytevector-copy!: arg 5 must be an integer (end)",
                 TYPE_ERR);
-        from_end_idx = (int32_t)a->cell[4]->integer_v;
+        from_end_idx = (int32_t)cell_int(a->cell[4]);
     }
 
     /* R7RS Index Validation. */
@@ -466,11 +554,17 @@ Cell* builtin_bytevector_copy_bang(const Lex* e, const Cell* a)
             INDEX_ERR);
 
     const int32_t num_bytes = from_end_idx - from_start_idx;
-    for (int i = to_start_idx; i < to_start_idx + num_bytes; i++) {
-        const int64_t byte = BV_OPS[from_type].get(from_bv, from_start_idx);
-        BV_OPS[to_type].set(to_bv, i, byte);
-        from_start_idx++;
-    }
+    if (num_bytes > to_bv_len - to_start_idx)
+        return make_cell_error(
+            "bytevector-copy!: not enough room in 'to' bytevector",
+            INDEX_ERR);
+
+    /* 'to' and 'from' may be the same bytevector, or slices sharing storage,
+     * so the ranges can overlap. */
+    const size_t elem_size = BV_OPS[to_type].elem_size;
+    memmove((char*)to_bv->bv->data + (size_t)to_start_idx * elem_size,
+            (const char*)from_bv->bv->data + (size_t)from_start_idx * elem_size,
+            (size_t)num_bytes * elem_size);
     return USP_Obj;
 }
 
@@ -518,7 +612,7 @@ Cell* builtin_utf8_string(const Lex* e, const Cell* a)
     if (err) return err;
 
     const Cell* bv = a->cell[0];
-    if (bv->type != CELL_BYTEVECTOR || bv->bv->type != BV_U8) {
+    if (cell_type(bv) != CELL_BYTEVECTOR || bv->bv->type != BV_U8) {
         return make_cell_error(
             "utf8->string: arg 1 must be a u8 bytevector",
             TYPE_ERR);
@@ -529,30 +623,30 @@ Cell* builtin_utf8_string(const Lex* e, const Cell* a)
     int end = bv->count;
 
     if (a->count > 1) {
-        if (a->cell[1]->type != CELL_INTEGER) {
+        if (cell_type(a->cell[1]) != CELL_INTEGER) {
             return make_cell_error(
                 "utf8->string: arg 2 must be a non-negative integer",
                 TYPE_ERR);
         }
-        if (a->cell[1]->integer_v < 0) {
+        if (cell_int(a->cell[1]) < 0) {
             return make_cell_error(
                 "utf8->string: arg 2 must be non-negative",
                 VALUE_ERR);
         }
-        start = (int)a->cell[1]->integer_v;
+        start = (int)cell_int(a->cell[1]);
     }
     if (a->count == 3) {
-        if (a->cell[2]->type != CELL_INTEGER) {
+        if (cell_type(a->cell[2]) != CELL_INTEGER) {
             return make_cell_error(
                 "utf8->string: arg 3 must be a non-negative integer",
                 TYPE_ERR);
         }
-        if (a->cell[2]->integer_v < 0) {
+        if (cell_int(a->cell[2]) < 0) {
             return make_cell_error(
                 "utf8->string: arg 3 must be non-negative",
                 VALUE_ERR);
         }
-        end = (int)a->cell[2]->integer_v;
+        end = (int)cell_int(a->cell[2]);
     }
 
     if (start > bv->count || end > bv->count) {
@@ -601,7 +695,7 @@ Cell* builtin_string_utf8(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_RANGE(a, 1, 3, "string->utf8");
     if (err) return err;
-    if (a->cell[0]->type != CELL_STRING) {
+    if (cell_type(a->cell[0]) != CELL_STRING) {
         return make_cell_error(
             "string->utf8: arg 1 must be a string",
             TYPE_ERR);
@@ -612,30 +706,30 @@ Cell* builtin_string_utf8(const Lex* e, const Cell* a)
     int end_char = str_cell->char_count;
 
     if (a->count > 1) {
-        if (a->cell[1]->type != CELL_INTEGER) {
+        if (cell_type(a->cell[1]) != CELL_INTEGER) {
             return make_cell_error(
                 "string->utf8: arg 2 must be a non-negative integer",
                 TYPE_ERR);
         }
-        if (a->cell[1]->integer_v < 0) {
+        if (cell_int(a->cell[1]) < 0) {
             return make_cell_error(
                 "string->utf8: arg 2 must be non-negative",
                 VALUE_ERR);
         }
-        start_char = (int)a->cell[1]->integer_v;
+        start_char = (int)cell_int(a->cell[1]);
     }
     if (a->count == 3) {
-        if (a->cell[2]->type != CELL_INTEGER) {
+        if (cell_type(a->cell[2]) != CELL_INTEGER) {
             return make_cell_error(
                 "string->utf8: arg 3 must be a non-negative integer",
                 TYPE_ERR);
         }
-        if (a->cell[2]->integer_v < 0) {
+        if (cell_int(a->cell[2]) < 0) {
             return make_cell_error(
                 "string->utf8: arg 3 must be non-negative",
                 VALUE_ERR);
         }
-        end_char = (int)a->cell[2]->integer_v;
+        end_char = (int)cell_int(a->cell[2]);
     }
 
     if (start_char > str_cell->char_count || end_char > str_cell->char_count) {
@@ -661,3 +755,200 @@ Cell* builtin_string_utf8(const Lex* e, const Cell* a)
     }
     return bv;
 }
+
+
+/* (bytevector-slice bytevector start)
+ * (bytevector-slice bytevector start end)
+ * Returns a bytevector of the same type containing the elements of bytevector between start and end. Unlike
+ * bytevector-copy, no elements are copied: the slice shares its storage with bytevector, so a change to either is
+ * seen in both. A slice of a read-only bytevector is read-only. */
+Cell* builtin_bytevector_slice(const Lex* e, const Cell* a)
+{
+    (void)e;
+    Cell* err = CHECK_ARITY_RANGE(a, 2, 3, "bytevector-slice");
+    if (err) return err;
+    if (cell_type(a->cell[0]) != CELL_BYTEVECTOR) {
+        return make_cell_error(
+            "bytevector-slice: arg 1 must be a bytevector",
+            TYPE_ERR);
+    }
+    for (int i = 1; i < a->count; i++) {
+        if (cell_type(a->cell[i]) != CELL_INTEGER) {
+            return make_cell_error(
+                "bytevector-slice: start/end args must be integers",
+                TYPE_ERR);
+        }
+    }
+    const Cell* bv = a->cell[0];
+    const long long start = cell_int(a->cell[1]);
+    const long long end = a->count == 3 ? cell_int(a->cell[2]) : bv->count;
+    if (start < 0 || end > bv->count) {
+        return make_cell_error(
+            "bytevector-slice: index out of range",
+            INDEX_ERR);
+    }
+    if (start > end) {
+        return make_cell_error(
+            "bytevector-slice: start index cannot be greater than end index",
+            INDEX_ERR);
+    }
+
+    Cell* slice = GC_MALLOC(sizeof(Cell));
+    slice->type = CELL_BYTEVECTOR;
+    slice->bv = GC_MALLOC(sizeof(byte_v));
+    slice->bv->type = bv->bv->type;
+    slice->bv->capacity = (size_t)(end - start);
+    slice->bv->read_only = bv->bv->read_only;
+    slice->bv->data = (char*)bv->bv->data + (size_t)start * BV_OPS[bv->bv->type].elem_size;
+    /* Always point at the bytevector which owns the storage, so slices of
+     * slices don't keep their intermediate parents alive. */
+    slice->bv->owner = bv->bv->owner ? bv->bv->owner : bv->bv;
+    slice->count = (int)(end - start);
+    return slice;
+}
+
+
+/* Unmap the file behind a mapped bytevector, once it and all its slices are
+ * unreachable. The data of a window starts part way into the first mapped
+ * page, and cd is the length mapped from the start of that page. */
+static void bv_unmap(void* obj, void* cd)
+{
+    const byte_v* bv = obj;
+    const uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+    munmap((void*)((uintptr_t)bv->data & ~(page - 1)), (size_t)cd);
+}
+
+
+/* (mmap-bytevector path)
+ * (mmap-bytevector path symbol)
+ * (mmap-bytevector path symbol mode)
+ * (mmap-bytevector path symbol mode offset)
+ * (mmap-bytevector path symbol mode offset count)
+ * Returns a bytevector whose elements are the contents of the file at path, mapped into memory rather than read. The
+ * optional symbol is the element type, as for make-bytevector, and trailing bytes which do not fill a whole element
+ * are ignored. Mode is either 'read-only (the default), in which case writing to the bytevector is an error, or
+ * 'copy-on-write, in which case writes are allowed, but are private to the bytevector and never reach the file.
+ * A window of the file may be mapped instead, of count elements from byte offset. A bytevector holds at most
+ * INT_MAX elements, so a larger file must be mapped a window at a time. */
+Cell* builtin_mmap_bytevector(const Lex* e, const Cell* a)
+{
+    (void)e;
+    Cell* err = CHECK_ARITY_RANGE(a, 1, 5, "mmap-bytevector");
+    if (err) return err;
+    if (cell_type(a->cell[0]) != CELL_STRING) {
+        return make_cell_error(
+            "mmap-bytevector: arg 1 must be a string",
+            TYPE_ERR);
+    }
+    bv_t type = BV_U8;
+    if (a->count > 1) {
+        if (cell_type(a->cell[1]) != CELL_SYMBOL) {
+            return make_cell_error(
+                "mmap-bytevector: arg 2 must be a symbol",
+                TYPE_ERR);
+        }
+        type = get_type(a->cell[1]);
+        if (type == INVALID) {
+            return make_cell_error(
+                fmt_err("mmap-bytevector: invalid bytevector type: %s", a->cell[1]->sym),
+                VALUE_ERR);
+        }
+    }
+    bool read_only = true;
+    if (a->count > 2) {
+        if (a->cell[2] == make_cell_symbol("copy-on-write")) {
+            read_only = false;
+        } else if (a->cell[2] != make_cell_symbol("read-only")) {
+            return make_cell_error(
+                "mmap-bytevector: arg 3 must be one of 'read-only or 'copy-on-write",
+                VALUE_ERR);
+        }
+    }
+    for (int i = 3; i < a->count; i++) {
+        if (cell_type(a->cell[i]) != CELL_INTEGER || cell_int(a->cell[i]) < 0) {
+            return make_cell_error(
+                fmt_err("mmap-bytevector: arg %d must be a non-negative integer", i + 1),
+                TYPE_ERR);
+        }
+    }
+
+    const char* path = a->cell[0]->str;
+    const int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        return make_cell_error(
+            fmt_err("mmap-bytevector: %s: %s", path, strerror(errno)),
+            FILE_ERR);
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        const int saved = errno;
+        close(fd);
+        return make_cell_error(
+            fmt_err("mmap-bytevector: %s: %s", path, strerror(saved)),
+            FILE_ERR);
+    }
+    if (!S_ISREG(st.st_mode)) {
+        close(fd);
+        return make_cell_error(
+            fmt_err("mmap-bytevector: %s: not a regular file", path),
+            FILE_ERR);
+    }
+
+    const size_t elem_size = BV_OPS[type].elem_size;
+    const size_t offset = a->count > 3 ? (size_t)cell_int(a->cell[3]) : 0;
+    if (offset > (size_t)st.st_size) {
+        close(fd);
+        return make_cell_error(
+            fmt_err("mmap-bytevector: %s: offset is past the end of the file", path),
+            INDEX_ERR);
+    }
+    const size_t avail = ((size_t)st.st_size - offset) / elem_size;
+    const size_t n = a->count > 4 ? (size_t)cell_int(a->cell[4]) : avail;
+    if (n > avail) {
+        close(fd);
+        return make_cell_error(
+            fmt_err("mmap-bytevector: %s: count runs past the end of the file", path),
+            INDEX_ERR);
+    }
+    if (n > INT_MAX) {
+        close(fd);
+        return make_cell_error(
+            fmt_err("mmap-bytevector: %s: file is too large: map a window of it", path),
+            VALUE_ERR);
+    }
+    /* Nothing to map: mmap() rejects a length of zero. */
+    if (n == 0) {
+        close(fd);
+        Cell* bv = make_cell_bytevector(type, 0);
+        bv->bv->read_only = read_only;
+        return bv;
+    }
+
+    /* mmap() takes a page-aligned offset, so a window is mapped from the
+     * start of the page it begins in. */
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    const size_t skip = offset % page;
+    const size_t len = skip + n * elem_size;
+    const int prot = read_only ? PROT_READ : PROT_READ|PROT_WRITE;
+    char* data = mmap(nullptr, len, prot, MAP_PRIVATE, fd, (off_t)(offset - skip));
+    const int saved = errno;
+    /* The mapping holds its own reference to the file. */
+    close(fd);
+    if (data == MAP_FAILED) {
+        return make_cell_error(
+            fmt_err("mmap-bytevector: %s: %s", path, strerror(saved)),
+            FILE_ERR);
+    }
+
+    Cell* bv = GC_MALLOC(sizeof(Cell));
+    bv->type = CELL_BYTEVECTOR;
+    bv->bv = GC_MALLOC(sizeof(byte_v));
+    bv->bv->type = type;
+    bv->bv->capacity = n;
+    bv->bv->read_only = read_only;
+    bv->bv->data = data + skip;
+    bv->bv->owner = nullptr;
+    bv->count = (int)n;
+    GC_register_finalizer(bv->bv, bv_unmap, (void*)len, nullptr, nullptr);
+    return bv;
+}
@@ -22,7 +22,9 @@
 
 #include "cell.h"
 #include "buffer.h"
+#include "float_io.h"
 
+#include <string.h>
 #include <gc/gc.h>
 
 
@@ -48,7 +50,7 @@ static void set_##suffix(Cell* bv, int i, int64_t val) {                    \
 ((ctype*)bv->bv->data)[i] = (ctype)val;                                     \
 }                                                                           \
 static void append_##suffix(Cell* bv, int64_t val) {                        \
-if (bv->count == bv->bv->capacity) {                                        \
+if ((size_t)bv->count == bv->bv->capacity) {                                \
 bv->bv->capacity *= 2;                                                      \
 bv->bv->data = GC_REALLOC(bv->bv->data, bv->bv->capacity * sizeof(ctype));  \
 }                                                                           \
@@ -64,6 +66,82 @@ sb_append_char(sb, ')');                                                    \
 }
 
 
+/* The float types, f32 and f64, pass the bit patterns of their elements
+ * through the int64_t ops above, so that bytevectors of any type are copied,
+ * compared and serialized alike. Element values are read and written as
+ * reals with bv_real_ref() and bv_real_set(). */
+
+#define DEFINE_BV_FLOAT_TYPE(suffix, ctype, bits_t, single)                 \
+static int64_t get_##suffix(const Cell* bv, int i) {                        \
+bits_t bits;                                                                \
+memcpy(&bits, (ctype*)bv->bv->data + i, sizeof bits);                       \
+return (int64_t)bits;                                                       \
+}                                                                           \
+static void set_##suffix(Cell* bv, int i, int64_t val) {                    \
+const bits_t bits = (bits_t)val;                                            \
+memcpy((ctype*)bv->bv->data + i, &bits, sizeof bits);                       \
+}                                                                           \
+static void append_##suffix(Cell* bv, int64_t val) {                        \
+if ((size_t)bv->count == bv->bv->capacity) {                                \
+bv->bv->capacity *= 2;                                                      \
+bv->bv->data = GC_REALLOC(bv->bv->data, bv->bv->capacity * sizeof(ctype));  \
+}                                                                           \
+set_##suffix(bv, bv->count++, val);                                         \
+}                                                                           \
+static void repr_##suffix(const Cell* bv, str_buf_t *sb) {                  \
+char buf[REAL_BUF_SIZE];                                                    \
+sb_append_fmt(sb, "#%s(", #suffix);                                         \
+for (int i = 0; i < bv->count; i++) {                                       \
+format_float_shortest(buf, ((ctype*)bv->bv->data)[i], single);              \
+sb_append_str(sb, buf);                                                     \
+if (i != bv->count - 1) sb_append_char(sb, ' ');                            \
+}                                                                           \
+sb_append_char(sb, ')');                                                    \
+}
+
+
+static inline bool bv_is_float(const bv_t type)
+{
+    return type == BV_F32 || type == BV_F64;
+}
+
+/* Value of element i of an f32 or f64 bytevector. */
+static inline double bv_real_ref(const Cell* bv, const int i)
+{
+    if (bv->bv->type == BV_F32) {
+        return ((const float*)bv->bv->data)[i];
+    }
+    return ((const double*)bv->bv->data)[i];
+}
+
+/* Store x in element i of an f32 or f64 bytevector. */
+static inline void bv_real_set(Cell* bv, const int i, const double x)
+{
+    if (bv->bv->type == BV_F32) {
+        ((float*)bv->bv->data)[i] = (float)x;
+    } else {
+        ((double*)bv->bv->data)[i] = x;
+    }
+}
+
+/* Bit pattern of x as an element of an f32 or f64 bytevector, for byte_add(). */
+static inline int64_t bv_real_bits(const bv_t type, const double x)
+{
+    if (type == BV_F32) {
+        const float f = (float)x;
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof bits);
+        return bits;
+    }
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof bits);
+    return (int64_t)bits;
+}
+
+
+Cell* bv_elem_ref(const Cell* bv, int i);
+Cell* bv_check_writable(const Cell* bv, const char* name);
+
 /* Bytevector constructors, selectors,and procedures */
 Cell* builtin_bytevector(const Lex* e, const Cell* a);
 Cell* builtin_bytevector_length(const Lex* e, const Cell* a);
@@ -75,5 +153,7 @@ Cell* builtin_bytevector_copy_bang(const Lex* e, const Cell* a);
 Cell* builtin_bytevector_append(const Lex* e, const Cell* a);
 Cell* builtin_utf8_string(const Lex* e, const Cell* a);
 Cell* builtin_string_utf8(const Lex* e, const Cell* a);
+Cell* builtin_bytevector_slice(const Lex* e, const Cell* a);
+Cell* builtin_mmap_bytevector(const Lex* e, const Cell* a);
 
 #endif //COZENAGE_BYTEVECTORS_H
@@ -52,6 +52,9 @@ Cell* TCS_Obj = nullptr;
 /* Global unspecified object. */
 Cell* USP_Obj = nullptr;
 
+/* Global empty string, shared by every empty string literal. */
+Cell* Empty_String_Obj = nullptr;
+
 /* Default ports. */
 Cell* default_input_port  = nullptr;
 Cell* default_output_port = nullptr;
@@ -116,6 +119,19 @@ static Cell* make_cell_usp__(void)
 }
 
 
+static Cell* make_cell_empty_string__(void)
+{
+    Cell* v = GC_MALLOC_UNCOLLECTABLE(sizeof(Cell));
+    v->type = CELL_STRING;
+    v->str = GC_MALLOC_ATOMIC_UNCOLLECTABLE(1);
+    v->str[0] = '\0';
+    v->count = 0;
+    v->char_count = 0;
+    v->ascii = 1;
+    return v;
+}
+
+
 /* Initialize global singletons. */
 void init_global_singletons(void)
 {
@@ -125,6 +141,7 @@ void init_global_singletons(void)
     EOF_Obj = make_cell_eof__();
     TCS_Obj = make_cell_tcs__();
     USP_Obj = make_cell_usp__();
+    Empty_String_Obj = make_cell_empty_string__();
 }
 
 
@@ -189,9 +206,13 @@ Cell* make_cell_real(const long double the_real)
 }
 
 
-/* Cell constructor for integers < INT64_MAX. */
+/* Cell constructor for integers < INT64_MAX. Fixnums are returned as
+ * immediates, without allocating. */
 Cell* make_cell_integer(const long long int the_integer)
 {
+    if (the_integer >= FIXNUM_MIN && the_integer <= FIXNUM_MAX) {
+        return (Cell*)(((uintptr_t)the_integer << 2) | IMM_FIXNUM);
+    }
     Cell* v = GC_MALLOC_ATOMIC(sizeof(Cell));
     if (!v) {
         fprintf(stderr, "ENOMEM: GC_MALLOC failed\n");
@@ -228,7 +249,7 @@ Cell* make_cell_rational(const long int numerator,
 /* Cell constructor for complex numbers. */
 Cell* make_cell_complex(Cell* real_part, Cell *imag_part)
 {
-    if (real_part->type == CELL_COMPLEX || imag_part->type == CELL_COMPLEX) {
+    if (cell_type(real_part) == CELL_COMPLEX || cell_type(imag_part) == CELL_COMPLEX) {
         return make_cell_error(
             "Cannot have complex real or imaginary parts.",
             GEN_ERR);
@@ -241,7 +262,7 @@ Cell* make_cell_complex(Cell* real_part, Cell *imag_part)
     v->type = CELL_COMPLEX;
     v->real = real_part;
     v->imag = imag_part;
-    v->exact = real_part->exact && imag_part->exact;
+    v->exact = cell_exact(real_part) && cell_exact(imag_part);
     return v;
 }
 
@@ -249,8 +270,10 @@ Cell* make_cell_complex(Cell* real_part, Cell *imag_part)
 /* Cell constructor for symbols. All symbols are first looked up in the intern hash. */
 Cell* make_cell_symbol(const char* the_symbol)
 {
-    /* Lookup in symbol table first. */
-    Cell* v = ht_get(symbol_table, the_symbol);
+    /* Lookup in symbol table first. The hash is kept in the symbol, so
+     * global lookups by it never need to rehash its name. */
+    const uint64_t hash = hash_string_key(the_symbol);
+    Cell* v = ht_get_hashed(symbol_table, the_symbol, hash);
     if (v) {
         return v;
     }
@@ -263,15 +286,48 @@ Cell* make_cell_symbol(const char* the_symbol)
     }
     v->sf_id = 0; /* Special form id zero by default. */
     v->type = CELL_SYMBOL;
-    const char* canonical_name = ht_set(symbol_table, the_symbol, v);
+    v->hash = hash;
+    const char* canonical_name = ht_set_hashed(symbol_table, the_symbol, hash, v);
     v->sym = (char*)canonical_name;
     return v;
 }
 
 
+/* As make_cell_symbol(), for a name of len bytes which need not be
+ * NUL-terminated. The name is only copied the first time it is interned. */
+Cell* make_cell_symbol_n(const char* name, const size_t len)
+{
+    Cell* v = ht_get_n(symbol_table, name, len);
+    if (v) {
+        return v;
+    }
+    return make_cell_symbol(GC_strndup(name, len));
+}
+
+
 /* Cell constructor for strings. Calculate and store byte length and char length, and set an ascii flag for faster
  * operations on pure-ascii strings. */
 Cell* make_cell_string(const char* the_string)
+{
+    return make_cell_string_n(the_string, strlen(the_string));
+}
+
+
+/* Cell constructor for string literals, which are read-only. All empty
+ * literals are the one immortal empty string, while the procedures which
+ * return a newly allocated string use make_cell_string(). */
+Cell* make_cell_string_literal(const char* the_string)
+{
+    if (the_string[0] == '\0' && Empty_String_Obj) {
+        return Empty_String_Obj;
+    }
+    return make_cell_string(the_string);
+}
+
+
+/* Cell constructor for strings from the first len bytes of the_string,
+ * which need not be null-terminated. */
+Cell* make_cell_string_n(const char* the_string, const size_t len)
 {
     Cell* v = GC_MALLOC_ATOMIC(sizeof(Cell));
     if (!v) {
@@ -279,21 +335,26 @@ Cell* make_cell_string(const char* the_string)
         exit(EXIT_FAILURE);
     }
 
-    const int32_t byte_len = (int)strlen(the_string);
+    char* str = GC_MALLOC_ATOMIC(len + 1);
+    memcpy(str, the_string, len);
+    str[len] = '\0';
+
+    const int32_t byte_len = (int32_t)len;
     v->count = byte_len;
 
     /* Run the SWAR check. */
-    if (is_pure_ascii(the_string, byte_len)) {
+    if (is_pure_ascii(str, byte_len)) {
         v->ascii = 1;
         v->char_count = byte_len; /* For ASCII, bytes == chars. */
     } else {
         /* Scan string to count actual UTF-8 codepoints. */
         v->ascii = 0;
-        v->char_count = utf8_strlen(the_string);
+        v->char_count = utf8_strlen(str);
     }
 
     v->type = CELL_STRING;
-    v->str = GC_strdup(the_string);
+    v->str = str;
+    v->hash = 0;
     return v;
 }
 
@@ -310,21 +371,15 @@ Cell* make_cell_sexpr(void)
     v->type = CELL_SEXPR;
     v->count = 0;
     v->cell = nullptr;
+    v->capacity = 0;
     return v;
 }
 
 
-/* Cell constructor for chars. */
+/* Cell constructor for chars. Chars are always immediates. */
 Cell* make_cell_char(const UChar32 the_char)
 {
-    Cell* v = GC_MALLOC_ATOMIC(sizeof(Cell));
-    if (!v) {
-        fprintf(stderr, "ENOMEM: GC_MALLOC failed\n");
-        exit(EXIT_FAILURE);
-    }
-    v->type = CELL_CHAR;
-    v->char_v = the_char;
-    return v;
+    return (Cell*)(((uintptr_t)the_char << 2) | IMM_CHAR);
 }
 
 
@@ -354,6 +409,7 @@ Cell* make_cell_vector(void)
     }
     v->type = CELL_VECTOR;
     v->cell = nullptr;
+    v->capacity = 0;
     v->count = 0;
     return v;
 }
@@ -373,6 +429,8 @@ Cell* make_cell_bytevector(const bv_t t, const size_t initial_size)
 
     v->bv->type = t;
     v->bv->capacity = initial_size == 0 ? 8 : initial_size;
+    v->bv->read_only = false;
+    v->bv->owner = nullptr;
     v->count = 0;
 
     const size_t elem_size = BV_OPS[t].elem_size;
@@ -415,6 +473,7 @@ Cell* make_cell_file_port(const char* path, FILE* fh, const stream_t stream, con
     v->port->vtable = GC_MALLOC(sizeof(PortInterface));
     v->port->vtable = &FileVTable;
     v->port->index = 0;
+    v->port->buffer = nullptr;
     return v;
 }
 
@@ -438,6 +497,30 @@ Cell* make_cell_memory_port(const stream_t stream, const backend_t backend)
     /* Initialize the data store. */
     v->port->data = sb_new();
     v->port->index = 0;
+    v->port->buffer = nullptr;
+    return v;
+}
+
+
+/* Cell constructor for input file ports read in place from the
+ * contents of the file, mapped into memory. */
+Cell* make_cell_mapped_port(const char* path, struct FileMap* map, const backend_t backend)
+{
+    Cell* v = GC_MALLOC(sizeof(Cell));
+    if (!v) {
+        fprintf(stderr, "ENOMEM: GC_MALLOC failed\n");
+        exit(EXIT_FAILURE);
+    }
+    v->is_open = true;
+    v->type = CELL_PORT;
+    v->port = GC_MALLOC(sizeof(port_d));
+    v->port->stream_t = INPUT_STREAM;
+    v->port->path = GC_strdup(path);
+    v->port->backend_t = backend;
+    v->port->vtable = &MappedFileVTable;
+    v->port->map = map;
+    v->port->index = 0;
+    v->port->buffer = nullptr;
     return v;
 }
 
@@ -463,7 +546,7 @@ Cell* make_cell_bigint(const char* s, const Cell* a,  const uint8_t base)
         }
     } else {
         /* Set from integer (type promotion). */
-        mpz_init_set_si(*v->bi, a->integer_v);
+        mpz_init_set_si(*v->bi, cell_int(a));
     }
     return v;
 }
@@ -502,12 +585,13 @@ Cell* make_cell_promise(Cell* expr, Lex* env)
     // ReSharper disable once CppVariableCanBeMadeConstexpr
     const int mask = CELL_BOOLEAN|CELL_CHAR|CELL_INTEGER|CELL_RATIONAL|
                      CELL_REAL|CELL_COMPLEX|CELL_STRING;
-    if (expr->type & mask) {
+    if (cell_type(expr) & mask) {
         v->promise->status = DONE;
         v->promise->env = nullptr;
     } else {
         v->promise->status = READY;
         v->promise->env = env;
+        lex_capture(env);
     }
     return v;
 }
@@ -516,7 +600,7 @@ Cell* make_cell_promise(Cell* expr, Lex* env)
 /* Cell constructor for stream type. */
 Cell* make_cell_stream(Cell* head, Cell* tail_promise) {
     /* Safety check: Ensure the tail is actually a promise. */
-    if (tail_promise->type != CELL_PROMISE) {
+    if (cell_type(tail_promise) != CELL_PROMISE) {
         return make_cell_error(
             "Stream tail must be a promise",
             TYPE_ERR);
@@ -564,8 +648,10 @@ Cell* make_cell_hash(const Cell* values) {
     v->type = CELL_HASH;
     ght_table* t = ght_create(8);
     /* Already checked for evenness in the parser. */
-    for (int i = 0; i < values->count; i += 2) {
-        ght_set(t, values->cell[i], values->cell[i + 1]);
+    if (values) {
+        for (int i = 0; i < values->count; i += 2) {
+            ght_set(t, values->cell[i], values->cell[i + 1]);
+        }
     }
     v->table = t;
     return v;
@@ -577,12 +663,24 @@ Cell* make_cell_hash(const Cell* values) {
  * -----------------------------------------------*/
 
 
-/* Add a cell to compound type S-expr or vector. */
+/* Make room for at least n members in compound type S-expr or vector,
+ * without changing its count. */
+void cell_reserve(Cell* v, const int n)
+{
+    if (n <= v->capacity) return;
+    v->cell = GC_REALLOC(v->cell, sizeof(Cell*) * n);
+    v->capacity = n;
+}
+
+
+/* Add a cell to compound type S-expr or vector. The member array grows by
+ * half again each time it fills, so building up n members costs O(n). */
 Cell* cell_add(Cell* v, Cell* x)
 {
-    v->count++;
-    v->cell = GC_REALLOC(v->cell, sizeof(Cell*) * v->count);
-    v->cell[v->count-1] = x;
+    if (v->count >= v->capacity) {
+        cell_reserve(v, v->count + v->count / 2 + 4);
+    }
+    v->cell[v->count++] = x;
     return v;
 }
 
@@ -600,6 +698,8 @@ Cell* byte_add(Cell* bv, const int64_t value)
  * be copied. Deep-copying is expensive, and should be avoided if possible. */
 Cell* cell_copy(const Cell* v) {
     if (!v) return nullptr;
+    /* Immediates are values, not objects. */
+    if (is_immediate(v)) return (Cell*)v;
 
     Cell* copy = GC_MALLOC(sizeof(Cell));
     if (!copy) {
@@ -607,9 +707,9 @@ Cell* cell_copy(const Cell* v) {
         exit(EXIT_FAILURE);
     }
 
-    copy->type = v->type;
+    copy->type = cell_type(v);
 
-    switch (v->type) {
+    switch (cell_type(v)) {
     case CELL_INTEGER:
         copy->integer_v = v->integer_v;
         copy->exact = v->exact;
@@ -617,16 +717,12 @@ Cell* cell_copy(const Cell* v) {
 
     case CELL_REAL:
         copy->real_v = v->real_v;
-        copy->exact = v->exact;
+        copy->exact = cell_exact(v);
         break;
 
     case CELL_BOOLEAN:
         return v->boolean_v == 1 ? True_Obj : False_Obj;
 
-    case CELL_CHAR:
-        copy->char_v = v->char_v;
-        break;
-
     case CELL_SYMBOL:
         /* Symbols are interned, just grab the pointer. */
         copy = (Cell*)v;
@@ -637,6 +733,7 @@ Cell* cell_copy(const Cell* v) {
         copy->count = v->count;
         copy->char_count = v->char_count;
         copy->ascii = v->ascii;
+        copy->hash = v->hash;
         break;
 
     case CELL_ERROR:
@@ -655,6 +752,8 @@ Cell* cell_copy(const Cell* v) {
             copy->lambda->l_name = v->lambda->l_name ? GC_strdup(v->lambda->l_name) : nullptr;
             copy->lambda->formals = cell_copy(v->lambda->formals) ;
             copy->lambda->body = cell_copy(v->lambda->body);
+            copy->lambda->code = v->lambda->code;
+            copy->lambda->chunk = v->lambda->chunk;
             /* DO NOT copy environments; share the pointer. */
             copy->lambda->env = v->lambda->env;
         }
@@ -663,6 +762,7 @@ Cell* cell_copy(const Cell* v) {
     case CELL_SEXPR:
     case CELL_VECTOR:
         copy->count = v->count;
+        copy->capacity = v->count;
         if (v->count) {
             copy->cell = GC_MALLOC(sizeof(Cell*) * v->count);
         } else {
@@ -681,14 +781,14 @@ Cell* cell_copy(const Cell* v) {
     }
 
     case CELL_RATIONAL: {
-        copy->exact = v->exact;
+        copy->exact = cell_exact(v);
         copy->num = v->num;
         copy->den = v->den;
         break;
     }
 
     case CELL_COMPLEX: {
-        copy->exact = v->exact;
+        copy->exact = cell_exact(v);
         copy->real = cell_copy(v->real);
         copy->imag = cell_copy(v->imag);
         break;
@@ -702,6 +802,7 @@ Cell* cell_copy(const Cell* v) {
         copy->port->path = GC_strdup(v->port->path);
         copy->port->vtable = v->port->vtable;
         copy->port->index = v->port->index;
+        copy->port->buffer = v->port->buffer;
         if (v->port->backend_t == BK_FILE_BINARY || v->port->backend_t == BK_FILE_TEXT) {
             copy->port->fh = v->port->fh;
         } else {
@@ -748,8 +849,27 @@ Cell* cell_copy(const Cell* v) {
         return USP_Obj;
 
     default:
-        fprintf(stderr, "cell_copy: unknown type %u\n", v->type);
+        fprintf(stderr, "cell_copy: unknown type %u\n", cell_type(v));
         return nullptr;
     }
     return copy;
 }
+
+
+/* Set the exactness of a number, and return it. Fixnums are always exact,
+ * so an inexact integer is boxed, and an exact one becomes a fixnum again
+ * where it fits. Other numbers are changed in place. */
+Cell* cell_set_exact(Cell* v, const bool exact)
+{
+    if (cell_type(v) == CELL_INTEGER) {
+        if (exact) return make_cell_integer(cell_int(v));
+        if (is_immediate(v)) {
+            Cell* boxed = GC_MALLOC_ATOMIC(sizeof(Cell));
+            boxed->type = CELL_INTEGER;
+            boxed->integer_v = cell_int(v);
+            v = boxed;
+        }
+    }
+    v->exact = exact;
+    return v;
+}
@@ -31,9 +31,11 @@
 #define COZENAGE_CELL_H
 
 #include "environment.h"
+#include "hash.h"
 #include "buffer.h"
 #include "hash_type.h"
 
+#include <stdint.h>
 #include <stdio.h>
 #include <unicode/umachine.h>
 #include <gmp.h>
@@ -77,6 +79,11 @@ typedef enum Cell_t : uint32_t {
 } Cell_t;
 
 
+/* Pre-analyzed closure tree node (analyzer.h). */
+typedef struct Node Node;
+/* Compiled bytecode chunk (bytecode.h). */
+typedef struct Chunk Chunk;
+
 /* LAMBDA
  * Anonymous and named lambda struct. */
 typedef struct Lambda {
@@ -84,6 +91,8 @@ typedef struct Lambda {
     Cell* formals;    /* Must be symbols. */
     Cell* body;       /* S-expression for lambda. */
     Lex* env;         /* Closure environment. */
+    Node* code;       /* Analyzed body, or null until first call. */
+    Chunk* chunk;     /* Compiled body, or null until first VM call. */
  } lambda;
 
 
@@ -126,15 +135,18 @@ typedef enum BV_t : uint8_t {
     BV_S32,
     BV_U64,
     BV_S64,
-    BV_F32, /* TODO: 32-bit single precision floating-point vector. */
-    BV_F64  /* TODO: 64-bit double precision floating-point vector. */
+    BV_F32, /* 32-bit single precision floating-point vector. */
+    BV_F64  /* 64-bit double precision floating-point vector. */
 } bv_t;
 
-/* Bytevector struct. */
+/* Bytevector struct. Slices and file mappings point data into storage they
+ * don't own, and keep its owner alive through the owner pointer. */
 typedef struct ByteV {
-    uint16_t capacity;
+    size_t capacity;       /* Elements allocated in data. */
     bv_t type;
+    bool read_only;        /* Writing is an error, eg: a read-only mapping. */
     void* data;
+    struct ByteV* owner;   /* Owner of data, if not this bytevector. */
 } byte_v;
 
 
@@ -165,6 +177,9 @@ typedef struct PortInterface {
     ssize_t (*getdelim)(char **lineptr, size_t *n,
                         int delim, const Cell *port, int *err);
     void (*close)(Cell *port);
+    /* Ports whose contents are all in memory expose their unread bytes here,
+     * so that they can be sliced in place. Null for stdio file ports. */
+    const char* (*view)(const Cell* port, size_t* avail);
 } PortInterface;
 
 /* Port data struct. */
@@ -173,11 +188,13 @@ typedef struct Port_d {
     union {
         FILE* fh;         /* The associated file handle for a file port. */
         str_buf_t* data;  /* The data store for string and bv ports. */
+        struct FileMap* map;  /* The contents of a mapped input file port. */
     };
     const PortInterface *vtable;
     uint8_t backend_t;    /* The backing store (text file/bin file/string/bytevector). */
     uint8_t stream_t;     /* Stream type (input/output/async) */
-    uint32_t index;       /* read/write pointer. */
+    size_t index;         /* read/write pointer. */
+    struct PortBuffer* buffer;    /* Bytes read ahead from a stdio file port. */
 } port_d;
 
 
@@ -215,6 +232,11 @@ typedef struct Cell {
         bool is_builtin; /* proc object: builtin, or user-defined lambda. */
     };
 
+    /* hash_string_key() of the text of a string or symbol. Symbols set it
+     * when interned; strings set it on first use, and 0 means not yet
+     * computed, so any procedure which mutates a string must reset it. */
+    uint64_t hash;
+
     /* Union of type-specific data storage. */
     union {
         struct {
@@ -259,8 +281,13 @@ typedef struct Cell {
             Cell* tail;        /* second member */
         };
 
+        /* Compound types (sexpr, vector) */
+        struct {
+            Cell** cell;      /* member array */
+            int capacity;     /* slots allocated in cell (0 if not known) */
+        };
+
         /* Single-field types. */
-        Cell** cell;              /* for compound types (sexpr, vector) */
         char* error_v;            /* error string */
         long double real_v;       /* reals */
         int64_t integer_v;        /* integers */
@@ -286,6 +313,7 @@ extern Cell* EOF_Obj;
 extern Cell* True_Obj;
 extern Cell* False_Obj;
 extern Cell* USP_Obj;
+extern Cell* Empty_String_Obj;
 extern Cell* default_input_port;
 extern Cell* default_output_port;
 extern Cell* default_error_port;
@@ -293,6 +321,60 @@ void init_default_ports(void);
 void init_global_singletons(void);
 
 
+/* Immediate values. Exact integers which fit in 62 bits (fixnums), and
+ * characters, are not allocated: the value lives in the Cell* itself,
+ * tagged in the low two bits, which are always clear in a pointer to a
+ * real Cell. Such a pointer must never be dereferenced, so the type and
+ * value of any Cell are read through the accessors below. */
+#define IMM_TAG_MASK ((uintptr_t)3)
+#define IMM_FIXNUM   ((uintptr_t)1)
+#define IMM_CHAR     ((uintptr_t)2)
+#define FIXNUM_MIN   (INT64_MIN >> 2)
+#define FIXNUM_MAX   (INT64_MAX >> 2)
+
+static inline bool is_immediate(const Cell* v)
+{
+    return ((uintptr_t)v & IMM_TAG_MASK) != 0;
+}
+
+static inline bool is_fixnum(const Cell* v)
+{
+    return ((uintptr_t)v & IMM_TAG_MASK) == IMM_FIXNUM;
+}
+
+static inline Cell_t cell_type(const Cell* v)
+{
+    if (!is_immediate(v)) return v->type;
+    return is_fixnum(v) ? CELL_INTEGER : CELL_CHAR;
+}
+
+/* Integers outside the fixnum range, and inexact ones, are boxed. */
+static inline int64_t cell_int(const Cell* v)
+{
+    return is_fixnum(v) ? (int64_t)((intptr_t)v >> 2) : v->integer_v;
+}
+
+static inline UChar32 cell_char(const Cell* v)
+{
+    return (UChar32)((uintptr_t)v >> 2);
+}
+
+static inline bool cell_exact(const Cell* v)
+{
+    return is_immediate(v) || v->exact;
+}
+
+/* The hash of the text of a string or symbol, computed once and cached. */
+static inline uint64_t cell_text_hash(const Cell* v)
+{
+    if (v->hash == 0 && v->type == CELL_STRING) {
+        ((Cell*)v)->hash = hash_string_key_n(v->str, (size_t)v->count);
+    }
+    return v->hash;
+}
+
+
+
 Cell* make_cell_nil(void);
 Cell* make_cell_boolean(int the_boolean);
 Cell* make_cell_eof(void);
@@ -306,7 +388,10 @@ Cell* make_cell_char(UChar32 the_char);
 Cell* make_cell_vector(void);
 Cell* make_cell_bytevector(bv_t t, size_t initial_size);
 Cell* make_cell_symbol(const char* the_symbol);
+Cell* make_cell_symbol_n(const char* name, size_t len);
 Cell* make_cell_string(const char* the_string);
+Cell* make_cell_string_n(const char* the_string, size_t len);
+Cell* make_cell_string_literal(const char* the_string);
 Cell* make_cell_sexpr(void);
 Cell* make_cell_bigint(const char* s, const Cell* a, uint8_t base);
 Cell* make_cell_bigfloat(const char* s);
@@ -314,12 +399,15 @@ Cell* make_cell_pair(Cell* car, Cell* cdr);
 Cell* make_cell_error(const char* error_string, err_t error_type);
 Cell* make_cell_file_port(const char* path, FILE* fh, stream_t stream, backend_t backend);
 Cell* make_cell_memory_port(stream_t stream, backend_t backend);
+Cell* make_cell_mapped_port(const char* path, struct FileMap* map, backend_t backend);
 Cell* make_cell_promise(Cell* expr, Lex* env);
 Cell* make_cell_stream(Cell* head, Cell* tail_promise);
 Cell* make_cell_set(const Cell* values);
 Cell* make_cell_hash(const Cell* values);
 Cell* cell_add(Cell* v, Cell* x);
+void cell_reserve(Cell* v, int n);
 Cell* cell_copy(const Cell* v);
+Cell* cell_set_exact(Cell* v, bool exact);
 Cell* make_cell_bytevector_u8(void);
 Cell* byte_add(Cell* bv, int64_t value);
 
@@ -47,7 +47,7 @@ Cell* builtin_char_to_int(const Lex* e, const Cell* a)
     err = check_arg_types(a, CELL_CHAR, "char->integer");
     if (err) return err;
 
-    return make_cell_integer(a->cell[0]->char_v);
+    return make_cell_integer(cell_char(a->cell[0]));
 }
 
 
@@ -62,7 +62,7 @@ Cell* builtin_int_to_char(const Lex* e, const Cell* a)
     err = check_arg_types(a, CELL_INTEGER, "integer->char");
     if (err) return err;
 
-    const UChar32 val = (int)a->cell[0]->integer_v;
+    const UChar32 val = (int)cell_int(a->cell[0]);
     if (val >= 0xD800 && val <= 0xDFFF) {
         return make_cell_error(
             "integer->char: invalid code point (surrogate)",
@@ -90,7 +90,7 @@ Cell* builtin_char_equal_pred(const Lex* e, const Cell* a)
 
     Cell** cells = GC_MALLOC(sizeof(Cell*) * a->count);
     for (int i = 0; i < a->count; i++) {
-        cells[i] = make_cell_integer(a->cell[i]->char_v);
+        cells[i] = make_cell_integer(cell_char(a->cell[i]));
     }
 
     const Cell* cell_sexpr = make_sexpr_from_array(a->count, cells);
@@ -107,7 +107,7 @@ Cell* builtin_char_lt_pred(const Lex* e, const Cell* a)
 
     Cell** cells = GC_MALLOC(sizeof(Cell*) * a->count);
     for (int i = 0; i < a->count; i++) {
-        cells[i] = make_cell_integer(a->cell[i]->char_v);
+        cells[i] = make_cell_integer(cell_char(a->cell[i]));
     }
 
     const Cell* cell_sexpr = make_sexpr_from_array(a->count, cells);
@@ -124,7 +124,7 @@ Cell* builtin_char_lte_pred(const Lex* e, const Cell* a)
 
     Cell** cells = GC_MALLOC(sizeof(Cell*) * a->count);
     for (int i = 0; i < a->count; i++) {
-        cells[i] = make_cell_integer(a->cell[i]->char_v);
+        cells[i] = make_cell_integer(cell_char(a->cell[i]));
     }
 
     const Cell* cell_sexpr = make_sexpr_from_array(a->count, cells);
@@ -141,7 +141,7 @@ Cell* builtin_char_gt_pred(const Lex* e, const Cell* a)
 
     Cell** cells = GC_MALLOC(sizeof(Cell*) * a->count);
     for (int i = 0; i < a->count; i++) {
-        cells[i] = make_cell_integer(a->cell[i]->char_v);
+        cells[i] = make_cell_integer(cell_char(a->cell[i]));
     }
 
     const Cell* cell_sexpr = make_sexpr_from_array(a->count, cells);
@@ -158,7 +158,7 @@ Cell* builtin_char_gte_pred(const Lex* e, const Cell* a)
 
     Cell** cells = GC_MALLOC(sizeof(Cell*) * a->count);
     for (int i = 0; i < a->count; i++) {
-        cells[i] = make_cell_integer(a->cell[i]->char_v);
+        cells[i] = make_cell_integer(cell_char(a->cell[i]));
     }
 
     const Cell* cell_sexpr = make_sexpr_from_array(a->count, cells);
@@ -180,12 +180,12 @@ Cell* builtin_char_alphabetic(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "char-alphabetic?");
     if (err) return err;
-    if (a->cell[0]->type != CELL_CHAR) {
+    if (cell_type(a->cell[0]) != CELL_CHAR) {
         return make_cell_error(
             "char-alphabetic?: arg 1 must be a char",
             TYPE_ERR);
     }
-    return make_cell_boolean(u_isalpha(a->cell[0]->char_v));
+    return make_cell_boolean(u_isalpha(cell_char(a->cell[0])));
 }
 
 
@@ -195,12 +195,12 @@ Cell* builtin_char_whitespace(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "char-whitespace?");
     if (err) return err;
-    if (a->cell[0]->type != CELL_CHAR) {
+    if (cell_type(a->cell[0]) != CELL_CHAR) {
         return make_cell_error(
             "char-whitespace?: arg 1 must be a char",
             TYPE_ERR);
     }
-    return make_cell_boolean(u_isspace(a->cell[0]->char_v));
+    return make_cell_boolean(u_isspace(cell_char(a->cell[0])));
 }
 
 
@@ -210,12 +210,12 @@ Cell* builtin_char_numeric(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "char-numeric?");
     if (err) return err;
-    if (a->cell[0]->type != CELL_CHAR) {
+    if (cell_type(a->cell[0]) != CELL_CHAR) {
         return make_cell_error(
             "char-numeric?: arg 1 must be a char",
             TYPE_ERR);
     }
-    return make_cell_boolean(u_isdigit(a->cell[0]->char_v));
+    return make_cell_boolean(u_isdigit(cell_char(a->cell[0])));
 }
 
 
@@ -225,12 +225,12 @@ Cell* builtin_char_upper_case(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "char-upper-case?");
     if (err) return err;
-    if (a->cell[0]->type != CELL_CHAR) {
+    if (cell_type(a->cell[0]) != CELL_CHAR) {
         return make_cell_error(
             "char-upper-case?: arg 1 must be a char",
             TYPE_ERR);
     }
-    return make_cell_boolean(u_isupper(a->cell[0]->char_v));
+    return make_cell_boolean(u_isupper(cell_char(a->cell[0])));
 }
 
 
@@ -239,12 +239,12 @@ Cell* builtin_char_lower_case(const Lex* e, const Cell* a) {
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "char-lower-case?");
     if (err) return err;
-    if (a->cell[0]->type != CELL_CHAR) {
+    if (cell_type(a->cell[0]) != CELL_CHAR) {
         return make_cell_error(
             "char-lower-case?: arg 1 must be a char",
             TYPE_ERR);
     }
-    return make_cell_boolean(u_islower(a->cell[0]->char_v));
+    return make_cell_boolean(u_islower(cell_char(a->cell[0])));
 }
 
 
@@ -258,12 +258,12 @@ Cell* builtin_char_upcase(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "char-upcase");
     if (err) return err;
-    if (a->cell[0]->type != CELL_CHAR) {
+    if (cell_type(a->cell[0]) != CELL_CHAR) {
         return make_cell_error(
             "char-upcase: arg 1 must be a char",
             TYPE_ERR);
     }
-    return make_cell_char(u_toupper(a->cell[0]->char_v));
+    return make_cell_char(u_toupper(cell_char(a->cell[0])));
 }
 
 
@@ -277,12 +277,12 @@ Cell* builtin_char_downcase(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "char-downcase");
     if (err) return err;
-    if (a->cell[0]->type != CELL_CHAR) {
+    if (cell_type(a->cell[0]) != CELL_CHAR) {
         return make_cell_error(
             "char-downcase: arg 1 must be a char",
             TYPE_ERR);
     }
-    return make_cell_char(u_tolower(a->cell[0]->char_v));
+    return make_cell_char(u_tolower(cell_char(a->cell[0])));
 }
 
 
@@ -296,12 +296,12 @@ Cell* builtin_char_foldcase(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "char-foldcase");
     if (err) return err;
-    if (a->cell[0]->type != CELL_CHAR) {
+    if (cell_type(a->cell[0]) != CELL_CHAR) {
         return make_cell_error(
             "char-foldcase: arg 1 must be a char",
             TYPE_ERR);
     }
-    const unsigned char c = a->cell[0]->char_v;
+    const unsigned char c = cell_char(a->cell[0]);
     return make_cell_char(u_foldCase(c, U_FOLD_CASE_DEFAULT));
 }
 
@@ -314,13 +314,13 @@ Cell* builtin_digit_value(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "digit-value");
     if (err) return err;
-    if (a->cell[0]->type != CELL_CHAR) {
+    if (cell_type(a->cell[0]) != CELL_CHAR) {
         return make_cell_error(
             "digit-value: arg 1 must be a char",
             TYPE_ERR);
     }
 
-    const int32_t value = u_charDigitValue(a->cell[0]->char_v);
+    const int32_t value = u_charDigitValue(cell_char(a->cell[0]));
 
     if (value == -1) {
         return False_Obj;
@@ -344,7 +344,7 @@ Cell* builtin_char_equal_ci(const Lex* e, const Cell* a)
     for (int i = 0; i < a->count; i++) {
         const Cell* the_char = a->cell[i];
         const Cell* the_char_fc = builtin_char_foldcase(e, make_sexpr_len1(the_char));
-        cells[i] = make_cell_integer(the_char_fc->char_v);
+        cells[i] = make_cell_integer(cell_char(the_char_fc));
     }
 
     const Cell* cell_sexpr = make_sexpr_from_array(a->count, cells);
@@ -363,7 +363,7 @@ Cell* builtin_char_lt_ci(const Lex* e, const Cell* a)
     for (int i = 0; i < a->count; i++) {
         const Cell* the_char = a->cell[i];
         const Cell* the_char_fc = builtin_char_foldcase(e, make_sexpr_len1(the_char));
-        cells[i] = make_cell_integer(the_char_fc->char_v);
+        cells[i] = make_cell_integer(cell_char(the_char_fc));
     }
 
     const Cell* cell_sexpr = make_sexpr_from_array(a->count, cells);
@@ -382,7 +382,7 @@ Cell* builtin_char_lte_ci(const Lex* e, const Cell* a)
     for (int i = 0; i < a->count; i++) {
         const Cell* the_char = a->cell[i];
         const Cell* the_char_fc = builtin_char_foldcase(e, make_sexpr_len1(the_char));
-        cells[i] = make_cell_integer(the_char_fc->char_v);
+        cells[i] = make_cell_integer(cell_char(the_char_fc));
     }
 
     const Cell* cell_sexpr = make_sexpr_from_array(a->count, cells);
@@ -401,7 +401,7 @@ Cell* builtin_char_gt_ci(const Lex* e, const Cell* a)
     for (int i = 0; i < a->count; i++) {
         const Cell* the_char = a->cell[i];
         const Cell* the_char_fc = builtin_char_foldcase(e, make_sexpr_len1(the_char));
-        cells[i] = make_cell_integer(the_char_fc->char_v);
+        cells[i] = make_cell_integer(cell_char(the_char_fc));
     }
 
     const Cell* cell_sexpr = make_sexpr_from_array(a->count, cells);
@@ -420,7 +420,7 @@ Cell* builtin_char_gte_ci(const Lex* e, const Cell* a)
     for (int i = 0; i < a->count; i++) {
         const Cell* the_char = a->cell[i];
         const Cell* the_char_fc = builtin_char_foldcase(e, make_sexpr_len1(the_char));
-        cells[i] = make_cell_integer(the_char_fc->char_v);
+        cells[i] = make_cell_integer(cell_char(the_char_fc));
     }
 
     const Cell* cell_sexpr = make_sexpr_from_array(a->count, cells);
@@ -49,11 +49,27 @@ static int complex_eq_op(const Lex* e, const Cell* lhs, const Cell* rhs)
  * results. The safe approach is to either cross-multiply using 64-bit intermediates with overflow detection,
  * or to normalise both rationals to a common denominator using GMP arithmetic before comparing. */
 
+/* Fast path for the common case of comparing two fixnums, or two reals,
+ * which needs no type checking or promotion. */
+#define COMPARE_FAST_PATH(a, op) do { \
+    if ((a)->count == 2) { \
+        const Cell* x_ = (a)->cell[0]; \
+        const Cell* y_ = (a)->cell[1]; \
+        if (is_fixnum(x_) && is_fixnum(y_)) { \
+            return cell_int(x_) op cell_int(y_) ? True_Obj : False_Obj; \
+        } \
+        if (cell_type(x_) == CELL_REAL && cell_type(y_) == CELL_REAL) { \
+            return x_->real_v op y_->real_v ? True_Obj : False_Obj; \
+        } \
+    } \
+} while (0)
+
 /* (= z1 z2 z3 ...)
  * Returns true if all arguments are equal. */
 Cell* builtin_eq_op(const Lex* e, const Cell* a)
 {
     (void)e;
+    COMPARE_FAST_PATH(a, ==);
     Cell* err = check_arg_types(a,
         CELL_INTEGER|CELL_REAL|CELL_RATIONAL|CELL_COMPLEX|CELL_BIGINT,
         "=");
@@ -64,9 +80,9 @@ Cell* builtin_eq_op(const Lex* e, const Cell* a)
         Cell* rhs = a->cell[i+1];
         numeric_promote(&lhs, &rhs);
 
-        switch (lhs->type) {
+        switch (cell_type(lhs)) {
             case CELL_INTEGER:
-                if (lhs->integer_v == rhs->integer_v) { the_same = 1; }
+                if (cell_int(lhs) == cell_int(rhs)) { the_same = 1; }
                 break;
             case CELL_RATIONAL:
                 if (lhs->den == rhs->den && lhs->num == rhs->num) { the_same = 1; }
@@ -96,6 +112,7 @@ Cell* builtin_eq_op(const Lex* e, const Cell* a)
 Cell* builtin_gt_op(const Lex* e, const Cell* a)
 {
     (void)e;
+    COMPARE_FAST_PATH(a, >);
     Cell* err = check_arg_types(a,
         CELL_INTEGER|CELL_REAL|CELL_RATIONAL|CELL_BIGINT,
         ">");
@@ -105,9 +122,9 @@ Cell* builtin_gt_op(const Lex* e, const Cell* a)
         Cell* lhs = a->cell[i];
         Cell* rhs = a->cell[i+1];
         numeric_promote(&lhs, &rhs);
-        switch (lhs->type) {
+        switch (cell_type(lhs)) {
             case CELL_INTEGER: {
-                if (lhs->integer_v > rhs->integer_v) { ok = 1; }
+                if (cell_int(lhs) > cell_int(rhs)) { ok = 1; }
                 break;
             }
             case CELL_REAL: {
@@ -137,6 +154,7 @@ Cell* builtin_gt_op(const Lex* e, const Cell* a)
 Cell* builtin_lt_op(const Lex* e, const Cell* a)
 {
     (void)e;
+    COMPARE_FAST_PATH(a, <);
     Cell* err = check_arg_types(a,
         CELL_INTEGER|CELL_REAL|CELL_RATIONAL|CELL_BIGINT,
         "<");
@@ -146,9 +164,9 @@ Cell* builtin_lt_op(const Lex* e, const Cell* a)
         Cell* lhs = a->cell[i];
         Cell* rhs = a->cell[i+1];
         numeric_promote(&lhs, &rhs);
-        switch (lhs->type) {
+        switch (cell_type(lhs)) {
             case CELL_INTEGER: {
-                if (lhs->integer_v < rhs->integer_v) { ok = 1; }
+                if (cell_int(lhs) < cell_int(rhs)) { ok = 1; }
                 break;
             }
             case CELL_REAL: {
@@ -178,6 +196,7 @@ Cell* builtin_lt_op(const Lex* e, const Cell* a)
 Cell* builtin_gte_op(const Lex* e, const Cell* a)
 {
     (void)e;
+    COMPARE_FAST_PATH(a, >=);
     Cell* err = check_arg_types(a,
         CELL_INTEGER|CELL_REAL|CELL_RATIONAL|CELL_BIGINT,
         ">=");
@@ -187,9 +206,9 @@ Cell* builtin_gte_op(const Lex* e, const Cell* a)
         Cell* lhs = a->cell[i];
         Cell* rhs = a->cell[i+1];
         numeric_promote(&lhs, &rhs);
-        switch (lhs->type) {
+        switch (cell_type(lhs)) {
             case CELL_INTEGER: {
-                if (lhs->integer_v >= rhs->integer_v) { ok = 1; }
+                if (cell_int(lhs) >= cell_int(rhs)) { ok = 1; }
                 break;
             }
             case CELL_REAL: {
@@ -219,6 +238,7 @@ Cell* builtin_gte_op(const Lex* e, const Cell* a)
 Cell* builtin_lte_op(const Lex* e, const Cell* a)
 {
     (void)e;
+    COMPARE_FAST_PATH(a, <=);
     Cell* err = check_arg_types(a,
         CELL_INTEGER|CELL_REAL|CELL_RATIONAL|CELL_BIGINT,
         "<=");
@@ -228,9 +248,9 @@ Cell* builtin_lte_op(const Lex* e, const Cell* a)
         Cell* lhs = a->cell[i];
         Cell* rhs = a->cell[i+1];
         numeric_promote(&lhs, &rhs);
-        switch (lhs->type) {
+        switch (cell_type(lhs)) {
             case CELL_INTEGER: {
-                if (lhs->integer_v <= rhs->integer_v) { ok = 1; }
+                if (cell_int(lhs) <= cell_int(rhs)) { ok = 1; }
                 break;
             }
             case CELL_REAL: {
@@ -293,19 +313,19 @@ Cell* builtin_eqv(const Lex* e, const Cell* a)
     const Cell* x = a->cell[0];
     const Cell* y = a->cell[1];
 
-    if (x->type != y->type) return False_Obj;
+    if (cell_type(x) != cell_type(y)) return False_Obj;
 
     /* Just kick numbers over to '='. */
     // ReSharper disable once CppVariableCanBeMadeConstexpr
     const int mask = CELL_INTEGER|CELL_REAL|CELL_RATIONAL|CELL_COMPLEX|CELL_BIGINT;
-    if (x->type & mask) {
+    if (cell_type(x) & mask) {
         return builtin_eq_op(e, make_sexpr_len2(x, y));
     }
 
-    switch (x->type) {
+    switch (cell_type(x)) {
         case CELL_BOOLEAN: return make_cell_boolean(x->boolean_v == y->boolean_v);
-        case CELL_CHAR: return make_cell_boolean(x->char_v == y->char_v);
-        case CELL_NIL: return make_cell_boolean(y->type == CELL_NIL);
+        case CELL_CHAR: return make_cell_boolean(cell_char(x) == cell_char(y));
+        case CELL_NIL: return make_cell_boolean(cell_type(y) == CELL_NIL);
         default: return make_cell_boolean(x == y); /* Fall back to identity. */
     }
 }
@@ -318,8 +338,8 @@ static Cell* val_equal(const Lex* e, Cell* x, Cell* y);
 static Cell* check_if_lists_are_equal_recursive(const Lex* e, Cell* x, Cell* y, Cell* visited) {
     /* Base Cases. */
     if (x == y) return True_Obj;
-    if (x->type != y->type) return False_Obj;
-    if (x->type != CELL_PAIR) {
+    if (cell_type(x) != cell_type(y)) return False_Obj;
+    if (cell_type(x) != CELL_PAIR) {
         /* If at the end of the list structure (could be NIL or an improper tail)
          * Use the main val_equal to handle the final tail values. */
         return val_equal(e, x, y);
@@ -329,7 +349,7 @@ static Cell* check_if_lists_are_equal_recursive(const Lex* e, Cell* x, Cell* y,
      * If this specific pair of pairs have already been compared,
      * assume they are equal to break the infinite recursion. */
     const Cell* v = visited;
-    while (v->type == CELL_PAIR) {
+    while (cell_type(v) == CELL_PAIR) {
         const Cell* comparison = v->car;
         if (comparison->car == x && comparison->cdr == y) return True_Obj;
         v = v->cdr;
@@ -359,23 +379,23 @@ static Cell* val_equal(const Lex* e, Cell* x, Cell* y)
     /* Just kick numbers over to '='. */
     // ReSharper disable once CppVariableCanBeMadeConstexpr
     const int mask = CELL_INTEGER|CELL_REAL|CELL_RATIONAL|CELL_COMPLEX|CELL_BIGINT;
-    if (x->type & mask) {
+    if (cell_type(x) & mask) {
         /* 2 != 2.0, but 2 = 2/1. */
-        if (x->exact != y->exact) {
+        if (!(cell_type(y) & mask) || cell_exact(x) != cell_exact(y)) {
             return False_Obj;
         }
         return builtin_eq_op(e, make_sexpr_len2(x, y));
     }
 
     /* Do the type test AFTER dispatching numeric types to = */
-    if (x->type != y->type) { return False_Obj; }
+    if (cell_type(x) != cell_type(y)) { return False_Obj; }
 
-    switch (x->type) {
+    switch (cell_type(x)) {
         case CELL_BOOLEAN: return make_cell_boolean(x->boolean_v == y->boolean_v);
-        case CELL_CHAR: return make_cell_boolean(x->char_v == y->char_v);
+        case CELL_CHAR: return make_cell_boolean(cell_char(x) == cell_char(y));
         case CELL_SYMBOL: return make_cell_boolean(strcmp(x->sym, y->sym) == 0);
         case CELL_STRING: return make_cell_boolean(strcmp(x->str, y->str) == 0);
-        case CELL_NIL: return make_cell_boolean(y->type == CELL_NIL);
+        case CELL_NIL: return make_cell_boolean(cell_type(y) == CELL_NIL);
         case CELL_BYTEVECTOR:
             if (x->bv->type != y->bv->type || x->count != y->count) {
                 return False_Obj;
@@ -19,6 +19,9 @@
 
 #include "config.h"
 #include "load_library.h"
+#include "runner.h"
+#include "repr.h"
+#include "file_map.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -31,6 +34,7 @@
 
 
 char *cozenage_history_path = nullptr;
+char *cozenage_cache_path = nullptr;
 
 void load_initial_libraries(const Lex* e, const lib_load_config load_libs) {
     if (load_libs.file) {
@@ -60,6 +64,55 @@ void load_initial_libraries(const Lex* e, const lib_load_config load_libs) {
 }
 
 
+/* Prelude files named with -p, in the order given. */
+static const char** prelude_files = nullptr;
+static int prelude_count = 0;
+
+void add_prelude(const char* path)
+{
+    prelude_files = GC_REALLOC(prelude_files, sizeof(char*) * (prelude_count + 1));
+    prelude_files[prelude_count++] = GC_strdup(path);
+}
+
+
+/* Evaluate one prelude file in the global environment. A prelude
+ * which is missing, or raises an error, is fatal. */
+static void load_prelude(Lex* e, const char* path)
+{
+    const char* file = tilde_expand(path);
+    file_map_t source;
+    if (!file_map_open(file, &source)) {
+        fprintf(stderr, "Fatal: could not open and read prelude '%s': %s\n", file, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    const Cell* result = eval_source(e, source.data);
+    file_map_close(&source);
+    if (cell_type(result) == CELL_ERROR) {
+        fprintf(stderr, "In prelude '%s':\n%s\n", file, cell_to_string(result, MODE_REPL));
+        exit(EXIT_FAILURE);
+    }
+}
+
+
+/* Evaluate the files listed in $COZENAGE_PRELUDE (colon-separated), then
+ * those given with -p. Their expanded code is kept in the code cache, so
+ * after the first run a prelude costs little more than its evaluation. */
+void load_preludes(Lex* e)
+{
+    const char* env = getenv("COZENAGE_PRELUDE");
+    if (env && *env) {
+        char* paths = GC_strdup(env);
+        char* save = nullptr;
+        for (const char* p = strtok_r(paths, ":", &save); p; p = strtok_r(nullptr, ":", &save)) {
+            load_prelude(e, p);
+        }
+    }
+    for (int i = 0; i < prelude_count; i++) {
+        load_prelude(e, prelude_files[i]);
+    }
+}
+
+
 void init_history_path() {
     char path[PATH_MAX];
     const char *xdg_state = getenv("XDG_STATE_HOME");
@@ -81,8 +134,31 @@ void init_history_path() {
 }
 
 
+/* Set the code cache directory, on first use. */
+void init_cache_path() {
+    if (cozenage_cache_path) return;
+
+    char path[PATH_MAX];
+    const char *xdg_cache = getenv("XDG_CACHE_HOME");
+    const char *home = getenv("HOME");
+
+    if (xdg_cache && strlen(xdg_cache) > 0) {
+        /* Use $XDG_CACHE_HOME/cozenage/fasl */
+        snprintf(path, sizeof(path), "%s/cozenage/fasl", xdg_cache);
+    } else if (home) {
+        /* Fallback to ~/.cache/cozenage/fasl */
+        snprintf(path, sizeof(path), "%s/.cache/cozenage/fasl", home);
+    } else {
+        /* Absolute emergency fallback. */
+        strncpy(path, "/tmp/cozenage_fasl", sizeof(path));
+    }
+
+    cozenage_cache_path = strdup(path);
+}
+
+
 /* TODO: incorporate this into file library. */
-static int mkdir_p(const char *path) {
+int mkdir_p(const char *path) {
     char temp[PATH_MAX];
 
     snprintf(temp, sizeof(temp), "%s", path);
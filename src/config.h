@@ -22,8 +22,9 @@
 
 #include "environment.h"
 
-/* Global variable to hold the history path. */
+/* Global variables to hold the history path, and code cache directory. */
 extern char *cozenage_history_path;
+extern char *cozenage_cache_path;
 
 
 typedef struct lib_load {
@@ -38,8 +39,12 @@ typedef struct lib_load {
 } lib_load_config;
 
 void load_initial_libraries(const Lex* e, lib_load_config load_libs);
+void add_prelude(const char* path);
+void load_preludes(Lex* e);
 void init_history_path();
+void init_cache_path();
 void setup_history();
+int mkdir_p(const char *path);
 /* Path expansion. */
 char* tilde_expand(const char* path);
 
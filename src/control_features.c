@@ -25,6 +25,8 @@
 #include "lexer.h"
 #include "repl.h"
 #include "repr.h"
+#include "fold.h"
+#include "file_map.h"
 
 #include <stdlib.h>
 #include <gc/gc.h>
@@ -51,10 +53,10 @@ Cell* builtin_eval(const Lex* e, const Cell* a)
     if (err) return err;
     Cell* args;
     /* Convert list to s-expr if we are handed a quote. */
-    if (a->cell[0]->type == CELL_PAIR) {
+    if (cell_type(a->cell[0]) == CELL_PAIR) {
         args = make_sexpr_from_list(a->cell[0], false);
         for (int i = 0; i < args->count; i++ ) {
-            if (args->cell[i]->type == CELL_PAIR && args->cell[i]->len != -1) {
+            if (cell_type(args->cell[i]) == CELL_PAIR && args->cell[i]->len != -1) {
                 Cell* tmp = args->cell[i];
                 args->cell[i] = make_sexpr_from_list(tmp, false);
             }
@@ -76,7 +78,7 @@ Cell* builtin_apply(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_MIN(a, 2, "apply");
     if (err) return err;
-    if (a->cell[0]->type != CELL_PROC) {
+    if (cell_type(a->cell[0]) != CELL_PROC) {
         return make_cell_error(
             "apply: arg 1 must be a procedure",
             TYPE_ERR);
@@ -91,13 +93,13 @@ Cell* builtin_apply(const Lex* e, const Cell* a)
     }
     const Cell* final_list = a->cell[last_arg_index];
     /* Ensure last arg is a list. */
-    if (final_list->type != CELL_PAIR || final_list->len == -1) {
+    if (cell_type(final_list) != CELL_PAIR || final_list->len == -1) {
         return make_cell_error(
             "apply: last arg must be a proper list",
             TYPE_ERR);
     }
     const Cell* current_item = final_list;
-    while (current_item->type != CELL_NIL) {
+    while (cell_type(current_item) != CELL_NIL) {
         cell_add(final_sexpr, current_item->car);
         current_item = current_item->cdr;
     }
@@ -121,7 +123,7 @@ Cell* builtin_map(const Lex* e, const Cell* a)
     if (err) return err;
 
     const Cell* proc = a->cell[0];
-    if (proc->type != CELL_PROC)
+    if (cell_type(proc) != CELL_PROC)
         return make_cell_error(
             "map: arg 1 must be a procedure",
             TYPE_ERR);
@@ -137,12 +139,12 @@ Cell* builtin_map(const Lex* e, const Cell* a)
         Cell* lst = a->cell[i + 1];
 
         /* Dirty kludge to get some macros to work. */
-        if (lst->type == CELL_SEXPR) {
+        if (cell_type(lst) == CELL_SEXPR) {
             lst = make_list_from_sexpr(lst);
         }
 
-        if (lst->type == CELL_NIL) return make_cell_nil();
-        if (lst->type != CELL_PAIR) {
+        if (cell_type(lst) == CELL_NIL) return make_cell_nil();
+        if (cell_type(lst) != CELL_PAIR) {
             return make_cell_error(
                 fmt_err("map: arg %d must be a proper list", i+2),
                 TYPE_ERR);
@@ -155,12 +157,12 @@ Cell* builtin_map(const Lex* e, const Cell* a)
             /* If this call fails, it's because lst is an improper list,
              * so we'll return an appropriate error message, rather than
              * the error from list_length(); */
-            if (len_obj->type == CELL_ERROR) {
+            if (cell_type(len_obj) == CELL_ERROR) {
                 return make_cell_error(
                 fmt_err("map: arg %d must be a proper list", i+2),
                 TYPE_ERR);
             }
-            lst->len = (int)len_obj->integer_v;
+            lst->len = (int)cell_int(len_obj);
         }
 
         if (lst->len < shortest_len) shortest_len = lst->len;
@@ -191,7 +193,7 @@ Cell* builtin_map(const Lex* e, const Cell* a)
             val = coz_apply_and_get_val(proc, args_sexpr, (Lex*)e);
         }
 
-        if (val && val->type == CELL_ERROR) return val;
+        if (val && cell_type(val) == CELL_ERROR) return val;
         /* Ignore unspecified results. */
         if (val == USP_Obj) continue;
 
@@ -221,14 +223,14 @@ Cell* builtin_vector_map(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_MIN(a, 2, "vector-map");
     if (err) return err;
-    if (a->cell[0]->type != CELL_PROC) {
+    if (cell_type(a->cell[0]) != CELL_PROC) {
         return make_cell_error(
             "vector-map: arg 1 must be a procedure",
             TYPE_ERR);
     }
     int shortest_vec_length = INT32_MAX;
     for (int i = 1; i < a->count; i++) {
-        if (a->cell[i]->type != CELL_VECTOR) {
+        if (cell_type(a->cell[i]) != CELL_VECTOR) {
             return make_cell_error(
                 fmt_err("vector-map: arg %d must be a vector", i+1),
                 TYPE_ERR);
@@ -270,7 +272,7 @@ Cell* builtin_vector_map(const Lex* e, const Cell* a)
          * after replacing all 'legitimate' null returns with USP_Obj. */
         if (!tmp_result) continue;
         if (tmp_result == USP_Obj) continue;
-        if (tmp_result->type == CELL_ERROR) {
+        if (cell_type(tmp_result) == CELL_ERROR) {
             /* Propagate any evaluation errors */
             return tmp_result;
         }
@@ -293,7 +295,7 @@ Cell* builtin_string_map(const Lex* e, const Cell* a)
     if (err) return err;
 
     const Cell* proc = a->cell[0];
-    if (proc->type != CELL_PROC)
+    if (cell_type(proc) != CELL_PROC)
         return make_cell_error(
             "string-map: arg 1 must be a procedure",
             TYPE_ERR);
@@ -307,7 +309,7 @@ Cell* builtin_string_map(const Lex* e, const Cell* a)
 
     for (int i = 0; i < num_strings; i++) {
         const Cell* s = a->cell[i + 1];
-        if (s->type != CELL_STRING)
+        if (cell_type(s) != CELL_STRING)
             return make_cell_error(
                 fmt_err("string-map: arg %d must be a string", i+2),
                 TYPE_ERR);
@@ -347,13 +349,13 @@ Cell* builtin_string_map(const Lex* e, const Cell* a)
         }
 
         if (!val) return nullptr;
-        if (val->type == CELL_ERROR) return val;
-        if (val->type != CELL_CHAR)
+        if (cell_type(val) == CELL_ERROR) return val;
+        if (cell_type(val) != CELL_CHAR)
             return make_cell_error(
                 "string-map: procedure must return a char",
                 TYPE_ERR);
 
-        const UChar32 res_c = val->char_v;
+        const UChar32 res_c = cell_char(val);
         res_chars[i] = res_c;
         const int b_len = utf8_code_point_len(res_c);
         total_bytes += b_len;
@@ -377,6 +379,7 @@ Cell* builtin_string_map(const Lex* e, const Cell* a)
     v->count = total_bytes;
     v->char_count = shortest_len;
     v->ascii = is_ascii;
+    v->hash = 0;
 
     return v;
 }
@@ -392,7 +395,7 @@ Cell* builtin_foreach(const Lex* e, const Cell* a)
     if (err) return err;
 
     const Cell* proc = a->cell[0];
-    if (proc->type != CELL_PROC)
+    if (cell_type(proc) != CELL_PROC)
         return make_cell_error(
             "for-each: arg 1 must be a procedure",
             TYPE_ERR);
@@ -404,10 +407,10 @@ Cell* builtin_foreach(const Lex* e, const Cell* a)
     const Cell** cursors = GC_MALLOC(sizeof(Cell*) * num_lists);
     for (int i = 0; i < num_lists; i++) {
         Cell* lst = a->cell[i + 1];
-        if (lst->type == CELL_NIL) return USP_Obj;
+        if (cell_type(lst) == CELL_NIL) return USP_Obj;
 
         /* Ensure all list args are lists. */
-        if (lst->type != CELL_PAIR) {
+        if (cell_type(lst) != CELL_PAIR) {
             return make_cell_error(
                 fmt_err("map: arg %d must be a proper list", i+2),
                 TYPE_ERR);
@@ -418,13 +421,13 @@ Cell* builtin_foreach(const Lex* e, const Cell* a)
             const Cell* len_obj = builtin_list_length(e, make_sexpr_len1(lst));
 
             /* If this is an error, it means the list arg is improper or circular. */
-            if (len_obj->type == CELL_ERROR) {
+            if (cell_type(len_obj) == CELL_ERROR) {
                 return make_cell_error(
                 fmt_err("map: arg %d must be a proper list", i+2),
                 TYPE_ERR);
             }
 
-            lst->len = (int)len_obj->integer_v;
+            lst->len = (int)cell_int(len_obj);
         }
         if (lst->len < shortest_len) shortest_len = lst->len;
         cursors[i] = lst;
@@ -446,7 +449,7 @@ Cell* builtin_foreach(const Lex* e, const Cell* a)
         }
 
         /* If the procedure returns an error, stop and propagate it. */
-        if (val && val->type == CELL_ERROR) return val;
+        if (val && cell_type(val) == CELL_ERROR) return val;
     }
     return USP_Obj;
 }
@@ -462,7 +465,7 @@ Cell* builtin_vector_foreach(const Lex* e, const Cell* a)
     if (err) return err;
 
     const Cell* proc = a->cell[0];
-    if (proc->type != CELL_PROC)
+    if (cell_type(proc) != CELL_PROC)
         return make_cell_error(
             "vector-for-each: arg 1 must be a procedure",
             TYPE_ERR);
@@ -473,7 +476,7 @@ Cell* builtin_vector_foreach(const Lex* e, const Cell* a)
     /* Calculate the shortest length and validate types. */
     for (int i = 0; i < num_vectors; i++) {
         const Cell* v = a->cell[i + 1];
-        if (v->type != CELL_VECTOR)
+        if (cell_type(v) != CELL_VECTOR)
             return make_cell_error(
                 fmt_err("vector-for-each: arg %d must be a vector", i+2),
                 TYPE_ERR);
@@ -498,7 +501,7 @@ Cell* builtin_vector_foreach(const Lex* e, const Cell* a)
         }
 
         /* Stop execution and return if the procedure returns an error. */
-        if (tmp_result && tmp_result->type == CELL_ERROR) return tmp_result;
+        if (tmp_result && cell_type(tmp_result) == CELL_ERROR) return tmp_result;
     }
     return USP_Obj;
 }
@@ -514,7 +517,7 @@ Cell* builtin_string_foreach(const Lex* e, const Cell* a)
     if (err) return err;
 
     const Cell* proc = a->cell[0];
-    if (proc->type != CELL_PROC)
+    if (cell_type(proc) != CELL_PROC)
         return make_cell_error(
             "string-for-each: arg 1 must be a procedure",
             TYPE_ERR);
@@ -528,7 +531,7 @@ Cell* builtin_string_foreach(const Lex* e, const Cell* a)
 
     for (int i = 0; i < num_strings; i++) {
         const Cell* s = a->cell[i + 1];
-        if (s->type != CELL_STRING)
+        if (cell_type(s) != CELL_STRING)
             return make_cell_error(
                 fmt_err("string-for-each: arg %d must be a string", i+2),
                 TYPE_ERR);
@@ -560,7 +563,7 @@ Cell* builtin_string_foreach(const Lex* e, const Cell* a)
             val = coz_apply_and_get_val(proc, args_sexpr, (Lex*)e);
         }
 
-        if (val && val->type == CELL_ERROR) return val;
+        if (val && cell_type(val) == CELL_ERROR) return val;
         /* Return value is ignored in for-each. */
     }
     return USP_Obj;
@@ -575,17 +578,26 @@ Cell* builtin_load(const Lex* e, const Cell* a)
 {
     Cell* err = CHECK_ARITY_EXACT(a, 1, "load");
     if (err) return err;
-    if (a->cell[0]->type != CELL_STRING) {
+    if (cell_type(a->cell[0]) != CELL_STRING) {
         return make_cell_error(
             "load: arg must be a string",
             TYPE_ERR);
     }
     const char* file = a->cell[0]->str;
-    const char* input = read_file_to_string(file);
-    TokenArray* ta = scan_all_tokens(input);
-    const Cell* result = parse_all_expressions((Lex*)e, ta, false);
-
-    if (result && result->type == CELL_ERROR) {
+    file_map_t source;
+    if (!file_map_open(file, &source)) {
+        perror("Error opening file");
+        return False_Obj;
+    }
+    /* Count the loaded file's folds apart from those of the file loading it. */
+    const long outer_folds = fold_stats.folds;
+    fold_stats.folds = 0;
+    const Cell* result = eval_source((Lex*)e, source.data);
+    file_map_close(&source);
+    fold_stats_report(file);
+    fold_stats.folds = outer_folds;
+
+    if (result && cell_type(result) == CELL_ERROR) {
         fprintf(stderr, "%s\n", cell_to_string(result, MODE_REPL));
         return False_Obj;
     }
@@ -611,7 +623,7 @@ Cell* builtin_exit(const Lex* e, const Cell* a)
 
     /* Convert boolean value to exit success or failure. */
     if (a->count == 1) {
-        if (a->cell[0]->type == CELL_BOOLEAN) {
+        if (cell_type(a->cell[0]) == CELL_BOOLEAN) {
             const int es = a->cell[0]->boolean_v;
             if (es) {
                 exit(0); /* flip boolean 1 (#t) to exit success (0). */
@@ -619,7 +631,7 @@ Cell* builtin_exit(const Lex* e, const Cell* a)
             exit(1);
         }
         /* If not bool, int. Just return directly. */
-        exit((int)a->cell[0]->integer_v);
+        exit((int)cell_int(a->cell[0]));
     }
     exit(0); /* exit success if no arg. */
 }
@@ -27,6 +27,7 @@
 #include "pairs.h"
 #include "vectors.h"
 #include "bytevectors.h"
+#include "fvectors.h"
 #include "ports.h"
 #include "strings.h"
 #include "chars.h"
@@ -36,8 +37,11 @@
 #include "polymorph.h"
 #include "repr.h"
 #include "sets.h"
+#include "bytecode.h"
+#include "builtin_hash.h"
 
 #include <gc.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -46,7 +50,7 @@
 /* Initialize the global environment, and return a pointer to it. */
 Lex* lex_initialize_global_env(void)
 {
-    ht_table* global_env = ht_create(256);
+    ht_table* global_env = ht_create(GLOBAL_ENV_INITIAL_CAPACITY);
     Lex* e = GC_MALLOC(sizeof(Lex));
     e->local = nullptr;
     e->global = global_env;
@@ -64,6 +68,8 @@ Lex* new_child_env(const Lex* parent_env)
     e->vals = GC_MALLOC(sizeof(char*) * e->capacity);
     /* The new frame's parent is the PARENT'S LOCAL FRAME. */
     e->parent = parent_env->local;
+    e->pooled = false;
+    e->captured = false;
 
     Lex* w = GC_MALLOC(sizeof(Lex));
     w->local = e; /* The new wrapper points to the new local frame. */
@@ -72,10 +78,80 @@ Lex* new_child_env(const Lex* parent_env)
 }
 
 
+/* A recyclable frame: the wrapper, the frame, and its slot arrays in one block. */
+typedef struct Pooled_Frame {
+    Lex lex;
+    Ch_Env env;
+    char* syms[FRAME_POOL_SLOTS];
+    Cell* vals[FRAME_POOL_SLOTS];
+} Pooled_Frame;
+
+/* Released frames, chained through env.parent. */
+static Pooled_Frame* frame_pool = nullptr;
+
+
+/* Like new_child_env, but takes the frame from the frame pool. Only frames
+ * whose body the analyzer has shown creates no closures are acquired here;
+ * they go back to the pool through lex_release_frames once the body returns.
+ * Frames with more than FRAME_POOL_SLOTS bindings come from the heap. */
+Lex* lex_acquire_frame(const Lex* parent_env, const int n_slots)
+{
+    if (n_slots > FRAME_POOL_SLOTS) {
+        return new_child_env(parent_env);
+    }
+    Pooled_Frame* f = frame_pool;
+    if (f) {
+        frame_pool = (Pooled_Frame*)f->env.parent;
+    } else {
+        f = GC_MALLOC(sizeof(Pooled_Frame));
+        f->lex.local = &f->env;
+    }
+    f->env.count = 0;
+    f->env.capacity = FRAME_POOL_SLOTS;
+    f->env.syms = f->syms;
+    f->env.vals = f->vals;
+    f->env.parent = parent_env->local;
+    f->env.pooled = true;
+    f->env.captured = false;
+    f->lex.global = parent_env->global;
+    return &f->lex;
+}
+
+
+/* Return the pooled frames on e's chain to the pool, walking up from e's
+ * local frame. The walk stops at 'floor' or 'keep', which belong to the
+ * caller, and at the first heap or captured frame, as everything above
+ * such a frame may still be referenced. */
+void lex_release_frames(const Lex* e, const Ch_Env* floor, const Ch_Env* keep)
+{
+    Ch_Env* frame = e->local;
+    while (frame && frame != floor && frame != keep && frame->pooled && !frame->captured) {
+        Ch_Env* parent = frame->parent;
+        Pooled_Frame* f = (Pooled_Frame*)((char*)frame - offsetof(Pooled_Frame, env));
+        memset(f->vals, 0, sizeof(Cell*) * frame->count);
+        frame->pooled = false;
+        frame->parent = (Ch_Env*)frame_pool;
+        frame_pool = f;
+        frame = parent;
+    }
+}
+
+
+/* Mark e's local frames as captured by a closure or promise, so that they are
+ * never recycled. Frames above a captured frame are captured already. */
+void lex_capture(const Lex* e)
+{
+    if (!e) return;
+    for (Ch_Env* frame = e->local; frame && !frame->captured; frame = frame->parent) {
+        frame->captured = true;
+    }
+}
+
+
 /* Retrieve a Cell value from an environment. */
 Cell* lex_get(const Lex* e, const Cell* k)
 {
-    if (!e || !k || k->type != CELL_SYMBOL) return nullptr;
+    if (!e || !k || cell_type(k) != CELL_SYMBOL) return nullptr;
 
     /* Search the entire local environment chain iteratively. */
     const Ch_Env* current_frame = e->local;
@@ -91,7 +167,7 @@ Cell* lex_get(const Lex* e, const Cell* k)
     }
 
     /* If not found in any local frame, check the global environment. */
-    Cell* result = ht_get(e->global, k->sym);
+    Cell* result = ht_get_hashed(e->global, k->sym, k->hash);
     if (result) {
         return result;
     }
@@ -106,15 +182,27 @@ Cell* lex_get(const Lex* e, const Cell* k)
 /* Place a Cell* value into a local environment. */
 void lex_put_local(Lex* e, const Cell* k, const Cell* v)
 {
-    if (!e || !k || !v || k->type != CELL_SYMBOL) {
+    if (!e || !k || !v || cell_type(k) != CELL_SYMBOL) {
         fprintf(stderr, "lex_put: invalid arguments\n");
         return;
     }
     /* Check if we need to reallocate. */
     if (e->local->count == e->local->capacity) {
         e->local->capacity *= 2; /* Double the capacity */
-        e->local->syms = GC_REALLOC(e->local->syms, sizeof(char*) * e->local->capacity);
-        e->local->vals = GC_REALLOC(e->local->vals, sizeof(Cell*) * e->local->capacity);
+        if (e->local->pooled) {
+            /* The slots of a pooled frame live inside it, so copy them out
+             * and leave the frame to the GC. */
+            char** syms = GC_MALLOC(sizeof(char*) * e->local->capacity);
+            Cell** vals = GC_MALLOC(sizeof(Cell*) * e->local->capacity);
+            memcpy(syms, e->local->syms, sizeof(char*) * e->local->count);
+            memcpy(vals, e->local->vals, sizeof(Cell*) * e->local->count);
+            e->local->syms = syms;
+            e->local->vals = vals;
+            e->local->pooled = false;
+        } else {
+            e->local->syms = GC_REALLOC(e->local->syms, sizeof(char*) * e->local->capacity);
+            e->local->vals = GC_REALLOC(e->local->vals, sizeof(Cell*) * e->local->capacity);
+        }
         if (!e->local->syms || !e->local->vals) {
             fprintf(stderr, "ENOMEM: symbol_table_put failed\n");
             exit(EXIT_FAILURE);
@@ -138,20 +226,139 @@ void lex_put_local(Lex* e, const Cell* k, const Cell* v)
 /* Place a Cell* value in the global environment. */
 void lex_put_global(const Lex* e, const Cell* k, Cell* v)
 {
-    if (!e || !k || !v || k->type != CELL_SYMBOL) {
+    if (!e || !k || !v || cell_type(k) != CELL_SYMBOL) {
         fprintf(stderr, "lex_put: invalid arguments\n");
         return;
     }
-    ht_set(e->global, k->sym, v);
+    ht_set_hashed(e->global, k->sym, k->hash, v);
+}
+
+
+/* Update an existing binding, searching the local frames first, then the
+ * global table. Returns false if the symbol is not bound anywhere. */
+bool lex_set(const Lex* e, const Cell* k, Cell* v)
+{
+    const Ch_Env* current_frame = e->local;
+    while (current_frame != nullptr) {
+        for (int i = 0; i < current_frame->count; i++) {
+            if (strcmp(current_frame->syms[i], k->sym) == 0) {
+                current_frame->vals[i] = v;
+                return true;
+            }
+        }
+        current_frame = current_frame->parent;
+    }
+
+    /* Only update the global binding if it already exists. Updating the
+     * slot in place keeps global reference caches valid. */
+    ht_item* item = ht_get_item_hashed(e->global, k->sym, k->hash);
+    if (item) {
+        item->value = v;
+        return true;
+    }
+    return false;
+}
+
+
+/* Local frames are only ever created by lambda calls, let, and letrec, and
+ * define always binds globally, so the shape of every frame is known when the
+ * code which runs in it is analyzed. lex_resolve() finds the lexical address
+ * of a symbol in the frames of a (compile-time) scope: the number of frames
+ * to walk up, and the slot within that frame. Returns false for free symbols. */
+bool lex_resolve(const Lex* e, const Cell* k, int* depth, int* slot)
+{
+    int d = 0;
+    for (const Ch_Env* frame = e->local; frame != nullptr; frame = frame->parent) {
+        for (int i = 0; i < frame->count; i++) {
+            if (strcmp(frame->syms[i], k->sym) == 0) {
+                *depth = d;
+                *slot = i;
+                return true;
+            }
+        }
+        d++;
+    }
+    return false;
+}
+
+
+/* Walk 'depth' frames up, and check that 'slot' really holds k. The names are
+ * interned, so this is a pointer compare. */
+static Ch_Env* frame_at(const Lex* e, const Cell* k, int depth, const int slot)
+{
+    Ch_Env* frame = e->local;
+    while (depth-- > 0 && frame != nullptr) {
+        frame = frame->parent;
+    }
+    if (frame && slot < frame->count && frame->syms[slot] == k->sym) {
+        return frame;
+    }
+    return nullptr;
+}
+
+
+/* Retrieve a local by its lexical address. If the frames do not have the
+ * shape they had at analysis time, fall back to a search by name. */
+Cell* lex_get_at(const Lex* e, const Cell* k, const int depth, const int slot)
+{
+    const Ch_Env* frame = frame_at(e, k, depth, slot);
+    if (frame) {
+        return frame->vals[slot];
+    }
+    return lex_get(e, k);
+}
+
+
+/* Update a local by its lexical address, as lex_set(). */
+bool lex_set_at(const Lex* e, const Cell* k, const int depth, const int slot, Cell* v)
+{
+    const Ch_Env* frame = frame_at(e, k, depth, slot);
+    if (frame) {
+        frame->vals[slot] = v;
+        return true;
+    }
+    return lex_set(e, k, v);
+}
+
+
+/* Retrieve a symbol which is not bound in any local frame, through the
+ * reference's cache, which skips hashing and probing the table while valid. */
+Cell* lex_get_global(const Lex* e, const Cell* k, global_cache* cache)
+{
+    if (cache->item && cache->table == e->global &&
+        cache->generation == e->global->generation) {
+        return cache->item->value;
+    }
+    ht_item* item = ht_get_item_hashed(e->global, k->sym, k->hash);
+    if (item) {
+        cache->table = e->global;
+        cache->generation = e->global->generation;
+        cache->item = item;
+        return item->value;
+    }
+    return make_cell_error(
+        fmt_err("Unbound symbol: '%s'", k->sym),
+        VALUE_ERR);
+}
+
+
+global_cache* lex_make_global_cache(void)
+{
+    global_cache* cache = GC_MALLOC(sizeof(global_cache));
+    cache->table = nullptr;
+    cache->generation = 0;
+    cache->item = nullptr;
+    return cache;
 }
 
 
-/* Populate the CELL_PROC struct of a Cell* object for builtin procedures. */
+/* Populate the CELL_PROC struct of a Cell* object for builtin procedures.
+ * The name is not copied, so it must live as long as the procedure does. */
 Cell* lex_make_builtin(const char* name, Cell* (*func)(const Lex*, const Cell*))
 {
     Cell* c = GC_MALLOC(sizeof(Cell));
     c->type = CELL_PROC;
-    c->f_name = GC_strdup(name);
+    c->f_name = (char*)name;
     c->builtin = func;
     c->is_builtin = true;
     return c;
@@ -168,6 +375,9 @@ Cell* lex_make_named_lambda(char* name, Cell* formals, Cell* body, Lex* env)
     c->lambda->formals = formals;
     c->lambda->body = body;
     c->lambda->env = env;
+    lex_capture(env);
+    c->lambda->code = nullptr;
+    c->lambda->chunk = nullptr;
     c->is_builtin = false;
     return c;
 }
@@ -183,6 +393,9 @@ Cell* lex_make_lambda(Cell* formals, Cell* body, Lex* env)
     c->lambda->formals = formals;
     c->lambda->body = body;
     c->lambda->env = env;
+    lex_capture(env);
+    c->lambda->code = nullptr;
+    c->lambda->chunk = nullptr;
     c->is_builtin = false;
     return c;
 }
@@ -198,6 +411,9 @@ Cell* lex_make_defmacro(char* name, Cell* formals, Cell* body, Lex* env)
     c->lambda->formals = formals;
     c->lambda->body = body;
     c->lambda->env = env;
+    lex_capture(env);
+    c->lambda->code = nullptr;
+    c->lambda->chunk = nullptr;
     c->is_builtin = false;
     return c;
 }
@@ -211,378 +427,57 @@ Cell* builtin_print_env(const Lex* e, const Cell* a) {
 }
 
 
-/* Register a procedure in the global environment. */
+/* Register a procedure in the global environment. The procedure
+ * shares its name with the interned symbol it is bound to. */
 void lex_add_builtin(const Lex* e, const char* name, Cell* (*func)(const Lex*, const Cell*))
 {
-    Cell* fn = lex_make_builtin(name, func);
     const Cell* k = make_cell_symbol(name);
+    Cell* fn = lex_make_builtin(k->sym, func);
     lex_put_global(e, k, fn);
 }
 
 
-/* Register all builtin procedures in the global environment. */
+/* The builtin procedures, in the order of src/builtins.def. */
+#define PURE true
+#define BUILTIN(name, func, flags) {name, func, flags},
+const builtin_entry builtin_table[] = {
+#include "builtins.def"
+};
+#undef BUILTIN
+#undef PURE
+
+#define N_BUILTINS (sizeof(builtin_table) / sizeof(builtin_table[0]))
+
+_Static_assert(N_BUILTINS == BUILTIN_HASH_COUNT,
+               "src/builtin_hash.h is out of date: run 'make builtin-hash'");
+
+
+/* Find a builtin by name in the generated perfect hash, without probing.
+ * Returns null if name is not a builtin. */
+const builtin_entry* builtin_lookup(const char* name)
+{
+    const uint64_t h = hash_string_key(name);
+    const uint16_t d = builtin_hash_disp[h & (BUILTIN_HASH_BUCKETS - 1)];
+    const int i = builtin_hash_index[BUILTIN_HASH_SLOT(h, d)];
+    if (i < 0 || strcmp(builtin_table[i].name, name) != 0) {
+        return nullptr;
+    }
+    return &builtin_table[i];
+}
+
+
+/* Register all builtin procedures in the global environment.
+ * Their procedure cells are made in one block. */
 void lex_add_builtins(const Lex* e)
 {
-    /*
-     * Basic arithmetic operators.
-     *
-     */
-    lex_add_builtin(e, "+", builtin_add);
-    lex_add_builtin(e, "-", builtin_sub);
-    lex_add_builtin(e, "*", builtin_mul);
-    lex_add_builtin(e, "/", builtin_div);
-    /*
-     * Numeric comparison operators.
-     *
-     */
-    lex_add_builtin(e, "=", builtin_eq_op);
-    lex_add_builtin(e, ">", builtin_gt_op);
-    lex_add_builtin(e, "<", builtin_lt_op);
-    lex_add_builtin(e, ">=", builtin_gte_op);
-    lex_add_builtin(e, "<=", builtin_lte_op);
-    /*
-     * Numeric predicate procedures.
-     *
-     */
-    lex_add_builtin(e, "zero?", builtin_zero);
-    lex_add_builtin(e, "positive?", builtin_positive);
-    lex_add_builtin(e, "negative?", builtin_negative);
-    lex_add_builtin(e, "odd?", builtin_odd);
-    lex_add_builtin(e, "even?", builtin_even);
-    /*
-     * Equality and equivalence comparators.
-     *
-     */
-    lex_add_builtin(e, "eq?", builtin_eq);
-    lex_add_builtin(e, "eqv?", builtin_eqv);
-    lex_add_builtin(e, "equal?", builtin_equal);
-    /*
-     * Generic numeric operations.
-     *
-     */
-    lex_add_builtin(e, "abs", builtin_abs);
-    lex_add_builtin(e, "expt", builtin_expt);
-    lex_add_builtin(e, "remainder", builtin_remainder);
-    lex_add_builtin(e, "modulo", builtin_modulo);
-    lex_add_builtin(e, "quotient", builtin_quotient);
-    lex_add_builtin(e, "max", builtin_max);
-    lex_add_builtin(e, "min", builtin_min);
-    lex_add_builtin(e, "floor", builtin_floor);
-    lex_add_builtin(e, "ceiling", builtin_ceiling);
-    lex_add_builtin(e, "round", builtin_round);
-    lex_add_builtin(e, "truncate", builtin_truncate);
-    lex_add_builtin(e, "numerator", builtin_numerator);
-    lex_add_builtin(e, "denominator", builtin_denominator);
-    lex_add_builtin(e, "rationalize", builtin_rationalize);
-    lex_add_builtin(e, "square", builtin_square);
-    lex_add_builtin(e, "sqrt", builtin_sqrt);
-    lex_add_builtin(e, "exact-integer-sqrt", builtin_exact_integer_sqrt);
-    lex_add_builtin(e, "exact", builtin_exact);
-    lex_add_builtin(e, "inexact", builtin_inexact);
-    lex_add_builtin(e, "lcm", builtin_lcm);
-    lex_add_builtin(e, "gcd", builtin_gcd);
-    /*
-     * Type identity predicate procedures.
-     *
-     */
-    lex_add_builtin(e, "number?", builtin_number_pred);
-    lex_add_builtin(e, "boolean?", builtin_boolean_pred);
-    lex_add_builtin(e, "null?", builtin_null_pred);
-    lex_add_builtin(e, "pair?", builtin_pair_pred);
-    lex_add_builtin(e, "list?", builtin_list_pred);
-    lex_add_builtin(e, "procedure?", builtin_proc_pred);
-    lex_add_builtin(e, "symbol?", builtin_sym_pred);
-    lex_add_builtin(e, "string?", builtin_string_pred);
-    lex_add_builtin(e, "char?", builtin_char_pred);
-    lex_add_builtin(e, "vector?", builtin_vector_pred);
-    lex_add_builtin(e, "bytevector?", builtin_bytevector_pred);
-    lex_add_builtin(e, "port?", builtin_port_pred);
-    lex_add_builtin(e, "set?", builtin_set_pred);
-    lex_add_builtin(e, "hash?", builtin_hash_pred);
-    lex_add_builtin(e, "eof-object?", builtin_eof_pred);
-    /*
-     * Numeric identity predicate procedures.
-     *
-     */
-    lex_add_builtin(e, "exact?", builtin_exact_pred);
-    lex_add_builtin(e, "inexact?", builtin_inexact_pred);
-    lex_add_builtin(e, "complex?", builtin_complex);
-    lex_add_builtin(e, "real?", builtin_real);
-    lex_add_builtin(e, "rational?", builtin_rational);
-    lex_add_builtin(e, "integer?", builtin_integer);
-    lex_add_builtin(e, "exact-integer?", builtin_exact_integer);
-    lex_add_builtin(e, "bigint?", builtin_bigint);
-    lex_add_builtin(e, "bigfloat?", builtin_bigfloat);
-    lex_add_builtin(e, "infinite?", builtin_infinite);
-    lex_add_builtin(e, "finite?", builtin_finite);
-    lex_add_builtin(e, "nan?", builtin_nan);
-    /*
-     * Boolean and logical procedures.
-     *
-     */
-    lex_add_builtin(e, "not", builtin_not);
-    lex_add_builtin(e, "boolean=?", builtin_boolean);
-    lex_add_builtin(e, "false?", builtin_false_pred);
-    lex_add_builtin(e, "true?", builtin_true_pred);
-    /*
-     * Pair/list procedures.
-     *
-     */
-    lex_add_builtin(e, "cons", builtin_cons);
-    lex_add_builtin(e, "car", builtin_car);
-    lex_add_builtin(e, "cdr", builtin_cdr);
-    lex_add_builtin(e, "caar", builtin_caar);
-    lex_add_builtin(e, "cadr", builtin_cadr);
-    lex_add_builtin(e, "cdar", builtin_cdar);
-    lex_add_builtin(e, "cddr", builtin_cddr);
-    lex_add_builtin(e, "list", builtin_list);
-    lex_add_builtin(e, "set-car!", builtin_set_car);
-    lex_add_builtin(e, "set-cdr!", builtin_set_cdr);
-    lex_add_builtin(e, "length", builtin_list_length);
-    lex_add_builtin(e, "list-ref", builtin_list_ref);
-    lex_add_builtin(e, "append", builtin_list_append);
-    lex_add_builtin(e, "reverse", builtin_list_reverse);
-    lex_add_builtin(e, "list-tail", builtin_list_tail);
-    lex_add_builtin(e, "make-list", builtin_make_list);
-    lex_add_builtin(e, "list-set!", builtin_list_set);
-    lex_add_builtin(e, "memq", builtin_memq);
-    lex_add_builtin(e, "memv", builtin_memv);
-    lex_add_builtin(e, "member", builtin_member);
-    lex_add_builtin(e, "assq", builtin_assq);
-    lex_add_builtin(e, "assv", builtin_assv);
-    lex_add_builtin(e, "assoc", builtin_assoc);
-    lex_add_builtin(e, "list-copy", builtin_list_copy);
-    lex_add_builtin(e, "filter", builtin_filter);
-    lex_add_builtin(e, "foldl", builtin_foldl);
-    lex_add_builtin(e, "foldr", builtin_foldr);
-    lex_add_builtin(e, "zip", builtin_zip);
-    lex_add_builtin(e, "count", builtin_count);
-    lex_add_builtin(e, "count-equal", builtin_count_equal);
-    /*
-     * Vector procedures.
-     *
-     */
-    lex_add_builtin(e, "vector", builtin_vector);
-    lex_add_builtin(e, "vector-length", builtin_vector_length);
-    lex_add_builtin(e, "vector-ref", builtin_vector_ref);
-    lex_add_builtin(e, "make-vector", builtin_make_vector);
-    lex_add_builtin(e, "list->vector", builtin_list_to_vector);
-    lex_add_builtin(e, "vector->list", builtin_vector_to_list);
-    lex_add_builtin(e, "vector-copy", builtin_vector_copy);
-    lex_add_builtin(e, "vector-copy!", builtin_vector_copy_bang);
-    lex_add_builtin(e, "vector->string", builtin_vector_to_string);
-    lex_add_builtin(e, "string->vector", builtin_string_to_vector);
-    lex_add_builtin(e, "vector-set!", builtin_vector_set_bang);
-    lex_add_builtin(e, "vector-fill!", builtin_vector_fill_bang);
-    lex_add_builtin(e, "vector-append", builtin_vector_append);
-    /*
-     * Bytevector procedures.
-     *
-     */
-    lex_add_builtin(e, "bytevector", builtin_bytevector);
-    lex_add_builtin(e, "bytevector-length", builtin_bytevector_length);
-    lex_add_builtin(e, "bytevector-ref", builtin_bytevector_ref);
-    lex_add_builtin(e, "bytevector-set!", builtin_bytevector_set_bang);
-    lex_add_builtin(e, "make-bytevector", builtin_make_bytevector);
-    lex_add_builtin(e, "bytevector-copy", builtin_bytevector_copy);
-    lex_add_builtin(e, "bytevector-copy!", builtin_bytevector_copy_bang);
-    lex_add_builtin(e, "bytevector-append", builtin_bytevector_append);
-    lex_add_builtin(e, "utf8->string", builtin_utf8_string);
-    lex_add_builtin(e, "string->utf8", builtin_string_utf8);
-    /*
-     * Char procedures.
-     *
-     */
-    lex_add_builtin(e, "char->integer", builtin_char_to_int);
-    lex_add_builtin(e, "integer->char", builtin_int_to_char);
-    lex_add_builtin(e, "char=?", builtin_char_equal_pred);
-    lex_add_builtin(e, "char<?", builtin_char_lt_pred);
-    lex_add_builtin(e, "char<=?", builtin_char_lte_pred);
-    lex_add_builtin(e, "char>?", builtin_char_gt_pred);
-    lex_add_builtin(e, "char>=?", builtin_char_gte_pred);
-    lex_add_builtin(e, "char-alphabetic?", builtin_char_alphabetic);
-    lex_add_builtin(e, "char-whitespace?", builtin_char_whitespace);
-    lex_add_builtin(e, "char-numeric?", builtin_char_numeric);
-    lex_add_builtin(e, "char-upper-case?", builtin_char_upper_case);
-    lex_add_builtin(e, "char-lower-case?", builtin_char_lower_case);
-    lex_add_builtin(e, "char-upcase", builtin_char_upcase);
-    lex_add_builtin(e, "char-downcase", builtin_char_downcase);
-    lex_add_builtin(e, "char-foldcase", builtin_char_foldcase);
-    lex_add_builtin(e, "digit-value", builtin_digit_value);
-    lex_add_builtin(e, "char-ci=?", builtin_char_equal_ci);
-    lex_add_builtin(e, "char-ci<?", builtin_char_lt_ci);
-    lex_add_builtin(e, "char-ci<=?", builtin_char_lte_ci);
-    lex_add_builtin(e, "char-ci>?", builtin_char_gt_ci);
-    lex_add_builtin(e, "char-ci>=?", builtin_char_gte_ci);
-    /*
-     * Symbol and string procedures.
-     *
-     */
-    lex_add_builtin(e, "features", builtin_features);
-    lex_add_builtin(e, "symbol=?", builtin_symbol_equal_pred);
-    lex_add_builtin(e, "symbol->string", builtin_symbol_to_string);
-    lex_add_builtin(e, "string->symbol", builtin_string_to_symbol);
-    lex_add_builtin(e, "string", builtin_string);
-    lex_add_builtin(e, "string-length", builtin_string_length);
-    lex_add_builtin(e, "string=?", builtin_string_eq_pred);
-    lex_add_builtin(e, "string<?", builtin_string_lt_pred);
-    lex_add_builtin(e, "string<=?", builtin_string_lte_pred);
-    lex_add_builtin(e, "string>?", builtin_string_gt_pred);
-    lex_add_builtin(e, "string>=?", builtin_string_gte_pred);
-    lex_add_builtin(e, "string-append", builtin_string_append);
-    lex_add_builtin(e, "string-ref", builtin_string_ref);
-    lex_add_builtin(e, "make-string", builtin_make_string);
-    lex_add_builtin(e, "string->list", builtin_string_list);
-    lex_add_builtin(e, "list->string", builtin_list_string);
-    lex_add_builtin(e, "substring", builtin_substring);
-    lex_add_builtin(e, "string-set!", builtin_string_set_bang);
-    lex_add_builtin(e, "string-copy", builtin_string_copy);
-    lex_add_builtin(e, "string-copy!", builtin_string_copy_bang);
-    lex_add_builtin(e, "string-fill!", builtin_string_fill_bang);
-    lex_add_builtin(e, "string->number", builtin_string_number);
-    lex_add_builtin(e, "number->string", builtin_number_string);
-    lex_add_builtin(e, "string-downcase", builtin_string_downcase);
-    lex_add_builtin(e, "string-upcase", builtin_string_upcase);
-    lex_add_builtin(e, "string-foldcase", builtin_string_foldcase);
-    lex_add_builtin(e, "string-ci=?", builtin_string_equal_ci);
-    lex_add_builtin(e, "string-ci<?", builtin_string_lt_ci);
-    lex_add_builtin(e, "string-ci<=?", builtin_string_lte_ci);
-    lex_add_builtin(e, "string-ci>?", builtin_string_gt_ci);
-    lex_add_builtin(e, "string-ci>=?", builtin_string_gte_ci);
-    lex_add_builtin(e, "string-split", builtin_string_split);
-    /*
-     * Control features.
-     *
-     */
-    lex_add_builtin(e, "eval", builtin_eval);
-    lex_add_builtin(e, "apply", builtin_apply);
-    lex_add_builtin(e, "map", builtin_map);
-    lex_add_builtin(e, "vector-map", builtin_vector_map);
-    lex_add_builtin(e, "string-map", builtin_string_map);
-    lex_add_builtin(e, "for-each", builtin_foreach);
-    lex_add_builtin(e, "vector-for-each", builtin_vector_foreach);
-    lex_add_builtin(e, "string-for-each", builtin_string_foreach);
-    lex_add_builtin(e, "load", builtin_load);
-    lex_add_builtin(e, "command-line", builtin_command_line);
-    lex_add_builtin(e, "exit", builtin_exit);
-    /*
-     * Input/output and ports.
-     *
-     */
-    lex_add_builtin(e, "current-input-port", builtin_current_input_port);
-    lex_add_builtin(e, "current-output-port", builtin_current_output_port);
-    lex_add_builtin(e, "current-error-port", builtin_current_error_port);
-    lex_add_builtin(e, "input-port?", builtin_input_port_pred);
-    lex_add_builtin(e, "output-port?", builtin_output_port_pred);
-    lex_add_builtin(e, "textual-port?", builtin_text_port_pred);
-    lex_add_builtin(e, "binary-port?", builtin_binary_port_pred);
-    lex_add_builtin(e, "input-port-open?", builtin_input_port_open);
-    lex_add_builtin(e, "output-port-open?", builtin_output_port_open);
-    lex_add_builtin(e, "close-port", builtin_close_port);
-    /* No distinction yet...will implement these two with ASYNC ports later. */
-    lex_add_builtin(e, "close-input-port", builtin_close_port);
-    lex_add_builtin(e, "close-output-port", builtin_close_port);
-    lex_add_builtin(e, "read-line", builtin_read_line);
-    lex_add_builtin(e, "read-lines", builtin_read_lines);
-    lex_add_builtin(e, "read", builtin_read);
-    lex_add_builtin(e, "read-char", builtin_read_char);
-    lex_add_builtin(e, "read-u8", builtin_read_u8);
-    lex_add_builtin(e, "read-string", builtin_read_string);
-    lex_add_builtin(e, "read-bytevector", builtin_read_bytevector);
-    lex_add_builtin(e, "read-bytevector!", builtin_read_bytevector_bang);
-    lex_add_builtin(e, "peek-char", builtin_peek_char);
-    lex_add_builtin(e, "peek-u8", builtin_peek_u8);
-    lex_add_builtin(e, "char-ready?", builtin_char_ready);
-    lex_add_builtin(e, "u8-ready?", builtin_u8_ready);
-    lex_add_builtin(e, "write-char", builtin_write_char);
-    lex_add_builtin(e, "write-string", builtin_write_string);
-    lex_add_builtin(e, "write-u8", builtin_write_u8);
-    lex_add_builtin(e, "write-bytevector", builtin_write_bytevector);
-    lex_add_builtin(e, "newline", builtin_newline);
-    lex_add_builtin(e, "eof-object", builtin_eof);
-    lex_add_builtin(e, "flush-output-port", builtin_flush_output_port);
-    lex_add_builtin(e, "open-input-file", builtin_open_input_file);
-    lex_add_builtin(e, "open-output-file", builtin_open_output_file);
-    /* Unix makes no binary/text distinction - but Scheme does. */
-    lex_add_builtin(e, "open-binary-input-file", builtin_open_bin_input_file);
-    lex_add_builtin(e, "open-binary-output-file", builtin_open_bin_output_file);
-    lex_add_builtin(e, "open-and-trunc-output-file", builtin_open_and_trunc_output_file);
-    lex_add_builtin(e, "open-and-trunc-bin-output-file", builtin_open_and_trunc_bin_output_file);
-    lex_add_builtin(e, "display", builtin_display);
-    lex_add_builtin(e, "displayln", builtin_displayln);
-    lex_add_builtin(e, "write", builtin_write);
-    lex_add_builtin(e, "writeln", builtin_writeln);
-    lex_add_builtin(e, "call-with-input-file", builtin_call_with_input_file);
-    lex_add_builtin(e, "call-with-output-file", builtin_call_with_output_file);
-    lex_add_builtin(e, "with-input-from-file", builtin_with_input_from_file);
-    lex_add_builtin(e, "with-output-to-file", builtin_with_output_to_file);
-    lex_add_builtin(e, "open-output-string", builtin_open_output_string);
-    lex_add_builtin(e, "open-input-string", builtin_open_input_string);
-    lex_add_builtin(e, "get-output-string", builtin_get_output_string);
-    lex_add_builtin(e, "open-output-bytevector", builtin_open_output_bytevector);
-    lex_add_builtin(e, "open-input-bytevector", builtin_open_input_bytevector);
-    lex_add_builtin(e, "get-output-bytevector", builtin_get_output_bytevector);
-    lex_add_builtin(e, "call-with-port", builtin_call_with_port);
-    /*
-     * Error/debug procedures.
-     *
-     */
-    lex_add_builtin(e, "read-error?", builtin_read_error);
-    lex_add_builtin(e, "file-error?", builtin_file_error);
-    lex_add_builtin(e, "error-object?", builtin_error_object);
-    lex_add_builtin(e, "raise", builtin_raise);
-    lex_add_builtin(e, "gc-report", builtin_gc_report);
-    lex_add_builtin(e, "print-env", builtin_print_env);
-    /*
-     * Polymorphic procedures.
-     *
-     */
-    lex_add_builtin(e, "len", builtin_len);
-    lex_add_builtin(e, "idx", builtin_idx);
-    lex_add_builtin(e, "rev", builtin_rev);
-    /*
-     * Set procedures.
-     *
-     */
-    lex_add_builtin(e, "set", builtin_set);
-    lex_add_builtin(e, "set-copy", builtin_set_copy);
-    lex_add_builtin(e, "set-clear!", builtin_set_clear);
-    lex_add_builtin(e, "set-add!", builtin_set_add);
-    lex_add_builtin(e, "set-remove!", builtin_set_remove);
-    lex_add_builtin(e, "set-member?", builtin_set_member);
-    lex_add_builtin(e, "set-disjoint?", builtin_set_is_disjoint);
-    lex_add_builtin(e, "set-subset?", builtin_set_is_subset);
-    lex_add_builtin(e, "set-superset?", builtin_set_is_superset);
-    lex_add_builtin(e, "set-union", builtin_set_union);
-    lex_add_builtin(e, "set-union!", builtin_set_union_bang);
-    lex_add_builtin(e, "set-intersection", builtin_set_intersection);
-    lex_add_builtin(e, "set-intersection!", builtin_set_intersection_bang);
-    lex_add_builtin(e, "set-difference", builtin_set_difference);
-    lex_add_builtin(e, "set-difference!", builtin_set_difference_bang);
-    lex_add_builtin(e, "set-sym-difference", builtin_set_sym_difference);
-    lex_add_builtin(e, "set-sym-difference!", builtin_set_sym_difference_bang);
-    lex_add_builtin(e, "set-map", builtin_set_map);
-    lex_add_builtin(e, "set-foreach", builtin_set_foreach);
-    lex_add_builtin(e, "list->set", builtin_list_to_set);
-    lex_add_builtin(e, "set->list", builtin_set_to_list);
-    /*
-     * Hash procedures.
-     *
-     */
-    lex_add_builtin(e, "hash", builtin_hash);
-    lex_add_builtin(e, "hash-copy", builtin_hash_copy);
-    lex_add_builtin(e, "hash-clear!", builtin_hash_clear);
-    lex_add_builtin(e, "hash-add!", builtin_hash_add);
-    lex_add_builtin(e, "hash-remove!", builtin_hash_remove);
-    lex_add_builtin(e, "hash-get", builtin_hash_get);
-    lex_add_builtin(e, "hash-keys", builtin_hash_keys);
-    lex_add_builtin(e, "hash-values", builtin_hash_values);
-    lex_add_builtin(e, "hash->alist", builtin_hash_to_alist);
-    lex_add_builtin(e, "alist->hash", builtin_alist_to_hash);
-    lex_add_builtin(e, "hash-keys-map", builtin_hash_keys_map);
-    lex_add_builtin(e, "hash-values-map", builtin_hash_values_map);
-    lex_add_builtin(e, "hash-keys-foreach", builtin_hash_keys_foreach);
-    lex_add_builtin(e, "hash-values-foreach", builtin_hash_values_foreach);
-    lex_add_builtin(e, "hash-items-map", builtin_hash_items_map);
-    lex_add_builtin(e, "hash-items-foreach", builtin_hash_items_foreach);
+    Cell* procs = GC_MALLOC(sizeof(Cell) * N_BUILTINS);
+    for (size_t i = 0; i < N_BUILTINS; i++) {
+        const Cell* k = make_cell_symbol(builtin_table[i].name);
+        Cell* c = &procs[i];
+        c->type = CELL_PROC;
+        c->f_name = k->sym;
+        c->builtin = builtin_table[i].func;
+        c->is_builtin = true;
+        lex_put_global(e, k, c);
+    }
 }
@@ -26,6 +26,9 @@
 typedef struct Ch_Env Ch_Env;
 
 #define INITIAL_CHILD_ENV_CAPACITY 4
+/* Big enough to hold the builtins and the usual libraries without a resize. */
+#define GLOBAL_ENV_INITIAL_CAPACITY 512
+#define FRAME_POOL_SLOTS 8
 
 /* Wrapper which holds the current child-env (if any), and a
  * pointer to the global env hash table. */
@@ -42,18 +45,39 @@ typedef struct Ch_Env {
     char** syms;            /* symbol names. */
     Cell** vals;            /* values. */
     Ch_Env* parent;         /* points to parent env, NULL if top-level. */
+    bool pooled;            /* Frame came from the frame pool and may be recycled. */
+    bool captured;          /* A closure or promise holds this frame (or a child of it). */
 } Ch_Env;
 
 
+/* Inline cache for a global variable reference. It holds the global table
+ * slot of the binding, which define and set! update in place, so it stays
+ * valid until the table is resized or has a binding deleted. */
+typedef struct Global_Cache {
+    const ht_table* table;  /* Global table the slot belongs to. */
+    size_t generation;      /* Table generation when the slot was cached. */
+    ht_item* item;          /* The slot, or null if not yet cached. */
+} global_cache;
+
+
 /* Environment management. */
 Lex* lex_initialize_global_env(void);
 Lex* new_child_env(const Lex* parent_env);
+Lex* lex_acquire_frame(const Lex* parent_env, int n_slots);
+void lex_release_frames(const Lex* e, const Ch_Env* floor, const Ch_Env* keep);
+void lex_capture(const Lex* e);
 
 
 /* Environment operations. */
 Cell* lex_get(const Lex* e, const Cell* k);
 void lex_put_local(Lex* e, const Cell* k, const Cell* v);
 void lex_put_global(const Lex* e, const Cell* k, Cell* v);
+bool lex_set(const Lex* e, const Cell* k, Cell* v);
+bool lex_resolve(const Lex* e, const Cell* k, int* depth, int* slot);
+Cell* lex_get_at(const Lex* e, const Cell* k, int depth, int slot);
+bool lex_set_at(const Lex* e, const Cell* k, int depth, int slot, Cell* v);
+Cell* lex_get_global(const Lex* e, const Cell* k, global_cache* cache);
+global_cache* lex_make_global_cache(void);
 
 
 /* Builtin helpers. */
@@ -63,5 +87,17 @@ Cell* lex_make_lambda(Cell* formals, Cell* body, Lex* env);
 Cell* lex_make_defmacro(char* name, Cell* formals, Cell* body, Lex* env);
 void lex_add_builtin(const Lex* e, const char* name, Cell* (*func)(const Lex*, const Cell*));
 void lex_add_builtins(const Lex* e);
+Cell* builtin_print_env(const Lex* e, const Cell* a);
+
+
+/* An entry of the builtin table, generated from src/builtins.def. */
+typedef struct builtin_entry {
+    const char* name;
+    Cell* (*func)(const Lex*, const Cell*);
+    bool pure;  /* No side effects, and the result depends only on the args. */
+} builtin_entry;
+
+extern const builtin_entry builtin_table[];
+const builtin_entry* builtin_lookup(const char* name);
 
 #endif //COZENAGE_ENVIRONMENT_H
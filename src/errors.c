@@ -33,7 +33,7 @@ Cell* builtin_error_object(const Lex* e, const Cell* a)
     Cell* err = CHECK_ARITY_EXACT(a, 1, "error-object?");
     if (err) return err;
 
-    if (a->cell[0]->type == CELL_ERROR) {
+    if (cell_type(a->cell[0]) == CELL_ERROR) {
         return True_Obj;
     }
     return False_Obj;
@@ -63,7 +63,7 @@ Cell* builtin_raise(const Lex* e, const Cell* a) {
     Cell* err = CHECK_ARITY_RANGE(a, 1, 3, "raise");
     if (err) return err;
 
-    if (a->cell[0]->type != CELL_STRING) {
+    if (cell_type(a->cell[0]) != CELL_STRING) {
         return make_cell_error(
             "raise: arg must be string",
             TYPE_ERR);
@@ -72,13 +72,13 @@ Cell* builtin_raise(const Lex* e, const Cell* a) {
         return make_cell_error(a->cell[0]->str, GEN_ERR);
     }
     if (a->count > 1) {
-        if (a->cell[1]->type != CELL_INTEGER) {
+        if (cell_type(a->cell[1]) != CELL_INTEGER) {
             return make_cell_error(
                 "raise: error type arg must be an integer",
                 TYPE_ERR);
         }
 
-        const uint8_t err_no = a->cell[1]->integer_v;
+        const uint8_t err_no = cell_int(a->cell[1]);
         if (err_no > 7) {
             return make_cell_error(
                 "raise: invalid error type value",
@@ -23,10 +23,11 @@
  * S-expressions with special forms in the first position.
  *
  * After that, the S-expression is assumed to be a procedure call. The procedure
- * is evaluated, then the arguments are copied and evaluated, and the procedure,
- * arguments, and environment are sent to apply. Builtin procedures will
- * directly return a result, but user-defined lambda procedures will construct
- * the lambda environment, and be sent back to eval as a tail call.
+ * is evaluated, then the arguments are evaluated into slots on the argument
+ * stack, and the procedure, a view of the arguments, and environment are sent
+ * to apply. Builtin procedures will directly return a result, and user-defined
+ * lambda procedures will construct the lambda environment, and run their
+ * pre-analyzed body (see analyzer.c).
  *
  * The file also defines an apply_and_get_val function which will directly
  * return a value instead of tail-calling. This allows for it to be used to
@@ -34,24 +35,88 @@
  */
 
 #include "eval.h"
+#include "analyzer.h"
+#include "vm.h"
 #include "special_forms.h"
 #include "cell.h"
 #include "types.h"
 #include "repr.h"
 #include "symbols.h"
 
+#include <gc/gc.h>
 
-/* Helper to extract procedure args from s-expr. */
+
+/* Helper to get the (unevaluated) args of an s-expr. The result shares the
+ * s-expr's cell array, so it must be treated as read-only. */
 static Cell* get_args_from_sexpr(const Cell* v)
 {
     Cell* args = make_cell_sexpr();
-    for (int i = 1; i < v->count; i++) {
-        cell_add(args, v->cell[i]);
-    }
+    args->count = v->count - 1;
+    args->cell = v->cell + 1;
     return args;
 }
 
 
+/* -----------------------------*
+ *        Argument stack        *
+ * -----------------------------*/
+
+/* Procedure arguments are evaluated into slots reserved on this stack, and
+ * procedures are applied to a view of those slots, rather than to a freshly
+ * allocated s-expr. The stack grows by chaining segments, so reserved slots
+ * never move while a builtin which calls back into the evaluator (map, sort,
+ * etc.) is still reading them.
+ *
+ * Builtins must not keep a pointer to their arg s-expr, or its cell array,
+ * after they return; the values themselves may of course be kept. */
+
+#define ARG_SEGMENT_SLOTS 1024
+
+typedef struct Arg_Segment {
+    struct Arg_Segment* prev;  /* Older segment, or null. */
+    struct Arg_Segment* next;  /* Newer segment kept for re-use, or null. */
+    int top;                   /* Index of the first free slot. */
+    int capacity;              /* Number of slots. */
+    Cell* slots[];
+} arg_segment;
+
+/* In static storage, so the GC scans the segment chain. */
+static arg_segment* arg_seg = nullptr;
+
+
+/* Reserve n contiguous slots, and return a pointer to the first. */
+Cell** arg_stack_reserve(const int n)
+{
+    if (!arg_seg || arg_seg->top + n > arg_seg->capacity) {
+        arg_segment* s = arg_seg ? arg_seg->next : nullptr;
+        if (!s || s->capacity < n) {
+            const int capacity = n > ARG_SEGMENT_SLOTS ? n : ARG_SEGMENT_SLOTS;
+            s = GC_MALLOC(sizeof(arg_segment) + sizeof(Cell*) * capacity);
+            s->capacity = capacity;
+            s->prev = arg_seg;
+            s->next = nullptr;
+            if (arg_seg) arg_seg->next = s;
+        }
+        s->top = 0;
+        arg_seg = s;
+    }
+    Cell** base = &arg_seg->slots[arg_seg->top];
+    arg_seg->top += n;
+    return base;
+}
+
+
+/* Release the slots reserved at base, and everything reserved after them. */
+void arg_stack_release(Cell** base)
+{
+    while (base < arg_seg->slots || base > arg_seg->slots + arg_seg->capacity) {
+        arg_seg->top = 0;
+        arg_seg = arg_seg->prev;
+    }
+    arg_seg->top = (int)(base - arg_seg->slots);
+}
+
+
 /* This is only for special forms that are manually
  * implemented in special_forms.c */
 special_form_handler_t SF_DISPATCH_TABLE[] = {
@@ -66,11 +131,12 @@ special_form_handler_t SF_DISPATCH_TABLE[] = {
     [SF_ID_BEGIN]    = &sf_begin,
     [SF_ID_AND]      = &sf_and,
     [SF_ID_DEFMACRO] = &sf_defmacro,
-    [SF_ID_DEBUG]    = &sf_with_gc_stats
+    [SF_ID_DEBUG]    = &sf_with_gc_stats,
+    [SF_ID_FOLD]     = &sf_fold
 };
 
 
-static Cell* coz_apply(const Cell* proc, Cell* args, Lex** env_out, Cell** expr_out);
+static Cell* coz_apply(const Cell* proc, Cell* args, Lex* env);
 
 /* Evaluate a Cell in the given environment. */
 Cell* coz_eval(Lex* env, Cell* expr)
@@ -79,7 +145,7 @@ Cell* coz_eval(Lex* env, Cell* expr)
         if (!expr) return nullptr;
 
         /* Quick exit for all the self-evaluating types. */
-        if (expr->type & (CELL_INTEGER|CELL_REAL|CELL_RATIONAL|CELL_COMPLEX|
+        if (cell_type(expr) & (CELL_INTEGER|CELL_REAL|CELL_RATIONAL|CELL_COMPLEX|
                           CELL_BOOLEAN|CELL_CHAR|CELL_STRING|CELL_PAIR|
                           CELL_VECTOR|CELL_BYTEVECTOR|CELL_NIL|CELL_EOF|
                           CELL_PROC|CELL_PORT|CELL_ERROR|CELL_UNSPEC|
@@ -89,7 +155,7 @@ Cell* coz_eval(Lex* env, Cell* expr)
         }
 
         /* Symbols: look them up in the environment. */
-        if (expr->type & CELL_SYMBOL) {
+        if (cell_type(expr) & CELL_SYMBOL) {
 
             /* Scold for using syntax dumbly */
             if (is_syntactic_keyword(expr)) {
@@ -114,7 +180,7 @@ Cell* coz_eval(Lex* env, Cell* expr)
 
         /* Special forms need to be dispatched out of
          * eval_sexpr() early, so the arguments are not evaluated. */
-        if (first->type == CELL_SYMBOL && first->sf_id > 0) {
+        if (cell_type(first) == CELL_SYMBOL && first->sf_id > 0) {
             const special_form_handler_t handler = SF_DISPATCH_TABLE[first->sf_id];
             if (!handler) {
                 return make_cell_error(
@@ -136,16 +202,16 @@ Cell* coz_eval(Lex* env, Cell* expr)
         /* It's not a special form, so it's a procedure call or macro. */
         /* First, evaluate the procedure itself. */
         Cell* f = coz_eval(env, first);
-        if (f->type == CELL_ERROR) {
+        if (cell_type(f) == CELL_ERROR) {
             return f;
         }
 
-        if (f->type == CELL_MACRO) {
+        if (cell_type(f) == CELL_MACRO) {
             /* Transform the macro. */
-            Cell* raw_args = get_args_from_sexpr(expr);
-            Cell* result = coz_apply_and_get_val(f, raw_args, env);
+            Cell raw_args = { .type = CELL_SEXPR, .count = expr->count - 1, .cell = expr->cell + 1 };
+            Cell* result = coz_apply_and_get_val(f, &raw_args, env);
             /* Propagate errors. */
-            if (result->type == CELL_ERROR) {
+            if (cell_type(result) == CELL_ERROR) {
                 return result;
             }
             /* Tail-call evaluate the result of the transformation. */
@@ -155,63 +221,62 @@ Cell* coz_eval(Lex* env, Cell* expr)
         }
 
         /* Here, if first position is not a procedure, it is an error. */
-        if (f->type != CELL_PROC) {
+        if (cell_type(f) != CELL_PROC) {
             return make_cell_error(
                 fmt_err("bad identifier: '%s'. Expression must start with a procedure",
                     cell_to_string(f, MODE_REPL)),
                 TYPE_ERR);
         }
 
-        /* Create a new list containing the unevaluated arguments. */
-        Cell* args = get_args_from_sexpr(expr);
+        /* Evaluate the arguments onto the argument stack. */
+        const int argc = expr->count - 1;
+        Cell** argv = arg_stack_reserve(argc);
+        for (int i = 0; i < argc; i++) {
+            Cell* result = coz_eval(env, expr->cell[i + 1]);
+            /* A legitimate null leaves the arg unevaluated. */
+            if (!result) { result = expr->cell[i + 1]; }
+            argv[i] = result;
 
-        /* Evaluate each argument within this new list. */
-        for (int i = 0; i < args->count; i++) {
-            Cell* result = coz_eval(env, args->cell[i]);
-            /* Ignore legitimate null. */
-            if (!result) { continue; }
-            args->cell[i] = result;
-
-            if (args->cell[i]->type == CELL_ERROR) {
+            if (cell_type(result) == CELL_ERROR) {
                 /* If an argument evaluation fails, return the error. */
-                return args->cell[i];
+                arg_stack_release(argv);
+                return result;
             }
         }
 
-        Cell* result = coz_apply(f, args, &env, &expr);
-        if (!result) return nullptr;
-
-        if (result != TCS_Obj) {
-            /* f was a primitive C function that returned a final value. */
-            return result;
-        }
-        /* If here ...it was a TCS, and apply() updated
-         * expr and env. Allow the control flow to begin another
-         * loop, performing the tail call. */
+        Cell args = { .type = CELL_SEXPR, .count = argc, .cell = argv };
+        Cell* result = coz_apply(f, &args, env);
+        arg_stack_release(argv);
+        return result;
     }
 }
 
 
 /* Apply that procedure on them args! */
-static Cell* coz_apply(const Cell* proc, Cell* args, Lex** env_out, Cell** expr_out)
+static Cell* coz_apply(const Cell* proc, Cell* args, Lex* env)
 {
-    if (proc->is_builtin) {
+    while (proc->is_builtin) {
         /* Run the builtin. */
-        Cell* result = proc->builtin(*env_out, args);
-
-        /* If the builtin returned TCS_Obj (only 'apply' does this thus far),
-         * it means that 'result' is an expression that needs to be tail-called... */
-        if (result->type == CELL_TCS) {
-            result->type = CELL_SEXPR;
-            *expr_out = result;
-            return TCS_Obj;
+        Cell* result = proc->builtin(env, args);
+
+        /* If the builtin returned a CELL_TCS (only 'apply' does this thus far),
+         * it is a (proc arg ...) s-expr whose args are already evaluated, so
+         * apply it directly rather than evaluating it again. */
+        if (cell_type(result) != CELL_TCS) {
+            /* Otherwise, it's a final result. */
+            return result;
         }
-        /* Otherwise, it's a final result. */
-        return result;
+        proc = result->cell[0];
+        args = get_args_from_sexpr(result);
     }
 
-    /* It's a Scheme lambda, return TCO. */
-    Lex* le = build_lambda_env(proc->lambda->env, proc->lambda->formals, args);
+    /* It's a Scheme lambda. */
+    if (!proc->lambda->code) {
+        proc->lambda->code = analyze(proc->lambda->body,
+                                     scope_for_formals(proc->lambda->env, proc->lambda->formals));
+    }
+    Lex* le = build_lambda_env(proc->lambda->env, proc->lambda->formals, args,
+                               !proc->lambda->code->captures);
     if (le == nullptr) {
         /* We cannot return a specific error message from build_lambda_env(),
          * so we have to return this generic error. */
@@ -219,9 +284,10 @@ static Cell* coz_apply(const Cell* proc, Cell* args, Lex** env_out, Cell** expr_
             "bad lambda expression",
             SYNTAX_ERR);
     }
-    *env_out = le;
-    *expr_out = proc->lambda->body;
-    return TCS_Obj;
+    /* Run the analyzed body, which does its own tail calls. */
+    Cell* result = coz_exec(le, proc->lambda->code);
+    lex_release_frames(le, proc->lambda->env->local, nullptr);
+    return result;
 }
 
 
@@ -233,6 +299,10 @@ static Cell* coz_apply(const Cell* proc, Cell* args, Lex** env_out, Cell** expr_
  */
 Cell* coz_apply_and_get_val(const Cell* proc, Cell* args, const Lex* env)
 {
+    if (coz_engine == ENGINE_VM) {
+        return vm_apply(proc, args, env);
+    }
+
     if (proc->is_builtin) {
         return proc->builtin(env, args);
     }
@@ -241,7 +311,12 @@ Cell* coz_apply_and_get_val(const Cell* proc, Cell* args, const Lex* env)
      * This is a Scheme lambda. We can't just call it because it might tail-call
      * internally. We need to set it up and then kick off a self-contained
      * evaluation loop that runs until it produces a final value. */
-    Lex* lambda_env  = build_lambda_env(proc->lambda->env, proc->lambda->formals, args);
+    if (!proc->lambda->code) {
+        proc->lambda->code = analyze(proc->lambda->body,
+                                     scope_for_formals(proc->lambda->env, proc->lambda->formals));
+    }
+    Lex* lambda_env  = build_lambda_env(proc->lambda->env, proc->lambda->formals, args,
+                                        !proc->lambda->code->captures);
     if (lambda_env == nullptr) {
         /* We cannot return a specific error message from build_lambda_env(),
          * so we have to return this generic error. */
@@ -249,6 +324,7 @@ Cell* coz_apply_and_get_val(const Cell* proc, Cell* args, const Lex* env)
             "bad lambda expression",
             SYNTAX_ERR);
     }
-    Cell* body_expr = proc->lambda->body;
-    return coz_eval(lambda_env, body_expr);
+    Cell* result = coz_exec(lambda_env, proc->lambda->code);
+    lex_release_frames(lambda_env, proc->lambda->env->local, nullptr);
+    return result;
 }
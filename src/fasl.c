@@ -0,0 +1,486 @@
+/*
+ * 'src/fasl.c'
+ * This file is part of Cozenage - https://github.com/DarrenKirby/cozenage
+ * Copyright © 2026 Darren Kirby <darren@dragonbyte.ca>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* This file implements a binary ('fasl', fast-load) format for the expanded
+ * forms of a source file, and a cache of them on disk, so a file which has
+ * not changed since it was last run is not lexed, parsed or expanded again.
+ *
+ * A fasl file holds, in host byte order:
+ *
+ *   "COZFASL" magic, format version, interpreter version,
+ *   hash and length of the source it was made from,
+ *   the table of symbol names used by the forms,
+ *   the forms themselves, each a tagged tree of data.
+ *
+ * Symbols are written once, in the table, and referenced by their index, so
+ * each is interned just once on loading. The cache is keyed by the hash of the
+ * interpreter version and the source text, and lives in
+ * $XDG_CACHE_HOME/cozenage/fasl, or ~/.cache/cozenage/fasl. Forms are cached as
+ * they are after expand(), as that is independent of the environment, and
+ * constant folding is left to run on them when they are evaluated.
+ */
+
+#include "fasl.h"
+#include "main.h"
+#include "config.h"
+#include "hash.h"
+#include "bytevectors.h"
+#include "file_map.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <gc/gc.h>
+#include <gmp.h>
+
+
+#define FASL_MAGIC "COZFASL"
+#define FASL_VERSION 1
+
+fasl_cache_t fasl_cache = {0};
+
+/* Tags of the data in a form. */
+typedef enum : uint8_t {
+    F_SEXPR,
+    F_SYMBOL,
+    F_INTEGER,
+    F_RATIONAL,
+    F_REAL,
+    F_COMPLEX,
+    F_BIGINT,
+    F_STRING,
+    F_CHAR,
+    F_TRUE,
+    F_FALSE,
+    F_NIL,
+    F_UNSPEC,
+    F_PAIR,
+    F_VECTOR,
+    F_BYTEVECTOR
+} fasl_tag;
+
+
+/* Hash of the interpreter version and the source, which keys the cache. */
+static uint64_t source_hash(const char* source)
+{
+    uint64_t hash = hash_string_key(APP_VERSION);
+    for (const char* p = source; *p; p++) {
+        hash ^= (uint64_t)(unsigned char)*p;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+
+/*-------------------------------------------*
+ *                 Writing                   *
+ * ------------------------------------------*/
+
+typedef struct {
+    str_buf_t* out;
+    ht_table* sym_index;  /* Symbol name -> its index in syms. */
+    Cell* syms;           /* The symbols, in order of first use. */
+} fasl_writer;
+
+
+static void put_u8(const fasl_writer* w, const uint8_t v) { sb_append_data(w->out, &v, sizeof(v)); }
+static void put_u32(const fasl_writer* w, const uint32_t v) { sb_append_data(w->out, &v, sizeof(v)); }
+static void put_u64(const fasl_writer* w, const uint64_t v) { sb_append_data(w->out, &v, sizeof(v)); }
+
+static void put_bytes(const fasl_writer* w, const void* data, const size_t len)
+{
+    put_u32(w, (uint32_t)len);
+    sb_append_data(w->out, data, len);
+}
+
+
+/* Append the datum v to the output. Returns false if v is of a type which
+ * cannot be written, such as a procedure or port. */
+static bool put_datum(fasl_writer* w, const Cell* v)
+{
+    switch (cell_type(v)) {
+        case CELL_SEXPR:
+        case CELL_VECTOR:
+            put_u8(w, cell_type(v) == CELL_SEXPR ? F_SEXPR : F_VECTOR);
+            put_u32(w, v->count);
+            for (int i = 0; i < v->count; i++) {
+                if (!put_datum(w, v->cell[i])) return false;
+            }
+            return true;
+        case CELL_SYMBOL: {
+            const Cell* idx = ht_get_hashed(w->sym_index, v->sym, v->hash);
+            if (!idx) {
+                idx = make_cell_integer(w->syms->count);
+                ht_set_hashed(w->sym_index, v->sym, v->hash, (Cell*)idx);
+                cell_add(w->syms, (Cell*)v);
+            }
+            put_u8(w, F_SYMBOL);
+            put_u32(w, (uint32_t)cell_int(idx));
+            return true;
+        }
+        case CELL_INTEGER:
+            put_u8(w, F_INTEGER);
+            put_u8(w, cell_exact(v));
+            put_u64(w, (uint64_t)cell_int(v));
+            return true;
+        case CELL_RATIONAL:
+            put_u8(w, F_RATIONAL);
+            put_u8(w, v->exact);
+            put_u64(w, (uint64_t)v->num);
+            put_u64(w, (uint64_t)v->den);
+            return true;
+        case CELL_REAL:
+            put_u8(w, F_REAL);
+            put_u8(w, v->exact);
+            sb_append_data(w->out, &v->real_v, sizeof(v->real_v));
+            return true;
+        case CELL_COMPLEX:
+            put_u8(w, F_COMPLEX);
+            return put_datum(w, v->real) && put_datum(w, v->imag);
+        case CELL_BIGINT: {
+            char* digits = GC_MALLOC_ATOMIC(mpz_sizeinbase(*v->bi, 16) + 2);
+            mpz_get_str(digits, 16, *v->bi);
+            put_u8(w, F_BIGINT);
+            put_bytes(w, digits, strlen(digits));
+            return true;
+        }
+        case CELL_STRING:
+            put_u8(w, F_STRING);
+            put_bytes(w, v->str, v->count);
+            return true;
+        case CELL_CHAR:
+            put_u8(w, F_CHAR);
+            put_u32(w, (uint32_t)cell_char(v));
+            return true;
+        case CELL_BOOLEAN:
+            put_u8(w, v->boolean_v ? F_TRUE : F_FALSE);
+            return true;
+        case CELL_NIL:
+            put_u8(w, F_NIL);
+            return true;
+        case CELL_UNSPEC:
+            put_u8(w, F_UNSPEC);
+            return true;
+        case CELL_PAIR:
+            put_u8(w, F_PAIR);
+            put_u32(w, (uint32_t)v->len);
+            return put_datum(w, v->car) && put_datum(w, v->cdr);
+        case CELL_BYTEVECTOR:
+            put_u8(w, F_BYTEVECTOR);
+            put_u8(w, v->bv->type);
+            put_u32(w, v->count);
+            sb_append_data(w->out, v->bv->data, (size_t)v->count * BV_OPS[v->bv->type].elem_size);
+            return true;
+        default:
+            return false;
+    }
+}
+
+
+/* Write the forms read from source to sb in fasl format. Returns false if
+ * the forms hold data which cannot be written. */
+bool fasl_write(str_buf_t* sb, const char* source, const Cell* forms)
+{
+    /* The forms are written first, to collect their symbols, then the
+     * header and symbol table are put in front of them. */
+    fasl_writer w = { sb_new(), ht_create(64), make_cell_sexpr() };
+    put_u32(&w, forms->count);
+    for (int i = 0; i < forms->count; i++) {
+        if (!put_datum(&w, forms->cell[i])) return false;
+    }
+    str_buf_t* body = w.out;
+
+    w.out = sb;
+    sb_append_data(sb, FASL_MAGIC, sizeof(FASL_MAGIC));
+    put_u32(&w, FASL_VERSION);
+    put_bytes(&w, APP_VERSION, strlen(APP_VERSION));
+    put_u64(&w, source_hash(source));
+    put_u64(&w, strlen(source));
+    put_u32(&w, w.syms->count);
+    for (int i = 0; i < w.syms->count; i++) {
+        put_bytes(&w, w.syms->cell[i]->sym, strlen(w.syms->cell[i]->sym));
+    }
+    sb_append_data(sb, body->buffer, body->length);
+    return true;
+}
+
+
+/*-------------------------------------------*
+ *                 Reading                   *
+ * ------------------------------------------*/
+
+typedef struct {
+    const char* p;
+    const char* end;
+    Cell** syms;
+    uint32_t n_syms;
+    bool ok;              /* Cleared on reading past the end, or a bad tag. */
+} fasl_reader;
+
+
+static bool get(fasl_reader* r, void* dest, const size_t len)
+{
+    if (!r->ok || (size_t)(r->end - r->p) < len) {
+        r->ok = false;
+        memset(dest, 0, len);
+        return false;
+    }
+    memcpy(dest, r->p, len);
+    r->p += len;
+    return true;
+}
+
+static uint8_t get_u8(fasl_reader* r) { uint8_t v; get(r, &v, sizeof(v)); return v; }
+static uint32_t get_u32(fasl_reader* r) { uint32_t v; get(r, &v, sizeof(v)); return v; }
+static uint64_t get_u64(fasl_reader* r) { uint64_t v; get(r, &v, sizeof(v)); return v; }
+
+/* Return a pointer to the next len bytes, and their length in *len. */
+static const char* get_bytes(fasl_reader* r, uint32_t* len)
+{
+    *len = get_u32(r);
+    if (!r->ok || (size_t)(r->end - r->p) < *len) {
+        r->ok = false;
+        return nullptr;
+    }
+    const char* bytes = r->p;
+    r->p += *len;
+    return bytes;
+}
+
+
+static Cell* fail(fasl_reader* r)
+{
+    r->ok = false;
+    return USP_Obj;
+}
+
+
+static Cell* get_datum(fasl_reader* r)
+{
+    if (!r->ok) return USP_Obj;
+
+    const uint8_t tag = get_u8(r);
+    switch (tag) {
+        case F_SEXPR:
+        case F_VECTOR: {
+            Cell* v = tag == F_VECTOR ? make_cell_vector() : make_cell_sexpr();
+            const uint32_t n = get_u32(r);
+            for (uint32_t i = 0; i < n && r->ok; i++) {
+                cell_add(v, get_datum(r));
+            }
+            return v;
+        }
+        case F_SYMBOL: {
+            const uint32_t i = get_u32(r);
+            if (i >= r->n_syms) return fail(r);
+            return r->syms[i];
+        }
+        case F_INTEGER: {
+            const bool exact = get_u8(r);
+            Cell* v = make_cell_integer((int64_t)get_u64(r));
+            return exact ? v : cell_set_exact(v, false);
+        }
+        case F_RATIONAL: {
+            const bool exact = get_u8(r);
+            const int64_t num = (int64_t)get_u64(r);
+            const int64_t den = (int64_t)get_u64(r);
+            return cell_set_exact(make_cell_rational(num, den, false), exact);
+        }
+        case F_REAL: {
+            const bool exact = get_u8(r);
+            long double real;
+            get(r, &real, sizeof(real));
+            Cell* v = make_cell_real(real);
+            v->exact = exact;
+            return v;
+        }
+        case F_COMPLEX: {
+            Cell* real = get_datum(r);
+            Cell* imag = get_datum(r);
+            return make_cell_complex(real, imag);
+        }
+        case F_BIGINT: {
+            uint32_t len;
+            const char* digits = get_bytes(r, &len);
+            if (!digits) return USP_Obj;
+            Cell* v = make_cell_bigint(GC_strndup(digits, len), nullptr, 16);
+            return cell_type(v) == CELL_BIGINT ? v : fail(r);
+        }
+        case F_STRING: {
+            uint32_t len;
+            const char* str = get_bytes(r, &len);
+            if (!str) return USP_Obj;
+            return make_cell_string_literal(GC_strndup(str, len));
+        }
+        case F_CHAR:
+            return make_cell_char((UChar32)get_u32(r));
+        case F_TRUE:
+            return True_Obj;
+        case F_FALSE:
+            return False_Obj;
+        case F_NIL:
+            return Nil_Obj;
+        case F_UNSPEC:
+            return USP_Obj;
+        case F_PAIR: {
+            const int len = (int)get_u32(r);
+            Cell* car = get_datum(r);
+            Cell* cdr = get_datum(r);
+            Cell* v = make_cell_pair(car, cdr);
+            v->len = len;
+            return v;
+        }
+        case F_BYTEVECTOR: {
+            const uint8_t type = get_u8(r);
+            const uint32_t n = get_u32(r);
+            if (type > BV_F64) return fail(r);
+            const size_t size = (size_t)n * BV_OPS[type].elem_size;
+            if ((size_t)(r->end - r->p) < size) return fail(r);
+            Cell* v = make_cell_bytevector(type, n);
+            memcpy(v->bv->data, r->p, size);
+            v->count = (int)n;
+            r->p += size;
+            return v;
+        }
+        default:
+            return fail(r);
+    }
+}
+
+
+/* Read the forms of source from the len bytes of fasl data. Returns an
+ * s-expression of the forms, or null if the data is malformed, or was made
+ * from another source or by another version of the interpreter. */
+Cell* fasl_read(const char* data, const size_t len, const char* source)
+{
+    fasl_reader r = { data, data + len, nullptr, 0, true };
+
+    char magic[sizeof(FASL_MAGIC)];
+    get(&r, magic, sizeof(magic));
+    if (!r.ok || memcmp(magic, FASL_MAGIC, sizeof(magic)) != 0) return nullptr;
+    if (get_u32(&r) != FASL_VERSION) return nullptr;
+
+    uint32_t v_len;
+    const char* version = get_bytes(&r, &v_len);
+    if (!version || v_len != strlen(APP_VERSION) || memcmp(version, APP_VERSION, v_len) != 0) {
+        return nullptr;
+    }
+    const uint64_t hash = get_u64(&r);
+    const uint64_t src_len = get_u64(&r);
+    if (!r.ok || src_len != strlen(source) || hash != source_hash(source)) return nullptr;
+
+    r.n_syms = get_u32(&r);
+    if (!r.ok || r.n_syms > len) return nullptr;
+    r.syms = GC_MALLOC(r.n_syms * sizeof(Cell*));
+    for (uint32_t i = 0; i < r.n_syms && r.ok; i++) {
+        uint32_t s_len;
+        const char* name = get_bytes(&r, &s_len);
+        if (name) r.syms[i] = make_cell_symbol_n(name, s_len);
+    }
+
+    Cell* forms = make_cell_sexpr();
+    const uint32_t n_forms = get_u32(&r);
+    for (uint32_t i = 0; i < n_forms && r.ok; i++) {
+        cell_add(forms, get_datum(&r));
+    }
+    if (!r.ok || r.p != r.end) return nullptr;
+    return forms;
+}
+
+
+/*-------------------------------------------*
+ *                  Cache                    *
+ * ------------------------------------------*/
+
+/* Path of the cache file for source. */
+static char* cache_file_path(const char* source)
+{
+    init_cache_path();
+    char* path = GC_MALLOC_ATOMIC(strlen(cozenage_cache_path) + 32);
+    sprintf(path, "%s/%016llx.fasl", cozenage_cache_path,
+        (unsigned long long)source_hash(source));
+    return path;
+}
+
+
+/* Return the cached forms of source, or null if they are not cached. */
+Cell* fasl_cache_load(const char* source)
+{
+    if (fasl_cache.disabled) return nullptr;
+
+    file_map_t cached;
+    if (!file_map_open(cache_file_path(source), &cached)) return nullptr;
+
+    /* Everything read is copied out, so the file can be let go of at once. */
+    Cell* forms = fasl_read(cached.data, cached.length, source);
+    file_map_close(&cached);
+    return forms;
+}
+
+
+/* Cache the forms of source. Failure to do so is silently ignored; the
+ * source is simply read again next time. */
+void fasl_cache_store(const char* source, const Cell* forms)
+{
+    if (fasl_cache.disabled) return;
+
+    str_buf_t* sb = sb_new();
+    if (!fasl_write(sb, source, forms)) return;
+
+    init_cache_path();
+    if (mkdir_p(cozenage_cache_path) != 0) return;
+
+    /* Write to a temporary file, then rename it into place, so a
+     * concurrent run never sees a partly written cache file. */
+    const char* path = cache_file_path(source);
+    char* tmp_path = GC_MALLOC_ATOMIC(strlen(path) + 32);
+    sprintf(tmp_path, "%s.%ld.tmp", path, (long)getpid());
+
+    FILE* f = fopen(tmp_path, "wb");
+    if (!f) return;
+    const bool written = fwrite(sb->buffer, 1, sb->length, f) == sb->length;
+    if (fclose(f) != 0 || !written || rename(tmp_path, path) != 0) {
+        unlink(tmp_path);
+    }
+}
+
+
+/* Delete every file in the cache. Returns the number deleted. */
+int fasl_cache_flush(void)
+{
+    init_cache_path();
+    DIR* dir = opendir(cozenage_cache_path);
+    if (!dir) return 0;
+
+    int n = 0;
+    const struct dirent* entry;
+    while ((entry = readdir(dir))) {
+        const char* ext = strrchr(entry->d_name, '.');
+        if (!ext || (strcmp(ext, ".fasl") != 0 && strcmp(ext, ".tmp") != 0)) continue;
+
+        char path[PATH_MAX];
+        snprintf(path, sizeof(path), "%s/%s", cozenage_cache_path, entry->d_name);
+        if (unlink(path) == 0) n++;
+    }
+    closedir(dir);
+    return n;
+}
@@ -0,0 +1,40 @@
+/*
+ * 'src/fasl.h'
+ * This file is part of Cozenage - https://github.com/DarrenKirby/cozenage
+ * Copyright © 2026 Darren Kirby <darren@dragonbyte.ca>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COZENAGE_FASL_H
+#define COZENAGE_FASL_H
+
+#include "cell.h"
+#include "buffer.h"
+
+
+/* Code cache settings, set from the command line. */
+typedef struct {
+    bool disabled;  /* Neither read nor write the cache. */
+} fasl_cache_t;
+
+extern fasl_cache_t fasl_cache;
+
+bool fasl_write(str_buf_t* sb, const char* source, const Cell* forms);
+Cell* fasl_read(const char* data, size_t len, const char* source);
+Cell* fasl_cache_load(const char* source);
+void fasl_cache_store(const char* source, const Cell* forms);
+int fasl_cache_flush(void);
+
+#endif //COZENAGE_FASL_H
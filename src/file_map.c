@@ -0,0 +1,117 @@
+/*
+ * 'src/file_map.c'
+ * This file is part of Cozenage - https://github.com/DarrenKirby/cozenage
+ * Copyright © 2026 Darren Kirby <darren@dragonbyte.ca>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* This file loads whole files for reading: source files to be run or
+ * loaded, cached code, and the contents of read-only file ports.
+ *
+ * A regular file is mapped into memory rather than read, so it is never
+ * copied, and never lands in the GC heap, where a large one would only add
+ * to the time spent scanning it. The lexer needs a '\0' after the source;
+ * the bytes of the last page past the end of a mapped file are zeros, so
+ * this comes for free, except when the file fills its last page exactly.
+ * Such files, empty files, and things which cannot be mapped, like pipes,
+ * are read into the heap instead.
+ */
+
+#include "file_map.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <gc/gc.h>
+
+
+/* Read the rest of fd into a '\0' terminated heap buffer. */
+static bool read_whole(const int fd, const size_t size_hint, file_map_t* fm)
+{
+    size_t capacity = size_hint + 1 > 4096 ? size_hint + 1 : 4096;
+    char* buf = GC_MALLOC_ATOMIC(capacity);
+    size_t length = 0;
+
+    for (;;) {
+        if (length + 1 == capacity) {
+            capacity *= 2;
+            buf = GC_REALLOC(buf, capacity);
+        }
+        const ssize_t n = read(fd, buf + length, capacity - 1 - length);
+        if (n == 0) break;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        length += (size_t)n;
+    }
+    buf[length] = '\0';
+
+    fm->data = buf;
+    fm->length = length;
+    fm->mapped = false;
+    return true;
+}
+
+
+/* Open the file at path for reading. Returns false, with errno set, if it
+ * cannot be opened or read. */
+bool file_map_open(const char* path, file_map_t* fm)
+{
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        const int saved = errno;
+        close(fd);
+        errno = saved;
+        return false;
+    }
+
+    const size_t size = (size_t)st.st_size;
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    if (S_ISREG(st.st_mode) && size > 0 && size % page != 0) {
+        void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            close(fd);
+            posix_madvise(p, size, POSIX_MADV_SEQUENTIAL);
+            fm->data = p;
+            fm->length = size;
+            fm->mapped = true;
+            return true;
+        }
+    }
+
+    const bool ok = read_whole(fd, S_ISREG(st.st_mode) ? size : 0, fm);
+    const int saved = errno;
+    close(fd);
+    errno = saved;
+    return ok;
+}
+
+
+/* Release the contents of a file. A heap copy is left to the GC. */
+void file_map_close(file_map_t* fm)
+{
+    if (fm->mapped) {
+        munmap((void*)fm->data, fm->length);
+    }
+    fm->data = "";
+    fm->length = 0;
+    fm->mapped = false;
+}
@@ -0,0 +1,37 @@
+/*
+ * 'src/file_map.h'
+ * This file is part of Cozenage - https://github.com/DarrenKirby/cozenage
+ * Copyright © 2026 Darren Kirby <darren@dragonbyte.ca>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COZENAGE_FILE_MAP_H
+#define COZENAGE_FILE_MAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+
+/* The read-only contents of a file. */
+typedef struct FileMap {
+    const char* data;  /* The contents, always followed by a '\0'. */
+    size_t length;     /* Bytes in the file, not counting the '\0'. */
+    bool mapped;       /* data is a mapping of the file, not a heap copy. */
+} file_map_t;
+
+bool file_map_open(const char* path, file_map_t* fm);
+void file_map_close(file_map_t* fm);
+
+#endif //COZENAGE_FILE_MAP_H
@@ -0,0 +1,315 @@
+/*
+ * 'src/float_io.c'
+ * This file is part of Cozenage - https://github.com/DarrenKirby/cozenage
+ * Copyright © 2026 Darren Kirby <darren@dragonbyte.ca>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* This file implements fast conversions between reals and decimal text.
+ *
+ * Both rest on one fact: a long double product or quotient of two exactly
+ * representable numbers is correctly rounded. So a decimal literal with few
+ * enough significant digits, and a small enough exponent, is converted with
+ * one multiplication or division by an exact power of ten, giving the same
+ * result as strtold() (Clinger's fast path). And a real is formatted from the
+ * integer nearest to it scaled by a power of ten, unless the scaled value is
+ * too close to a rounding boundary to be sure which way it goes.
+ *
+ * Anything else falls back to strtold() and snprintf(), so results are always
+ * the same as theirs, only much faster in the common case.
+ */
+
+#include "float_io.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* Powers of ten which are exact long doubles, ie: whose factor of 5^n fits
+ * in the significand. */
+#if LDBL_MANT_DIG >= 113
+#define MAX_EXACT_POW10 48
+#elif LDBL_MANT_DIG >= 64
+#define MAX_EXACT_POW10 27
+#else
+#define MAX_EXACT_POW10 22
+#endif
+
+static const long double pow10_table[] = {
+    1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L,
+    1e10L, 1e11L, 1e12L, 1e13L, 1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L,
+    1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L, 1e26L, 1e27L, 1e28L, 1e29L,
+    1e30L, 1e31L, 1e32L, 1e33L, 1e34L, 1e35L, 1e36L, 1e37L, 1e38L, 1e39L,
+    1e40L, 1e41L, 1e42L, 1e43L, 1e44L, 1e45L, 1e46L, 1e47L, 1e48L
+};
+
+/* Most significant digits which fit in the uint64_t the digits are
+ * gathered in, and, for the parser, in the significand of a long double. */
+#define MAX_FAST_DIGITS 19
+#if LDBL_MANT_DIG >= 64
+#define MAX_EXACT_MANTISSA UINT64_MAX
+#else
+#define MAX_EXACT_MANTISSA ((uint64_t)1 << LDBL_MANT_DIG)
+#endif
+
+/* Fewest digits round-tripping every long double. */
+#ifdef LDBL_DECIMAL_DIG
+#define MAX_ROUND_TRIP_DIGITS LDBL_DECIMAL_DIG
+#else
+#define MAX_ROUND_TRIP_DIGITS 36
+#endif
+
+
+static bool is_digit(const char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+
+/* Convert a decimal literal: [sign] digits [. digits] [e [sign] digits], with
+ * at least one digit before the exponent. Returns false, and leaves out
+ * untouched, if str is anything else, or cannot be converted exactly by the
+ * fast path. The caller then falls back to strtold(). */
+bool parse_decimal_fast(const char* str, long double* out)
+{
+    const char* p = str;
+    bool neg = false;
+    if (*p == '+' || *p == '-') {
+        neg = *p++ == '-';
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;     /* Significant digits in mantissa. */
+    int exponent = 0;   /* Power of ten to scale mantissa by. */
+    bool seen = false;  /* Any digit at all. */
+
+    for (; is_digit(*p); p++) {
+        seen = true;
+        if (mantissa == 0 && *p == '0') continue;
+        if (++digits > MAX_FAST_DIGITS) return false;
+        mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+    }
+    if (*p == '.') {
+        for (p++; is_digit(*p); p++) {
+            seen = true;
+            exponent--;
+            if (mantissa == 0 && *p == '0') continue;
+            if (++digits > MAX_FAST_DIGITS) return false;
+            mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+        }
+    }
+    if (!seen) return false;
+
+    if (*p == 'e' || *p == 'E') {
+        p++;
+        bool exp_neg = false;
+        if (*p == '+' || *p == '-') {
+            exp_neg = *p++ == '-';
+        }
+        if (!is_digit(*p)) return false;
+        int e = 0;
+        for (; is_digit(*p); p++) {
+            if (e > 10000) return false;
+            e = e * 10 + (*p - '0');
+        }
+        exponent += exp_neg ? -e : e;
+    }
+    if (*p != '\0') return false;
+
+    long double val;
+    if (mantissa == 0) {
+        val = 0.0L;
+    } else {
+        if (mantissa > MAX_EXACT_MANTISSA) return false;
+        if (exponent < -MAX_EXACT_POW10 || exponent > MAX_EXACT_POW10) return false;
+        val = exponent < 0
+            ? (long double)mantissa / pow10_table[-exponent]
+            : (long double)mantissa * pow10_table[exponent];
+    }
+    *out = neg ? -val : val;
+    return true;
+}
+
+
+/* Scale x by 10^k, with a single rounding. */
+static long double scale10(const long double x, const int k)
+{
+    return k < 0 ? x / pow10_table[-k] : x * pow10_table[k];
+}
+
+
+/* Write the digits of n, which has exactly count of them, to buf. */
+static char* put_digits(char* buf, uint64_t n, const int count)
+{
+    for (int i = count - 1; i >= 0; i--) {
+        buf[i] = (char)('0' + n % 10);
+        n /= 10;
+    }
+    return buf + count;
+}
+
+
+/* Format x as snprintf() "%.*Lg" does, with prec significant digits. Returns
+ * false if x is not a finite, non-zero value in the range of the fast path,
+ * or its rounding to prec digits is in doubt. */
+static bool format_fast(char* buf, const long double x, const int prec)
+{
+    if (prec > MAX_FAST_DIGITS - 1 || !isfinite(x) || x == 0.0L) return false;
+
+    const long double ax = fabsl(x);
+    const long double lo = pow10_table[prec - 1];
+    const long double hi = pow10_table[prec];
+
+    /* Find the decimal exponent of x, from its binary one, so that x scaled
+     * by 10^(prec - 1 - dexp) lies in [10^(prec - 1), 10^prec). */
+    int bexp;
+    frexpl(ax, &bexp);
+    int dexp = (int)floorl((long double)(bexp - 1) * 0.30102999566398119521L);
+    long double scaled;
+    for (int tries = 0;; tries++) {
+        const int k = prec - 1 - dexp;
+        if (k < -MAX_EXACT_POW10 || k > MAX_EXACT_POW10 || tries > 2) return false;
+        scaled = scale10(ax, k);
+        if (scaled >= hi) {
+            dexp++;
+        } else if (scaled < lo) {
+            dexp--;
+        } else {
+            break;
+        }
+    }
+
+    /* The scaled value is within half an ulp of exact. If that could put it
+     * on the other side of the halfway point between two integers, give up. */
+    const long double whole = floorl(scaled);
+    const long double frac = scaled - whole;
+    if (fabsl(frac - 0.5L) <= scaled * LDBL_EPSILON * 2) return false;
+
+    uint64_t n = (uint64_t)whole + (frac > 0.5L);
+    if ((long double)n == hi) {
+        n = (uint64_t)lo;
+        dexp++;
+    }
+
+    /* Drop trailing zeros. */
+    int count = prec;
+    while (count > 1 && n % 10 == 0) {
+        n /= 10;
+        count--;
+    }
+
+    char* p = buf;
+    if (x < 0) *p++ = '-';
+
+    if (dexp < -4 || dexp >= prec) {
+        /* d.ddde+XX */
+        const uint64_t lead = n / (uint64_t)pow10_table[count - 1];
+        *p++ = (char)('0' + lead);
+        if (count > 1) {
+            *p++ = '.';
+            p = put_digits(p, n - lead * (uint64_t)pow10_table[count - 1], count - 1);
+        }
+        *p++ = 'e';
+        *p++ = dexp < 0 ? '-' : '+';
+        const int e = dexp < 0 ? -dexp : dexp;
+        p = put_digits(p, (uint64_t)e, e >= 100 ? 3 : 2);
+    } else if (dexp < 0) {
+        /* 0.000ddd */
+        *p++ = '0';
+        *p++ = '.';
+        for (int i = -1; i > dexp; i--) *p++ = '0';
+        p = put_digits(p, n, count);
+    } else {
+        /* ddd.ddd, or ddd */
+        const int int_digits = dexp + 1;
+        if (count <= int_digits) {
+            p = put_digits(p, n, count);
+            for (int i = count; i < int_digits; i++) *p++ = '0';
+        } else {
+            const uint64_t div = (uint64_t)pow10_table[count - int_digits];
+            p = put_digits(p, n / div, int_digits);
+            *p++ = '.';
+            p = put_digits(p, n % div, count - int_digits);
+        }
+    }
+    *p = '\0';
+    return true;
+}
+
+
+/* Format x with prec significant digits. If there's no '.' or exponent
+ * marker, force a ".0", so that the result still reads back as a real. */
+static void format_digits(char* buf, const long double x, const int prec)
+{
+    if (!format_fast(buf, x, prec)) {
+        snprintf(buf, REAL_BUF_SIZE - 2, "%.*Lg", prec, x);
+    }
+    if (!strpbrk(buf, ".eE")) {
+        strcat(buf, ".0");
+    }
+}
+
+
+/* Format x with REAL_DISPLAY_DIGITS significant digits, exactly as "%.15Lg"
+ * would, plus the ".0" described above. */
+void format_real(char* buf, const long double x)
+{
+    format_digits(buf, x, REAL_DISPLAY_DIGITS);
+}
+
+
+/* Format x with the fewest significant digits which read back as exactly x,
+ * and no fewer than REAL_DISPLAY_DIGITS. This is how display, write and
+ * number->string all print reals. Reals which came from a decimal literal of
+ * up to REAL_DISPLAY_DIGITS digits come out as they went in. */
+void format_real_shortest(char* buf, const long double x)
+{
+    if (!isfinite(x)) {
+        format_real(buf, x);
+        return;
+    }
+    for (int prec = REAL_DISPLAY_DIGITS; prec < MAX_ROUND_TRIP_DIGITS; prec++) {
+        format_digits(buf, x, prec);
+        long double back;
+        if (!parse_decimal_fast(buf, &back)) {
+            back = strtold(buf, nullptr);
+        }
+        if (back == x) return;
+    }
+    format_digits(buf, x, MAX_ROUND_TRIP_DIGITS);
+}
+
+
+/* Format x, a double, or a float if single is true, with the fewest
+ * significant digits which read back as exactly x in that precision. Used
+ * for the elements of f64 and f32 bytevectors, where the digits needed to
+ * tell apart long doubles would only add noise. */
+void format_float_shortest(char* buf, const double x, const bool single)
+{
+    if (!isfinite(x)) {
+        format_real(buf, x);
+        return;
+    }
+    const int max_digits = single ? FLT_DECIMAL_DIG : DBL_DECIMAL_DIG;
+    for (int prec = 1; prec < max_digits; prec++) {
+        format_digits(buf, x, prec);
+        if (single ? strtof(buf, nullptr) == (float)x : strtod(buf, nullptr) == x) return;
+    }
+    format_digits(buf, x, max_digits);
+}
@@ -0,0 +1,37 @@
+/*
+ * 'src/float_io.h'
+ * This file is part of Cozenage - https://github.com/DarrenKirby/cozenage
+ * Copyright © 2026 Darren Kirby <darren@dragonbyte.ca>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COZENAGE_FLOAT_IO_H
+#define COZENAGE_FLOAT_IO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Significant digits with which reals are formatted, at least. */
+#define REAL_DISPLAY_DIGITS 15
+
+/* Big enough for any real formatted by the functions below. */
+#define REAL_BUF_SIZE 64
+
+bool parse_decimal_fast(const char* str, long double* out);
+void format_real(char* buf, long double x);
+void format_real_shortest(char* buf, long double x);
+void format_float_shortest(char* buf, double x, bool single);
+
+#endif //COZENAGE_FLOAT_IO_H
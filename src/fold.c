@@ -0,0 +1,390 @@
+/*
+ * 'src/fold.c'
+ * This file is part of Cozenage - https://github.com/DarrenKirby/cozenage
+ * Copyright © 2026 Darren Kirby <darren@dragonbyte.ca>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* This file implements a constant folding pass, which runs on the output of
+ * expand(), before analysis or compilation. It:
+ *
+ *  - replaces calls of known-pure builtins on literal args with their result,
+ *    ie: (* 2 (+ 1 2)) -> 6,
+ *  - replaces an 'if' on a literal test with the branch it would take,
+ *  - eliminates trivial lets: (let () e) -> e, and (let ((x e)) x) -> e.
+ *
+ * A call is only folded if its operator is not bound by an enclosing lambda,
+ * let or letrec, is not the target of a define or set! anywhere in the form,
+ * and is still globally bound to the original builtin. Calls which return an
+ * error are left for the evaluator to raise, and the args of macro uses are
+ * left untouched.
+ *
+ * A procedure body may run after a later form has rebound the builtin, so a
+ * call folded there is kept behind a guard: (%fold value call op ...) yields
+ * value while each op is still bound to its builtin, and runs call otherwise.
+ * The ops are those of the call, and of any folded calls in its args.
+ */
+
+#include "fold.h"
+#include "cell.h"
+#include "symbols.h"
+
+#include <stdio.h>
+
+
+fold_stats_t fold_stats = {0};
+
+/* Types which may be passed to, and returned from a folded call. Strings
+ * may be args, but are never results, as a folded string would be shared
+ * by every evaluation of the expression. */
+#define FOLD_RESULTS (CELL_INTEGER|CELL_REAL|CELL_RATIONAL|CELL_COMPLEX| \
+                      CELL_BIGINT|CELL_BIGFLOAT|CELL_BOOLEAN|CELL_CHAR)
+#define FOLD_LITERALS (FOLD_RESULTS|CELL_STRING)
+
+
+/* Names bound by an enclosing lambda (formals), or let/letrec (bindings).
+ * A frame of formals is the body of a procedure. */
+typedef struct Shadow {
+    const Cell* names;
+    bool bindings;
+    const struct Shadow* up;
+} Shadow;
+
+typedef struct {
+    const Lex* env;
+    Cell* assigned;  /* Names which are defined or set! in the form. */
+    Cell* macros;    /* Names of macros defined in the form. */
+} Fold_Ctx;
+
+
+static bool in_list(const Cell* list, const Cell* sym)
+{
+    for (int i = 0; i < list->count; i++) {
+        if (list->cell[i] == sym) return true;
+    }
+    return false;
+}
+
+
+static bool is_shadowed(const Shadow* s, const Cell* sym)
+{
+    for (; s; s = s->up) {
+        if (cell_type(s->names) == CELL_SYMBOL) {
+            if (s->names == sym) return true;
+            continue;
+        }
+        for (int i = 0; i < s->names->count; i++) {
+            const Cell* n = s->names->cell[i];
+            if (s->bindings && cell_type(n) == CELL_SEXPR && n->count > 0) {
+                n = n->cell[0];
+            }
+            if (n == sym) return true;
+        }
+    }
+    return false;
+}
+
+
+static bool in_procedure(const Shadow* s)
+{
+    for (; s; s = s->up) {
+        if (!s->bindings) return true;
+    }
+    return false;
+}
+
+
+/* Gather the names the form binds globally at runtime. */
+static void collect_assigned(const Cell* c, const Fold_Ctx* ctx)
+{
+    if (cell_type(c) != CELL_SEXPR || c->count == 0) return;
+    const Cell* head = c->cell[0];
+    if (head == G_quote_sym) return;
+
+    if ((head == G_define_sym || head == G_set_bang_sym || head == G_defmacro_sym) &&
+        c->count > 1) {
+        Cell* target = c->cell[1];
+        if (cell_type(target) == CELL_SEXPR && target->count > 0) {
+            target = target->cell[0];
+        }
+        if (cell_type(target) == CELL_SYMBOL) {
+            cell_add(head == G_defmacro_sym ? ctx->macros : ctx->assigned, target);
+        }
+    }
+    for (int i = 0; i < c->count; i++) {
+        collect_assigned(c->cell[i], ctx);
+    }
+}
+
+
+/* A literal arg is a self-evaluating atom, or a quoted symbol or atom. */
+static Cell* literal_value(Cell* c)
+{
+    if (cell_type(c) & FOLD_LITERALS) return c;
+    if (cell_type(c) == CELL_SEXPR && c->count == 2 && c->cell[0] == G_quote_sym &&
+        cell_type(c->cell[1]) & (FOLD_LITERALS|CELL_SYMBOL)) {
+        return c->cell[1];
+    }
+    return nullptr;
+}
+
+
+/* A guarded fold, (%fold value call op ...). */
+static bool is_guard(const Cell* c)
+{
+    return cell_type(c) == CELL_SEXPR && c->count >= 3 && c->cell[0] == G_fold_sym;
+}
+
+
+/* The value of a folded arg. The ops of a guarded arg are added to ops. */
+static Cell* arg_value(Cell* c, const Cell* ops)
+{
+    if (!is_guard(c)) return literal_value(c);
+    for (int i = 3; i < c->count; i++) {
+        if (!in_list(ops, c->cell[i])) cell_add((Cell*)ops, c->cell[i]);
+    }
+    return c->cell[1];
+}
+
+
+static bool is_macro_use(const Fold_Ctx* ctx, const Shadow* sh, const Cell* head)
+{
+    if (cell_type(head) != CELL_SYMBOL || is_shadowed(sh, head)) return false;
+    if (in_list(ctx->macros, head)) return true;
+    const Cell* v = lex_get(ctx->env, head);
+    return v && cell_type(v) == CELL_MACRO;
+}
+
+
+/* Return the builtin a call head refers to, if it is pure and unchanged. */
+static Cell* (*pure_func(const Fold_Ctx* ctx, const Shadow* sh, const Cell* head))(const Lex*, const Cell*)
+{
+    if (cell_type(head) != CELL_SYMBOL || is_shadowed(sh, head) ||
+        in_list(ctx->assigned, head)) {
+        return nullptr;
+    }
+    const Cell* v = lex_get(ctx->env, head);
+    if (!v || cell_type(v) != CELL_PROC || !v->is_builtin) return nullptr;
+
+    const builtin_entry* b = builtin_lookup(head->sym);
+    return b && b->pure && v->builtin == b->func ? v->builtin : nullptr;
+}
+
+
+static Cell* fold_expr(const Fold_Ctx* ctx, const Shadow* sh, Cell* c);
+
+
+static void fold_from(const Fold_Ctx* ctx, const Shadow* sh, const Cell* c, const int start)
+{
+    for (int i = start; i < c->count; i++) {
+        c->cell[i] = fold_expr(ctx, sh, c->cell[i]);
+    }
+}
+
+
+/* let and letrec bindings must be ((symbol init) ...), or they are left for
+ * the analyzer to report. */
+static bool bindings_ok(const Cell* bindings)
+{
+    if (cell_type(bindings) != CELL_SEXPR) return false;
+    for (int i = 0; i < bindings->count; i++) {
+        const Cell* b = bindings->cell[i];
+        if (cell_type(b) != CELL_SEXPR || b->count != 2 ||
+            cell_type(b->cell[0]) != CELL_SYMBOL) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/* A body which may hold definitions cannot be lifted out of its let, as they
+ * would no longer be local to it. */
+static bool may_define(const Fold_Ctx* ctx, const Shadow* sh, const Cell* body)
+{
+    if (cell_type(body) != CELL_SEXPR || body->count == 0) return false;
+    const Cell* head = body->cell[0];
+    return head == G_define_sym || head == G_begin_sym || head == G_defmacro_sym ||
+           head == G_import_sym || is_macro_use(ctx, sh, head);
+}
+
+
+static Cell* fold_let(const Fold_Ctx* ctx, const Shadow* sh, Cell* c, const bool rec)
+{
+    if (c->count < 3 || !bindings_ok(c->cell[1])) return c;
+    const Cell* bindings = c->cell[1];
+    const Shadow inner = { bindings, true, sh };
+
+    for (int i = 0; i < bindings->count; i++) {
+        Cell* b = bindings->cell[i];
+        b->cell[1] = fold_expr(ctx, rec ? &inner : sh, b->cell[1]);
+    }
+    fold_from(ctx, &inner, c, 2);
+
+    if (rec || c->count != 3) return c;
+    Cell* body = c->cell[2];
+    /* (let () e) -> e */
+    if (bindings->count == 0 && !may_define(ctx, sh, body)) {
+        fold_stats.folds++;
+        return body;
+    }
+    /* (let ((x e)) x) -> e */
+    if (bindings->count == 1 && body == bindings->cell[0]->cell[0]) {
+        fold_stats.folds++;
+        return bindings->cell[0]->cell[1];
+    }
+    return c;
+}
+
+
+static Cell* fold_if(const Fold_Ctx* ctx, const Shadow* sh, Cell* c)
+{
+    fold_from(ctx, sh, c, 1);
+    if (c->count < 3 || c->count > 4) return c;
+
+    const Cell* test = literal_value(c->cell[1]);
+    if (!test) return c;
+    if (cell_type(test) != CELL_BOOLEAN || test->boolean_v) {
+        fold_stats.folds++;
+        return c->cell[2];
+    }
+    /* A one-armed if on #false is left to return its unspecified value. */
+    if (c->count == 4) {
+        fold_stats.folds++;
+        return c->cell[3];
+    }
+    return c;
+}
+
+
+static Cell* fold_call(const Fold_Ctx* ctx, const Shadow* sh, Cell* c)
+{
+    if (is_macro_use(ctx, sh, c->cell[0])) return c;
+    fold_from(ctx, sh, c, 0);
+
+    Cell* (*func)(const Lex*, const Cell*) = pure_func(ctx, sh, c->cell[0]);
+    if (!func) return c;
+
+    Cell* args = make_cell_sexpr();
+    Cell* ops = make_cell_sexpr();
+    cell_add(ops, c->cell[0]);
+    for (int i = 1; i < c->count; i++) {
+        Cell* v = arg_value(c->cell[i], ops);
+        if (!v) return c;
+        cell_add(args, v);
+    }
+
+    Cell* result = func(ctx->env, args);
+    if (!result || !(cell_type(result) & FOLD_RESULTS)) return c;
+    fold_stats.folds++;
+    if (!in_procedure(sh)) return result;
+
+    Cell* guard = make_cell_sexpr();
+    cell_add(guard, G_fold_sym);
+    cell_add(guard, result);
+    cell_add(guard, c);
+    for (int i = 0; i < ops->count; i++) {
+        cell_add(guard, ops->cell[i]);
+    }
+    return guard;
+}
+
+
+static Cell* fold_expr(const Fold_Ctx* ctx, const Shadow* sh, Cell* c)
+{
+    if (cell_type(c) != CELL_SEXPR || c->count == 0) return c;
+
+    const Cell* head = c->cell[0];
+    if (cell_type(head) != CELL_SYMBOL || head->sf_id <= 0) {
+        return fold_call(ctx, sh, c);
+    }
+
+    switch (head->sf_id) {
+        case SF_ID_IF:
+            return fold_if(ctx, sh, c);
+        case SF_ID_LET:
+            return fold_let(ctx, sh, c, false);
+        case SF_ID_LETREC:
+            return fold_let(ctx, sh, c, true);
+        case SF_ID_LAMBDA: {
+            if (c->count < 3) return c;
+            const Shadow inner = { c->cell[1], false, sh };
+            fold_from(ctx, &inner, c, 2);
+            return c;
+        }
+        case SF_ID_DEFINE: {
+            if (c->count < 3) return c;
+            if (cell_type(c->cell[1]) == CELL_SEXPR) {
+                const Shadow inner = { c->cell[1], false, sh };
+                fold_from(ctx, &inner, c, 2);
+            } else {
+                fold_from(ctx, sh, c, 2);
+            }
+            return c;
+        }
+        case SF_ID_SET_BANG:
+            fold_from(ctx, sh, c, 2);
+            return c;
+        case SF_ID_BEGIN:
+        case SF_ID_AND:
+            fold_from(ctx, sh, c, 1);
+            return c;
+        default:
+            /* quote, defmacro, delay and friends hold data, or are opaque. */
+            return c;
+    }
+}
+
+
+/* Fold the constant sub-expressions of an expanded top-level form, which
+ * will be run in environment e. The form is rewritten in place. */
+Cell* fold_constants(Cell* expr, const Lex* e)
+{
+    if (cell_type(expr) != CELL_SEXPR) return expr;
+
+    const Fold_Ctx ctx = { e, make_cell_sexpr(), make_cell_sexpr() };
+    collect_assigned(expr, &ctx);
+    return fold_expr(&ctx, nullptr, expr);
+}
+
+
+/* Check the shape of a (%fold value call op ...) form, whose ops must all
+ * name builtins. */
+bool fold_guard_ok(const Cell* form)
+{
+    if (!is_guard(form)) return false;
+    for (int i = 3; i < form->count; i++) {
+        const Cell* op = form->cell[i];
+        if (cell_type(op) != CELL_SYMBOL || !builtin_lookup(op->sym)) return false;
+    }
+    return true;
+}
+
+
+/* The original builtin procedure named by op, to check its binding against. */
+Cell* fold_builtin(const Cell* op)
+{
+    const builtin_entry* b = builtin_lookup(op->sym);
+    return lex_make_builtin(b->name, b->func);
+}
+
+
+/* Print the folds made in file_path, if -s/--stats was given. */
+void fold_stats_report(const char* file_path)
+{
+    if (!fold_stats.report) return;
+    fprintf(stderr, "%s: %ld constant fold%s\n",
+        file_path, fold_stats.folds, fold_stats.folds == 1 ? "" : "s");
+}
@@ -0,0 +1,48 @@
+/*
+ * 'src/fold.h'
+ * This file is part of Cozenage - https://github.com/DarrenKirby/cozenage
+ * Copyright © 2026 Darren Kirby <darren@dragonbyte.ca>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COZENAGE_FOLD_H
+#define COZENAGE_FOLD_H
+
+#include "cell.h"
+#include "types.h"
+
+
+/* Fold counts, reported per file with -s/--stats. */
+typedef struct {
+    bool report;    /* Print the folds made in each file run or loaded. */
+    long folds;     /* Folds made in the current file. */
+} fold_stats_t;
+
+extern fold_stats_t fold_stats;
+
+Cell* fold_constants(Cell* expr, const Lex* e);
+bool fold_guard_ok(const Cell* form);
+Cell* fold_builtin(const Cell* op);
+void fold_stats_report(const char* file_path);
+
+
+/* Is v, the value bound to an op of a (%fold ...) guard, still the
+ * builtin the call was folded with? */
+static inline bool fold_bound_to(const Cell* v, const Cell* builtin)
+{
+    return cell_type(v) == CELL_PROC && v->is_builtin && v->builtin == builtin->builtin;
+}
+
+#endif //COZENAGE_FOLD_H
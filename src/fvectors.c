@@ -0,0 +1,822 @@
+/*
+ * 'src/fvectors.c'
+ * This file is part of Cozenage - https://github.com/DarrenKirby/cozenage
+ * Copyright © 2026 Darren Kirby <darren@dragonbyte.ca>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* This file implements the SRFI-4 procedures for f32 and f64 bytevectors,
+ * and numeric kernels which run over their unboxed elements: sum, dot
+ * product, min, max, scale and axpy.
+ *
+ * The kernels work on four doubles at a time, in an AVX2 register where
+ * available, and otherwise in a plain array which the compiler is free to
+ * vectorize as it can. Both take the same steps in the same order. f32
+ * elements are widened to double for the arithmetic, and rounded back when
+ * stored. */
+
+#include "fvectors.h"
+#include "bytevectors.h"
+#include "types.h"
+
+#include <limits.h>
+#include <math.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+
+/*-------------------------------------------------------*
+ *                    Numeric kernels                    *
+ * ------------------------------------------------------*/
+
+/* The lesser, or greater, of x and m, where m is a running min or max which
+ * is never a NaN. A NaN in x is skipped, as by fmin() and fmax(). Every
+ * path of the min and max reductions below compares this way. */
+static inline double min_num(const double x, const double m) { return x < m ? x : m; }
+static inline double max_num(const double x, const double m) { return x > m ? x : m; }
+
+#if defined(__AVX2__)
+
+typedef __m256d lanes;
+
+static inline lanes lanes_set1(const double x) { return _mm256_set1_pd(x); }
+static inline lanes lanes_add(const lanes a, const lanes b) { return _mm256_add_pd(a, b); }
+static inline lanes lanes_mul(const lanes a, const lanes b) { return _mm256_mul_pd(a, b); }
+/* x < m ? x : m, and x > m ? x : m, lane by lane, as min_num() and max_num()
+ * below: so a NaN in x leaves m as it was. The operand order matters. */
+static inline lanes lanes_min(const lanes x, const lanes m) { return _mm256_min_pd(x, m); }
+static inline lanes lanes_max(const lanes x, const lanes m) { return _mm256_max_pd(x, m); }
+static inline lanes lanes_load_f64(const double* p) { return _mm256_loadu_pd(p); }
+static inline lanes lanes_load_f32(const float* p) { return _mm256_cvtps_pd(_mm_loadu_ps(p)); }
+static inline void lanes_store_f64(double* p, const lanes v) { _mm256_storeu_pd(p, v); }
+static inline void lanes_store_f32(float* p, const lanes v) { _mm_storeu_ps(p, _mm256_cvtpd_ps(v)); }
+static inline void lanes_spill(double* out, const lanes v) { _mm256_storeu_pd(out, v); }
+
+#else
+
+typedef struct { double v[4]; } lanes;
+
+static inline lanes lanes_set1(const double x)
+{
+    return (lanes){ { x, x, x, x } };
+}
+
+static inline lanes lanes_add(lanes a, const lanes b)
+{
+    for (int j = 0; j < 4; j++) a.v[j] += b.v[j];
+    return a;
+}
+
+static inline lanes lanes_mul(lanes a, const lanes b)
+{
+    for (int j = 0; j < 4; j++) a.v[j] *= b.v[j];
+    return a;
+}
+
+static inline lanes lanes_min(lanes x, const lanes m)
+{
+    for (int j = 0; j < 4; j++) x.v[j] = min_num(x.v[j], m.v[j]);
+    return x;
+}
+
+static inline lanes lanes_max(lanes x, const lanes m)
+{
+    for (int j = 0; j < 4; j++) x.v[j] = max_num(x.v[j], m.v[j]);
+    return x;
+}
+
+static inline lanes lanes_load_f64(const double* p)
+{
+    return (lanes){ { p[0], p[1], p[2], p[3] } };
+}
+
+static inline lanes lanes_load_f32(const float* p)
+{
+    return (lanes){ { p[0], p[1], p[2], p[3] } };
+}
+
+static inline void lanes_store_f64(double* p, const lanes v)
+{
+    for (int j = 0; j < 4; j++) p[j] = v.v[j];
+}
+
+static inline void lanes_store_f32(float* p, const lanes v)
+{
+    for (int j = 0; j < 4; j++) p[j] = (float)v.v[j];
+}
+
+static inline void lanes_spill(double* out, const lanes v)
+{
+    for (int j = 0; j < 4; j++) out[j] = v.v[j];
+}
+
+#endif
+
+/* Fold the lanes of v together, pairwise. */
+static inline double lanes_sum(const lanes v)
+{
+    double s[4];
+    lanes_spill(s, v);
+    return (s[0] + s[1]) + (s[2] + s[3]);
+}
+
+static inline double lanes_hmin(const lanes v)
+{
+    double s[4];
+    lanes_spill(s, v);
+    double m = s[0];
+    for (int j = 1; j < 4; j++) m = min_num(s[j], m);
+    return m;
+}
+
+static inline double lanes_hmax(const lanes v)
+{
+    double s[4];
+    lanes_spill(s, v);
+    double m = s[0];
+    for (int j = 1; j < 4; j++) m = max_num(s[j], m);
+    return m;
+}
+
+
+/* Reductions keep two sets of lanes, so that consecutive additions don't
+ * wait on each other. min and max start from an infinity and skip NaNs,
+ * wherever they are, and the caller sorts out a vector of nothing but NaNs. */
+#define DEFINE_FV_KERNELS(sfx, ctype)                                       \
+static double sum_##sfx(const ctype* x, const size_t n) {                   \
+lanes lo = lanes_set1(0.0), hi = lanes_set1(0.0);                           \
+size_t i = 0;                                                               \
+for (; i + 8 <= n; i += 8) {                                                \
+lo = lanes_add(lo, lanes_load_##sfx(x + i));                                \
+hi = lanes_add(hi, lanes_load_##sfx(x + i + 4));                            \
+}                                                                           \
+double total = lanes_sum(lanes_add(lo, hi));                                \
+for (; i < n; i++) total += x[i];                                           \
+return total;                                                               \
+}                                                                           \
+static double dot_##sfx(const ctype* x, const ctype* y, const size_t n) {   \
+lanes lo = lanes_set1(0.0), hi = lanes_set1(0.0);                           \
+size_t i = 0;                                                               \
+for (; i + 8 <= n; i += 8) {                                                \
+lo = lanes_add(lo, lanes_mul(lanes_load_##sfx(x + i),                       \
+                             lanes_load_##sfx(y + i)));                     \
+hi = lanes_add(hi, lanes_mul(lanes_load_##sfx(x + i + 4),                   \
+                             lanes_load_##sfx(y + i + 4)));                 \
+}                                                                           \
+double total = lanes_sum(lanes_add(lo, hi));                                \
+for (; i < n; i++) total += (double)x[i] * y[i];                            \
+return total;                                                               \
+}                                                                           \
+static double min_##sfx(const ctype* x, const size_t n) {                   \
+lanes lo = lanes_set1(INFINITY), hi = lanes_set1(INFINITY);                 \
+size_t i = 0;                                                               \
+for (; i + 8 <= n; i += 8) {                                                \
+lo = lanes_min(lanes_load_##sfx(x + i), lo);                                \
+hi = lanes_min(lanes_load_##sfx(x + i + 4), hi);                            \
+}                                                                           \
+double m = lanes_hmin(lanes_min(lo, hi));                                   \
+for (; i < n; i++) m = min_num(x[i], m);                                    \
+return m;                                                                   \
+}                                                                           \
+static double max_##sfx(const ctype* x, const size_t n) {                   \
+lanes lo = lanes_set1(-INFINITY), hi = lanes_set1(-INFINITY);               \
+size_t i = 0;                                                               \
+for (; i + 8 <= n; i += 8) {                                                \
+lo = lanes_max(lanes_load_##sfx(x + i), lo);                                \
+hi = lanes_max(lanes_load_##sfx(x + i + 4), hi);                            \
+}                                                                           \
+double m = lanes_hmax(lanes_max(lo, hi));                                   \
+for (; i < n; i++) m = max_num(x[i], m);                                    \
+return m;                                                                   \
+}                                                                           \
+static void scale_##sfx(ctype* x, const size_t n, const double k) {         \
+const lanes kv = lanes_set1(k);                                             \
+size_t i = 0;                                                               \
+for (; i + 4 <= n; i += 4) {                                                \
+lanes_store_##sfx(x + i, lanes_mul(lanes_load_##sfx(x + i), kv));           \
+}                                                                           \
+for (; i < n; i++) x[i] = (ctype)(x[i] * k);                                \
+}                                                                           \
+static void axpy_##sfx(const double k, const ctype* x, ctype* y,            \
+                       const size_t n) {                                    \
+const lanes kv = lanes_set1(k);                                             \
+size_t i = 0;                                                               \
+for (; i + 4 <= n; i += 4) {                                                \
+lanes_store_##sfx(y + i, lanes_add(lanes_mul(lanes_load_##sfx(x + i), kv),  \
+                                   lanes_load_##sfx(y + i)));               \
+}                                                                           \
+for (; i < n; i++) y[i] = (ctype)(x[i] * k + y[i]);                         \
+}
+
+DEFINE_FV_KERNELS(f64, double)
+DEFINE_FV_KERNELS(f32, float)
+
+
+/*-------------------------------------------------------*
+ *                   Argument checking                   *
+ * ------------------------------------------------------*/
+
+static const char* fvector_name(const bv_t type)
+{
+    return type == BV_F32 ? "f32vector" : "f64vector";
+}
+
+
+static Cell* check_fvector(const Cell* x, const bv_t type, const char* name, const int arg)
+{
+    if (cell_type(x) != CELL_BYTEVECTOR || x->bv->type != type) {
+        return make_cell_error(
+            fmt_err("%s: arg %d must be an %s", name, arg, fvector_name(type)),
+            TYPE_ERR);
+    }
+    return nullptr;
+}
+
+
+static Cell* check_real(const Cell* x, const char* name, const int arg)
+{
+    if (!(cell_type(x) & (CELL_INTEGER|CELL_RATIONAL|CELL_REAL))) {
+        return make_cell_error(
+            fmt_err("%s: arg %d must be a real number", name, arg),
+            TYPE_ERR);
+    }
+    return nullptr;
+}
+
+
+static Cell* check_index(const Cell* v, const Cell* k, const char* name)
+{
+    if (cell_type(k) != CELL_INTEGER) {
+        return make_cell_error(
+            fmt_err("%s: arg 2 must be an exact integer", name),
+            TYPE_ERR);
+    }
+    if (cell_int(k) < 0 || cell_int(k) >= v->count) {
+        return make_cell_error(
+            fmt_err("%s: index out of bounds", name),
+            INDEX_ERR);
+    }
+    return nullptr;
+}
+
+
+/*-------------------------------------------------------*
+ *     Constructors, selectors, and conversions          *
+ * ------------------------------------------------------*/
+
+static Cell* fvector(const Cell* a, const bv_t type, const char* name)
+{
+    for (int i = 0; i < a->count; i++) {
+        Cell* err = check_real(a->cell[i], name, i + 1);
+        if (err) return err;
+    }
+    Cell* v = make_cell_bytevector(type, a->count);
+    for (int i = 0; i < a->count; i++) {
+        byte_add(v, bv_real_bits(type, (double)cell_to_long_double(a->cell[i])));
+    }
+    return v;
+}
+
+
+static Cell* make_fvector(const Cell* a, const bv_t type, const char* name)
+{
+    Cell* err = CHECK_ARITY_RANGE(a, 1, 2, name);
+    if (err) return err;
+    if (cell_type(a->cell[0]) != CELL_INTEGER) {
+        return make_cell_error(
+            fmt_err("%s: arg 1 must be an integer", name),
+            TYPE_ERR);
+    }
+    const long long n = cell_int(a->cell[0]);
+    if (n < 0) {
+        return make_cell_error(
+            fmt_err("%s: arg 1 must be non-negative", name),
+            VALUE_ERR);
+    }
+    if (n > INT_MAX) {
+        return make_cell_error(
+            fmt_err("%s: arg 1 is too large", name),
+            VALUE_ERR);
+    }
+    double fill = 0.0;
+    if (a->count == 2) {
+        err = check_real(a->cell[1], name, 2);
+        if (err) return err;
+        fill = (double)cell_to_long_double(a->cell[1]);
+    }
+    Cell* v = make_cell_bytevector(type, n);
+    const int64_t bits = bv_real_bits(type, fill);
+    for (long long i = 0; i < n; i++) {
+        byte_add(v, bits);
+    }
+    return v;
+}
+
+
+static Cell* fvector_ref(const Cell* a, const bv_t type, const char* name)
+{
+    Cell* err = CHECK_ARITY_EXACT(a, 2, name);
+    if (err) return err;
+    err = check_fvector(a->cell[0], type, name, 1);
+    if (err) return err;
+    err = check_index(a->cell[0], a->cell[1], name);
+    if (err) return err;
+    return make_cell_real(bv_real_ref(a->cell[0], (int)cell_int(a->cell[1])));
+}
+
+
+static Cell* fvector_set(const Cell* a, const bv_t type, const char* name)
+{
+    Cell* err = CHECK_ARITY_EXACT(a, 3, name);
+    if (err) return err;
+    err = check_fvector(a->cell[0], type, name, 1);
+    if (err) return err;
+    err = check_index(a->cell[0], a->cell[1], name);
+    if (err) return err;
+    err = check_real(a->cell[2], name, 3);
+    if (err) return err;
+    err = bv_check_writable(a->cell[0], name);
+    if (err) return err;
+    bv_real_set(a->cell[0], (int)cell_int(a->cell[1]),
+        (double)cell_to_long_double(a->cell[2]));
+    return USP_Obj;
+}
+
+
+static Cell* fvector_length(const Cell* a, const bv_t type, const char* name)
+{
+    Cell* err = CHECK_ARITY_EXACT(a, 1, name);
+    if (err) return err;
+    err = check_fvector(a->cell[0], type, name, 1);
+    if (err) return err;
+    return make_cell_integer(a->cell[0]->count);
+}
+
+
+static Cell* fvector_to_list(const Cell* a, const bv_t type, const char* name)
+{
+    Cell* err = CHECK_ARITY_EXACT(a, 1, name);
+    if (err) return err;
+    err = check_fvector(a->cell[0], type, name, 1);
+    if (err) return err;
+
+    const Cell* v = a->cell[0];
+    Cell* result = make_cell_nil();
+    for (int i = v->count - 1; i >= 0; i--) {
+        result = make_cell_pair(make_cell_real(bv_real_ref(v, i)), result);
+        result->len = v->count - i;
+    }
+    return result;
+}
+
+
+static Cell* list_to_fvector(const Cell* a, const bv_t type, const char* name)
+{
+    Cell* err = CHECK_ARITY_EXACT(a, 1, name);
+    if (err) return err;
+    if (!(cell_type(a->cell[0]) & (CELL_PAIR|CELL_NIL))) {
+        return make_cell_error(
+            fmt_err("%s: arg 1 must be a list", name),
+            TYPE_ERR);
+    }
+    Cell* v = make_cell_bytevector(type, 0);
+    const Cell* p = a->cell[0];
+    for (; cell_type(p) == CELL_PAIR; p = p->cdr) {
+        if (!(cell_type(p->car) & (CELL_INTEGER|CELL_RATIONAL|CELL_REAL))) {
+            return make_cell_error(
+                fmt_err("%s: list members must be real numbers", name),
+                TYPE_ERR);
+        }
+        byte_add(v, bv_real_bits(type, (double)cell_to_long_double(p->car)));
+    }
+    if (cell_type(p) != CELL_NIL) {
+        return make_cell_error(
+            fmt_err("%s: arg 1 must be a proper list", name),
+            TYPE_ERR);
+    }
+    return v;
+}
+
+
+/*-------------------------------------------------------*
+ *                 Reductions and updates                *
+ * ------------------------------------------------------*/
+
+static Cell* fvector_sum(const Cell* a, const bv_t type, const char* name)
+{
+    Cell* err = CHECK_ARITY_EXACT(a, 1, name);
+    if (err) return err;
+    err = check_fvector(a->cell[0], type, name, 1);
+    if (err) return err;
+
+    const Cell* v = a->cell[0];
+    const size_t n = (size_t)v->count;
+    return make_cell_real(type == BV_F32
+        ? sum_f32(v->bv->data, n)
+        : sum_f64(v->bv->data, n));
+}
+
+
+static Cell* fvector_dot(const Cell* a, const bv_t type, const char* name)
+{
+    Cell* err = CHECK_ARITY_EXACT(a, 2, name);
+    if (err) return err;
+    err = check_fvector(a->cell[0], type, name, 1);
+    if (err) return err;
+    err = check_fvector(a->cell[1], type, name, 2);
+    if (err) return err;
+
+    const Cell* x = a->cell[0];
+    const Cell* y = a->cell[1];
+    if (x->count != y->count) {
+        return make_cell_error(
+            fmt_err("%s: vectors must be the same length", name),
+            VALUE_ERR);
+    }
+    const size_t n = (size_t)x->count;
+    return make_cell_real(type == BV_F32
+        ? dot_f32(x->bv->data, y->bv->data, n)
+        : dot_f64(x->bv->data, y->bv->data, n));
+}
+
+
+/* Min or max of the elements of an f32 or f64 vector, ignoring NaNs. */
+static Cell* fvector_extreme(const Cell* a, const bv_t type, const char* name, const bool max)
+{
+    Cell* err = CHECK_ARITY_EXACT(a, 1, name);
+    if (err) return err;
+    err = check_fvector(a->cell[0], type, name, 1);
+    if (err) return err;
+
+    const Cell* v = a->cell[0];
+    if (v->count == 0) {
+        return make_cell_error(
+            fmt_err("%s: vector is empty", name),
+            VALUE_ERR);
+    }
+    const size_t n = (size_t)v->count;
+    double m;
+    if (type == BV_F32) {
+        m = max ? max_f32(v->bv->data, n) : min_f32(v->bv->data, n);
+    } else {
+        m = max ? max_f64(v->bv->data, n) : min_f64(v->bv->data, n);
+    }
+
+    /* Still at its starting value: either an infinity is the answer, or
+     * every element is a NaN. */
+    if (isinf(m)) {
+        bool all_nan = true;
+        for (int i = 0; i < v->count && all_nan; i++) {
+            all_nan = isnan(bv_real_ref(v, i));
+        }
+        if (all_nan) m = NAN;
+    }
+    return make_cell_real(m);
+}
+
+
+static Cell* fvector_scale(const Cell* a, const bv_t type, const char* name)
+{
+    Cell* err = CHECK_ARITY_EXACT(a, 2, name);
+    if (err) return err;
+    err = check_fvector(a->cell[0], type, name, 1);
+    if (err) return err;
+    err = check_real(a->cell[1], name, 2);
+    if (err) return err;
+    err = bv_check_writable(a->cell[0], name);
+    if (err) return err;
+
+    const Cell* v = a->cell[0];
+    const double k = (double)cell_to_long_double(a->cell[1]);
+    const size_t n = (size_t)v->count;
+    if (type == BV_F32) {
+        scale_f32(v->bv->data, n, k);
+    } else {
+        scale_f64(v->bv->data, n, k);
+    }
+    return USP_Obj;
+}
+
+
+static Cell* fvector_axpy(const Cell* a, const bv_t type, const char* name)
+{
+    Cell* err = CHECK_ARITY_EXACT(a, 3, name);
+    if (err) return err;
+    err = check_real(a->cell[0], name, 1);
+    if (err) return err;
+    err = check_fvector(a->cell[1], type, name, 2);
+    if (err) return err;
+    err = check_fvector(a->cell[2], type, name, 3);
+    if (err) return err;
+    err = bv_check_writable(a->cell[2], name);
+    if (err) return err;
+
+    const Cell* x = a->cell[1];
+    const Cell* y = a->cell[2];
+    if (x->count != y->count) {
+        return make_cell_error(
+            fmt_err("%s: vectors must be the same length", name),
+            VALUE_ERR);
+    }
+    const double k = (double)cell_to_long_double(a->cell[0]);
+    const size_t n = (size_t)x->count;
+    if (type == BV_F32) {
+        axpy_f32(k, x->bv->data, y->bv->data, n);
+    } else {
+        axpy_f64(k, x->bv->data, y->bv->data, n);
+    }
+    return USP_Obj;
+}
+
+
+/*-------------------------------------------------------*
+ *              SRFI-4 f64 vector procedures             *
+ * ------------------------------------------------------*/
+
+/* (f64vector x ...)
+ * Returns a newly allocated f64 vector whose elements are the real numbers x ..., in order. */
+Cell* builtin_f64vector(const Lex* e, const Cell* a)
+{
+    (void)e;
+    return fvector(a, BV_F64, "f64vector");
+}
+
+
+/* (make-f64vector k)
+ * (make-f64vector k x)
+ * Returns a newly allocated f64 vector of k elements, each set to x, or to 0.0 if x is not
+ * given. */
+Cell* builtin_make_f64vector(const Lex* e, const Cell* a)
+{
+    (void)e;
+    return make_fvector(a, BV_F64, "make-f64vector");
+}
+
+
+/* (f64vector? obj)
+ * Returns #t if obj is an f64 vector, otherwise returns #f. */
+Cell* builtin_f64vector_pred(const Lex* e, const Cell* a)
+{
+    (void)e;
+    Cell* err = CHECK_ARITY_EXACT(a, 1, "f64vector?");
+    if (err) return err;
+    const Cell* x = a->cell[0];
+    return make_cell_boolean(cell_type(x) == CELL_BYTEVECTOR && x->bv->type == BV_F64);
+}
+
+
+/* (f64vector-length v)
+ * Returns the number of elements in the f64 vector v. */
+Cell* builtin_f64vector_length(const Lex* e, const Cell* a)
+{
+    (void)e;
+    return fvector_length(a, BV_F64, "f64vector-length");
+}
+
+
+/* (f64vector-ref v k)
+ * Returns element k of the f64 vector v, as a real. */
+Cell* builtin_f64vector_ref(const Lex* e, const Cell* a)
+{
+    (void)e;
+    return fvector_ref(a, BV_F64, "f64vector-ref");
+}
+
+
+/* (f64vector-set! v k x)
+ * Stores the real number x in element k of the f64 vector v. */
+Cell* builtin_f64vector_set_bang(const Lex* e, const Cell* a)
+{
+    (void)e;
+    return fvector_set(a, BV_F64, "f64vector-set!");
+}
+
+
+/* (f64vector->list v)
+ * Returns a newly allocated list of the elements of the f64 vector v, in order. */
+Cell* builtin_f64vector_to_list(const Lex* e, const Cell* a)
+{
+    (void)e;
+    return fvector_to_list(a, BV_F64, "f64vector->list");
+}
+
+
+/* (list->f64vector list)
+ * Returns a newly allocated f64 vector of the real numbers in list, in order. */
+Cell* builtin_list_to_f64vector(const Lex* e, const Cell* a)
+{
+    (void)e;
+    return list_to_fvector(a, BV_F64, "list->f64vector");
+}
+
+
+/*-------------------------------------------------------*
+ *              SRFI-4 f32 vector procedures             *
+ * ------------------------------------------------------*/
+
+/* (f32vector x ...)
+ * Returns a newly allocated f32 vector whose elements are the real numbers x ..., rounded to
+ * single precision, in order. */
+Cell* builtin_f32vector(const Lex* e, const Cell* a)
+{
+    (void)e;
+    return fvector(a, BV_F32, "f32vector");
+}
+
+
+/* (make-f32vector k)
+ * (make-f32vector k x)
+ * Returns a newly allocated f32 vector of k elements, each set to x, or to 0.0 if x is not
+ * given. */
+Cell* builtin_make_f32vector(const Lex* e, const Cell* a)
+{
+    (void)e;
+    return make_fvector(a, BV_F32, "make-f32vector");
+}
+
+
+/* (f32vector? obj)
+ * Returns #t if obj is an f32 vector, otherwise returns #f. */
+Cell* builtin_f32vector_pred(const Lex* e, const Cell* a)
+{
+    (void)e;
+    Cell* err = CHECK_ARITY_EXACT(a, 1, "f32vector?");
+    if (err) return err;
+    const Cell* x = a->cell[0];
+    return make_cell_boolean(cell_type(x) == CELL_BYTEVECTOR && x->bv->type == BV_F32);
+}
+
+
+/* (f32vector-length v)
+ * Returns the number of elements in the f32 vector v. */
+Cell* builtin_f32vector_length(const Lex* e, const Cell* a)
+{
+    (void)e;
+    return fvector_length(a, BV_F32, "f32vector-length");
+}
+
+
+/* (f32vector-ref v k)
+ * Returns element k of the f32 vector v, as a real. */
+Cell* builtin_f32vector_ref(const Lex* e, const Cell* a)
+{
+    (void)e;
+    return fvector_ref(a, BV_F32, "f32vector-ref");
+}
+
+
+/* (f32vector-set! v k x)
+ * Stores the real number x, rounded to single precision, in element k of the f32 vector v. */
+Cell* builtin_f32vector_set_bang(const Lex* e, const Cell* a)
+{
+    (void)e;
+    return fvector_set(a, BV_F32, "f32vector-set!");
+}
+
+
+/* (f32vector->list v)
+ * Returns a newly allocated list of the elements of the f32 vector v, in order. */
+Cell* builtin_f32vector_to_list(const Lex* e, const Cell* a)
+{
+    (void)e;
+    return fvector_to_list(a, BV_F32, "f32vector->list");
+}
+
+
+/* (list->f32vector list)
+ * Returns a newly allocated f32 vector of the real numbers in list, in order. */
+Cell* builtin_list_to_f32vector(const Lex* e, const Cell* a)
+{
+    (void)e;
+    return list_to_fvector(a, BV_F32, "list->f32vector");
+}
+
+
+/*-------------------------------------------------------*
+ *                    Numeric kernels                    *
+ * ------------------------------------------------------*/
+
+/* (f64vector-sum v)
+ * Returns the sum of the elements of v. */
+Cell* builtin_f64vector_sum(const Lex* e, const Cell* a)
+{
+    (void)e;
+    return fvector_sum(a, BV_F64, "f64vector-sum");
+}
+
+
+/* (f64vector-dot x y)
+ * Returns the dot product of x and y, which must be the same length. */
+Cell* builtin_f64vector_dot(const Lex* e, const Cell* a)
+{
+    (void)e;
+    return fvector_dot(a, BV_F64, "f64vector-dot");
+}
+
+
+/* (f64vector-min v)
+ * Returns the least element of the non-empty vector v. NaNs are ignored, unless there is
+ * nothing else. */
+Cell* builtin_f64vector_min(const Lex* e, const Cell* a)
+{
+    (void)e;
+    return fvector_extreme(a, BV_F64, "f64vector-min", false);
+}
+
+
+/* (f64vector-max v)
+ * Returns the greatest element of the non-empty vector v. NaNs are ignored, unless there is
+ * nothing else. */
+Cell* builtin_f64vector_max(const Lex* e, const Cell* a)
+{
+    (void)e;
+    return fvector_extreme(a, BV_F64, "f64vector-max", true);
+}
+
+
+/* (f64vector-scale! v k)
+ * Multiplies each element of v by k, in place. */
+Cell* builtin_f64vector_scale_bang(const Lex* e, const Cell* a)
+{
+    (void)e;
+    return fvector_scale(a, BV_F64, "f64vector-scale!");
+}
+
+
+/* (f64vector-axpy! k x y)
+ * Adds k times each element of x to the same element of y, in place: y = kx + y. */
+Cell* builtin_f64vector_axpy_bang(const Lex* e, const Cell* a)
+{
+    (void)e;
+    return fvector_axpy(a, BV_F64, "f64vector-axpy!");
+}
+
+
+/* (f32vector-sum v)
+ * Returns the sum of the elements of v, added in double precision. */
+Cell* builtin_f32vector_sum(const Lex* e, const Cell* a)
+{
+    (void)e;
+    return fvector_sum(a, BV_F32, "f32vector-sum");
+}
+
+
+/* (f32vector-dot x y)
+ * Returns the dot product of x and y, which must be the same length, in double precision. */
+Cell* builtin_f32vector_dot(const Lex* e, const Cell* a)
+{
+    (void)e;
+    return fvector_dot(a, BV_F32, "f32vector-dot");
+}
+
+
+/* (f32vector-min v)
+ * Returns the least element of the non-empty vector v. NaNs are ignored, unless there is
+ * nothing else. */
+Cell* builtin_f32vector_min(const Lex* e, const Cell* a)
+{
+    (void)e;
+    return fvector_extreme(a, BV_F32, "f32vector-min", false);
+}
+
+
+/* (f32vector-max v)
+ * Returns the greatest element of the non-empty vector v. NaNs are ignored, unless there is
+ * nothing else. */
+Cell* builtin_f32vector_max(const Lex* e, const Cell* a)
+{
+    (void)e;
+    return fvector_extreme(a, BV_F32, "f32vector-max", true);
+}
+
+
+/* (f32vector-scale! v k)
+ * Multiplies each element of v by k, in place. */
+Cell* builtin_f32vector_scale_bang(const Lex* e, const Cell* a)
+{
+    (void)e;
+    return fvector_scale(a, BV_F32, "f32vector-scale!");
+}
+
+
+/* (f32vector-axpy! k x y)
+ * Adds k times each element of x to the same element of y, in place: y = kx + y. */
+Cell* builtin_f32vector_axpy_bang(const Lex* e, const Cell* a)
+{
+    (void)e;
+    return fvector_axpy(a, BV_F32, "f32vector-axpy!");
+}
@@ -0,0 +1,60 @@
+/*
+ * 'src/fvectors.h'
+ * This file is part of Cozenage - https://github.com/DarrenKirby/cozenage
+ * Copyright © 2026 Darren Kirby <darren@dragonbyte.ca>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COZENAGE_FVECTORS_H
+#define COZENAGE_FVECTORS_H
+
+#include "cell.h"
+
+
+/* SRFI-4 f64 vector procedures */
+Cell* builtin_f64vector(const Lex* e, const Cell* a);
+Cell* builtin_make_f64vector(const Lex* e, const Cell* a);
+Cell* builtin_f64vector_pred(const Lex* e, const Cell* a);
+Cell* builtin_f64vector_length(const Lex* e, const Cell* a);
+Cell* builtin_f64vector_ref(const Lex* e, const Cell* a);
+Cell* builtin_f64vector_set_bang(const Lex* e, const Cell* a);
+Cell* builtin_f64vector_to_list(const Lex* e, const Cell* a);
+Cell* builtin_list_to_f64vector(const Lex* e, const Cell* a);
+
+/* SRFI-4 f32 vector procedures */
+Cell* builtin_f32vector(const Lex* e, const Cell* a);
+Cell* builtin_make_f32vector(const Lex* e, const Cell* a);
+Cell* builtin_f32vector_pred(const Lex* e, const Cell* a);
+Cell* builtin_f32vector_length(const Lex* e, const Cell* a);
+Cell* builtin_f32vector_ref(const Lex* e, const Cell* a);
+Cell* builtin_f32vector_set_bang(const Lex* e, const Cell* a);
+Cell* builtin_f32vector_to_list(const Lex* e, const Cell* a);
+Cell* builtin_list_to_f32vector(const Lex* e, const Cell* a);
+
+/* Numeric kernels */
+Cell* builtin_f64vector_sum(const Lex* e, const Cell* a);
+Cell* builtin_f64vector_dot(const Lex* e, const Cell* a);
+Cell* builtin_f64vector_min(const Lex* e, const Cell* a);
+Cell* builtin_f64vector_max(const Lex* e, const Cell* a);
+Cell* builtin_f64vector_scale_bang(const Lex* e, const Cell* a);
+Cell* builtin_f64vector_axpy_bang(const Lex* e, const Cell* a);
+Cell* builtin_f32vector_sum(const Lex* e, const Cell* a);
+Cell* builtin_f32vector_dot(const Lex* e, const Cell* a);
+Cell* builtin_f32vector_min(const Lex* e, const Cell* a);
+Cell* builtin_f32vector_max(const Lex* e, const Cell* a);
+Cell* builtin_f32vector_scale_bang(const Lex* e, const Cell* a);
+Cell* builtin_f32vector_axpy_bang(const Lex* e, const Cell* a);
+
+#endif //COZENAGE_FVECTORS_H
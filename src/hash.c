@@ -51,6 +51,7 @@ ht_table* ht_create(const int initial_capacity)
     }
     table->count = 0;
     table->capacity = initial_capacity;
+    table->generation = 0;
 
     /* Allocate space for entry buckets. */
     table->items = GC_MALLOC(table->capacity * sizeof(ht_item));
@@ -92,11 +93,48 @@ uint64_t hash_string_key(const char* key)
 }
 
 
+/* As hash_string_key(), for the first len bytes of key, which need not be
+ * NUL-terminated. */
+uint64_t hash_string_key_n(const char* key, const size_t len)
+{
+    uint64_t hash = FNV_OFFSET;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (uint64_t)(unsigned char)key[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+
 /* Given a hash table and key, return a pointer to the object or null. */
 Cell* ht_get(const ht_table* table, const char* key)
+{
+    return ht_get_hashed(table, key, hash_string_key(key));
+}
+
+
+/* As ht_get(), where the caller already has hash_string_key(key), such as
+ * the hash cached in a symbol cell. */
+Cell* ht_get_hashed(const ht_table* table, const char* key, const uint64_t hash)
+{
+    const ht_item* item = ht_get_item_hashed(table, key, hash);
+    return item ? item->value : nullptr;
+}
+
+
+/* Given a hash table and key, return a pointer to the slot holding the key,
+ * or null. The slot stays valid, and ht_set() updates its value in place,
+ * until the table's generation changes. */
+ht_item* ht_get_item(const ht_table* table, const char* key)
+{
+    return ht_get_item_hashed(table, key, hash_string_key(key));
+}
+
+
+/* As ht_get_item(), with a precomputed hash_string_key(key). */
+ht_item* ht_get_item_hashed(const ht_table* table, const char* key, const uint64_t hash)
 {
     /* AND hash with capacity-1 to ensure it's within entries array. */
-    const uint64_t hash = hash_string_key(key);
     size_t index = hash & (uint64_t)(table->capacity - 1);
 
     /* Loop till we find an empty entry. */
@@ -104,8 +142,8 @@ Cell* ht_get(const ht_table* table, const char* key)
         /* Keep iterating if slot marked as deleted. */
         if (table->items[index].key != HT_DELETED_ITEM.key) {
             if (strcmp(key, table->items[index].key) == 0) {
-                /* Found key, return value. */
-                return table->items[index].value;
+                /* Found key, return its slot. */
+                return &table->items[index];
             }
         }
         /* Key wasn't in this slot, move to next (linear probing). */
@@ -119,12 +157,33 @@ Cell* ht_get(const ht_table* table, const char* key)
 }
 
 
+/* As ht_get(), for a key of len bytes which need not be NUL-terminated. This
+ * lets the reader look up a symbol in place in the source text. */
+Cell* ht_get_n(const ht_table* table, const char* key, const size_t len)
+{
+    const uint64_t hash = hash_string_key_n(key, len);
+    size_t index = hash & (uint64_t)(table->capacity - 1);
+
+    while (table->items[index].key != NULL) {
+        const char* item_key = table->items[index].key;
+        if (item_key != HT_DELETED_ITEM.key &&
+            strncmp(key, item_key, len) == 0 && item_key[len] == '\0') {
+            return table->items[index].value;
+        }
+        index++;
+        if (index >= table->capacity) {
+            index = 0;
+        }
+    }
+    return nullptr;
+}
+
+
 /* Internal function to populate a slot with an item */
 static const char* ht_set_item(ht_item* slot, const size_t capacity,
-        const char* key, Cell* value, size_t* p_length)
+        const char* key, const uint64_t hash, Cell* value, size_t* p_length)
 {
     /* AND hash with capacity-1 to ensure it's within slot array. */
-    const uint64_t hash = hash_string_key(key);
     size_t index = hash & (uint64_t)(capacity - 1);
 
     /* Loop till we find an empty or deleted entry. */
@@ -173,18 +232,26 @@ static bool ht_resize(ht_table* table)
         /* Ensure we only move real entries, not empty or deleted ones. */
         if (item.key != nullptr && item.key != HT_DELETED_ITEM.key) {
             ht_set_item(new_items, new_capacity, item.key,
-                         item.value, nullptr);
+                         hash_string_key(item.key), item.value, nullptr);
         }
     }
     /* Free old items array and update this table's details. */
     GC_free(table->items);
     table->items = new_items;
     table->capacity = new_capacity;
+    table->generation++;
     return true;
 }
 
 
 const char* ht_set(ht_table* table, const char* key, Cell* value)
+{
+    return ht_set_hashed(table, key, hash_string_key(key), value);
+}
+
+
+/* As ht_set(), with a precomputed hash_string_key(key). */
+const char* ht_set_hashed(ht_table* table, const char* key, const uint64_t hash, Cell* value)
 {
     if (value == NULL) {
         return nullptr;
@@ -197,7 +264,7 @@ const char* ht_set(ht_table* table, const char* key, Cell* value)
         }
     }
     /* Set entry and update count. */
-    return ht_set_item(table->items, table->capacity, key, value,
+    return ht_set_item(table->items, table->capacity, key, hash, value,
                         &table->count);
 }
 
@@ -215,6 +282,7 @@ void ht_delete(ht_table* table, const char* key)
                 GC_free(table->items[index].key);
                 table->items[index] = HT_DELETED_ITEM;
                 table->count--;
+                table->generation++;
                 return; /* Item deleted, we are done. */
             }
         }
@@ -42,6 +42,7 @@ typedef struct hash_table {
     ht_item* items;     /* items array. */
     size_t capacity;    /* size of items array. */
     size_t count;       /* number of items in hash table. */
+    size_t generation;  /* bumped whenever items move, or are deleted. */
 } ht_table;
 
 /* Hash table iterator: create with ht_iterator, iterate with ht_next. */
@@ -58,11 +59,17 @@ typedef struct {
 ht_table* ht_create(int initial_capacity);
 void ht_destroy(ht_table* table);
 Cell* ht_get(const ht_table* table, const char* key);
+Cell* ht_get_hashed(const ht_table* table, const char* key, uint64_t hash);
+Cell* ht_get_n(const ht_table* table, const char* key, size_t len);
+ht_item* ht_get_item(const ht_table* table, const char* key);
+ht_item* ht_get_item_hashed(const ht_table* table, const char* key, uint64_t hash);
 const char* ht_set(ht_table* table, const char* key, Cell* value);
+const char* ht_set_hashed(ht_table* table, const char* key, uint64_t hash, Cell* value);
 void ht_delete(ht_table* table, const char* key);
 size_t ht_length(const ht_table* table);
 hti ht_iterator(ht_table* table);
 bool ht_next(hti* it);
 uint64_t hash_string_key(const char* key);
+uint64_t hash_string_key_n(const char* key, size_t len);
 
 #endif //COZENAGE_HASH_H
@@ -26,7 +26,22 @@
 #include <math.h>
 #include <gc/gc.h>
 
-#define GHT_TOMBSTONE ((Cell*)0x1)
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+/* Control byte values. A full slot holds the low 7 bits of its key's hash,
+ * so both of the special values are negative, and can be told apart from
+ * full slots by their sign bit alone. */
+#define GHT_EMPTY   ((int8_t)-128)
+#define GHT_DELETED ((int8_t)-2)
+
+/* Slots probed at once, ie: the width of an SSE2 register in bytes. */
+#define GHT_GROUP 16
+
+/* The table is resized when 7/8 of its slots are full or deleted. */
+#define GHT_MAX_LOAD(cap) ((cap) - (cap) / 8)
 
 
 /* Thomas Wang's fast, avalanching, 64-bit integer hash function. */
@@ -68,15 +83,13 @@ uint64_t hash_cell(const Cell* c)
 {
     uint64_t h = 0;
 
-    switch (c->type) {
+    switch (cell_type(c)) {
         case CELL_STRING:
-            h = hash_string_key(c->str);
-            break;
         case CELL_SYMBOL:
-            h = hash_string_key(c->sym);
+            h = cell_text_hash(c);
             break;
         case CELL_INTEGER:
-            h = hash_int_key((uint64_t)c->integer_v);
+            h = hash_int_key((uint64_t)cell_int(c));
             break;
         case CELL_RATIONAL:
             h = hash_int_key(c->num);
@@ -93,18 +106,18 @@ uint64_t hash_cell(const Cell* c)
             h = hash_int_key(c->boolean_v);
             break;
         case CELL_CHAR:
-            h = hash_int_key((uint64_t)c->char_v);
+            h = hash_int_key((uint64_t)cell_char(c));
             break;
             /* Types are checked long before we get here,
              * so this _should_ never run. */
         default:
-            fprintf(stderr, "Cannot hash type %d\n", c->type);
+            fprintf(stderr, "Cannot hash type %d\n", cell_type(c));
             exit(EXIT_FAILURE);
     }
 
     /* Mix in the type tag enum val, so string "hello"
      * and symbol 'hello return different hashes. */
-    h ^= c->type;
+    h ^= cell_type(c);
     h *= FNV_PRIME;
     /* Debug print for hashes. */
     //printf("Hashed '%s' as : %llx\n", cell_to_string(c, MODE_REPL), h);
@@ -114,10 +127,10 @@ uint64_t hash_cell(const Cell* c)
 
 bool equal_cell(const Cell* a, const Cell* b)
 {
-    if (a->type != b->type) {
+    if (cell_type(a) != cell_type(b)) {
         return false;
     }
-    switch (a->type) {
+    switch (cell_type(a)) {
         case CELL_STRING:
             if (a->count != b->count || a->char_count != b->char_count) {
                 return false;
@@ -126,7 +139,7 @@ bool equal_cell(const Cell* a, const Cell* b)
         case CELL_SYMBOL:
             return a == b ? true : false;
         case CELL_INTEGER:
-            return a->integer_v == b->integer_v ? true : false;
+            return cell_int(a) == cell_int(b) ? true : false;
         case CELL_RATIONAL:
             return (a->num == b->num) && (a->den == b->den) ? true : false;
         case CELL_REAL:
@@ -136,7 +149,7 @@ bool equal_cell(const Cell* a, const Cell* b)
         case CELL_BOOLEAN:
             return a->boolean_v == b->boolean_v ? true : false;
         case CELL_CHAR:
-            return a->char_v == b->char_v ? true : false;
+            return cell_char(a) == cell_char(b) ? true : false;
         default:
             return false;
     }
@@ -147,7 +160,7 @@ bool equal_cell(const Cell* a, const Cell* b)
  * procedures to ensure sane key values. */
 bool cell_is_hashable(const Cell* c)
 {
-    switch (c->type) {
+    switch (cell_type(c)) {
         case CELL_STRING:
         case CELL_SYMBOL:
         case CELL_INTEGER:
@@ -163,7 +176,168 @@ bool cell_is_hashable(const Cell* c)
 }
 
 
-static ght_item GHT_DELETED_ITEM = { GHT_TOMBSTONE, NULL };
+/*
+ * Group matching. Each returns a bitmask with bit i set if slot i of the
+ * group starting at ctrl matches: its control byte equals h2, it is empty,
+ * or it is free (empty or deleted).
+ */
+
+#if defined(__SSE2__)
+
+static inline uint32_t group_match(const int8_t* ctrl, const int8_t h2)
+{
+    const __m128i g = _mm_loadu_si128((const __m128i*)ctrl);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8(h2)));
+}
+
+static inline uint32_t group_match_empty(const int8_t* ctrl)
+{
+    return group_match(ctrl, GHT_EMPTY);
+}
+
+static inline uint32_t group_match_free(const int8_t* ctrl)
+{
+    /* Free control bytes are the ones with the sign bit set. */
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)ctrl));
+}
+
+#else
+
+static inline uint32_t group_match(const int8_t* ctrl, const int8_t h2)
+{
+    uint32_t mask = 0;
+    for (int i = 0; i < GHT_GROUP; i++) {
+        mask |= (uint32_t)(ctrl[i] == h2) << i;
+    }
+    return mask;
+}
+
+static inline uint32_t group_match_empty(const int8_t* ctrl)
+{
+    return group_match(ctrl, GHT_EMPTY);
+}
+
+static inline uint32_t group_match_free(const int8_t* ctrl)
+{
+    uint32_t mask = 0;
+    for (int i = 0; i < GHT_GROUP; i++) {
+        mask |= (uint32_t)(ctrl[i] < 0) << i;
+    }
+    return mask;
+}
+
+#endif
+
+
+/* The control byte of a key with this hash. */
+static inline int8_t hash_h2(const uint64_t hash)
+{
+    return (int8_t)(hash & 0x7f);
+}
+
+
+/*
+ * Probing. A key's probe sequence starts at the slot picked by the rest of
+ * its hash, not at the start of an aligned group, so that at the usual load
+ * it is found in that very slot, or one just after it, and the item can be
+ * fetched from memory alongside its control byte. Groups of GHT_GROUP slots
+ * are probed from there at triangular number multiples of GHT_GROUP, which
+ * covers every slot once. The first GHT_GROUP control bytes are mirrored
+ * after the last slot, so a group which wraps around the end is read in one
+ * load.
+ */
+
+typedef struct {
+    size_t pos;     /* First slot of the current group. */
+    size_t step;
+    size_t mask;
+} ght_probe;
+
+
+static inline ght_probe probe_start(const uint64_t hash, const size_t capacity)
+{
+    return (ght_probe){ (size_t)(hash >> 7) & (capacity - 1), 0, capacity - 1 };
+}
+
+
+static inline void probe_next(ght_probe* p)
+{
+    p->step += GHT_GROUP;
+    p->pos = (p->pos + p->step) & p->mask;
+}
+
+
+/* Set the control byte of slot i, and its mirror if it has one. */
+static inline void set_ctrl(int8_t* ctrl, const size_t capacity, const size_t i, const int8_t c)
+{
+    ctrl[i] = c;
+    if (i < GHT_GROUP) {
+        ctrl[capacity + i] = c;
+    }
+}
+
+
+#define GHT_NOT_FOUND SIZE_MAX
+
+
+/* Index of the slot holding key, or GHT_NOT_FOUND. */
+static size_t ght_find(const ght_table* table, const Cell* key, const uint64_t hash)
+{
+    const int8_t h2 = hash_h2(hash);
+    ght_probe p = probe_start(hash, table->capacity);
+    __builtin_prefetch(&table->items[p.pos]);
+
+    /* Never loops forever, as there is always at least one empty slot. */
+    for (;;) {
+        const int8_t* ctrl = table->ctrl + p.pos;
+        uint32_t match = group_match(ctrl, h2);
+        while (match) {
+            const size_t i = (p.pos + (size_t)__builtin_ctz(match)) & p.mask;
+            const ght_item* item = &table->items[i];
+            if (item->hash == hash && equal_cell(item->key, key)) {
+                return i;
+            }
+            match &= match - 1;
+        }
+        /* An empty slot means the key was never placed beyond this group. */
+        if (group_match_empty(ctrl)) {
+            return GHT_NOT_FOUND;
+        }
+        probe_next(&p);
+    }
+}
+
+
+/* Index of the first free slot in the probe sequence of hash. */
+static size_t ght_find_free(const int8_t* ctrl, const size_t capacity, const uint64_t hash)
+{
+    ght_probe p = probe_start(hash, capacity);
+    for (;;) {
+        const uint32_t free = group_match_free(ctrl + p.pos);
+        if (free) {
+            return (p.pos + (size_t)__builtin_ctz(free)) & p.mask;
+        }
+        probe_next(&p);
+    }
+}
+
+
+/* Allocate empty control bytes and items for capacity slots. */
+static bool ght_alloc(ght_table* table, const size_t capacity)
+{
+    int8_t* ctrl = GC_MALLOC_ATOMIC(capacity + GHT_GROUP);
+    ght_item* items = GC_MALLOC(capacity * sizeof(ght_item));
+    if (ctrl == NULL || items == NULL) {
+        return false;
+    }
+    memset(ctrl, GHT_EMPTY, capacity + GHT_GROUP);
+    memset(items, 0, capacity * sizeof(ght_item));
+    table->ctrl = ctrl;
+    table->items = items;
+    table->capacity = capacity;
+    table->growth_left = GHT_MAX_LOAD(capacity) - table->count;
+    return true;
+}
 
 
 ght_table* ght_create(const size_t initial_capacity)
@@ -175,12 +349,13 @@ ght_table* ght_create(const size_t initial_capacity)
         exit(EXIT_FAILURE);
     }
     table->count = 0;
-    table->capacity = initial_capacity;
 
-    /* Allocate space for entry buckets, and zero them out. */
-    table->items = GC_MALLOC(table->capacity * sizeof(ght_item));
-    memset(table->items, 0, table->capacity * sizeof(ght_item));
-    if (table->items == NULL) {
+    /* At least one whole group, and a power of two. */
+    size_t capacity = GHT_GROUP;
+    while (capacity < initial_capacity) {
+        capacity *= 2;
+    }
+    if (!ght_alloc(table, capacity)) {
         fprintf(stderr, "ENOMEM: malloc failed in ght_create\n");
         exit(EXIT_FAILURE);
     }
@@ -190,141 +365,149 @@ ght_table* ght_create(const size_t initial_capacity)
 
 void ght_destroy(ght_table* table)
 {
+    GC_free(table->ctrl);
     GC_free(table->items);
     GC_free(table);
 }
 
 
-Cell* ght_get(const ght_table* table, const Cell* key)
+/* Return a new table with the same items as table. Keys and values are
+ * shared, not copied. */
+ght_table* ght_copy(const ght_table* table)
 {
-    /* Note: proper type checking will be done at the
-     * user-procedure level, so all calls here
-     * will be type-checked and safe. */
-
-    /* AND hash with capacity-1 to ensure it's within entries array. */
-    const uint64_t hash = hash_cell(key);
-    size_t index = hash & (uint64_t)(table->capacity - 1);
-
-    /* Loop till we find an empty entry. */
-    while (table->items[index].key != NULL) {
-        /* Keep iterating if slot marked as deleted. */
-        if (table->items[index].key != GHT_DELETED_ITEM.key) {
-            if (equal_cell(table->items[index].key, key)) {
-                /* Found key, return value. */
-                return table->items[index].value;
-            }
-        }
-        /* Key wasn't in this slot, move to next (linear probing). */
-        index++;
-        if (index >= table->capacity) {
-            /* At end of entries array, wrap around. */
-            index = 0;
-        }
+    ght_table* copy = GC_MALLOC(sizeof(ght_table));
+    if (copy == NULL) {
+        fprintf(stderr, "ENOMEM: malloc failed in ght_copy\n");
+        exit(EXIT_FAILURE);
     }
-    return nullptr;
+    *copy = *table;
+    copy->ctrl = GC_MALLOC_ATOMIC(table->capacity + GHT_GROUP);
+    copy->items = GC_MALLOC(table->capacity * sizeof(ght_item));
+    if (copy->ctrl == NULL || copy->items == NULL) {
+        fprintf(stderr, "ENOMEM: malloc failed in ght_copy\n");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(copy->ctrl, table->ctrl, table->capacity + GHT_GROUP);
+    memcpy(copy->items, table->items, table->capacity * sizeof(ght_item));
+    return copy;
 }
 
 
-/* Internal function to populate a slot with an item */
-bool ght_set_item(ght_item* slot, const size_t capacity,
-        Cell* key, Cell* value, size_t* p_length)
+/* Remove every item, and shrink table back to a single group. */
+void ght_clear(ght_table* table)
 {
-    if (!key || !value || !slot) {
-        return false;
+    GC_FREE(table->ctrl);
+    GC_FREE(table->items);
+    table->count = 0;
+    if (!ght_alloc(table, GHT_GROUP)) {
+        fprintf(stderr, "ENOMEM: malloc failed in ght_clear\n");
+        exit(EXIT_FAILURE);
     }
-    /* AND hash with capacity-1 to ensure it's within slot array. */
-    const uint64_t hash = hash_cell(key);
-    size_t index = hash & (uint64_t)(capacity - 1);
+}
 
-    /* Loop till we find an empty or deleted entry. */
-    while (slot[index].key != NULL && slot[index].key != GHT_DELETED_ITEM.key) {
-        if (equal_cell(key, slot[index].key)) {
-            /* Found key (it already exists), update value. */
-            slot[index].value = value;
-            return true;
-        }
-        /* Key wasn't in this slot, move to next (linear probing). */
-        index++;
-        if (index >= capacity) {
-            /* At end of slot array, wrap around. */
-            index = 0;
-        }
-    }
-    /* Didn't find the key, just insert it. */
-    if (p_length != NULL) {
-        (*p_length)++;
-    }
-    slot[index].key = key;
-    slot[index].value = value;
-    return true;
+
+Cell* ght_get(const ght_table* table, const Cell* key)
+{
+    /* Note: proper type checking will be done at the
+     * user-procedure level, so all calls here
+     * will be type-checked and safe. */
+    const size_t i = ght_find(table, key, hash_cell(key));
+    return i == GHT_NOT_FOUND ? nullptr : table->items[i].value;
 }
 
 
-/* Expand hash table to twice its current size. */
+/* Move every item into freshly allocated slots, dropping deleted ones. The
+ * table doubles in size, unless deleted slots are most of what filled it,
+ * in which case it is rebuilt at the same size. Hashes are stored in the
+ * items, so no key is rehashed or compared. */
 static bool ght_resize(ght_table* table)
 {
-    /* Allocate new entries array. */
-    const size_t new_capacity = table->capacity * 2;
-    if (new_capacity < table->capacity) {
-        return false;  /* Overflow (capacity would be too big). */
+    size_t new_capacity = table->capacity;
+    if (table->count >= GHT_MAX_LOAD(table->capacity) / 2) {
+        new_capacity = table->capacity * 2;
+        if (new_capacity < table->capacity) {
+            return false;  /* Overflow (capacity would be too big). */
+        }
     }
-    ght_item* new_items = GC_MALLOC(new_capacity * sizeof(ght_item));
-    if (new_items == NULL) {
+
+    const int8_t* old_ctrl = table->ctrl;
+    const ght_item* old_items = table->items;
+    const size_t old_capacity = table->capacity;
+    if (!ght_alloc(table, new_capacity)) {
         return false;
     }
-    /* Iterate items, move all non-empty items to new table's items. */
-    for (size_t i = 0; i < table->capacity; i++) {
-        const ght_item item = table->items[i];
-        /* Ensure we only move real entries, not empty or deleted ones. */
-        if (item.key != nullptr && item.key != GHT_DELETED_ITEM.key) {
-            ght_set_item(new_items, new_capacity, item.key,
-                         item.value, nullptr);
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old_ctrl[i] >= 0) {
+            const size_t slot = ght_find_free(table->ctrl, new_capacity, old_items[i].hash);
+            set_ctrl(table->ctrl, new_capacity, slot, old_ctrl[i]);
+            table->items[slot] = old_items[i];
         }
     }
-    /* Free old items array and update this table's details. */
-    GC_FREE(table->items);
-    table->items = new_items;
-    table->capacity = new_capacity;
+    /* Free old arrays. */
+    GC_FREE((void*)old_ctrl);
+    GC_FREE((void*)old_items);
     return true;
 }
 
 
 bool ght_set(ght_table* table, Cell* key, Cell* value)
 {
-    /* Resize table if load >= 0.7. */
-    const size_t load = table->count * 100 / table->capacity;
-    if (load >= 70) {
+    if (!key || !value) {
+        return false;
+    }
+    const uint64_t hash = hash_cell(key);
+    const size_t found = ght_find(table, key, hash);
+    if (found != GHT_NOT_FOUND) {
+        /* Found key (it already exists), update value. */
+        table->items[found].value = value;
+        return true;
+    }
+
+    /* Reusing a deleted slot doesn't use up any room; only filling an empty
+     * one can call for a resize. */
+    size_t slot = ght_find_free(table->ctrl, table->capacity, hash);
+    if (table->growth_left == 0 && table->ctrl[slot] == GHT_EMPTY) {
         if (!ght_resize(table)) {
             return false;
         }
+        slot = ght_find_free(table->ctrl, table->capacity, hash);
     }
-    /* Set entry and update count. */
-    return ght_set_item(table->items, table->capacity, key, value, &table->count);
+    if (table->ctrl[slot] == GHT_EMPTY) {
+        table->growth_left--;
+    }
+    set_ctrl(table->ctrl, table->capacity, slot, hash_h2(hash));
+    table->items[slot] = (ght_item){ key, value, hash };
+    table->count++;
+    return true;
 }
 
 
 bool ght_delete(ght_table* table, const Cell* key)
 {
-    const uint64_t hash = hash_cell(key);
-    size_t index = hash & (uint64_t)(table->capacity - 1);
-
-    while (table->items[index].key != NULL) {
-        if (table->items[index].key != GHT_DELETED_ITEM.key) {
-            if (equal_cell(key, table->items[index].key)) {
-                /* Found item. Do not free the key,
-                 * just mark the slot as deleted. */
-                table->items[index] = GHT_DELETED_ITEM;
-                table->count--;
-                return true;
-            }
-        }
-        /* Move to next slot. */
-        index++;
-        if (index >= table->capacity) {
-            index = 0;
-        }
+    const size_t i = ght_find(table, key, hash_cell(key));
+    if (i == GHT_NOT_FOUND) {
+        return false;
     }
-    return false;
+    /* A probe only goes past a group with no empty slot. If the run of
+     * non-empty slots around this one is shorter than a group, no group
+     * holding it has ever been without one, so no key was placed beyond it,
+     * and the slot can be emptied outright. Otherwise probes must be kept
+     * going through it. */
+    const size_t mask = table->capacity - 1;
+    const uint32_t empty_before = group_match_empty(table->ctrl + ((i - GHT_GROUP) & mask));
+    const uint32_t empty_after = group_match_empty(table->ctrl + i);
+    const int run_before = empty_before ? __builtin_clz(empty_before) - (32 - GHT_GROUP) : GHT_GROUP;
+    const int run_after = empty_after ? __builtin_ctz(empty_after) : GHT_GROUP;
+    if (run_before + run_after < GHT_GROUP) {
+        set_ctrl(table->ctrl, table->capacity, i, GHT_EMPTY);
+        table->growth_left++;
+    } else {
+        set_ctrl(table->ctrl, table->capacity, i, GHT_DELETED);
+    }
+    /* Don't keep the key and value alive. */
+    table->items[i] = (ght_item){ nullptr, nullptr, 0 };
+    table->count--;
+    return true;
 }
 
 
@@ -354,8 +537,8 @@ bool ght_next(ghti* it)
     while (it->_index < table->capacity) {
         const size_t i = it->_index;
         it->_index++;
-        if (table->items[i].key != NULL && table->items[i].key != GHT_DELETED_ITEM.key) {
-            /* Found next non-empty item, update iterator key and value. */
+        if (table->ctrl[i] >= 0) {
+            /* Found next full slot, update iterator key and value. */
             const ght_item entry = table->items[i];
             it->key = entry.key;
             it->value = entry.value;
@@ -363,4 +546,4 @@ bool ght_next(ghti* it)
         }
     }
     return false;
-}
\ No newline at end of file
+}
@@ -22,6 +22,7 @@
 #define COZENAGE_HASH_TYPE_H
 
 #include  <stdio.h>
+#include  <stdint.h>
 
 
 /* Forward declare Cell. */
@@ -33,20 +34,28 @@ typedef struct Cell Cell;
 
 /* Hash table item. */
 typedef struct {
-    Cell* key;     /* NULL = empty, TOMBSTONE = deleted. */
+    Cell* key;
     Cell* value;   /* Value is ignored and slugged with #t for sets. */
+    uint64_t hash; /* hash_cell(key), kept so resizing never rehashes. */
 } ght_item;
 
 
-/* Hash table structure */
+/* Hash table structure. This is a 'Swiss table': each slot has a control
+ * byte, which is either GHT_EMPTY, GHT_DELETED, or the low 7 bits of the
+ * hash of the key in the slot. Slots are probed a group of GHT_GROUP at a
+ * time, by matching the control bytes of the whole group at once, and a key
+ * is only compared with the keys whose 7 bits match. */
 typedef struct Ght_Table{
+    int8_t* ctrl;        /* Control bytes, one per slot, then the first GHT_GROUP again. */
     ght_item* items;
-    size_t capacity;   /* Must be power of two. */
+    size_t capacity;     /* Must be a power of two, and at least GHT_GROUP. */
     size_t count;
+    size_t growth_left;  /* Empty slots which may be filled before a resize. */
 } ght_table;
 
 
-/* Hash table iterator: create with ght_iterator, iterate with ght_next. */
+/* Hash table iterator: create with ght_iterator, iterate with ght_next.
+ * Deleting the current key while iterating is allowed. */
 typedef struct {
     Cell* key;        /* Current key. */
     Cell* value;      /* Current value. */
@@ -59,6 +68,8 @@ typedef struct {
 
 ght_table* ght_create(size_t initial_capacity);
 void ght_destroy(ght_table* table);
+ght_table* ght_copy(const ght_table* table);
+void ght_clear(ght_table* table);
 Cell* ght_get(const ght_table* table, const Cell* key);
 bool ght_set(ght_table* table, Cell* key, Cell* value);
 bool ght_delete(ght_table* table, const Cell* key);
@@ -42,7 +42,7 @@ Cell* builtin_hash(const Lex* e, const Cell* a)
         if (!cell_is_hashable(a->cell[i])) {
             return make_cell_error(
             fmt_err("hash: arg type '%s' is not a hashable",
-                     cell_type_name(a->cell[i]->type)),
+                     cell_type_name(cell_type(a->cell[i]))),
                      TYPE_ERR);
         }
     }
@@ -61,7 +61,7 @@ Cell* builtin_hash_copy(const Lex* e, const Cell* a)
     if (err) return err;
 
     const Cell* hash = a->cell[0];
-    if (hash->type != CELL_HASH) {
+    if (cell_type(hash) != CELL_HASH) {
         return make_cell_error(
             "hash-copy: arg must be a hash",
             TYPE_ERR);
@@ -79,7 +79,7 @@ Cell* builtin_hash_clear(const Lex* e, const Cell* a)
     if (err) return err;
 
     Cell* hash = a->cell[0];
-    if (hash->type != CELL_HASH) {
+    if (cell_type(hash) != CELL_HASH) {
         return make_cell_error(
             "hash-clear!: arg must be a hash",
             TYPE_ERR);
@@ -101,7 +101,7 @@ Cell* builtin_hash_get(const Lex* e, const Cell* a)
     const Cell* hash = a->cell[0];
     const Cell* obj = a->cell[1];
 
-    if (hash->type != CELL_HASH) {
+    if (cell_type(hash) != CELL_HASH) {
         return make_cell_error(
             "hash-get: arg1 must be a hash",
             TYPE_ERR);
@@ -109,7 +109,7 @@ Cell* builtin_hash_get(const Lex* e, const Cell* a)
     if (!cell_is_hashable(obj)) {
         return make_cell_error(
             fmt_err("hash-get: arg type '%s' is not a hashable",
-                cell_type_name(obj->type)),
+                cell_type_name(cell_type(obj))),
             TYPE_ERR);
     }
 
@@ -135,7 +135,7 @@ Cell* builtin_hash_add(const Lex* e, const Cell* a)
     if (err) return err;
 
     Cell* hash = a->cell[0];
-    if (hash->type != CELL_HASH) {
+    if (cell_type(hash) != CELL_HASH) {
         return make_cell_error(
             "hash-add!: arg1 must be a hash",
             TYPE_ERR);
@@ -144,7 +144,7 @@ Cell* builtin_hash_add(const Lex* e, const Cell* a)
     if (!cell_is_hashable(a->cell[1])) {
         return make_cell_error(
         fmt_err("hash-add!: arg type '%s' is not hashable",
-                 cell_type_name(a->cell[1]->type)),
+                 cell_type_name(cell_type(a->cell[1]))),
                  TYPE_ERR);
     }
 
@@ -169,7 +169,7 @@ Cell* builtin_hash_remove(const Lex* e, const Cell* a)
     if (err) return err;
 
     Cell* hash = a->cell[0];
-    if (hash->type != CELL_HASH) {
+    if (cell_type(hash) != CELL_HASH) {
         return make_cell_error(
             "hash-remove!: arg1 must be a hash",
             TYPE_ERR);
@@ -187,7 +187,7 @@ Cell* builtin_hash_remove(const Lex* e, const Cell* a)
             "hash-remove!: arg 2 not member of hash",
             INDEX_ERR);
     }
-    if (a->count == 3 && a->cell[2]->type != CELL_SYMBOL) {
+    if (a->count == 3 && cell_type(a->cell[2]) != CELL_SYMBOL) {
         return make_cell_error(
             "hash-remove!: arg 3 must be a symbol",
             INDEX_ERR);
@@ -204,7 +204,7 @@ Cell* builtin_hash_keys(const Lex* e, const Cell* a)
     Cell* err = CHECK_ARITY_EXACT(a, 1, "hash-keys");
     if (err) return err;
     const Cell* hash = a->cell[0];
-    if (hash->type != CELL_HASH) {
+    if (cell_type(hash) != CELL_HASH) {
         return make_cell_error(
             "hash-keys: arg must be a hash",
             TYPE_ERR);
@@ -228,7 +228,7 @@ Cell* builtin_hash_values(const Lex* e, const Cell* a)
     Cell* err = CHECK_ARITY_EXACT(a, 1, "hash-values");
     if (err) return err;
     const Cell* hash = a->cell[0];
-    if (hash->type != CELL_HASH) {
+    if (cell_type(hash) != CELL_HASH) {
         return make_cell_error(
             "hash-values: arg must be a hash",
             TYPE_ERR);
@@ -253,7 +253,7 @@ Cell* builtin_hash_to_alist(const Lex* e, const Cell* a)
     Cell* err = CHECK_ARITY_EXACT(a, 1, "hash->alist");
     if (err) return err;
     const Cell* hash = a->cell[0];
-    if (hash->type != CELL_HASH) {
+    if (cell_type(hash) != CELL_HASH) {
         return make_cell_error(
             "hash->alist: arg must be a hash",
             TYPE_ERR);
@@ -279,7 +279,7 @@ Cell* builtin_alist_to_hash(const Lex* e, const Cell* a)
     Cell* err = CHECK_ARITY_EXACT(a, 1, "alist->hash");
     if (err) return err;
     const Cell* alist = a->cell[0];
-    if (alist->type != CELL_PAIR || a->cell[0]->count == -1) {
+    if (cell_type(alist) != CELL_PAIR || a->cell[0]->count == -1) {
         return make_cell_error(
             "alist->hash: arg must be an association list",
             TYPE_ERR);
@@ -288,7 +288,7 @@ Cell* builtin_alist_to_hash(const Lex* e, const Cell* a)
     Cell* r = make_cell_sexpr();
     while (alist->cdr) {
         /* This also enforces an even number of objects fed to make_cell_hash(). */
-        if (alist->car->type != CELL_PAIR) {
+        if (cell_type(alist->car) != CELL_PAIR) {
             return make_cell_error(
                 "alist->hash: car field of list is not a dotted pair",
                 TYPE_ERR);
@@ -312,12 +312,12 @@ Cell* builtin_hash_keys_map(const Lex* e, const Cell* a)
     const Cell* proc = a->cell[0];
     const Cell* hash = a->cell[1];
 
-    if (proc->type != CELL_PROC) {
+    if (cell_type(proc) != CELL_PROC) {
         return make_cell_error(
             "hash-keys-map: arg1 must be a procedure",
             TYPE_ERR);
     }
-    if (hash->type != CELL_HASH) {
+    if (cell_type(hash) != CELL_HASH) {
         return make_cell_error(
             "hash-keys-map: arg2 must be a hash",
             TYPE_ERR);
@@ -338,12 +338,12 @@ Cell* builtin_hash_keys_foreach(const Lex* e, const Cell* a)
     const Cell* proc = a->cell[0];
     const Cell* hash = a->cell[1];
 
-    if (proc->type != CELL_PROC) {
+    if (cell_type(proc) != CELL_PROC) {
         return make_cell_error(
             "hash-keys-foreach: arg1 must be a procedure",
             TYPE_ERR);
     }
-    if (hash->type != CELL_HASH) {
+    if (cell_type(hash) != CELL_HASH) {
         return make_cell_error(
             "hash-keys-foreach: arg2 must be a hash",
             TYPE_ERR);
@@ -363,12 +363,12 @@ Cell* builtin_hash_values_map(const Lex* e, const Cell* a)
     const Cell* proc = a->cell[0];
     const Cell* hash = a->cell[1];
 
-    if (proc->type != CELL_PROC) {
+    if (cell_type(proc) != CELL_PROC) {
         return make_cell_error(
             "hash-values-map: arg1 must be a procedure",
             TYPE_ERR);
     }
-    if (hash->type != CELL_HASH) {
+    if (cell_type(hash) != CELL_HASH) {
         return make_cell_error(
             "hash-values-map: arg2 must be a hash",
             TYPE_ERR);
@@ -389,12 +389,12 @@ Cell* builtin_hash_values_foreach(const Lex* e, const Cell* a)
     const Cell* proc = a->cell[0];
     const Cell* hash = a->cell[1];
 
-    if (proc->type != CELL_PROC) {
+    if (cell_type(proc) != CELL_PROC) {
         return make_cell_error(
             "hash-values-foreach: arg1 must be a procedure",
             TYPE_ERR);
     }
-    if (hash->type != CELL_HASH) {
+    if (cell_type(hash) != CELL_HASH) {
         return make_cell_error(
             "hash-values-foreach: arg2 must be a hash",
             TYPE_ERR);
@@ -420,7 +420,7 @@ static Cell* map_foreach(const Cell* proc, const Cell* h_table, const Lex* e, co
             val = coz_apply_and_get_val(proc, make_sexpr_len2(it.key, it.value), e);
         }
         /* Propagate errors. */
-        if (val && val->type == CELL_ERROR) return val;
+        if (val && cell_type(val) == CELL_ERROR) return val;
         if (ret_res) {
             /* Ignore unspecified results. */
             if (val == USP_Obj) continue;
@@ -445,12 +445,12 @@ Cell* builtin_hash_items_map(const Lex* e, const Cell* a)
     const Cell* proc = a->cell[0];
     const Cell* hash = a->cell[1];
 
-    if (proc->type != CELL_PROC) {
+    if (cell_type(proc) != CELL_PROC) {
         return make_cell_error(
             "hash-items-map: arg1 must be a procedure",
             TYPE_ERR);
     }
-    if (hash->type != CELL_HASH) {
+    if (cell_type(hash) != CELL_HASH) {
         return make_cell_error(
             "hash-items-map: arg2 must be a hash",
             TYPE_ERR);
@@ -471,12 +471,12 @@ Cell* builtin_hash_items_foreach(const Lex* e, const Cell* a)
     const Cell* proc = a->cell[0];
     const Cell* hash = a->cell[1];
 
-    if (proc->type != CELL_PROC) {
+    if (cell_type(proc) != CELL_PROC) {
         return make_cell_error(
             "hash-items-foreach: arg1 must be a procedure",
             TYPE_ERR);
     }
-    if (hash->type != CELL_HASH) {
+    if (cell_type(hash) != CELL_HASH) {
         return make_cell_error(
             "hash-items-foreach: arg2 must be a hash",
             TYPE_ERR);
@@ -19,25 +19,24 @@
 
 #include "lexer.h"
 
+#include <stdint.h>
 #include <string.h>
 #include <stdio.h>
-#include <stdlib.h>
-#include <gc/gc.h>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
-typedef struct {
-    const char* start;
-    const char* current;
-    int line;
-} Scanner;
 
-Scanner scanner;
-
-void init_lexer(const char* source)
+/* Initialize a scanner over source. The scanner holds no state outside of
+ * itself, so any number of them can be live at once, eg: one per nested load. */
+void init_scanner(Scanner* s, const char* source)
 {
-    scanner.start = source;
-    scanner.current = source;
-    scanner.line = 1;
+    s->start = source;
+    s->current = source;
+    s->line = 1;
 }
 
 
@@ -47,91 +46,239 @@ static bool is_digit(const char c)
 }
 
 
-static bool is_whitespace(const char c)
+/*
+ * Run scanners.
+ *
+ * scan_until() returns a pointer to the first byte at or after p which ends a
+ * run: of whitespace, a line comment, a block comment, the body of a string,
+ * or an atom (number, boolean) or symbol. The NUL at the end of the source
+ * always ends a run. Given a line count, it adds the newlines it passes to it.
+ *
+ * Most runs are short, so the first few bytes are tested one at a time. With
+ * SSE2 or AVX2 the rest are tested a block at a time, and the first stop byte
+ * is found from a bitmask of the block. Loads are aligned to the block size,
+ * so never cross a page boundary, and may safely read past the NUL to the end
+ * of its block. AddressSanitizer counts that as out of bounds, so is told to
+ * keep out.
+ */
+
+static inline bool stop_blank(const char c)
+{
+    return c != ' ' && c != '\t' && c != '\r' && c != '\n';
+}
+
+static inline bool stop_line(const char c)
+{
+    return c == '\n' || c == '\0';
+}
+
+static inline bool stop_bar(const char c)
+{
+    return c == '|' || c == '\0';
+}
+
+static inline bool stop_string(const char c)
+{
+    return c == '"' || c == '\\' || c == '\0';
+}
+
+static inline bool stop_atom(const char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' ||
+           c == ')' || c == ']' || c == '}' || c == '\0';
+}
+
+static inline bool stop_symbol(const char c)
+{
+    return stop_atom(c) || c == '(';
+}
+
+#define SCAN_PREFIX 8
+
+#if defined(__AVX2__) || defined(__SSE2__)
+
+#if defined(__AVX2__)
+#define SCAN_WIDTH 32
+typedef __m256i scan_vec;
+#define scan_load(p) _mm256_load_si256((const __m256i*)(p))
+#define scan_eq(v, c) ((uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8((v), _mm256_set1_epi8(c))))
+#else
+#define SCAN_WIDTH 16
+typedef __m128i scan_vec;
+#define scan_load(p) _mm_load_si128((const __m128i*)(p))
+#define scan_eq(v, c) ((uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8((v), _mm_set1_epi8(c))))
+#endif
+
+/* Bitmasks of the stop bytes in a block, for each kind of run. */
+static inline uint32_t stop_blank_mask(const scan_vec v)
+{
+    const uint32_t blank = scan_eq(v, ' ') | scan_eq(v, '\t') | scan_eq(v, '\r') | scan_eq(v, '\n');
+    return ~blank & (uint32_t)((1ull << SCAN_WIDTH) - 1);
+}
+
+static inline uint32_t stop_line_mask(const scan_vec v)
+{
+    return scan_eq(v, '\n') | scan_eq(v, '\0');
+}
+
+static inline uint32_t stop_bar_mask(const scan_vec v)
+{
+    return scan_eq(v, '|') | scan_eq(v, '\0');
+}
+
+static inline uint32_t stop_string_mask(const scan_vec v)
+{
+    return scan_eq(v, '"') | scan_eq(v, '\\') | scan_eq(v, '\0');
+}
+
+static inline uint32_t stop_atom_mask(const scan_vec v)
+{
+    return scan_eq(v, ' ') | scan_eq(v, '\t') | scan_eq(v, '\r') | scan_eq(v, '\n') |
+           scan_eq(v, ')') | scan_eq(v, ']') | scan_eq(v, '}') | scan_eq(v, '\0');
+}
+
+static inline uint32_t stop_symbol_mask(const scan_vec v)
+{
+    return stop_atom_mask(v) | scan_eq(v, '(');
+}
+
+
+/* Find the first stop byte at or after p, a block at a time. Bytes of the
+ * first block before p are shifted out of the masks. */
+__attribute__((no_sanitize_address))
+static inline const char* scan_blocks(const char* p, uint32_t (*stop)(scan_vec), int* lines)
+{
+    unsigned skip = (uintptr_t)p & (SCAN_WIDTH - 1);
+    const char* block = p - skip;
+    scan_vec v = scan_load(block);
+    uint32_t mask = stop(v) >> skip << skip;
+    for (;;) {
+        if (mask) {
+            const int i = __builtin_ctz(mask);
+            if (lines) {
+                const uint32_t before = (scan_eq(v, '\n') >> skip << skip) & ((1u << i) - 1);
+                *lines += __builtin_popcount(before);
+            }
+            return block + i;
+        }
+        if (lines) {
+            *lines += __builtin_popcount(scan_eq(v, '\n') >> skip << skip);
+        }
+        skip = 0;
+        block += SCAN_WIDTH;
+        v = scan_load(block);
+        mask = stop(v);
+    }
+}
+
+#define scan_until(p, kind, lines) scan_run((p), stop_##kind, stop_##kind##_mask, (lines))
+
+static inline const char* scan_run(const char* p, bool (*stop)(char),
+                                   uint32_t (*stop_mask)(scan_vec), int* lines)
 {
-    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    for (int n = 0; n < SCAN_PREFIX; n++, p++) {
+        if (stop(*p)) return p;
+        if (lines && *p == '\n') (*lines)++;
+    }
+    return scan_blocks(p, stop_mask, lines);
 }
 
+#else
+
+#define scan_until(p, kind, lines) scan_run((p), stop_##kind, (lines))
 
-static bool at_end()
+static inline const char* scan_run(const char* p, bool (*stop)(char), int* lines)
 {
-    return *scanner.current == '\0';
+    while (!stop(*p)) {
+        if (lines && *p == '\n') (*lines)++;
+        p++;
+    }
+    return p;
 }
 
+#endif
 
-static char advance()
+
+static bool at_end(const Scanner* s)
+{
+    return *s->current == '\0';
+}
+
+
+static char advance(Scanner* s)
 {
-    scanner.current++;
-    return scanner.current[-1];
+    s->current++;
+    return s->current[-1];
 }
 
 
-static char peek()
+static char peek(const Scanner* s)
 {
-    return *scanner.current;
+    return *s->current;
 }
 
 
-static char peekNext()
+static char peekNext(const Scanner* s)
 {
-    if (at_end()) return '\0';
-    return scanner.current[1];
+    if (at_end(s)) return '\0';
+    return s->current[1];
 }
 
 
-static Token make_token(const TokenType type)
+static Token make_token(const Scanner* s, const TokenType type)
 {
     Token token;
     token.type = type;
-    token.start = scanner.start;
-    token.length = (int)(scanner.current - scanner.start);
-    token.line = scanner.line;
+    token.start = s->start;
+    token.length = (int)(s->current - s->start);
+    token.line = s->line;
     return token;
 }
 
 
-static Token error_token(const char* message)
+static Token error_token(const Scanner* s, const char* message)
 {
     Token token;
     token.type = T_ERROR;
     token.start = message;
     token.length = (int)strlen(message);
-    token.line = scanner.line;
+    token.line = s->line;
     return token;
 }
 
 
-static void skip_whitespace()
+static void skip_whitespace(Scanner* s)
 {
     for (;;) {
-        const char c = peek();
+        const char c = peek(s);
         switch (c) {
         case ' ':
         case '\r':
         case '\t':
-            advance();
-            break;
         case '\n':
-            scanner.line++;
-            advance();
+            s->current = scan_until(s->current, blank, &s->line);
             break;
         /* Line comment. */
         case ';':
-            while (peek() != '\n' && !at_end()) advance();
+            s->current = scan_until(s->current, line, nullptr);
             break;
             /* Block comment. */
         case '#':
-            if (peekNext() == '|')
+            if (peekNext(s) == '|')
             {
                 /* Consume "#|". */
-                advance(); advance();
-                while (peek() != '|' && !at_end())
-                {
-                    if (peek() == '\n') scanner.line++;
-                    advance();
+                advance(s); advance(s);
+                for (;;) {
+                    s->current = scan_until(s->current, bar, &s->line);
+                    /* An unterminated comment runs to the end of the source. */
+                    if (at_end(s)) return;
+                    /* Consume the '|', and the '#' if it closes the comment. */
+                    advance(s);
+                    if (peek(s) == '#') {
+                        advance(s);
+                        break;
+                    }
                 }
-                /* Consume "|#". */
-                advance(); advance();
                 break;
             }
             return;
@@ -142,159 +289,148 @@ static void skip_whitespace()
 }
 
 
-static Token string()
+static Token string(Scanner* s)
 {
-    while (peek() != '"' && !at_end()) {
-        const char c = peek();
-
-        if (c == '\\') {
-            /* It's an escape character. */
-            advance(); /* Consume the backslash. */
+    for (;;) {
+        /* Skip to the closing quote, or an escape. */
+        s->current = scan_until(s->current, string, &s->line);
+        if (peek(s) != '\\') break;
 
-            /* Check for EOF right after the backslash. */
-            if (at_end()) return error_token("Unterminated string.");
+        /* It's an escape character. */
+        advance(s); /* Consume the backslash. */
 
-            /* If the escaped char is a newline, count it. */
-            if (peek() == '\n') {
-                scanner.line++;
-            }
+        /* Check for EOF right after the backslash. */
+        if (at_end(s)) return error_token(s, "Unterminated string.");
 
-            /* Consume the escaped character.
-               We don't care what it is, we just skip over it. */
-            advance();
-        } else if (c == '\n') {
-            /* This is a *literal* (unescaped) newline in the string. */
-            scanner.line++;
-            advance();
-        } else {
-            /* Any other regular character. */
-            advance();
+        /* If the escaped char is a newline, count it. */
+        if (peek(s) == '\n') {
+            s->line++;
         }
+
+        /* Consume the escaped character.
+           We don't care what it is, we just skip over it. */
+        advance(s);
     }
 
-    if (at_end()) return error_token("Unterminated string.");
+    if (at_end(s)) return error_token(s, "Unterminated string.");
 
     /* Consume the closing quote. */
-    advance();
-    return make_token(T_STRING);
+    advance(s);
+    return make_token(s, T_STRING);
 }
 
 
-static Token number()
+static Token number(Scanner* s)
 {
-    while (!is_whitespace(peek()) && !at_end() && peek() != ')' && peek() != ']' && peek() != '}') {
-        advance();
-    }
-    return make_token(T_NUMBER);
+    s->current = scan_until(s->current, atom, nullptr);
+    return make_token(s, T_NUMBER);
 }
 
 
-static Token boolean()
+static Token boolean(Scanner* s)
 {
-    scanner.start = scanner.current;
-    while (!is_whitespace(peek()) && !at_end() && peek() != ')' && peek() != ']' && peek() != '}') {
-        advance();
-    }
-    return make_token(T_BOOLEAN);
+    s->start = s->current;
+    s->current = scan_until(s->current, atom, nullptr);
+    return make_token(s, T_BOOLEAN);
 }
 
 
-static Token multi_word_identifier()
+static Token multi_word_identifier(Scanner* s)
 {
-    while (peek() != '|' && !at_end()) {
-        advance();
-    }
-    if (at_end()) return error_token("Unterminated multi-word identifier.");
+    s->current = scan_until(s->current, bar, nullptr);
+    if (at_end(s)) return error_token(s, "Unterminated multi-word identifier.");
 
-    advance();
-    return make_token(T_SYMBOL);
+    advance(s);
+    return make_token(s, T_SYMBOL);
 }
 
 
-static Token symbol()
+static Token symbol(Scanner* s)
 {
-    while (!is_whitespace(peek()) && peek() != ')' && peek() != '(' && peek() != ']' && peek() != '}' && !at_end()) {
-        advance();
-    }
-    return make_token(T_SYMBOL);
+    s->current = scan_until(s->current, symbol, nullptr);
+    return make_token(s, T_SYMBOL);
 }
 
 
-static Token character()
+static Token character(Scanner* s)
 {
-    scanner.start = scanner.current;
-    while (!is_whitespace(peek()) && peek() != ')' && peek() != '(' && peek() != ']' && peek() != '}' && !at_end()) {
-        advance();
-    }
-    return make_token(T_CHAR);
+    s->start = s->current;
+    s->current = scan_until(s->current, symbol, nullptr);
+    return make_token(s, T_CHAR);
 }
 
 
-Token lex_token()
+Token lex_token(Scanner* s)
 {
-    skip_whitespace();
-    scanner.start = scanner.current;
+    skip_whitespace(s);
+    s->start = s->current;
 
-    if (at_end()) return make_token(T_EOF);
+    if (at_end(s)) return make_token(s, T_EOF);
 
-    const char c = advance();
-    if (is_digit(c)) return number();
+    const char c = advance(s);
+    if (is_digit(c)) return number(s);
 
     switch (c) {
         case '(':
-            return make_token(T_LEFT_PAREN);
+            return make_token(s, T_LEFT_PAREN);
         case ')':
-            return make_token(T_RIGHT_PAREN);
+            return make_token(s, T_RIGHT_PAREN);
         case '"':
-            return string();
+            return string(s);
         case ']':
-            return make_token(T_RIGHT_BRACKET);
+            return make_token(s, T_RIGHT_BRACKET);
         case '}':
-            return make_token(T_RIGHT_BRACE);
+            return make_token(s, T_RIGHT_BRACE);
         case '\'':
-            return make_token(T_QUOTE);
+            return make_token(s, T_QUOTE);
         case '`':
-            return make_token(T_QUASIQUOTE);
+            return make_token(s, T_QUASIQUOTE);
 
         /* Either a number prefix, or symbol. */
         case '+':
         case '-': {
             /* -inf.0, +inf.0, +nan.0, and -nan.0 need special handling.
              * lex them as symbols, and deal with it in the parser. */
-            if (peek() == 'i' && peekNext() == 'n') return symbol();
-            if (peek() == 'n' && peekNext() == 'a') return symbol();
-            if (is_digit(peek())) return number();
-            return make_token(T_SYMBOL);
+            if (peek(s) == 'i' && peekNext(s) == 'n') return symbol(s);
+            if (peek(s) == 'n' && peekNext(s) == 'a') return symbol(s);
+            if (is_digit(peek(s))) return number(s);
+            return make_token(s, T_SYMBOL);
         }
 
         /* Comma, and comma at. */
         case ',': {
-            switch (peek()) {
+            switch (peek(s)) {
                 case '@':
-                    advance();
-                    return make_token(T_COMMA_AT);
+                    advance(s);
+                    return make_token(s, T_COMMA_AT);
                 default:
-                    return make_token(T_COMMA);
+                    return make_token(s, T_COMMA);
             }
         }
 
         /* Multiple possibilities, depending on what follows the hash. */
         case '#': {
-            switch (peek()) {
+            switch (peek(s)) {
                 /* Character literal. */
                 case '\\':
-                    advance();
-                    return character();
-                /* #t, #f, #true, #false. */
-                case 't':
+                    advance(s);
+                    return character(s);
+                /* #t, #f, #true, #false, but not #f32( or #f64(. */
                 case 'f':
-                    return boolean();
+                    if (((s->current[1] == '3' && s->current[2] == '2') ||
+                         (s->current[1] == '6' && s->current[2] == '4')) &&
+                        s->current[3] == '(') {
+                        return make_token(s, T_HASH);
+                    }
+                    return boolean(s);
+                case 't':
+                    return boolean(s);
                 case '[':
-                    advance();
-                    return make_token(T_HASH_START);
+                    advance(s);
+                    return make_token(s, T_HASH_START);
                 case '{':
-                    advance();
-                    return make_token(T_SET_START);
+                    advance(s);
+                    return make_token(s, T_SET_START);
                 /* Exact or inexact, and numeric base literals. */
                 case 'e':
                 case 'i':
@@ -302,92 +438,38 @@ Token lex_token()
                 case 'd':
                 case 'x':
                 case 'b':
-                    advance();
-                    Token t = number();
+                    advance(s);
+                    Token t = number(s);
                     t.start++;
                     t.length--;
                     return t;
-                default: return make_token(T_HASH);
+                default: return make_token(s, T_HASH);
             }
         }
         /* eg: |dumb variable name| */
         case '|':
-            return multi_word_identifier();
+            return multi_word_identifier(s);
         /* If it's not something else, treat as a symbol/identifier. */
-        default: return symbol();
+        default: return symbol(s);
     }
 }
 
 
-static TokenArray* init_token_array()
-{
-    /* Allocate space for the manager struct itself. */
-    TokenArray *ta = GC_MALLOC(sizeof(TokenArray));
-    if (ta == NULL) {
-        fprintf(stderr, "ENOMEM: GC_MALLOC failed\n");
-        exit(EXIT_FAILURE);
-    }
-
-    /* Allocate space for the actual tokens it will hold. */
-    ta->tokens = GC_MALLOC(TA_CAPACITY * sizeof(Token));
-    if (ta->tokens == NULL) {
-        fprintf(stderr, "ENOMEM: GC_MALLOC failed\n");
-        exit(EXIT_FAILURE);
-    }
-
-    ta->count = 0;
-    ta->capacity = TA_CAPACITY;
-    ta->position = 0;
-    return ta;
-}
-
-
-static TokenArray* write_token_array(TokenArray* ta, const Token token)
-{
-    /* Check if we need to reallocate. */
-    if (ta->count == ta->capacity) {
-        ta->capacity *= 2;
-
-        ta->tokens = GC_REALLOC(ta->tokens, ta->capacity * sizeof(Token));
-        if (ta->tokens == NULL) {
-            fprintf(stderr, "ENOMEM: GC_REALLOC failed\n");
-            exit(EXIT_FAILURE);
-        }
-    }
-
-    /* Add the new token. */
-    ta->tokens[ta->count] = token;
-    ta->count++;
-
-    return ta;
-}
-
-
-TokenArray* scan_all_tokens(const char* source)
-{
-    TokenArray *t_array = init_token_array();
-
-    init_lexer(source);
-    for (;;) {
-        const Token token = lex_token();
-        t_array = write_token_array(t_array, token);
-        if (token.type == T_EOF) break;
-    }
-
-    return t_array;
-}
-
-
-void debug_lexer(const TokenArray* ta)
+/* Print the tokens of source, one per line, prefixed with their line number. */
+void debug_lexer(const char* source)
 {
+    Scanner s;
+    init_scanner(&s, source);
     int line = -1;
+    int count = 0;
 
-    for (int i = 0; i < ta->count; i++) {
-        const Token token = ta->tokens[i];
+    for (;;) {
+        const Token token = lex_token(&s);
 
         if (token.type == T_EOF) {
             break;
         }
+        count++;
 
         if (token.line != line) {
             printf("%4d ", token.line);
@@ -397,6 +479,5 @@ void debug_lexer(const TokenArray* ta)
         }
         printf("%2d [ %.*s ]\n", token.type, token.length, token.start);
     }
-    printf("token count: %d\n", ta->count);
-    printf("token position: %d\n", ta->position);
+    printf("token count: %d\n", count);
 }
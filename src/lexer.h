@@ -53,16 +53,14 @@ typedef struct {
 } Token;
 
 typedef struct {
-    Token* tokens;
-    int count;
-    int capacity;
-    int position;
-} TokenArray;
-
-#define TA_CAPACITY 8
+    const char* start;
+    const char* current;
+    int line;
+} Scanner;
 
 
-TokenArray* scan_all_tokens(const char* source);
-void debug_lexer(const TokenArray* ta);
+void init_scanner(Scanner* s, const char* source);
+Token lex_token(Scanner* s);
+void debug_lexer(const char* source);
 
 #endif //COZENAGE_LEXER_H
@@ -22,6 +22,9 @@
 #include "config.h"
 #include "repl.h"
 #include "runner.h"
+#include "vm.h"
+#include "fold.h"
+#include "fasl.h"
 
 #include <gc/gc.h>
 #include <stdio.h>
@@ -48,12 +51,19 @@ static void show_help(void)
 A Scheme-derived REPL and code runner\n\n\
 Options:\n\
     -l, --library\t preload Cozenage libraries at startup\n\
+    -p, --prelude\t evaluate a Scheme file at startup (may be repeated)\n\
+    -e, --engine\t select the evaluation engine: 'tree' (default) or 'vm'\n\
+    -s, --stats\t\t print the number of constant folds made in each file\n\
+    -n, --no-cache\t do not read or write the compiled code cache\n\
+    -F, --flush-cache\t delete all files in the compiled code cache\n\
     -h, --help\t\t display this help\n\
     -V, --version\t display version information\n\n\
 \n\
     '-l' and '--library' accept a required comma-delimited list of\n\
     libraries to pre-load. Accepted values are:\n\
     'bits' 'cxr' 'file' 'lazy' 'math' 'random' 'system' and 'time' \n\n\
+    Preludes are also read from the colon-separated list of files in\n\
+    $COZENAGE_PRELUDE, before any given with '-p'.\n\n\
 Report bugs to <darren@dragonbyte.ca>\n");
 }
 
@@ -114,11 +124,17 @@ int main(const int argc, char** argv)
         {"help", no_argument, nullptr, 'h'},
         {"version", no_argument, nullptr, 'V'},
         {"library", required_argument, nullptr, 'l'},
+        {"prelude", required_argument, nullptr, 'p'},
+        {"engine", required_argument, nullptr, 'e'},
+        {"stats", no_argument, nullptr, 's'},
+        {"no-cache", no_argument, nullptr, 'n'},
+        {"flush-cache", no_argument, nullptr, 'F'},
         {nullptr,0,nullptr,0}
     };
 
+    bool flush_cache = false;
     int opt;
-    while ((opt = getopt_long(argc, argv, "Vhl:", long_opts, nullptr)) != -1) {
+    while ((opt = getopt_long(argc, argv, "Vhl:p:e:snF", long_opts, nullptr)) != -1) {
         switch(opt) {
             case 'V':
                 printf("%s%s%s version %s\n", ANSI_BLUE_B, APP_NAME, ANSI_RESET, APP_VERSION);
@@ -130,6 +146,29 @@ int main(const int argc, char** argv)
             case 'l':
                 process_library_arg(&load_libs, optarg);
                 break;
+            case 'p':
+                add_prelude(optarg);
+                break;
+            case 'e':
+                if (strcmp(optarg, "tree") == 0) {
+                    coz_engine = ENGINE_TREE;
+                } else if (strcmp(optarg, "vm") == 0) {
+                    coz_engine = ENGINE_VM;
+                } else {
+                    fprintf(stderr, "Error: Unknown engine '%s' specified.\n", optarg);
+                    fprintf(stderr, "Run with -h for a list of valid engines.\n");
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case 's':
+                fold_stats.report = true;
+                break;
+            case 'n':
+                fasl_cache.disabled = true;
+                break;
+            case 'F':
+                flush_cache = true;
+                break;
             default:
                 ;
         }
@@ -137,6 +176,15 @@ int main(const int argc, char** argv)
 
     const int non_option_args = argc - optind;
 
+    if (flush_cache) {
+        const int n = fasl_cache_flush();
+        /* With no file to run, just flush. */
+        if (non_option_args == 0) {
+            printf("Deleted %d file%s from %s\n", n, n == 1 ? "" : "s", cozenage_cache_path);
+            exit(EXIT_SUCCESS);
+        }
+    }
+
     if (non_option_args > 0) {
         /* Grab the number of args, and the args themselves starting from the file arg
          * to construct (command-line) later if needed. */
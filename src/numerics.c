@@ -35,6 +35,14 @@
  * -----------------------------------*/
 
 
+/* Two reals, not both exact, combine into an inexact real. */
+static inline bool inexact_real_pair(const Cell* x, const Cell* y)
+{
+    return cell_type(x) == CELL_REAL && cell_type(y) == CELL_REAL &&
+           !(x->exact && y->exact);
+}
+
+
 /* (+)
  * (+ n)
  * (+ n1 n2)
@@ -43,6 +51,18 @@
 Cell* builtin_add(const Lex* e, const Cell* a)
 {
     (void)e;
+    /* Fast paths for two fixnums, or two reals. Fixnums are 62 bits wide,
+     * so their sum cannot overflow. */
+    if (a->count == 2) {
+        const Cell* x = a->cell[0];
+        const Cell* y = a->cell[1];
+        if (is_fixnum(x) && is_fixnum(y)) {
+            return make_cell_integer(cell_int(x) + cell_int(y));
+        }
+        if (inexact_real_pair(x, y)) {
+            return make_cell_real(x->real_v + y->real_v);
+        }
+    }
     Cell* err = check_arg_types(a,
         CELL_INTEGER|CELL_REAL|CELL_RATIONAL|CELL_COMPLEX|CELL_BIGINT|CELL_BIGFLOAT, "+");
     if (err) { return err; }
@@ -56,15 +76,17 @@ Cell* builtin_add(const Lex* e, const Cell* a)
     for (int i = 1; i < a->count; i++) {
         Cell* rhs = a->cell[i];
         numeric_promote(&result, &rhs);
+        /* Taken first, as the cases below may replace result. */
+        const bool exact = cell_exact(result) && cell_exact(rhs);
 
-        switch (result->type) {
+        switch (cell_type(result)) {
             case CELL_INTEGER: {
                 int64_t out;
-                if (add_will_overflow_i64(result->integer_v, rhs->integer_v, &out)) {
+                if (add_will_overflow_i64(cell_int(result), cell_int(rhs), &out)) {
                     result = bigint_add(make_cell_bigint(nullptr, result, 10),
                         make_cell_bigint(nullptr, rhs, 10));
                 } else {
-                    result->integer_v = out;
+                    result = make_cell_integer(out);
                 }
                 break;
             }
@@ -86,7 +108,7 @@ Cell* builtin_add(const Lex* e, const Cell* a)
             default:
                 ;
         }
-        result->exact = result->exact && rhs->exact;
+        result = cell_set_exact(result, exact);
     }
     return result;
 }
@@ -98,6 +120,17 @@ Cell* builtin_add(const Lex* e, const Cell* a)
  * Returns the difference of its arguments. */
 Cell* builtin_sub(const Lex* e, const Cell* a)
 {
+    /* Fast paths for two fixnums, or two reals. */
+    if (a->count == 2) {
+        const Cell* x = a->cell[0];
+        const Cell* y = a->cell[1];
+        if (is_fixnum(x) && is_fixnum(y)) {
+            return make_cell_integer(cell_int(x) - cell_int(y));
+        }
+        if (inexact_real_pair(x, y)) {
+            return make_cell_real(x->real_v - y->real_v);
+        }
+    }
     Cell* err = check_arg_types(a,
         CELL_INTEGER|CELL_REAL|CELL_RATIONAL|CELL_COMPLEX|CELL_BIGINT|CELL_BIGFLOAT, "-");
     if (err) { return err; }
@@ -114,15 +147,17 @@ Cell* builtin_sub(const Lex* e, const Cell* a)
     for (int i = 1; i < a->count; i++) {
         Cell* rhs = a->cell[i];
         numeric_promote(&result, &rhs);
+        /* Taken first, as the cases below may replace result. */
+        const bool exact = cell_exact(result) && cell_exact(rhs);
 
-        switch (result->type) {
+        switch (cell_type(result)) {
             case CELL_INTEGER: {
                 int64_t out;
-                if (sub_will_overflow_i64(result->integer_v, rhs->integer_v, &out)) {
+                if (sub_will_overflow_i64(cell_int(result), cell_int(rhs), &out)) {
                     result = bigint_sub(make_cell_bigint(nullptr, result, 10),
                         make_cell_bigint(nullptr, rhs, 10));
                 } else {
-                    result->integer_v = out;
+                    result = make_cell_integer(out);
                 }
                 break;
             }
@@ -145,7 +180,7 @@ Cell* builtin_sub(const Lex* e, const Cell* a)
             default:
                 ;
         }
-        result->exact = result->exact && rhs->exact;
+        result = cell_set_exact(result, exact);
     }
     return result;
 }
@@ -158,6 +193,19 @@ Cell* builtin_sub(const Lex* e, const Cell* a)
  * Returns the product of its arguments. */
 Cell* builtin_mul(const Lex* e, const Cell* a)
 {
+    /* Fast paths for two fixnums whose product fits in 64 bits, or two reals. */
+    if (a->count == 2) {
+        const Cell* x = a->cell[0];
+        const Cell* y = a->cell[1];
+        int64_t out;
+        if (is_fixnum(x) && is_fixnum(y) &&
+            !mul_will_overflow_i64(cell_int(x), cell_int(y), &out)) {
+            return make_cell_integer(out);
+        }
+        if (inexact_real_pair(x, y)) {
+            return make_cell_real(x->real_v * y->real_v);
+        }
+    }
     Cell* err = check_arg_types(a,
         CELL_INTEGER|CELL_REAL|CELL_RATIONAL|CELL_COMPLEX|CELL_BIGINT, "*");
     if (err) { return err; }
@@ -171,15 +219,17 @@ Cell* builtin_mul(const Lex* e, const Cell* a)
     for (int i = 1; i < a->count; i++) {
         Cell* rhs = a->cell[i];
         numeric_promote(&result, &rhs);
+        /* Taken first, as the cases below may replace result. */
+        const bool exact = cell_exact(result) && cell_exact(rhs);
 
-        switch (result->type) {
+        switch (cell_type(result)) {
             case CELL_INTEGER: {
                 int64_t out;
-                if (mul_will_overflow_i64(result->integer_v, rhs->integer_v, &out)) {
+                if (mul_will_overflow_i64(cell_int(result), cell_int(rhs), &out)) {
                     result = bigint_mul(make_cell_bigint(nullptr, result, 10),
                         make_cell_bigint(nullptr, rhs, 10));
                 } else {
-                    result->integer_v = out;
+                    result = make_cell_integer(out);
                 }
                 break;
             }
@@ -201,7 +251,7 @@ Cell* builtin_mul(const Lex* e, const Cell* a)
             default:
                 ;
         }
-        result->exact = result->exact && rhs->exact;
+        result = cell_set_exact(result, exact);
     }
     return result;
 }
@@ -221,18 +271,18 @@ Cell* builtin_div(const Lex* e, const Cell* a)
 
     /* Unary division reciprocal. */
     if (a->count == 1) {
-        if (a->cell[0]->type == CELL_INTEGER) {
-            return make_cell_rational(1, a->cell[0]->integer_v, 1);
+        if (cell_type(a->cell[0]) == CELL_INTEGER) {
+            return make_cell_rational(1, cell_int(a->cell[0]), 1);
         }
-        if (a->cell[0]->type == CELL_RATIONAL) {
+        if (cell_type(a->cell[0]) == CELL_RATIONAL) {
             const long int n = a->cell[0]->num;
             const long int d = a->cell[0]->den;
-            return make_cell_rational(d, n, 1);
+            return cell_set_exact(make_cell_rational(d, n, 1), cell_exact(a->cell[0]));
         }
-        if (a->cell[0]->type == CELL_REAL) {
+        if (cell_type(a->cell[0]) == CELL_REAL) {
             return make_cell_real(1.0L / a->cell[0]->real_v);
         }
-        if (a->cell[0]->type == CELL_COMPLEX) {
+        if (cell_type(a->cell[0]) == CELL_COMPLEX) {
             const Cell* z = a->cell[0];
             const Cell* a_part = z->real;
             const Cell* b_part = z->imag;
@@ -271,20 +321,22 @@ Cell* builtin_div(const Lex* e, const Cell* a)
     for (int i = 1; i < a->count; i++) {
         Cell* rhs = a->cell[i];
         numeric_promote(&result, &rhs);
+        /* Taken first, as the cases below may replace result. */
+        const bool exact = cell_exact(result) && cell_exact(rhs);
 
-        switch (result->type) {
+        switch (cell_type(result)) {
         case CELL_INTEGER:
-            if (rhs->integer_v == 0) {
+            if (cell_int(rhs) == 0) {
                 return make_cell_error(
                     "Division by zero.",
                     VALUE_ERR);
             }
             /* Pretty hacky way to get (/ 9 3) -> 3 but (/ 10 3) -> 10/3. */
-            const double r = remainder((double)result->integer_v, (double)rhs->integer_v);
+            const double r = remainder((double)cell_int(result), (double)cell_int(rhs));
             if (r == 0 || r == 0.0) {
-                result->integer_v /= rhs->integer_v;
+                result = make_cell_integer(cell_int(result) / cell_int(rhs));
             } else {
-                Cell* new_rat = make_cell_rational(result->integer_v, rhs->integer_v, 1);
+                Cell* new_rat = make_cell_rational(cell_int(result), cell_int(rhs), 1);
                 result = new_rat;
             }
             break;
@@ -310,7 +362,7 @@ Cell* builtin_div(const Lex* e, const Cell* a)
         default:
             ;
         }
-        result->exact = result->exact && rhs->exact;
+        result = cell_set_exact(result, exact);
     }
     return result;
 }
@@ -334,7 +386,7 @@ Cell* builtin_abs(const Lex* e, const Cell* a)
 
     const Cell* arg = a->cell[0];
 
-    if (arg->type == CELL_BIGINT) {
+    if (cell_type(arg) == CELL_BIGINT) {
         /* Check signedness - if negative, return a negated copy
          * of the value, else, just return it directly. */
         const int sign = mpz_sgn(*arg->bi);
@@ -348,7 +400,7 @@ Cell* builtin_abs(const Lex* e, const Cell* a)
     if (cell_is_real(arg)) {
         /* If the number is a complex type, we operate on its real part.
          * Otherwise, we operate on the number itself. */
-        const Cell* real_v = arg->type == CELL_COMPLEX? arg->real : arg;
+        const Cell* real_v = cell_type(arg) == CELL_COMPLEX? arg->real : arg;
 
         if (cell_is_negative(real_v)) {
             return negate_numeric(real_v);
@@ -385,18 +437,18 @@ Cell* builtin_expt(const Lex* e, const Cell* a)
     const Cell* exp  = a->cell[1];
 
     /* Handle bigint base. */
-    if (base->type == CELL_BIGINT) {
-        if (exp->type != CELL_INTEGER) {
+    if (cell_type(base) == CELL_BIGINT) {
+        if (cell_type(exp) != CELL_INTEGER) {
             return make_cell_error(
                 "expt: bigint base must have integer exponent",
                 VALUE_ERR);
         }
-        if (exp->integer_v > INT_MAX) {
+        if (cell_int(exp) > INT_MAX) {
             return make_cell_error(
                 fmt_err("expt: bigint exponent must be less than %d", INT_MAX),
                 VALUE_ERR);
         }
-        return bigint_expt((Cell*)base, (int)exp->integer_v);
+        return bigint_expt((Cell*)base, (int)cell_int(exp));
     }
 
     /* Simple edge cases. */
@@ -406,9 +458,9 @@ Cell* builtin_expt(const Lex* e, const Cell* a)
     /* Exact integer base and exponent.
      * This must be checked before the cell_is_real/cell_is_integer semantic
      * checks below, to ensure exactness is preserved (fixes bugs 16 and 17). */
-    if (base->type == CELL_INTEGER && exp->type == CELL_INTEGER) {
-        const long long b = base->integer_v;
-        const long long x = exp->integer_v;
+    if (cell_type(base) == CELL_INTEGER && cell_type(exp) == CELL_INTEGER) {
+        const long long b = cell_int(base);
+        const long long x = cell_int(exp);
 
         if (x >= 0) {
             /* Positive exponent: compute b^x with overflow detection,
@@ -489,7 +541,7 @@ Cell* builtin_expt(const Lex* e, const Cell* a)
     }
 
     /* Base is complex. */
-    const bool result_is_exact = base->exact && exp->exact;
+    const bool result_is_exact = cell_exact(base) && cell_exact(exp);
     const long double complex b_c = cell_to_c_complex(base);
     const long double complex e_c = cell_to_c_complex(exp);
     const long double complex res_c = cpowl(b_c, e_c);
@@ -519,13 +571,13 @@ Cell* builtin_modulo(const Lex* e, const Cell* a)
     if (err) { return err; }
     if ((err = CHECK_ARITY_EXACT(a, 2, "modulo"))) { return err; }
 
-    if (a->cell[0]->type == CELL_BIGINT) {
+    if (cell_type(a->cell[0]) == CELL_BIGINT) {
         return bigint_mod(a->cell[0], a->cell[1]);
     }
 
-    long long r = a->cell[0]->integer_v % a->cell[1]->integer_v;
-    if (r != 0 && ((a->cell[1]->integer_v > 0 && r < 0) || (a->cell[1]->integer_v < 0 && r > 0))) {
-        r += a->cell[1]->integer_v;
+    long long r = cell_int(a->cell[0]) % cell_int(a->cell[1]);
+    if (r != 0 && ((cell_int(a->cell[1]) > 0 && r < 0) || (cell_int(a->cell[1]) < 0 && r > 0))) {
+        r += cell_int(a->cell[1]);
     }
     return make_cell_integer(r);
 }
@@ -541,15 +593,15 @@ Cell* builtin_quotient(const Lex* e, const Cell* a)
     if (err) { return err; }
     if ((err = CHECK_ARITY_EXACT(a, 2, "quotient"))) { return err; }
 
-    if (a->cell[1]->integer_v == 0) {
+    if (cell_int(a->cell[1]) == 0) {
         return make_cell_error("quotient: division by zero", VALUE_ERR);
     }
 
-    if (a->cell[0]->type == CELL_BIGINT) {
+    if (cell_type(a->cell[0]) == CELL_BIGINT) {
         return bigint_quo_rem(a->cell[0], a->cell[1], QR_QUOTIENT);
     }
 
-    return make_cell_integer(a->cell[0]->integer_v / a->cell[1]->integer_v);
+    return make_cell_integer(cell_int(a->cell[0]) / cell_int(a->cell[1]));
 }
 
 
@@ -563,15 +615,15 @@ Cell* builtin_remainder(const Lex* e, const Cell* a)
     if (err) { return err; }
     if ((err = CHECK_ARITY_EXACT(a, 2, "remainder"))) { return err; }
 
-    if (a->cell[1]->integer_v == 0) {
+    if (cell_int(a->cell[1]) == 0) {
         return make_cell_error("remainder: division by zero", VALUE_ERR);
     }
 
-    if (a->cell[0]->type == CELL_BIGINT) {
+    if (cell_type(a->cell[0]) == CELL_BIGINT) {
         return bigint_quo_rem(a->cell[0], a->cell[1], QR_REMAINDER);
     }
 
-    return make_cell_integer(a->cell[0]->integer_v % a->cell[1]->integer_v);
+    return make_cell_integer(cell_int(a->cell[0]) % cell_int(a->cell[1]));
 }
 
 
@@ -655,7 +707,7 @@ Cell* builtin_floor(const Lex* e, const Cell* a)
     if (err) { return err; }
     if ((err = CHECK_ARITY_EXACT(a, 1, "floor"))) { return err; }
 
-    if (a->cell[0]->type == CELL_BIGINT || a->cell[0]->type == CELL_INTEGER) {
+    if (cell_type(a->cell[0]) == CELL_BIGINT || cell_type(a->cell[0]) == CELL_INTEGER) {
         return a->cell[0];
     }
 
@@ -677,7 +729,7 @@ Cell* builtin_ceiling(const Lex* e, const Cell* a)
     if (err) { return err; }
     if ((err = CHECK_ARITY_EXACT(a, 1, "ceiling"))) { return err; }
 
-    if (a->cell[0]->type == CELL_BIGINT || a->cell[0]->type == CELL_INTEGER) {
+    if (cell_type(a->cell[0]) == CELL_BIGINT || cell_type(a->cell[0]) == CELL_INTEGER) {
         return a->cell[0];
     }
 
@@ -699,7 +751,7 @@ Cell* builtin_round(const Lex* e, const Cell* a)
     if (err) { return err; }
     if ((err = CHECK_ARITY_EXACT(a, 1, "round"))) { return err; }
 
-    if (a->cell[0]->type == CELL_BIGINT || a->cell[0]->type == CELL_INTEGER) {
+    if (cell_type(a->cell[0]) == CELL_BIGINT || cell_type(a->cell[0]) == CELL_INTEGER) {
         return a->cell[0];
     }
 
@@ -728,7 +780,7 @@ Cell* builtin_truncate(const Lex* e, const Cell* a)
     if (err) { return err; }
     if ((err = CHECK_ARITY_EXACT(a, 1, "truncate"))) { return err; }
 
-    if (a->cell[0]->type == CELL_BIGINT || a->cell[0]->type == CELL_INTEGER) {
+    if (cell_type(a->cell[0]) == CELL_BIGINT || cell_type(a->cell[0]) == CELL_INTEGER) {
         return a->cell[0];
     }
 
@@ -752,7 +804,7 @@ Cell* builtin_numerator(const Lex* e, const Cell* a)
     if ((err = CHECK_ARITY_EXACT(a, 1, "numerator"))) { return err; }
 
     /* Return ints unchanged. */
-    if (a->cell[0]->type == CELL_INTEGER || a->cell[0]->type == CELL_BIGINT) {
+    if (cell_type(a->cell[0]) == CELL_INTEGER || cell_type(a->cell[0]) == CELL_BIGINT) {
         return a->cell[0];
     }
     return make_cell_integer(a->cell[0]->num);
@@ -772,7 +824,7 @@ Cell* builtin_denominator(const Lex* e, const Cell* a)
     if ((err = CHECK_ARITY_EXACT(a, 1, "denominator"))) { return err; }
 
     /* Denominator of int is always 1. */
-    if (a->cell[0]->type == CELL_INTEGER || a->cell[0]->type == CELL_BIGINT) {
+    if (cell_type(a->cell[0]) == CELL_INTEGER || cell_type(a->cell[0]) == CELL_BIGINT) {
         return make_cell_integer(1);
     }
     return make_cell_integer(a->cell[0]->den);
@@ -849,7 +901,7 @@ Cell* builtin_square(const Lex* e, const Cell* a)
     if (err) { return err; }
     if ((err = CHECK_ARITY_EXACT(a, 1, "square"))) { return err; }
 
-    if (a->cell[0]->type == CELL_BIGINT) {
+    if (cell_type(a->cell[0]) == CELL_BIGINT) {
         Cell* result = cell_copy(a->cell[0]);
         mpz_mul(*result->bi, *result->bi, *result->bi);
         return result;
@@ -872,7 +924,7 @@ Cell* builtin_sqrt(const Lex* e, const Cell* a)
 
     const Cell* v = a->cell[0];
 
-    if (v->type == CELL_COMPLEX)
+    if (cell_type(v) == CELL_COMPLEX)
     {
         const long double complex z = cell_to_c_complex(a->cell[0]);
         const long double complex z_result = csqrtl(z);
@@ -898,7 +950,7 @@ Cell* builtin_sqrt(const Lex* e, const Cell* a)
 
     const long double n_prime = sqrtl(n);
     /* If input was exact, try to return an exact integer root. */
-    if (v->exact) {
+    if (cell_exact(v)) {
         const long long root = (long long)n_prime;
         if (root * root == n) {
             return make_cell_integer(root);
@@ -946,11 +998,11 @@ Cell* builtin_exact_integer_sqrt(const Lex* e, const Cell* a)
     if (err) { return err; }
     if ((err = CHECK_ARITY_EXACT(a, 1, "exact-integer-sqrt"))) { return err; }
 
-    if (a->cell[0]->type == CELL_BIGINT) {
+    if (cell_type(a->cell[0]) == CELL_BIGINT) {
         return bigint_exact_int_sqrt(a->cell[0]);
     }
 
-    const long long k = a->cell[0]->integer_v;
+    const long long k = cell_int(a->cell[0]);
     if (k < 1) {
         make_cell_error(
             "exact-integer-sqrt: arg1 must be an exact positive integer",
@@ -983,15 +1035,14 @@ Cell* builtin_exact(const Lex* e, const Cell* a)
     if ((err = CHECK_ARITY_EXACT(a, 1, "exact"))) { return err; }
 
     /* Just return if it's already exact. */
-    if (a->cell[0]->exact) {
+    if (cell_exact(a->cell[0])) {
         return a->cell[0];
     }
-    if (a->cell[0]->type == CELL_COMPLEX) {
-        a->cell[0]->real->exact = 1;
-        a->cell[0]->imag->exact = 1;
+    if (cell_type(a->cell[0]) == CELL_COMPLEX) {
+        a->cell[0]->real = cell_set_exact(a->cell[0]->real, true);
+        a->cell[0]->imag = cell_set_exact(a->cell[0]->imag, true);
     }
-    a->cell[0]->exact = 1;
-    return a->cell[0];
+    return cell_set_exact(a->cell[0], true);
 }
 
 
@@ -1011,17 +1062,16 @@ Cell* builtin_inexact(const Lex* e, const Cell* a)
     if ((err = CHECK_ARITY_EXACT(a, 1, "inexact"))) { return err; }
 
     /* Just return if it's already inexact. */
-    if (a->cell[0]->exact == 0) {
+    if (cell_exact(a->cell[0]) == 0) {
         return a->cell[0];
     }
-    if (a->cell[0]->type == CELL_COMPLEX) {
-        a->cell[0]->real->exact = 0;
-        a->cell[0]->imag->exact = 0;
+    if (cell_type(a->cell[0]) == CELL_COMPLEX) {
+        a->cell[0]->real = cell_set_exact(a->cell[0]->real, false);
+        a->cell[0]->imag = cell_set_exact(a->cell[0]->imag, false);
     }
     Cell* slug = make_cell_real(0.0000);
     numeric_promote(&a->cell[0], &slug);
-    a->cell[0]->exact = 0;
-    return a->cell[0];
+    return cell_set_exact(a->cell[0], false);
 }
 
 
@@ -1037,12 +1087,12 @@ Cell* builtin_infinite(const Lex* e, const Cell* a)
     if (err) { return err; }
     if ((err = CHECK_ARITY_EXACT(a, 1, "infinite?"))) { return err; }
 
-    if (a->cell[0]->type == CELL_BIGINT) {
+    if (cell_type(a->cell[0]) == CELL_BIGINT) {
         return False_Obj;
     }
 
     const Cell* arg = a->cell[0];
-    if (arg->type == CELL_COMPLEX) {
+    if (cell_type(arg) == CELL_COMPLEX) {
         const long double r = cell_to_long_double(arg->real);
         const long double i = cell_to_long_double(arg->imag);
         return make_cell_boolean(isinf(r) || isinf(i));
@@ -1065,12 +1115,12 @@ Cell* builtin_finite(const Lex* e, const Cell* a)
     if (err) { return err; }
     if ((err = CHECK_ARITY_EXACT(a, 1, "finite?"))) { return err; }
 
-    if (a->cell[0]->type == CELL_BIGINT) {
+    if (cell_type(a->cell[0]) == CELL_BIGINT) {
         return True_Obj;
     }
 
     const Cell* arg = a->cell[0];
-    if (arg->type == CELL_COMPLEX) {
+    if (cell_type(arg) == CELL_COMPLEX) {
         const long double r = cell_to_long_double(arg->real);
         const long double i = cell_to_long_double(arg->imag);
         return make_cell_boolean(isfinite(r) && isfinite(i));
@@ -1094,12 +1144,12 @@ Cell* builtin_nan(const Lex* e, const Cell* a)
         "nan?");
     if (err) { return err; }
 
-    if (a->cell[0]->type == CELL_BIGINT) {
+    if (cell_type(a->cell[0]) == CELL_BIGINT) {
         return False_Obj;
     }
 
     const Cell* arg = a->cell[0];
-    if (arg->type == CELL_COMPLEX) {
+    if (cell_type(arg) == CELL_COMPLEX) {
         const long double r = cell_to_long_double(arg->real);
         const long double i = cell_to_long_double(arg->imag);
         return make_cell_boolean(isnan(r) || isnan(i));
@@ -1148,18 +1198,18 @@ Cell* builtin_gcd(const Lex* e, const Cell* a)
 
     bool bigint_seen = false;
     for (int i = 0; i < a->count; i++) {
-        if (a->cell[i]->type == CELL_BIGINT) {
+        if (cell_type(a->cell[i]) == CELL_BIGINT) {
             bigint_seen = true;
         }
     }
 
     if (bigint_seen) {
-        Cell* result = (a->cell[0]->type == CELL_BIGINT)
+        Cell* result = (cell_type(a->cell[0]) == CELL_BIGINT)
             ? cell_copy(a->cell[0])
             : make_cell_bigint(nullptr, a->cell[0], 10);
 
         for (int i = 1; i < a->count; i++) {
-            Cell* next = (a->cell[i]->type == CELL_BIGINT)
+            Cell* next = (cell_type(a->cell[i]) == CELL_BIGINT)
                 ? a->cell[i]
                 : make_cell_bigint(nullptr, a->cell[i], 10);
             mpz_gcd(*result->bi, *result->bi, *next->bi);
@@ -1167,9 +1217,9 @@ Cell* builtin_gcd(const Lex* e, const Cell* a)
         return result;
     }
 
-    long long result = a->cell[0]->integer_v;
+    long long result = cell_int(a->cell[0]);
     for (int i = 1; i < a->count; i++) {
-        result = gcd_helper(result, a->cell[i]->integer_v);
+        result = gcd_helper(result, cell_int(a->cell[i]));
     }
 
     return make_cell_integer(llabs(result)); /* Final result must be non-negative. */
@@ -1191,7 +1241,7 @@ Cell* builtin_lcm(const Lex* e, const Cell* a)
     /* If any argument is already a bigint, use GMP throughout. */
     bool bigint_seen = false;
     for (int i = 0; i < a->count; i++) {
-        if (a->cell[i]->type == CELL_BIGINT) {
+        if (cell_type(a->cell[i]) == CELL_BIGINT) {
             bigint_seen = true;
             break;
         }
@@ -1203,12 +1253,12 @@ Cell* builtin_lcm(const Lex* e, const Cell* a)
          * here as it won't promote INTEGER->BIGINT until it encounters
          * a BIGINT argument, leaving result->bi uninitialised for the
          * early iterations. */
-        Cell* result = (a->cell[0]->type == CELL_BIGINT)
+        Cell* result = (cell_type(a->cell[0]) == CELL_BIGINT)
             ? cell_copy(a->cell[0])
             : make_cell_bigint(nullptr, a->cell[0], 10);
 
         for (int i = 1; i < a->count; i++) {
-            Cell* next = (a->cell[i]->type == CELL_BIGINT)
+            Cell* next = (cell_type(a->cell[i]) == CELL_BIGINT)
                 ? a->cell[i]
                 : make_cell_bigint(nullptr, a->cell[i], 10);
             mpz_lcm(*result->bi, *result->bi, *next->bi);
@@ -1218,10 +1268,10 @@ Cell* builtin_lcm(const Lex* e, const Cell* a)
 
     /* Scalar path: compute in long long with mid-loop overflow detection,
      * promoting to bigint if needed. */
-    long long result = llabs(a->cell[0]->integer_v);
+    long long result = llabs(cell_int(a->cell[0]));
 
     for (int i = 1; i < a->count; i++) {
-        const long long b_val = llabs(a->cell[i]->integer_v);
+        const long long b_val = llabs(cell_int(a->cell[i]));
 
         /* LCM with zero is always zero. */
         if (result == 0 || b_val == 0) {
@@ -1247,7 +1297,7 @@ Cell* builtin_lcm(const Lex* e, const Cell* a)
             mpz_mul(*big_result->bi, *big_result->bi, *big_b->bi);
 
             for (int j = i + 1; j < a->count; j++) {
-                Cell* big_next = (a->cell[j]->type == CELL_BIGINT)
+                Cell* big_next = (cell_type(a->cell[j]) == CELL_BIGINT)
                     ? a->cell[j]
                     : make_cell_bigint(nullptr, a->cell[j], 10);
                 mpz_lcm(*big_result->bi, *big_result->bi, *big_next->bi);
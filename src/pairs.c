@@ -39,18 +39,18 @@ inline Cell* car__(const Cell* list)
 {
     // ReSharper disable once CppVariableCanBeMadeConstexpr
     const int mask = CELL_PAIR|CELL_NIL|CELL_SEXPR;
-    if (!(list->type & mask)) {
+    if (!(cell_type(list) & mask)) {
         return make_cell_error(
         fmt_err("car: got %s, expected %s",
-             cell_type_name(list->type),
+             cell_type_name(cell_type(list)),
              cell_mask_types(CELL_PAIR)),
             TYPE_ERR);
     }
-    if (list->type == CELL_NIL) {
+    if (cell_type(list) == CELL_NIL) {
         return Nil_Obj;
     }
 
-    if (list->type == CELL_PAIR) {
+    if (cell_type(list) == CELL_PAIR) {
         return list->car;
     }
     return list->cell[0];
@@ -61,18 +61,18 @@ inline Cell* cdr__(const Cell* list)
 {
     // ReSharper disable once CppVariableCanBeMadeConstexpr
     const int mask = CELL_PAIR|CELL_NIL|CELL_SEXPR;
-    if (!(list->type & mask)) {
+    if (!(cell_type(list) & mask)) {
         return make_cell_error(
         fmt_err("car: got %s, expected %s",
-             cell_type_name(list->type),
+             cell_type_name(cell_type(list)),
              cell_mask_types(CELL_PAIR)),
             TYPE_ERR);
     }
-    if (list->type == CELL_NIL) {
+    if (cell_type(list) == CELL_NIL) {
         return Nil_Obj;
     }
 
-    if (list->type == CELL_PAIR) {
+    if (cell_type(list) == CELL_PAIR) {
         return list->cdr;
     }
     return sexp_cdr((Cell*)list);
@@ -85,18 +85,18 @@ static int32_t list_len(const Cell* list)
     const Cell* slow = list;
     const Cell* fast = list;
 
-    while (list->type == CELL_PAIR) {
+    while (cell_type(list) == CELL_PAIR) {
         count++;
         list = list->cdr;
 
         /* Tortoise and Hare Cycle Detection. */
-        if (fast->type == CELL_PAIR && fast->cdr->type == CELL_PAIR) {
+        if (cell_type(fast) == CELL_PAIR && cell_type(fast->cdr) == CELL_PAIR) {
             fast = fast->cdr->cdr;
             slow = slow->cdr;
             if (fast == slow) return -2;
         }
 
-        if (list->type == CELL_NIL) {
+        if (cell_type(list) == CELL_NIL) {
             /* Found the end! Cache the result in the head for next time. */
             return count;
         }
@@ -204,7 +204,7 @@ Cell* builtin_set_car(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 2, "set-car!");
     if (err) return err;
-    if (a->cell[0]->type != CELL_PAIR) {
+    if (cell_type(a->cell[0]) != CELL_PAIR) {
         return make_cell_error(
             "set-car!: arg 1 must be a pair",
             TYPE_ERR);
@@ -223,7 +223,7 @@ Cell* builtin_set_cdr(const Lex* e, const Cell* a)
     if (err) return err;
 
     Cell* pair = a->cell[0];
-    if (pair->type != CELL_PAIR) {
+    if (cell_type(pair) != CELL_PAIR) {
         return make_cell_error(
             "set-cdr!: arg 1 must be a pair",
             TYPE_ERR);
@@ -249,8 +249,8 @@ Cell* builtin_list_length(const Lex* e, const Cell* a)
     if (err) return err;
 
     const Cell* list = a->cell[0];
-    if (list->type == CELL_NIL) return make_cell_integer(0);
-    if (list->type != CELL_PAIR) {
+    if (cell_type(list) == CELL_NIL) return make_cell_integer(0);
+    if (cell_type(list) != CELL_PAIR) {
         return make_cell_error(
             "length: arg must be a list",
             TYPE_ERR);
@@ -282,19 +282,19 @@ Cell* builtin_list_ref(const Lex* e, const Cell* a)
     if (err) return err;
 
     Cell* list = a->cell[0];
-    if (list->type != CELL_PAIR ) {
+    if (cell_type(list) != CELL_PAIR ) {
         return make_cell_error(
             "list-ref: arg 1 must be a list",
             TYPE_ERR);
     }
 
-    if (a->cell[1]->type != CELL_INTEGER) {
+    if (cell_type(a->cell[1]) != CELL_INTEGER) {
         return make_cell_error(
             "list-ref: arg 2 must be an integer",
             TYPE_ERR);
     }
 
-    const int32_t idx = (int32_t)a->cell[1]->integer_v;
+    const int32_t idx = (int32_t)cell_int(a->cell[1]);
     if (idx < 0) {
         return make_cell_error(
             "list-ref: index must be non-negative",
@@ -343,11 +343,11 @@ Cell* builtin_list_append(const Lex* e, const Cell* a)
     long long total_copied_len = 0;
     for (int i = 0; i < a->count - 1; i++) {
         const Cell* current_list = a->cell[i];
-        if (current_list->type == CELL_NIL) {
+        if (cell_type(current_list) == CELL_NIL) {
             continue; /* This is a proper, empty list. */
         }
         /* All but the last argument must be a list. */
-        if (current_list->type != CELL_PAIR) {
+        if (cell_type(current_list) != CELL_PAIR) {
             return make_cell_error(
                 fmt_err("append: arg%d is not a list", i+1),
                 TYPE_ERR);
@@ -355,10 +355,10 @@ Cell* builtin_list_append(const Lex* e, const Cell* a)
 
         /* Now, walk the list to ensure it's a *proper* list */
         const Cell* p = current_list;
-        while (p->type == CELL_PAIR) {
+        while (cell_type(p) == CELL_PAIR) {
             p = p->cdr;
         }
-        if (p->type != CELL_NIL) {
+        if (cell_type(p) != CELL_NIL) {
             return make_cell_error(
                 fmt_err("append: arg%d is not a proper list", i+1),
                 TYPE_ERR);
@@ -372,9 +372,9 @@ Cell* builtin_list_append(const Lex* e, const Cell* a)
     const Cell* last_arg = a->cell[a->count - 1];
     long long final_total_len = -1; /* Use -1 to signify an improper list. */
 
-    if (last_arg->type == CELL_NIL) {
+    if (cell_type(last_arg) == CELL_NIL) {
         final_total_len = total_copied_len;
-    } else if (last_arg->type == CELL_PAIR) {
+    } else if (cell_type(last_arg) == CELL_PAIR) {
         /* If the last arg has a valid length, the result will be a proper list. */
         if (last_arg->len != -1) {
              final_total_len = total_copied_len + last_arg->len;
@@ -388,7 +388,7 @@ Cell* builtin_list_append(const Lex* e, const Cell* a)
 
     for (int i = 0; i < a->count - 1; i++) {
         const Cell* p = a->cell[i];
-        while (p->type == CELL_PAIR) {
+        while (cell_type(p) == CELL_PAIR) {
             /* Create a new pair with a copy of the element. */
             Cell* new_pair = make_cell_pair(p->car, make_cell_nil());
 
@@ -432,7 +432,7 @@ Cell* builtin_list_reverse(const Lex* e, const Cell* a)
     if (err) { return err; }
 
     const Cell* original_list = a->cell[0];
-    if (original_list->type == CELL_NIL) {
+    if (cell_type(original_list) == CELL_NIL) {
         return make_cell_nil();
     }
 
@@ -440,20 +440,20 @@ Cell* builtin_list_reverse(const Lex* e, const Cell* a)
     const Cell* current = original_list;
     int length = 0;
 
-    while (current->type == CELL_PAIR) {
+    while (cell_type(current) == CELL_PAIR) {
         reversed_list = make_cell_pair(current->car, reversed_list);
         length++;
         current = current->cdr;
     }
 
-    if (current->type != CELL_NIL) {
+    if (cell_type(current) != CELL_NIL) {
         return make_cell_error(
             "reverse: cannot reverse improper list",
             TYPE_ERR);
     }
 
     /* Set the length on the final result. */
-    if (reversed_list->type != CELL_NIL) {
+    if (cell_type(reversed_list) != CELL_NIL) {
         reversed_list->len = length;
     }
     return reversed_list;
@@ -470,21 +470,25 @@ Cell* builtin_list_tail(const Lex* e, const Cell* a)
 
     const Cell* lst = a->cell[0];
 
-    if (a->cell[1]->type != CELL_INTEGER) {
+    if (cell_type(a->cell[1]) != CELL_INTEGER) {
         return make_cell_error(
             "list-tail: arg 2 must be an integer",
             TYPE_ERR);
     }
 
-    const int32_t k = (int32_t)a->cell[1]->integer_v;
+    const int32_t k = (int32_t)cell_int(a->cell[1]);
     if (k < 0) {
         return make_cell_error(
             "list-tail: index must be non-negative",
             VALUE_ERR);
     }
 
-    if (lst->type == CELL_NIL) {
+    if (cell_type(lst) == CELL_NIL) {
         if (k == 0) return make_cell_nil();
+    } else if (cell_type(lst) != CELL_PAIR) {
+        return make_cell_error(
+            "list-tail: arg1 must be a list",
+            TYPE_ERR);
     }
 
     if (k > lst->len) {
@@ -493,7 +497,7 @@ Cell* builtin_list_tail(const Lex* e, const Cell* a)
             INDEX_ERR);
     }
 
-    if (lst->type != CELL_PAIR) {
+    if (cell_type(lst) != CELL_PAIR) {
         return make_cell_error(
             "list-tail: arg1 must be a list",
             TYPE_ERR);
@@ -512,7 +516,7 @@ Cell* builtin_make_list(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_RANGE(a, 1, 2, "make-list");
     if (err) return err;
-    if (a->cell[0]->type != CELL_INTEGER || a->cell[0]->integer_v < 1) {
+    if (cell_type(a->cell[0]) != CELL_INTEGER || cell_int(a->cell[0]) < 1) {
         return make_cell_error(
             "make-list: arg 1 must be a positive integer",
             VALUE_ERR);
@@ -526,7 +530,7 @@ Cell* builtin_make_list(const Lex* e, const Cell* a)
     /* Start with nil. */
     Cell* result = make_cell_nil();
 
-    const int len = (int)a->cell[0]->integer_v;
+    const int len = (int)cell_int(a->cell[0]);
     /* Build backwards so it comes out in the right order. */
     for (int i = len - 1; i >= 0; i--) {
         result = make_cell_pair(fill, result);
@@ -543,18 +547,18 @@ Cell* builtin_list_set(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 3, "list-set!");
     if (err) return err;
-    if (a->cell[0]->type != CELL_PAIR) {
+    if (cell_type(a->cell[0]) != CELL_PAIR) {
         return make_cell_error(
             "list-set!: arg 1 must be a list",
             TYPE_ERR);
     }
-    if (a->cell[1]->type != CELL_INTEGER && a->cell[1]->integer_v < 0) {
+    if (cell_type(a->cell[1]) != CELL_INTEGER && cell_int(a->cell[1]) < 0) {
         return make_cell_error(
             "list-set!: arg 2 must be a valid list index",
             VALUE_ERR);
     }
     Cell* p = a->cell[0];
-    const int len = (int)a->cell[1]->integer_v;
+    const int len = (int)cell_int(a->cell[1]);
 
     if (a->cell[0]->len <= len) {
         return make_cell_error(
@@ -585,7 +589,7 @@ Cell* builtin_memq(const Lex* e, const Cell* a)
     const Cell* key = a->cell[0];
     Cell* list = a->cell[1];
 
-    while (list != NULL && list->type == CELL_PAIR) {
+    while (list != NULL && cell_type(list) == CELL_PAIR) {
         if (list->car == key) {
             return list;
         }
@@ -608,7 +612,7 @@ Cell* builtin_memv(const Lex* e, const Cell* a)
     Cell* list = a->cell[1];
 
     /* Iterate until we hit the end of the list. */
-    while (list != NULL && list->type == CELL_PAIR) {
+    while (list != NULL && cell_type(list) == CELL_PAIR) {
         /* Prepare args for eqv? : (key element). */
         Cell* eqv_args = make_cell_sexpr();
         cell_add(eqv_args, (Cell*)key);
@@ -642,7 +646,7 @@ Cell* builtin_member(const Lex* e, const Cell* a)
     Cell* list = a->cell[1];
     Cell* predicate = a->count == 3 ? a->cell[2] : USP_Obj;
 
-    while (list != NULL && list->type == CELL_PAIR) {
+    while (list != NULL && cell_type(list) == CELL_PAIR) {
         Cell* result;
         if (predicate == USP_Obj) {
             /* Default to equal? */
@@ -673,7 +677,7 @@ Cell* builtin_assq(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 2, "assq");
     if (err) return err;
-    if (a->cell[1]->type != CELL_PAIR) {
+    if (cell_type(a->cell[1]) != CELL_PAIR) {
         return make_cell_error(
             "assq: arg 2 must be a pair",
             TYPE_ERR);
@@ -681,9 +685,9 @@ Cell* builtin_assq(const Lex* e, const Cell* a)
 
     const Cell* p = a->cell[1];
     const Cell* obj = a->cell[0];
-    while (p->type != CELL_NIL) {
+    while (cell_type(p) != CELL_NIL) {
         /* eq? == direct pointer equality */
-        if (p->car->type != CELL_PAIR) {
+        if (cell_type(p->car) != CELL_PAIR) {
             return make_cell_error(
                 "assq: arg 2 must be an association list",
                 VALUE_ERR);
@@ -705,7 +709,7 @@ Cell* builtin_assv(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 2, "assv");
     if (err) return err;
-    if (a->cell[1]->type != CELL_PAIR) {
+    if (cell_type(a->cell[1]) != CELL_PAIR) {
         return make_cell_error(
             "assv: arg 2 must be a pair",
             TYPE_ERR);
@@ -713,8 +717,8 @@ Cell* builtin_assv(const Lex* e, const Cell* a)
 
     const Cell* p = a->cell[1];
     const Cell* obj = a->cell[0];
-    while (p->type != CELL_NIL) {
-        if (p->car->type != CELL_PAIR) {
+    while (cell_type(p) != CELL_NIL) {
+        if (cell_type(p->car) != CELL_PAIR) {
             return make_cell_error(
                 "assv: arg 2 must be an association list",
                 VALUE_ERR);
@@ -738,13 +742,13 @@ Cell* builtin_assoc(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_RANGE(a, 2, 3, "assoc");
     if (err) return err;
-    if (a->cell[1]->type != CELL_PAIR) {
+    if (cell_type(a->cell[1]) != CELL_PAIR) {
         return make_cell_error(
             "assoc: arg 2 must be a pair",
             TYPE_ERR);
     }
     if (a->count == 3) {
-        if (a->cell[2]->type != CELL_PROC) {
+        if (cell_type(a->cell[2]) != CELL_PROC) {
             return make_cell_error(
                 "assoc: arg 3 must be a procedure",
                 TYPE_ERR);
@@ -753,8 +757,8 @@ Cell* builtin_assoc(const Lex* e, const Cell* a)
 
     const Cell* p = a->cell[1];
     const Cell* obj = a->cell[0];
-    while (p->type != CELL_NIL) {
-        if (p->car->type != CELL_PAIR) {
+    while (cell_type(p) != CELL_NIL) {
+        if (cell_type(p->car) != CELL_PAIR) {
             return make_cell_error(
                 "assoc: arg 2 must be an association list",
                 VALUE_ERR);
@@ -791,7 +795,7 @@ Cell* builtin_list_copy(const Lex* e, const Cell* a)
     Cell* err = CHECK_ARITY_EXACT(a, 1, "list-copy");
     if (err) return err;
     /* Non-pairs get returned unaltered. */
-    if (a->cell[0]->type != CELL_PAIR) {
+    if (cell_type(a->cell[0]) != CELL_PAIR) {
         return a->cell[0];
     }
 
@@ -801,7 +805,7 @@ Cell* builtin_list_copy(const Lex* e, const Cell* a)
     /* Runner pointers for iteration. */
     Cell* new_p = new_list_head;
     const Cell* old_p = old_list;
-    while (old_p->cdr->type != CELL_NIL && old_p->cdr->type == CELL_PAIR) {
+    while (cell_type(old_p->cdr) != CELL_NIL && cell_type(old_p->cdr) == CELL_PAIR) {
         /* Advance the old pointer. */
         old_p = old_p->cdr;
         /* Create a new cell and link it. */
@@ -828,16 +832,16 @@ Cell* builtin_filter(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 2, "filter");
     if (err) return err;
-    if (a->cell[0]->type != CELL_PROC) {
+    if (cell_type(a->cell[0]) != CELL_PROC) {
         return make_cell_error(
             "filter: arg 1 must be a procedure",
             TYPE_ERR);
     }
     /* Empty list arg :: empty list result. */
-    if (a->cell[1]->type == CELL_NIL) {
+    if (cell_type(a->cell[1]) == CELL_NIL) {
         return make_cell_nil();
     }
-    if (a->cell[1]->type != CELL_PAIR || a->cell[1]->len < 1 ) {
+    if (cell_type(a->cell[1]) != CELL_PAIR || a->cell[1]->len < 1 ) {
         return make_cell_error(
             "filter: arg 2 must be a proper list",
             TYPE_ERR);
@@ -856,11 +860,11 @@ Cell* builtin_filter(const Lex* e, const Cell* a)
         } else {
             pred_outcome = coz_apply_and_get_val(proc, make_sexpr_len1(val->car), (Lex*)e);
         }
-        if (pred_outcome->type == CELL_ERROR) {
+        if (cell_type(pred_outcome) == CELL_ERROR) {
             return pred_outcome;
         }
         /* Continue if pred isn't true/truthy. */
-        if (pred_outcome->type == CELL_BOOLEAN && pred_outcome->boolean_v == 0) {
+        if (cell_type(pred_outcome) == CELL_BOOLEAN && pred_outcome->boolean_v == 0) {
             val = val->cdr;
             continue;
         }
@@ -877,7 +881,7 @@ Cell* builtin_foldl(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_MIN(a, 3, "foldl");
     if (err) return err;
-    if (a->cell[0]->type != CELL_PROC) {
+    if (cell_type(a->cell[0]) != CELL_PROC) {
         return make_cell_error(
             "foldl: arg 1 must be a procedure",
             TYPE_ERR);
@@ -886,11 +890,11 @@ Cell* builtin_foldl(const Lex* e, const Cell* a)
     int shortest_list_length = INT32_MAX;
     for (int i = 2; i < a->count; i++) {
         /* If any of the list args is empty, return the accumulator. */
-        if (a->cell[i]->type == CELL_NIL) {
+        if (cell_type(a->cell[i]) == CELL_NIL) {
             return a->cell[1];
         }
 
-        if (a->cell[i]->type != CELL_PAIR || a->cell[i]->len == -1) {
+        if (cell_type(a->cell[i]) != CELL_PAIR || a->cell[i]->len == -1) {
             return make_cell_error(
                 fmt_err("foldl: arg %d must be a proper list", i+1),
                 TYPE_ERR);
@@ -925,7 +929,7 @@ Cell* builtin_foldl(const Lex* e, const Cell* a)
         } else {
             tmp_result = coz_apply_and_get_val(proc, arg_list, (Lex*)e);
         }
-        if (tmp_result->type == CELL_ERROR) {
+        if (cell_type(tmp_result) == CELL_ERROR) {
             /* Propagate any evaluation errors. */
             return tmp_result;
         }
@@ -942,7 +946,7 @@ Cell* builtin_foldr(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_MIN(a, 3, "foldr");
     if (err) return err;
-    if (a->cell[0]->type != CELL_PROC) {
+    if (cell_type(a->cell[0]) != CELL_PROC) {
         return make_cell_error(
             "foldr: arg 1 must be a procedure",
             TYPE_ERR);
@@ -951,11 +955,11 @@ Cell* builtin_foldr(const Lex* e, const Cell* a)
     int shortest_list_length = INT32_MAX;
     for (int i = 2; i < a->count; i++) {
         /* If any of the list args is empty, return the accumulator. */
-        if (a->cell[i]->type == CELL_NIL) {
+        if (cell_type(a->cell[i]) == CELL_NIL) {
             return a->cell[1];
         }
 
-        if (a->cell[i]->type != CELL_PAIR || a->cell[i]->len == -1) {
+        if (cell_type(a->cell[i]) != CELL_PAIR || a->cell[i]->len == -1) {
             return make_cell_error(
                 fmt_err("foldr: arg %d must be a proper list", i+1),
                 TYPE_ERR);
@@ -991,7 +995,7 @@ Cell* builtin_foldr(const Lex* e, const Cell* a)
         } else {
             tmp_result = coz_apply_and_get_val(proc, arg_list, (Lex*)e);
         }
-        if (tmp_result->type == CELL_ERROR) {
+        if (cell_type(tmp_result) == CELL_ERROR) {
             /* Propagate any evaluation errors. */
             return tmp_result;
         }
@@ -1016,11 +1020,11 @@ Cell* builtin_zip(const Lex* e, const Cell* a)
     int shortest_list_length = INT32_MAX;
     for (int i = 0; i < a->count; i++) {
         /* If any of the list args is empty, return an empty list. */
-        if (a->cell[i]->type == CELL_NIL) {
+        if (cell_type(a->cell[i]) == CELL_NIL) {
             return make_cell_nil();
         }
 
-        if (a->cell[i]->type != CELL_PAIR || a->cell[i]->len == -1) {
+        if (cell_type(a->cell[i]) != CELL_PAIR || a->cell[i]->len == -1) {
             return make_cell_error(
                 fmt_err("zip: arg %d must be a proper list", i+1),
                 TYPE_ERR);
@@ -1058,12 +1062,12 @@ Cell* builtin_count(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 2, "count");
     if (err) return err;
-    if (a->cell[0]->type != CELL_PROC) {
+    if (cell_type(a->cell[0]) != CELL_PROC) {
         return make_cell_error(
             "count: arg 1 must be a predicate procedure",
             TYPE_ERR);
     }
-    if (a->cell[1]->type != CELL_PAIR || a->cell[1]->len == -1) {
+    if (cell_type(a->cell[1]) != CELL_PAIR || a->cell[1]->len == -1) {
         return make_cell_error(
             "count: arg 2 must be a list",
             TYPE_ERR);
@@ -1082,12 +1086,12 @@ Cell* builtin_count(const Lex* e, const Cell* a)
         } else {
             tmp_result = coz_apply_and_get_val(predicate, make_sexpr_len1(arg_list->car), (Lex*)e);
         }
-        if (tmp_result->type == CELL_ERROR) {
+        if (cell_type(tmp_result) == CELL_ERROR) {
             /* Propagate any evaluation errors. */
             return tmp_result;
         }
         /* Ensure the proc returned a boolean. */
-        if (tmp_result->type != CELL_BOOLEAN) {
+        if (cell_type(tmp_result) != CELL_BOOLEAN) {
             return make_cell_error(
                 "count: arg one must be a predicate procedure",
                 TYPE_ERR);
@@ -1111,7 +1115,7 @@ Cell* builtin_count_equal(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 2, "count-equal");
     if (err) return err;
-    if (a->cell[1]->type != CELL_PAIR || a->cell[1]->len == -1) {
+    if (cell_type(a->cell[1]) != CELL_PAIR || a->cell[1]->len == -1) {
         return make_cell_error(
             "count-equal: arg 2 must be a list",
             TYPE_ERR);
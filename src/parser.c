@@ -21,6 +21,8 @@
 #include "parser.h"
 #include "types.h"
 #include "repr.h"
+#include "float_io.h"
+#include "bytevectors.h"
 
 #include <gc.h>
 #include <stdio.h>
@@ -39,9 +41,16 @@
 
 static long double parse_float_checked(const char* str, char* err_buf, int* ok)
 {
+    /* Most literals are short plain decimals, which don't need strtold(). */
+    long double val;
+    if (parse_decimal_fast(str, &val)) {
+        *ok = 1;
+        return val;
+    }
+
     errno = 0;
     char* end_ptr;
-    const long double val = strtold(str, &end_ptr);
+    val = strtold(str, &end_ptr);
 
     if (end_ptr == str) {
         snprintf(err_buf, 128, "Invalid numeric: '%s%s%s'",
@@ -227,10 +236,10 @@ static Cell* parse_number(char* token, const int line, int len)
         }
 
         /* Propagate errors. */
-        if (r->type == CELL_ERROR) {
+        if (cell_type(r) == CELL_ERROR) {
             return r;
         }
-        if (i->type == CELL_ERROR) {
+        if (cell_type(i) == CELL_ERROR) {
             return i;
         }
 
@@ -261,10 +270,11 @@ static Cell* parse_number(char* token, const int line, int len)
                 VALUE_ERR);
         }
 
-        /* Make inexact if specified by prefix. */
+        /* Make inexact if specified by prefix. The rational may have
+         * reduced to a fixnum, which must be boxed to be inexact. */
         Cell* result = make_cell_rational(n, d, 1);
         if (exact == 0) {
-            result->exact = 0;
+            result = cell_set_exact(result, false);
         }
         return result;
     }
@@ -283,7 +293,7 @@ static Cell* parse_number(char* token, const int line, int len)
         if (ok) {
             Cell* result = make_cell_integer(i);
             if (exact == 0) {
-                result->exact = 0;
+                result = cell_set_exact(result, false);
             }
             return result;
         }
@@ -421,7 +431,7 @@ static Cell* parse_string(const char* str, const int len)
 
     /* Null-terminate the new, clean string. */
     internal_buffer[buf_idx] = '\0';
-    return make_cell_string(internal_buffer);
+    return make_cell_string_literal(internal_buffer);
 }
 
 
@@ -437,19 +447,24 @@ static Cell* parse_boolean(const char* tok, const int line)
 }
 
 
-static Cell* parse_symbol(char* tok, const int line, const int len)
+static Cell* parse_symbol(const Token* token)
 {
     /* This is kind of an ugly kludge, but I'm
      * not sure how to do it more elegantly. */
-    if (strcmp(tok, "+inf.0") == 0 ||
-        strcmp(tok, "-inf.0") == 0 ||
-        strcmp(tok, "+nan.0") == 0 ||
-        strcmp(tok, "-nan.0") == 0 ||
-        strcmp(tok, "nan.0") == 0 ||
-        strcmp(tok, "inf.0") == 0) {
-        return parse_number(tok, line, len);
+    if (token->length == 5 || token->length == 6) {
+        char* tok = token_to_string(token);
+        if (strcmp(tok, "+inf.0") == 0 ||
+            strcmp(tok, "-inf.0") == 0 ||
+            strcmp(tok, "+nan.0") == 0 ||
+            strcmp(tok, "-nan.0") == 0 ||
+            strcmp(tok, "nan.0") == 0 ||
+            strcmp(tok, "inf.0") == 0) {
+            return parse_number(tok, token->line, token->length);
+        }
     }
-    return make_cell_symbol(tok);
+    /* Intern straight from the source text, so a symbol
+     * which has been seen before is not copied at all. */
+    return make_cell_symbol_n(token->start, token->length);
 }
 
 
@@ -519,49 +534,90 @@ static Cell* parse_character(char* tok, const int line, const int len)
 }
 
 
-static Token *peek(const TokenArray *p)
+/* Initialize a reader over source. The source is not copied, and must outlive
+ * the reader. */
+void init_reader(Reader* r, const char* source)
 {
-    if (p->position < p->count) return &p->tokens[p->position];
-    return nullptr;
+    init_scanner(&r->scanner, source);
+    r->has_lookahead = false;
+    r->depth = 0;
 }
 
 
-static Token *advance(TokenArray *p)
+/* Return the next token without consuming it. */
+static const Token* peek(Reader* r)
 {
-    if (p->position < p->count) return &p->tokens[p->position++];
-    return nullptr;
+    if (!r->has_lookahead) {
+        r->lookahead = lex_token(&r->scanner);
+        r->has_lookahead = true;
+    }
+    return &r->lookahead;
 }
 
 
-Cell* parse_tokens(TokenArray *ta) {
-    /* First check that the expression is balanced. */
-    int left_count = 0, right_count = 0;
+/* Consume and return the next token. */
+static Token advance(Reader* r)
+{
+    const Token token = *peek(r);
+    r->has_lookahead = false;
+    return token;
+}
 
-    for (int i = 0; i < ta->count; i++) {
-        if (ta->tokens[i].type == T_LEFT_PAREN) left_count++;
-        if (ta->tokens[i].type == T_RIGHT_PAREN) right_count++;
-    }
 
-    if (left_count != right_count) {
-        return make_cell_error(
-            "Expression has unbalanced parentheses.",
-            SYNTAX_ERR);
+static Cell* unbalanced()
+{
+    return make_cell_error(
+        "Expression has unbalanced parentheses.",
+        SYNTAX_ERR);
+}
+
+
+static Cell* parse_datum(Reader* r, const Token* token);
+
+
+/* Parse the forms up to the closing token, and add them to container. The
+ * opening token has been consumed. Returns an error, or null on success. */
+static Cell* parse_forms(Reader* r, Cell* container, const TokenType close, int* n_forms)
+{
+    r->depth++;
+    for (;;) {
+        const Token token = advance(r);
+        if (token.type == close) break;
+        if (token.type == T_EOF) return unbalanced();
+
+        Cell* form = parse_datum(r, &token);
+        if (cell_type(form) == CELL_ERROR) return form;
+        cell_add(container, form);
+        if (n_forms) (*n_forms)++;
     }
+    r->depth--;
+    return nullptr;
+}
 
-    /* Check token type and dispatch accordingly. */
-    Token *token = &ta->tokens[ta->position];
-    if (!token) return nullptr;
 
+/* Parse the datum which starts with token, consuming the rest of it. */
+static Cell* parse_datum(Reader* r, const Token* token)
+{
     switch (token->type) {
-        case T_EOF: return nullptr; /* We're done. */
-            /* Dispatch out the atoms, first. */
+        /* Dispatch out the atoms, first. */
         case T_NUMBER: return parse_number(token_to_string(token), token->line, token->length);
-        case T_STRING: return parse_string(token_to_string(token), token->length);
-        case T_SYMBOL: return parse_symbol(token_to_string(token), token->line, token->length);
+        case T_STRING: {
+            Cell* str = parse_string(token->start, token->length);
+            if (!str) {
+                return make_cell_error(
+                    fmt_err("Line %d: Invalid string literal.", token->line),
+                    SYNTAX_ERR);
+            }
+            return str;
+        }
+        case T_SYMBOL: return parse_symbol(token);
         case T_BOOLEAN: return parse_boolean(token_to_string(token), token->line);
         case T_CHAR: return parse_character(token_to_string(token), token->line, token->length);
         case T_ERROR: return make_cell_error(token_to_string(token), SYNTAX_ERR);
 
+        /* A closing paren with no matching opener. */
+        case T_RIGHT_PAREN: return unbalanced();
+
         /* Handle quote and quasiquote.
          * This just transforms:
          * 'foo -> (quote foo)
@@ -569,13 +625,14 @@ Cell* parse_tokens(TokenArray *ta) {
         case T_QUOTE:
         case T_QUASIQUOTE:
         {
-            /* Grab the next token. */
-            const Token* t = advance(ta);
-            Cell *quoted = parse_tokens(ta);
-            if (!quoted) {
-                return make_cell_error(fmt_err("Line %d: Expected expression after quote: '%s%s%s'",
-                            t->line, ANSI_RED_B, token_to_string(t), ANSI_RESET), SYNTAX_ERR);
+            const Token next = advance(r);
+            if (next.type == T_EOF) {
+                return make_cell_error(fmt_err("Line %d: Expected expression after quote: '%s%.*s%s'",
+                            token->line, ANSI_RED_B, token->length, token->start, ANSI_RESET), SYNTAX_ERR);
             }
+            Cell *quoted = parse_datum(r, &next);
+            if (cell_type(quoted) == CELL_ERROR) return quoted;
+
             Cell *qexpr = make_cell_sexpr();
             /* Emit appropriate SF literal. */
             token->type == T_QUOTE ?
@@ -590,13 +647,15 @@ Cell* parse_tokens(TokenArray *ta) {
         case T_COMMA:
         case T_COMMA_AT:
         {
-            const Token* t = advance(ta);
-            Cell *expr = parse_tokens(ta);
-            if (!expr) {
-                return make_cell_error(fmt_err("Line %d: Expected expression after comma: '%s%s%s'",
-                            t->line, ANSI_RED_B, token_to_string(t), ANSI_RESET),
+            const Token next = advance(r);
+            if (next.type == T_EOF) {
+                return make_cell_error(fmt_err("Line %d: Expected expression after comma: '%s%.*s%s'",
+                            token->line, ANSI_RED_B, token->length, token->start, ANSI_RESET),
                             SYNTAX_ERR);
             }
+            Cell *expr = parse_datum(r, &next);
+            if (cell_type(expr) == CELL_ERROR) return expr;
+
             Cell *qexpr = make_cell_sexpr();
             /* Emit appropriate SF literal. */
             token->type == T_COMMA ?
@@ -608,37 +667,19 @@ Cell* parse_tokens(TokenArray *ta) {
         }
 
         case T_SET_START: {
-            /* Consume '#{' */
-            token = advance(ta);
-
             Cell *sexpr = make_cell_sexpr();
 
-            while (peek(ta)->type != T_RIGHT_BRACE) {
-                cell_add(sexpr, parse_tokens(ta));
-                advance(ta);
-            }
-
-            if (!peek(ta)) {
-                return make_cell_error(
-                    fmt_err("Line %d: Unmatched '{' in set literal: '%s%s%s'",
-                    token->line, ANSI_RED_B, token_to_string(token), ANSI_RESET),
-                    SYNTAX_ERR);
-            }
+            Cell* err = parse_forms(r, sexpr, T_RIGHT_BRACE, nullptr);
+            if (err) return err;
             return make_cell_set(sexpr);
         }
 
         case T_HASH_START: {
-            /* Consume '#[' */
-            token = advance(ta);
-
             Cell *sexpr = make_cell_sexpr();
 
             int n_forms = 0;
-            while (peek(ta)->type != T_RIGHT_BRACKET) {
-                cell_add(sexpr, parse_tokens(ta));
-                n_forms++;
-                advance(ta);
-            }
+            Cell* err = parse_forms(r, sexpr, T_RIGHT_BRACKET, &n_forms);
+            if (err) return err;
 
             /* Check for even number of forms in hash literal. */
             if (n_forms % 2 != 0) {
@@ -647,24 +688,16 @@ Cell* parse_tokens(TokenArray *ta) {
                     token->line, n_forms),
                     SYNTAX_ERR);
             }
-
-            if (!peek(ta)) {
-                return make_cell_error(
-                    fmt_err("Line %d: Unmatched '[' in hash literal: '%s%s%s'",
-                    token->line, ANSI_RED_B, token_to_string(token), ANSI_RESET),
-                    SYNTAX_ERR);
-            }
             return make_cell_hash(sexpr);
         }
 
         /* Vector or bytevector. */
         case T_HASH:
         {
-            token = advance(ta); /* Consume '#' */
-
-            if (peek(ta)->type == T_SYMBOL) {
+            if (peek(r)->type == T_SYMBOL) {
                 /* Bytevector. */
-                const char* bv_tok = token_to_string(peek(ta));
+                const Token label = advance(r);
+                const char* bv_tok = token_to_string(&label);
                 uint8_t bv_t;
                 int64_t bv_min;
                 int64_t bv_max;
@@ -700,97 +733,87 @@ Cell* parse_tokens(TokenArray *ta) {
                     bv_t = BV_S64;
                     bv_min = INT64_MIN;
                     bv_max = INT64_MAX;
+                } else if (strcmp(bv_tok, "f32") == 0 || strcmp(bv_tok, "f64") == 0) {
+                    /* Float elements have no integer range. */
+                    bv_t = bv_tok[1] == '3' ? BV_F32 : BV_F64;
+                    bv_min = 0;
+                    bv_max = 0;
                 } else {
                     return make_cell_error(
                         fmt_err("Line %d: Bad bytevector label: %s", token->line, bv_tok),
                         SYNTAX_ERR);
                 }
                 Cell* bv = make_cell_bytevector(bv_t, 8);
-                token = advance(ta); /* consume 'u8'. */
 
-                if (peek(ta)->type != T_LEFT_PAREN) {
+                if (peek(r)->type != T_LEFT_PAREN) {
                     return make_cell_error(
                         fmt_err(
                         "Line %d: Expected '(' in bytevector literal: '%s%s%s'",
-                        token->line, ANSI_RED_B, token_to_string(token), ANSI_RESET),
+                        label.line, ANSI_RED_B, bv_tok, ANSI_RESET),
                         SYNTAX_ERR);
                 }
 
-                token = advance(ta); /* Consume '('. */
-                while (peek(ta)->type != T_RIGHT_PAREN) {
-                    const Cell* val = parse_tokens(ta);
-                    if (val->type != CELL_INTEGER) {
+                const Token open = advance(r); /* Consume '('. */
+                r->depth++;
+                for (;;) {
+                    const Token t = advance(r);
+                    if (t.type == T_RIGHT_PAREN) break;
+                    if (t.type == T_EOF) return unbalanced();
+
+                    const Cell* val = parse_datum(r, &t);
+                    if (cell_type(val) == CELL_ERROR) return (Cell*)val;
+                    if (bv_t == BV_F32 || bv_t == BV_F64) {
+                        if (!(cell_type(val) & (CELL_INTEGER|CELL_RATIONAL|CELL_REAL))) {
+                            return make_cell_error(
+                                fmt_err("Line %d: bad value: '%s'. %s literals can only contain real numbers",
+                                open.line, cell_to_string(val, MODE_REPL), bv_tok),
+                                TYPE_ERR);
+                        }
+                        byte_add(bv, bv_real_bits(bv_t, (double)cell_to_long_double(val)));
+                        continue;
+                    }
+                    if (cell_type(val) != CELL_INTEGER) {
                         return make_cell_error(
                             fmt_err("Line %d: bad value: '%s'. bytevector literals can only contain bytes",
-                            token->line, cell_to_string(val, MODE_REPL)),
+                            open.line, cell_to_string(val, MODE_REPL)),
                             TYPE_ERR);
                     }
 
-                    if (val->integer_v < bv_min || val->integer_v > bv_max) {
+                    if (cell_int(val) < bv_min || cell_int(val) > bv_max) {
                         return make_cell_error(
                             fmt_err(
                                 "Line %d: invalid byte value for %s, must be (byte >= %"
                                 PRId64 ") and (byte <= %" PRId64 ")",
-                                token->line, bv_tok, bv_min, bv_max),
+                                open.line, bv_tok, bv_min, bv_max),
                             VALUE_ERR);
                     }
-                    const int64_t byte = val->integer_v;
+                    const int64_t byte = cell_int(val);
                     byte_add(bv, byte);
-                    advance(ta);
-                }
-
-                if (!peek(ta)) {
-                    return make_cell_error(
-                        fmt_err("Line %d: Unmatched '(' in bytevector literal: '%s%s%s'",
-                        token->line, ANSI_RED_B, token_to_string(token), ANSI_RESET), SYNTAX_ERR);
                 }
+                r->depth--;
                 return bv;
             }
 
             /* Vector. */
-            Cell* vec = make_cell_vector();
-
-            if (peek(ta)->type != T_LEFT_PAREN) {
+            if (peek(r)->type != T_LEFT_PAREN) {
                 return make_cell_error(
                     fmt_err("Line %d: Expected '(' in vector literal: '%s%s%s'",
                     token->line, ANSI_RED_B, token_to_string(token), ANSI_RESET), SYNTAX_ERR);
             }
+            advance(r); /* Consume '('. */
 
-            token = advance(ta); /* Consume '('. */
-            while (peek(ta)->type != T_RIGHT_PAREN) {
-                cell_add(vec, parse_tokens(ta));
-                advance(ta);
-            }
-
-            if (!peek(ta)) {
-                return make_cell_error(
-                    fmt_err("Line %d: Unmatched '(' in vector literal: '%s%s%s'",
-                    token->line, ANSI_RED_B, token_to_string(token), ANSI_RESET), SYNTAX_ERR);
-            }
+            Cell* vec = make_cell_vector();
+            Cell* err = parse_forms(r, vec, T_RIGHT_PAREN, nullptr);
+            if (err) return err;
             return vec;
         }
 
         /* S-expression. */
         case T_LEFT_PAREN:
         {
-            token = advance(ta); /* Consume '('. */
-            if (token->type == T_RIGHT_PAREN) {
-                /* Unquoted nil is an error. */
-                return make_cell_error(
-                    fmt_err("Line %d: Empty S-expression.", token->line),
-                    SYNTAX_ERR);
-            }
             Cell *sexpr = make_cell_sexpr();
-
-            while (peek(ta)->type != T_RIGHT_PAREN) {
-                cell_add(sexpr, parse_tokens(ta));
-                advance(ta);
-            }
-            if (!peek(ta)) {
-                return make_cell_error(
-                    fmt_err("Line %d: Unmatched '('.", token->line),
-                    SYNTAX_ERR);
-            }
+            Cell* err = parse_forms(r, sexpr, T_RIGHT_PAREN, nullptr);
+            if (err) return err;
             return sexpr;
         }
 
@@ -801,3 +824,123 @@ Cell* parse_tokens(TokenArray *ta) {
                 SYNTAX_ERR);
     }
 }
+
+
+/* Read the next datum from the reader's source. Returns null when the source
+ * is exhausted, or an error if the datum is malformed or incomplete. */
+Cell* read_datum(Reader* r)
+{
+    r->depth = 0;
+    const Token token = advance(r);
+    if (token.type == T_EOF) return nullptr;
+    return parse_datum(r, &token);
+}
+
+
+/* Make a stream reader, with no text yet. */
+StreamReader* make_stream_reader(void)
+{
+    StreamReader* sr = GC_MALLOC(sizeof(StreamReader));
+    sr->text = sb_new();
+    sr->start = 0;
+    sr->scanned = 0;
+    sr->depth = 0;
+    sr->after_hash = false;
+    sr->start_line = 1;
+    sr->line = 1;
+    return sr;
+}
+
+
+/* Append len bytes of text to the stream. The text already returned as data
+ * is dropped first, once it makes up at least half of the buffer, so the
+ * buffer stays in proportion to the largest datum read. */
+void stream_reader_feed(StreamReader* sr, const char* text, const size_t len)
+{
+    str_buf_t* sb = sr->text;
+    if (sr->start > 0 && sr->start >= sb->length / 2) {
+        sb->length -= sr->start;
+        memmove(sb->buffer, sb->buffer + sr->start, sb->length + 1);
+        sr->scanned -= sr->start;
+        sr->start = 0;
+    }
+    sb_append_data(sb, text, len);
+}
+
+
+/* Return the next datum in the stream, or null if the text fed so far does
+ * not hold all of it. Once at_eof is set, no more text is coming: an
+ * incomplete datum is then a syntax error, and null means the stream is
+ * exhausted. */
+Cell* stream_reader_next(StreamReader* sr, const bool at_eof)
+{
+    const char* text = sr->text->buffer;
+    const char* end = text + sr->text->length;
+
+    /* Carry on lexing from where the last call left off. */
+    Scanner s;
+    init_scanner(&s, text + sr->scanned);
+    s.line = sr->line;
+
+    for (;;) {
+        const Token token = lex_token(&s);
+        if (token.type == T_EOF) {
+            /* Only part of a datum, or nothing at all, left to read. */
+            if (!at_eof || sr->scanned == sr->start) return nullptr;
+            break;
+        }
+        /* A token which runs into the end of the text may be cut short. */
+        if (!at_eof && s.current >= end) return nullptr;
+
+        sr->scanned = s.current - text;
+        sr->line = s.line;
+
+        const bool after_hash = sr->after_hash;
+        sr->after_hash = false;
+        switch (token.type) {
+            case T_LEFT_PAREN:
+            case T_HASH_START:
+            case T_SET_START:
+                sr->depth++;
+                continue;
+            case T_RIGHT_PAREN:
+            case T_RIGHT_BRACKET:
+            case T_RIGHT_BRACE:
+                sr->depth--;
+                break;
+            /* Prefixes, which are part of the datum that follows. */
+            case T_QUOTE:
+            case T_QUASIQUOTE:
+            case T_COMMA:
+            case T_COMMA_AT:
+                continue;
+            case T_HASH:
+                sr->after_hash = true;
+                continue;
+            /* The label of a bytevector, as in '#u8('. */
+            case T_SYMBOL:
+                if (after_hash) continue;
+                break;
+            default:
+                break;
+        }
+        /* The datum is complete once its last list is closed. */
+        if (sr->depth <= 0) break;
+    }
+
+    /* Parse the datum from the text scanned for it. */
+    Reader r;
+    init_reader(&r, text + sr->start);
+    r.scanner.line = sr->start_line;
+    Cell* datum = read_datum(&r);
+
+    if (at_eof && sr->depth > 0) {
+        /* The datum was cut off, so drop the rest of the text. */
+        sr->scanned = sr->text->length;
+    }
+    sr->start = sr->scanned;
+    sr->start_line = sr->line;
+    sr->depth = 0;
+    sr->after_hash = false;
+    return datum;
+}
@@ -24,6 +24,34 @@
 #include "lexer.h"
 
 
-Cell* parse_tokens(TokenArray *ta);
+/* A streaming reader. Tokens are lexed from the source on demand, and each
+ * call to read_datum() parses just the next datum, so a source of any size is
+ * read in a single pass. */
+typedef struct {
+    Scanner scanner;
+    Token lookahead;      /* The next token, if has_lookahead is set. */
+    bool has_lookahead;
+    int depth;            /* Open lists, vectors, hashes, and sets in the datum being read. */
+} Reader;
+
+/* A reader for a stream which arrives in pieces, such as the lines of an input
+ * port. Text is appended with stream_reader_feed(), and is lexed just once, as
+ * it arrives, to find where each datum ends. Text after a datum is kept for
+ * the next one. */
+typedef struct StreamReader {
+    str_buf_t* text;      /* Text not yet returned as a datum. */
+    size_t start;         /* Offset in text of the next datum. */
+    size_t scanned;       /* Offset in text up to which it has been lexed. */
+    int depth;            /* Open lists, vectors, hashes, and sets in the scanned text. */
+    bool after_hash;      /* The last token scanned was a '#' prefix. */
+    int start_line;       /* Line numbers at start, and at scanned. */
+    int line;
+} StreamReader;
+
+void init_reader(Reader* r, const char* source);
+Cell* read_datum(Reader* r);
+StreamReader* make_stream_reader(void);
+void stream_reader_feed(StreamReader* sr, const char* text, size_t len);
+Cell* stream_reader_next(StreamReader* sr, bool at_eof);
 
 #endif //COZENAGE_PARSER_H
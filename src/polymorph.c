@@ -57,7 +57,9 @@ static Cell* bytevector_reverse(const Cell* v)
         case BV_S32: REVERSE_CASE(int32_t);  break;
         case BV_U64: REVERSE_CASE(uint64_t); break;
         case BV_S64: REVERSE_CASE(int64_t);  break;
-        default: return make_cell_error("No f32 or f64 bv yet", TYPE_ERR);
+        /* Float elements are moved as their bit patterns. */
+        case BV_F32: REVERSE_CASE(uint32_t); break;
+        case BV_F64: REVERSE_CASE(uint64_t); break;
     }
     return result;
 }
@@ -157,14 +159,14 @@ static Cell* string_reverse(const Cell* v)
 static Cell* list_idx(const Lex* e, const Cell* a)
 {
     const Cell* v = builtin_list_to_vector(e, make_sexpr_len1(a->cell[0]));
-    const int64_t start = a->cell[1]->integer_v;
+    const int64_t start = cell_int(a->cell[1]);
     int64_t stop = v->count;
     int64_t step = 1;
     if (a->count > 2) {
-        stop = a->cell[2]->integer_v;
+        stop = cell_int(a->cell[2]);
     }
     if (a->count > 3) {
-        step = a->cell[3]->integer_v;
+        step = cell_int(a->cell[3]);
     }
 
     Cell* result = make_cell_vector();
@@ -179,15 +181,15 @@ static Cell* bytevector_idx(const Cell* a)
 {
     const Cell* v = a->cell[0];
     const bv_t type = v->bv->type;
-    const int64_t start = a->cell[1]->integer_v;
+    const int64_t start = cell_int(a->cell[1]);
     int64_t stop = v->count;
     int64_t step = 1;
 
     if (a->count > 2) {
-        stop = a->cell[2]->integer_v;
+        stop = cell_int(a->cell[2]);
     }
     if (a->count > 3) {
-        step = a->cell[3]->integer_v;
+        step = cell_int(a->cell[3]);
     }
 
     if (start < 0 || stop > v->count || start > stop || step <= 0) {
@@ -210,14 +212,14 @@ static Cell* bytevector_idx(const Cell* a)
 static Cell* vector_idx(const Cell* a)
 {
     const Cell* v = a->cell[0];
-    const int64_t start = a->cell[1]->integer_v;
+    const int64_t start = cell_int(a->cell[1]);
     int64_t stop = v->count;
     int64_t step = 1;
     if (a->count > 2) {
-        stop = a->cell[2]->integer_v;
+        stop = cell_int(a->cell[2]);
     }
     if (a->count > 3) {
-        step = a->cell[3]->integer_v;
+        step = cell_int(a->cell[3]);
     }
 
     Cell* result = make_cell_vector();
@@ -234,12 +236,12 @@ Cell* builtin_len(const Lex* e, const Cell* a)
     Cell* err = CHECK_ARITY_EXACT(a, 1, "len");
     if (err) return err;
 
-    switch (a->cell[0]->type) {
+    switch (cell_type(a->cell[0])) {
     case CELL_PAIR:
         if (a->cell[0]->len >= 0) return make_cell_integer(a->cell[0]->len);
         /* Still run the check, as the length might not be cached. */
         Cell* result = builtin_list_length(e, a);
-        if (result->type == CELL_ERROR) {
+        if (cell_type(result) == CELL_ERROR) {
             return make_cell_error(
                 "len: no length for improper or circular list",
                 VALUE_ERR);
@@ -256,7 +258,7 @@ Cell* builtin_len(const Lex* e, const Cell* a)
     default:
         return make_cell_error(
             fmt_err("len: no length for non-compound type: %s",
-                cell_type_name(a->cell[0]->type)), TYPE_ERR);
+                cell_type_name(cell_type(a->cell[0]))), TYPE_ERR);
     }
 }
 
@@ -271,7 +273,7 @@ Cell* builtin_idx(const Lex* e, const Cell* a)
     Cell* err = CHECK_ARITY_RANGE(a, 2, 4, "idx");
     if (err) return err;
 
-    switch (a->cell[0]->type) {
+    switch (cell_type(a->cell[0])) {
     case CELL_PAIR:
         if (a->count == 2) {
             return builtin_list_ref(e, a);
@@ -292,7 +294,7 @@ Cell* builtin_idx(const Lex* e, const Cell* a)
     default:
         return make_cell_error(
         fmt_err("idx: cannot subscript non-ordered type: %s",
-            cell_type_name(a->cell[0]->type)), TYPE_ERR);
+            cell_type_name(cell_type(a->cell[0]))), TYPE_ERR);
     }
 }
 
@@ -302,7 +304,7 @@ Cell* builtin_rev(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "rev");
     if (err) return err;
-    switch (a->cell[0]->type) {
+    switch (cell_type(a->cell[0])) {
     case CELL_PAIR:
         return builtin_list_reverse(e, a);
     case CELL_VECTOR:
@@ -314,7 +316,7 @@ Cell* builtin_rev(const Lex* e, const Cell* a)
     default:
         return make_cell_error(
             fmt_err("rev: cannot reverse non-ordered type: %s",
-                cell_type_name(a->cell[0]->type)),
+                cell_type_name(cell_type(a->cell[0]))),
                 TYPE_ERR);
     }
 }
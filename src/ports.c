@@ -23,45 +23,104 @@
 #include "strings.h"
 #include "repr.h"
 #include "vectors.h"
+#include "bytevectors.h"
 #include "buffer.h"
 #include "lexer.h"
 #include "parser.h"
+#include "file_map.h"
 
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
 #include <gc/gc.h>
 #include <sys/select.h>
+#include <sys/stat.h>
 
 
-/* The actual character reader. */
-static ssize_t port_read_char(const Cell* p, UChar32* out_char, int* err) {
-    uint8_t buf[4];
+#if defined(__GLIBC__)
+/* glibc internal check */
+#define HAS_BUFFERED_DATA(fp) ((fp)->_IO_read_ptr < (fp)->_IO_read_end)
+#define STDIO_BUFFERED(fp) ((size_t)((fp)->_IO_read_end - (fp)->_IO_read_ptr))
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+/* BSD/Darwin internal check */
+#define HAS_BUFFERED_DATA(fp) ((fp)->_r > 0)
+#define STDIO_BUFFERED(fp) ((fp)->_r > 0 ? (size_t)(fp)->_r : 0)
+#else
+/* Fallback: We don't know how to check the buffer for this LibC.
+ * If we can't see the buffer, at least EOF counts as 'ready'. */
+#define HAS_BUFFERED_DATA(fp) (feof(fp))
+#define STDIO_BUFFERED(fp) ((size_t)0)
+#endif
 
-    /* Read the first byte. */
-    const ssize_t status = p->port->vtable->read(buf, 1, p, err);
-    if (status <= 0) return status; /* R_EOF or R_ERR. */
 
-    const int len = utf8_len(buf[0]);
-    if (len == 1) {
-        *out_char = (UChar32)buf[0];
-        return R_OK;
-    }
+/* Bytes read ahead from a stdio file port, so that its characters can be
+ * decoded a run at a time, rather than with a read call for every byte.
+ * Ports held in memory need no such buffer; they are decoded in place,
+ * through their view. The file handlers below take bytes from the buffer
+ * before going to the stream, and allow for it in tell and seek, so reads
+ * of characters, lines and bytes can be mixed freely. */
+#define PORT_BUFFER_SIZE 4096
 
-    /* Read the remaining bytes (len - 1). */
-    if (p->port->vtable->read(buf + 1, len - 1, p, err) != (len - 1)) {
-        return R_ERR; /* Truncated multi-byte character. */
-    }
+typedef struct PortBuffer {
+    size_t pos;   /* Next unread byte. */
+    size_t len;   /* Bytes held. */
+    uint8_t data[PORT_BUFFER_SIZE];
+} PortBuffer;
 
-    /* Reconstruct UChar32 */
-    if (len == 2) {
-        *out_char = ((buf[0] & 0x1F) << 6) | (buf[1] & 0x3F);
-    } else if (len == 3) {
-        *out_char = ((buf[0] & 0x0F) << 12) | ((buf[1] & 0x3F) << 6) | (buf[2] & 0x3F);
-    } else if (len == 4) {
-        *out_char = ((buf[0] & 0x07) << 18) | ((buf[1] & 0x3F) << 12) | ((buf[2] & 0x3F) << 6) | (buf[3] & 0x3F);
+
+/* Bytes read ahead, and not yet consumed. */
+static size_t buffered(const Cell* p)
+{
+    const PortBuffer* b = p->port->buffer;
+    return b ? b->len - b->pos : 0;
+}
+
+
+/* Take up to len read-ahead bytes into dest. */
+static size_t take_buffered(void* dest, const size_t len, const Cell* p)
+{
+    PortBuffer* b = p->port->buffer;
+    size_t n = buffered(p);
+    if (n == 0) return 0;
+    if (n > len) n = len;
+    memcpy(dest, b->data + b->pos, n);
+    b->pos += n;
+    return n;
+}
+
+
+/* Read ahead from a stdio port until at least need bytes are held, or the
+ * stream ends, then take whatever else stdio has buffered. Reading never
+ * blocks once need bytes are held, so interactive input is not waited on
+ * past what has been typed. */
+static void buffer_fill(const Cell* p, const size_t need)
+{
+    PortBuffer* b = p->port->buffer;
+    if (!b) {
+        b = GC_MALLOC_ATOMIC(sizeof(PortBuffer));
+        b->pos = b->len = 0;
+        p->port->buffer = b;
+    }
+    if (b->pos > 0) {
+        memmove(b->data, b->data + b->pos, b->len - b->pos);
+        b->len -= b->pos;
+        b->pos = 0;
+    }
+
+    FILE* fh = p->port->fh;
+    while (b->len < PORT_BUFFER_SIZE) {
+        size_t ready = STDIO_BUFFERED(fh);
+        if (ready > 0) {
+            if (ready > PORT_BUFFER_SIZE - b->len) ready = PORT_BUFFER_SIZE - b->len;
+            b->len += fread(b->data + b->len, 1, ready, fh);
+            continue;
+        }
+        if (b->len >= need) break;
+        /* This may block, and refills the stdio buffer. */
+        const int c = getc_unlocked(fh);
+        if (c == EOF) break;
+        b->data[b->len++] = (uint8_t)c;
     }
-    return R_OK;
 }
 
 
@@ -80,7 +139,11 @@ static ssize_t file_write(const void* buf, const size_t len, const Cell* p, int*
 
 
 static ssize_t file_read(void* buf, const size_t len, const Cell* p, int* err) {
-    const size_t ret = fread(buf, 1, len, p->port->fh);
+    /* Bytes read ahead come first. */
+    const size_t held = take_buffered(buf, len, p);
+    if (held == len) return (ssize_t)len;
+
+    const size_t ret = held + fread((char*)buf + held, 1, len - held, p->port->fh);
 
     /* There were bytes to read, but not as many as asked for. */
     if (ret > 0) {
@@ -109,28 +172,81 @@ static long file_tell(const Cell* p, int* err) {
         *err = errno;
         return R_ERR;
     }
-    return ret;
+    /* The stream is ahead of the port by what is read ahead. */
+    return ret - (long)buffered(p);
 }
 
 
 static int file_seek(const Cell* p, const long offset, int* err) {
+    if (p->port->buffer) {
+        p->port->buffer->pos = p->port->buffer->len = 0;
+    }
     if (fseek(p->port->fh, offset, SEEK_SET) == 0) return R_OK;
     *err = errno;
     return R_ERR;
 }
 
 
+/* Make room for len bytes, and a '\0', in a getdelim style buffer. */
+static bool reserve_line(char **lineptr, size_t *n, const size_t len, int* err) {
+    if (*lineptr == NULL || *n < len + 1) {
+        char *tmp = realloc(*lineptr, len + 1);
+        if (!tmp) {
+            *err = errno;
+            return false;
+        }
+        *lineptr = tmp;
+        *n = len + 1;
+    }
+    return true;
+}
+
+
 static ssize_t file_getdelim(char **lineptr, size_t *n, const int delim, const Cell *port, int* err) {
-    const ssize_t ret = getdelim(lineptr, n, delim, port->port->fh);
+    size_t held = buffered(port);
+    if (held == 0) {
+        const ssize_t ret = getdelim(lineptr, n, delim, port->port->fh);
+        if (ret < 0) {
+            if (feof(port->port->fh)) {
+                return R_EOF;
+            }
+            /* An actual error. */
+            *err = errno;
+            return R_ERR;
+        }
+        return ret;
+    }
+
+    /* Start with the bytes read ahead, which may hold the whole line. */
+    const PortBuffer* b = port->port->buffer;
+    const uint8_t* start = b->data + b->pos;
+    const uint8_t* found = memchr(start, delim, held);
+    if (found) held = (size_t)(found - start) + 1;
+    if (!reserve_line(lineptr, n, held, err)) return R_ERR;
+    take_buffered(*lineptr, held, port);
+    (*lineptr)[held] = '\0';
+    if (found) return (ssize_t)held;
+
+    /* Then the rest of the line from the stream. */
+    char* rest = nullptr;
+    size_t rest_n = 0;
+    const ssize_t ret = getdelim(&rest, &rest_n, delim, port->port->fh);
     if (ret < 0) {
+        free(rest);
         if (feof(port->port->fh)) {
-            return R_EOF;
+            return (ssize_t)held;
         }
         /* An actual error. */
         *err = errno;
         return R_ERR;
     }
-    return ret;
+    if (!reserve_line(lineptr, n, held + ret, err)) {
+        free(rest);
+        return R_ERR;
+    }
+    memcpy(*lineptr + held, rest, ret + 1);
+    free(rest);
+    return (ssize_t)held + ret;
 }
 
 
@@ -151,12 +267,14 @@ static ssize_t memory_write(const void* buf, const size_t len, const Cell* p, in
 }
 
 
-static ssize_t memory_read(void* buf, const size_t len, const Cell* p, int* err) {
-    *err = 0;
+/* Reads from a store of bytes held in memory, shared by memory-backed
+ * ports and mapped file ports. index is the read pointer into the store. */
+static ssize_t span_read(void* buf, const size_t len, const char* store, const size_t length, size_t* index)
+{
     /* Use void* buf as char* buf. */
     char* dest = buf;
     /* Check for EOF-type situation. */
-    size_t bytes_in_store = p->port->data->length - p->port->index;
+    const size_t bytes_in_store = *index < length ? length - *index : 0;
 
     if (bytes_in_store < len) {
         /* If no bytes to read, return EOF now. */
@@ -164,15 +282,42 @@ static ssize_t memory_read(void* buf, const size_t len, const Cell* p, int* err)
             return R_EOF;
         }
         /* Otherwise, return what is left, and update index to the end of the buffer. */
-        memcpy(dest, p->port->data->buffer + p->port->index, bytes_in_store);
-        p->port->index = p->port->data->length;
-        return (int)bytes_in_store;
+        memcpy(dest, store + *index, bytes_in_store);
+        *index = length;
+        return (ssize_t)bytes_in_store;
     }
 
     /* There is enough data in the buffer to pull the full read. */
-    memcpy(dest, p->port->data->buffer + p->port->index, len);
-    p->port->index += len;
-    return (int)len;
+    memcpy(dest, store + *index, len);
+    *index += len;
+    return (ssize_t)len;
+}
+
+
+static ssize_t span_getdelim(char **lineptr, size_t *n, const int delim,
+                             const char* store, const size_t length, size_t* index, int* err)
+{
+    if (*index >= length)
+        return R_EOF;
+
+    const size_t start = *index;
+    const char* found = memchr(store + start, delim, length - start);
+    const size_t end = found ? (size_t)(found - store) + 1 : length; /* Include delimiter. */
+    const size_t len = end - start;
+
+    if (!reserve_line(lineptr, n, len, err)) return R_ERR;
+
+    memcpy(*lineptr, store + start, len);
+    (*lineptr)[len] = '\0';
+
+    *index = end;
+    return (ssize_t)len;
+}
+
+
+static ssize_t memory_read(void* buf, const size_t len, const Cell* p, int* err) {
+    *err = 0;
+    return span_read(buf, len, p->port->data->buffer, p->port->data->length, &p->port->index);
 }
 
 
@@ -190,38 +335,55 @@ static int memory_seek(const Cell* p, const long offset, int* err) {
 
 
 static ssize_t memory_getdelim(char **lineptr, size_t *n, const int delim, const Cell* p, int *err) {
-    if (p->port->index >= p->port->data->length)
-        return R_EOF;
+    return span_getdelim(lineptr, n, delim, p->port->data->buffer, p->port->data->length, &p->port->index, err);
+}
 
-    const size_t start = p->port->index;
-    size_t i = start;
 
-    while (i < p->port->data->length && p->port->data->buffer[i] != (char)delim)
-        i++;
+static const char* memory_view(const Cell* p, size_t* avail) {
+    const size_t length = p->port->data->length;
+    *avail = p->port->index < length ? length - p->port->index : 0;
+    return p->port->data->buffer + p->port->index;
+}
 
-    size_t len = i - start;
-    if (i < p->port->data->length) len++; /* Include delimiter. */
 
-    if (*lineptr == NULL || *n < len + 1) {
-        char *tmp = realloc(*lineptr, len + 1);
-        if (!tmp) {
-            *err = errno;
-            return R_ERR;
-        }
-        *lineptr = tmp;
-        *n = len + 1;
-    }
+static void memory_close(Cell* p) {
+    if (p->is_open) p->is_open = 0;
+}
 
-    memcpy(*lineptr, p->port->data->buffer + start, len);
-    (*lineptr)[len] = '\0';
 
-    p->port->index += len;
-    return (ssize_t)len;
+/* Mapped file ports are read only, and read in place from the
+ * contents of the file. */
+
+static ssize_t mapped_write(const void* buf, const size_t len, const Cell* p, int* err) {
+    (void)buf; (void)len; (void)p;
+    *err = EBADF;
+    return R_ERR;
 }
 
 
-static void memory_close(Cell* p) {
-    if (p->is_open) p->is_open = 0;
+static ssize_t mapped_read(void* buf, const size_t len, const Cell* p, int* err) {
+    *err = 0;
+    return span_read(buf, len, p->port->map->data, p->port->map->length, &p->port->index);
+}
+
+
+static ssize_t mapped_getdelim(char **lineptr, size_t *n, const int delim, const Cell* p, int *err) {
+    return span_getdelim(lineptr, n, delim, p->port->map->data, p->port->map->length, &p->port->index, err);
+}
+
+
+static const char* mapped_view(const Cell* p, size_t* avail) {
+    const size_t length = p->port->map->length;
+    *avail = p->port->index < length ? length - p->port->index : 0;
+    return p->port->map->data + p->port->index;
+}
+
+
+static void mapped_close(Cell* p) {
+    if (p->is_open) {
+        file_map_close(p->port->map);
+        p->is_open = 0;
+    }
 }
 
 
@@ -235,7 +397,8 @@ const PortInterface FileVTable = {
     .tell     = file_tell,
     .seek     = file_seek,
     .getdelim = file_getdelim,
-    .close    = file_close
+    .close    = file_close,
+    .view     = nullptr
 };
 
 /* A port with in-memory backing store. */
@@ -245,9 +408,140 @@ const PortInterface MemoryVTable = {
     .tell     = memory_tell,
     .seek     = memory_seek,
     .getdelim = memory_getdelim,
-    .close    = memory_close
+    .close    = memory_close,
+    .view     = memory_view
+};
+
+/* A read-only port with a mapped file as backing store. */
+const PortInterface MappedFileVTable = {
+    .write    = mapped_write,
+    .read     = mapped_read,
+    .tell     = memory_tell,
+    .seek     = memory_seek,
+    .getdelim = mapped_getdelim,
+    .close    = mapped_close,
+    .view     = mapped_view
 };
 
+/* Point at the next unread bytes of a textual input port, topping them up
+ * to at least need of them if the port has that many left, and set *avail
+ * to how many there are. Returns null, with *err set, on a read error. */
+static const uint8_t* port_bytes(const Cell* p, const size_t need, size_t* avail, int* err)
+{
+    if (p->port->vtable->view) {
+        return (const uint8_t*)p->port->vtable->view(p, avail);
+    }
+    if (buffered(p) < need) {
+        buffer_fill(p, need);
+        if (buffered(p) == 0 && ferror(p->port->fh)) {
+            *err = errno;
+            return nullptr;
+        }
+    }
+    const PortBuffer* b = p->port->buffer;
+    *avail = b->len - b->pos;
+    return b->data + b->pos;
+}
+
+
+/* Step a port past n of the bytes from port_bytes(). */
+static void port_consume(const Cell* p, const size_t n)
+{
+    if (p->port->vtable->view) {
+        p->port->index += n;
+    } else {
+        p->port->buffer->pos += n;
+    }
+}
+
+
+/* Decode the UTF-8 character at s, given avail bytes. Returns its length,
+ * or -1 if it is malformed or cut short. */
+static int decode_utf8(const uint8_t* s, const size_t avail, UChar32* out_char)
+{
+    const int len = utf8_len(s[0]);
+    if (len < 0 || (size_t)len > avail) return -1;
+    for (int i = 1; i < len; i++) {
+        if ((s[i] & 0xC0) != 0x80) return -1;
+    }
+
+    if (len == 1) {
+        *out_char = s[0];
+    } else if (len == 2) {
+        *out_char = ((s[0] & 0x1F) << 6) | (s[1] & 0x3F);
+    } else if (len == 3) {
+        *out_char = ((s[0] & 0x0F) << 12) | ((s[1] & 0x3F) << 6) | (s[2] & 0x3F);
+    } else {
+        *out_char = ((s[0] & 0x07) << 18) | ((s[1] & 0x3F) << 12) | ((s[2] & 0x3F) << 6) | (s[3] & 0x3F);
+    }
+    return len;
+}
+
+
+/* The actual character reader. The character is left unread if consume
+ * is false, as peek-char needs. */
+static ssize_t port_read_char(const Cell* p, UChar32* out_char, int* err, const bool consume)
+{
+    size_t avail;
+    const uint8_t* s = port_bytes(p, 1, &avail, err);
+    if (!s) return R_ERR;
+    if (avail == 0) return R_EOF;
+
+    /* ASCII needs no decoding. */
+    if (s[0] < 0x80) {
+        *out_char = s[0];
+        if (consume) port_consume(p, 1);
+        return R_OK;
+    }
+
+    /* Make sure the whole of a multi-byte character is at hand. */
+    if (avail < UTF8_MAX_LEN) {
+        s = port_bytes(p, UTF8_MAX_LEN, &avail, err);
+        if (!s) return R_ERR;
+    }
+    const int len = decode_utf8(s, avail, out_char);
+    if (len < 0) {
+        *err = EILSEQ;
+        return R_ERR; /* Malformed or truncated multi-byte character. */
+    }
+    if (consume) port_consume(p, len);
+    return R_OK;
+}
+
+
+/* How many of the avail bytes at s make up the next count characters, or
+ * as many of them as are whole. Runs of ASCII are skipped eight at a time.
+ * *count is decreased by the number of characters found. */
+static size_t utf8_span(const uint8_t* s, const size_t avail, int* count)
+{
+    size_t i = 0;
+    int left = *count;
+    while (left > 0 && i < avail) {
+        if (left >= 8 && avail - i >= 8) {
+            uint64_t word;
+            memcpy(&word, s + i, sizeof word);
+            if ((word & 0x8080808080808080ULL) == 0) {
+                i += 8;
+                left -= 8;
+                continue;
+            }
+        }
+        if (s[i] < 0x80) {
+            i++;
+        } else {
+            const int len = utf8_len(s[i]);
+            /* A stray continuation byte is passed through on its own. */
+            const size_t step = len > 0 ? (size_t)len : 1;
+            if (step > avail - i) break;
+            i += step;
+        }
+        left--;
+    }
+    *count = left;
+    return i;
+}
+
+
 /*-------------------------------------------------------*
  *       Input/output and port builtin procedures        *
  * ------------------------------------------------------*/
@@ -287,7 +581,7 @@ Cell* builtin_input_port_pred(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "input-port?");
     if (err) return err;
-    if (a->cell[0]->type != CELL_PORT || a->cell[0]->port->stream_t != INPUT_STREAM) {
+    if (cell_type(a->cell[0]) != CELL_PORT || a->cell[0]->port->stream_t != INPUT_STREAM) {
         return False_Obj;
     }
     return True_Obj;
@@ -301,7 +595,7 @@ Cell* builtin_output_port_pred(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "output-port?");
     if (err) return err;
-    if (a->cell[0]->type != CELL_PORT || a->cell[0]->port->stream_t != OUTPUT_STREAM) {
+    if (cell_type(a->cell[0]) != CELL_PORT || a->cell[0]->port->stream_t != OUTPUT_STREAM) {
         return False_Obj;
     }
     return True_Obj;
@@ -315,7 +609,7 @@ Cell* builtin_text_port_pred(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "text-port?");
     if (err) return err;
-    if (a->cell[0]->type != CELL_PORT || a->cell[0]->port->backend_t == BK_BYTEVECTOR ||
+    if (cell_type(a->cell[0]) != CELL_PORT || a->cell[0]->port->backend_t == BK_BYTEVECTOR ||
         a->cell[0]->port->backend_t == BK_FILE_BINARY) {
         return False_Obj;
     }
@@ -330,7 +624,7 @@ Cell* builtin_binary_port_pred(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "binary-port?");
     if (err) return err;
-    if (a->cell[0]->type != CELL_PORT || a->cell[0]->port->backend_t == BK_STRING ||
+    if (cell_type(a->cell[0]) != CELL_PORT || a->cell[0]->port->backend_t == BK_STRING ||
         a->cell[0]->port->backend_t == BK_FILE_TEXT) {
         return False_Obj;
     }
@@ -345,7 +639,7 @@ Cell* builtin_input_port_open(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "input-port-open?");
     if (err) return err;
-    if (a->cell[0]->type == CELL_PORT &&
+    if (cell_type(a->cell[0]) == CELL_PORT &&
         a->cell[0]->port->stream_t == INPUT_STREAM &&
         a->cell[0]->is_open == true) {
         return True_Obj;
@@ -361,7 +655,7 @@ Cell* builtin_output_port_open(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "output-port-open?");
     if (err) return err;
-    if (a->cell[0]->type == CELL_PORT &&
+    if (cell_type(a->cell[0]) == CELL_PORT &&
         a->cell[0]->port->stream_t == OUTPUT_STREAM &&
         a->cell[0]->is_open == true) {
         return True_Obj;
@@ -379,7 +673,7 @@ Cell* builtin_close_port(const Lex* e, const Cell* a)
     Cell* err = CHECK_ARITY_EXACT(a, 1, "close-port");
     if (err) return err;
     Cell* p = a->cell[0];
-    if (p->type != CELL_PORT) {
+    if (cell_type(p) != CELL_PORT) {
         return make_cell_error(
             "close-port: arg1 is not a port",
             TYPE_ERR);
@@ -395,6 +689,23 @@ Cell* builtin_close_port(const Lex* e, const Cell* a)
  * For now, both procedures are aliases to close-port. */
 
 
+/* Point *line at the next line of a port which has a view, '\n' included,
+ * and step the port past it. Returns its length, or R_EOF. Unlike getdelim,
+ * nothing is copied. */
+static ssize_t view_getline(const Cell* port, const char** line)
+{
+    size_t avail;
+    const char* start = port->port->vtable->view(port, &avail);
+    if (avail == 0) return R_EOF;
+
+    const char* nl = memchr(start, '\n', avail);
+    const size_t len = nl ? (size_t)(nl - start) + 1 : avail;
+    port->port->index += len;
+    *line = start;
+    return (ssize_t)len;
+}
+
+
 /* (read-line)
  * (read-line port)
  * Returns the next line of text available from the textual input port, updating the port to point to the following
@@ -422,6 +733,15 @@ Cell* builtin_read_line(const Lex* e, const Cell* a)
             "read-line: port is not open for input",
             FILE_ERR);
 
+    /* Slice the line straight out of ports held in memory. */
+    if (port->port->vtable->view) {
+        const char* view_line;
+        ssize_t len = view_getline(port, &view_line);
+        if (len == R_EOF) return EOF_Obj;
+        if (view_line[len - 1] == '\n') len--;
+        return make_cell_string_n(view_line, len);
+    }
+
     char *line = nullptr;
     size_t n = 0;
     int err_r = 0;
@@ -475,6 +795,16 @@ Cell* builtin_read_lines(const Lex* e, const Cell* a)
     int err_r = 0;
 
     Cell* result = make_cell_vector();
+    if (port->port->vtable->view) {
+        const char* view_line;
+        ssize_t len;
+        while ((len = view_getline(port, &view_line)) != R_EOF) {
+            if (view_line[len - 1] == '\n') len--;
+            cell_add(result, make_cell_string_n(view_line, len));
+        }
+        return builtin_vector_to_list(e, make_sexpr_len1(result));
+    }
+
     for (;;) {
         const ssize_t len = port->port->vtable->getdelim(
             &line, &n, '\n', port, &err_r);
@@ -515,41 +845,54 @@ Cell* builtin_read(const Lex* e, const Cell* a) {
             "read: port is not open for input",
             FILE_ERR);
 
-    /* Initialize buffer. */
-    str_buf_t* buf = sb_new();
-
-    /* Read lines until we get a complete datum. */
-    for (;;) {
-        size_t n = 0;
+    /* Feed the reader a line at a time, straight from the port's bytes,
+     * and no more than a buffer's worth of a long line. */
+    StreamReader* sr = make_stream_reader();
+    size_t chunk = 0;
+    bool at_eof = false;
+    Cell* result;
+    while (!(result = stream_reader_next(sr, false))) {
         int err_r = 0;
-        char* t_buf = nullptr;
-        const ssize_t len = port->port->vtable->getdelim(
-            &t_buf, &n, '\n', port, &err_r);
-        sb_append_str(buf, t_buf);
-
-        if (len == R_EOF)
-            return EOF_Obj;
-
-        if (len == R_ERR) {
+        size_t avail;
+        const uint8_t* bytes = port_bytes(port, 1, &avail, &err_r);
+        if (!bytes) {
             return make_cell_error(
-                fmt_err("read: %s", err_r),
+                fmt_err("read: %s", strerror(err_r)),
                 FILE_ERR);
         }
-
-        TokenArray* ta = scan_all_tokens(buf->buffer);
-        Cell* result = parse_tokens(ta);
-
-        if (!result) continue; /* Not enough data for a datum. */
-        if (result->type == CELL_ERROR) {
-            /* Syntax error: bad parser input. */
-            if (result->err_t == SYNTAX_ERR) continue;
-            /* Otherwise, legitimate error. */
-            return result;
+        if (avail == 0) {
+            at_eof = true;
+            result = stream_reader_next(sr, true);
+            break;
+        }
+        if (avail > PORT_BUFFER_SIZE) avail = PORT_BUFFER_SIZE;
+        const uint8_t* nl = memchr(bytes, '\n', avail);
+        chunk = nl ? (size_t)(nl - bytes) + 1 : avail;
+        stream_reader_feed(sr, (const char*)bytes, chunk);
+        port_consume(port, chunk);
+    }
+
+    /* Give back the text after the datum, so the other input procedures,
+     * and the next read, start from there. It all came from the last
+     * chunk fed, which the port still holds: the reader only ends a datum
+     * before the end of the stream once it has seen past its last token. */
+    const size_t unread = sr->text->length - sr->start;
+    if (!at_eof && unread > 0 && unread <= chunk) {
+        if (port->port->vtable->view) {
+            port->port->index -= unread;
+        } else {
+            port->port->buffer->pos -= unread;
         }
+    }
 
-        /* We have a complete datum. */
+    if (!result) return EOF_Obj;
+    /* A malformed datum satisfies read-error?. */
+    if (cell_type(result) == CELL_ERROR) {
+        if (result->err_t == SYNTAX_ERR) result->err_t = READ_ERR;
         return result;
     }
+    /* Return the datum as data, as quote would. */
+    return make_list_from_sexpr(result);
 }
 
 
@@ -563,12 +906,12 @@ Cell* builtin_read_string(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_RANGE(a, 1, 2, "read-string");
     if (err) return err;
-    if (a->cell[0]->type != CELL_INTEGER) {
+    if (cell_type(a->cell[0]) != CELL_INTEGER) {
         return make_cell_error(
             "read-string: arg 1 must be exact positive integer",
             TYPE_ERR);
     }
-    const int chars_to_read = (int)a->cell[0]->integer_v;
+    const int chars_to_read = (int)cell_int(a->cell[0]);
     if (chars_to_read <= 0) {
         return make_cell_error(
            "read-string: arg 1 must be exact positive integer",
@@ -578,7 +921,7 @@ Cell* builtin_read_string(const Lex* e, const Cell* a)
     if (a->count == 1) {
         port = builtin_current_input_port(e, a);
     } else {
-        if (a->cell[1]->type != CELL_PORT) {
+        if (cell_type(a->cell[1]) != CELL_PORT) {
             return make_cell_error(
                 "read-string: arg 2 must be a port",
                 TYPE_ERR);
@@ -586,21 +929,48 @@ Cell* builtin_read_string(const Lex* e, const Cell* a)
         port = a->cell[1];
     }
 
-    /* Buffer size = the chars to read by potential 4 bytes each, plus 1 for \0. */
-    char* buffer = GC_MALLOC_ATOMIC(chars_to_read * 4 + 1);
-    int err_r;
-    const ssize_t chars_read = port->port->vtable->read(buffer, chars_to_read, port, &err_r);
+    if (!port->is_open || port->port->stream_t != INPUT_STREAM)
+        return make_cell_error(
+            "read-string: port is not open for input",
+            FILE_ERR);
 
-    if (chars_read == R_EOF) {
-        return EOF_Obj;
-    }
-    if (chars_read == R_ERR) {
+    if (port->port->backend_t == BK_FILE_BINARY || port->port->backend_t == BK_BYTEVECTOR) {
         return make_cell_error(
-            fmt_err("read-string: %s", strerror(err_r)),
-            OS_ERR);
+            "read-string: port must be a text or string port",
+            VALUE_ERR);
+    }
+
+    /* Take the characters a run of bytes at a time. Ports held in memory
+     * have them all in one run, which is sliced straight into the string. */
+    int chars_left = chars_to_read;
+    str_buf_t* sb = nullptr;
+    for (;;) {
+        int err_r = 0;
+        size_t avail;
+        const uint8_t* bytes = port_bytes(port, UTF8_MAX_LEN, &avail, &err_r);
+        if (!bytes) {
+            return make_cell_error(
+                fmt_err("read-string: %s", strerror(err_r)),
+                OS_ERR);
+        }
+        if (avail == 0) break;
+
+        size_t len = utf8_span(bytes, avail, &chars_left);
+        /* A character cut short by the end of the port. */
+        if (len == 0) len = avail;
+        if (!sb && chars_left == 0) {
+            Cell* result = make_cell_string_n((const char*)bytes, len);
+            port_consume(port, len);
+            return result;
+        }
+        if (!sb) sb = sb_new();
+        sb_append_data(sb, bytes, len);
+        port_consume(port, len);
+        if (chars_left == 0) break;
     }
 
-    return make_cell_string(buffer);
+    if (!sb) return EOF_Obj;
+    return make_cell_string_n(sb->buffer, sb->length);
 }
 
 
@@ -634,7 +1004,7 @@ Cell* builtin_read_char(const Lex* e, const Cell* a)
 
     int err_r;
     UChar32 out;
-    const ssize_t wc = port_read_char(port, &out, &err_r);
+    const ssize_t wc = port_read_char(port, &out, &err_r, true);
     if (wc == R_EOF) {
         return EOF_Obj;
     }
@@ -695,12 +1065,12 @@ Cell* builtin_read_bytevector(const Lex* e, const Cell* a)
     Cell* err = CHECK_ARITY_RANGE(a, 1, 2, "read-bytevector");
     if (err) return err;
 
-    if (a->cell[0]->type != CELL_INTEGER) {
+    if (cell_type(a->cell[0]) != CELL_INTEGER) {
         return make_cell_error(
             "read-bytevector: arg 1 must be exact positive integer",
             TYPE_ERR);
     }
-    const int bytes_to_read = (int)a->cell[0]->integer_v;
+    const int bytes_to_read = (int)cell_int(a->cell[0]);
     if (bytes_to_read <= 0) {
         return make_cell_error(
            "read-bytevector: arg 1 must be exact positive integer",
@@ -710,7 +1080,7 @@ Cell* builtin_read_bytevector(const Lex* e, const Cell* a)
     if (a->count == 1) {
         port = builtin_current_input_port(e, a);
     } else {
-        if (a->cell[1]->type != CELL_PORT) {
+        if (cell_type(a->cell[1]) != CELL_PORT) {
             return make_cell_error(
                 "read-bytevector: arg 2 must be a port",
                 TYPE_ERR);
@@ -723,12 +1093,11 @@ Cell* builtin_read_bytevector(const Lex* e, const Cell* a)
                 FILE_ERR);
     }
 
-    // ReSharper disable once CppVariableCanBeMadeConstexpr
     Cell* bv = make_cell_bytevector(BV_U8, bytes_to_read);
 
-    uint8_t* buffer = GC_MALLOC_ATOMIC(bytes_to_read * sizeof(uint8_t));
+    /* Read straight into the bytevector's storage. */
     int err_r;
-    const ssize_t bytes_read = port->port->vtable->read(buffer, bytes_to_read, port, &err_r);
+    const ssize_t bytes_read = port->port->vtable->read(bv->bv->data, bytes_to_read, port, &err_r);
 
     if (bytes_read == R_EOF) {
         return EOF_Obj;
@@ -741,7 +1110,6 @@ Cell* builtin_read_bytevector(const Lex* e, const Cell* a)
     }
 
     /* May have been EOF, so bytes_read may be < bytes_to_read. */
-    memcpy(bv->bv->data, buffer, bytes_read);
     bv->count = (int)bytes_read;
 
     return bv;
@@ -763,7 +1131,7 @@ Cell* builtin_read_bytevector_bang(const Lex* e, const Cell* a)
     if (err) return err;
 
     /* Ensure arg1 is a u8 bytevector. */
-    if (a->cell[0]->type != CELL_BYTEVECTOR) {
+    if (cell_type(a->cell[0]) != CELL_BYTEVECTOR) {
         return make_cell_error(
             "read-bytevector!: arg1 must be a u8 bytevector",
             TYPE_ERR);
@@ -774,13 +1142,15 @@ Cell* builtin_read_bytevector_bang(const Lex* e, const Cell* a)
             "read-bytevector!: arg1 must be a u8 bytevector",
             TYPE_ERR);
     }
+    err = bv_check_writable(bv, "read-bytevector!");
+    if (err) return err;
 
     /* Ensure arg2 is a port, if supplied. */
     Cell* port;
     if (a->count == 1) {
         port = builtin_current_input_port(e, a);
     } else {
-        if (a->cell[1]->type != CELL_PORT) {
+        if (cell_type(a->cell[1]) != CELL_PORT) {
             return make_cell_error(
                 "read-bytevector!: arg2 must be a port",
                 TYPE_ERR);
@@ -806,24 +1176,24 @@ Cell* builtin_read_bytevector_bang(const Lex* e, const Cell* a)
     int end = bv->count;
 
     if (a->count > 2) {
-        if (a->cell[2]->type != CELL_INTEGER) {
+        if (cell_type(a->cell[2]) != CELL_INTEGER) {
             return make_cell_error(
                 "read-bytevector!: arg3 must be an integer",
                 TYPE_ERR);
         }
-        start = (int)a->cell[2]->integer_v;
+        start = (int)cell_int(a->cell[2]);
         if (start < 0) {
             return make_cell_error(
                 "read-bytevector!: arg3 must be an exact, positive integer",
                 VALUE_ERR);
         }
         if (a->count > 3) {
-            if (a->cell[3]->type != CELL_INTEGER) {
+            if (cell_type(a->cell[3]) != CELL_INTEGER) {
                 return make_cell_error(
                     "read-bytevector!: arg4 must be an integer",
                     TYPE_ERR);
             }
-            end = (int)a->cell[3]->integer_v;
+            end = (int)cell_int(a->cell[3]);
             if (end < 0) {
                 return make_cell_error(
                     "read-bytevector!: arg4 must be an exact, positive integer",
@@ -896,36 +1266,19 @@ Cell* builtin_peek_char(const Lex* e, const Cell* a)
             FILE_ERR);
     }
 
+    /* The character is decoded where it lies, and left unread. */
     int err_r;
-    /* Grab and save current index. */
-    const long curr_index = port->port->vtable->tell(port, &err_r);
-    if (curr_index < 0) goto error;
-
-    /* Grab the char. */
     UChar32 out;
-    const ssize_t ret = port_read_char(port, &out, &err_r);
-
-    /* Reset index, even if there is an error. */
-    int seek_err;
-    const int seek_ret = port->port->vtable->seek(port, curr_index, &seek_err);
-    if (seek_ret < 0) {
-        err_r = seek_err;
-        goto error;
-    }
-
-    /* Error on byte read. */
-    if (ret == R_ERR) goto error;
-    /* Legitimate EOF. */
+    const ssize_t ret = port_read_char(port, &out, &err_r, false);
     if (ret == R_EOF) {
         return EOF_Obj;
     }
+    if (ret == R_ERR) {
+        return make_cell_error(
+            fmt_err("peek-char: %s", strerror(err_r)),
+            READ_ERR);
+    }
     return make_cell_char(out);
-
-error:
-    return make_cell_error(
-        fmt_err("peek-char: %s", strerror(err_r)),
-        READ_ERR);
-
 }
 
 
@@ -997,15 +1350,15 @@ Cell* builtin_write_char(const Lex* e, const Cell* a)
 {
     Cell* err = CHECK_ARITY_RANGE(a, 1, 2, "write-char");
     if (err) return err;
-    if (a->cell[0]->type != CELL_CHAR) {
+    if (cell_type(a->cell[0]) != CELL_CHAR) {
         return make_cell_error(
             "write-char: arg1 must be a char",
             TYPE_ERR);
     }
-    const UChar32 the_char = a->cell[0]->char_v;
+    const UChar32 the_char = cell_char(a->cell[0]);
 
     if (a->count == 2) {
-        if (a->cell[1]->type != CELL_PORT) {
+        if (cell_type(a->cell[1]) != CELL_PORT) {
             return make_cell_error(
                 "write-char: arg2 must be a port",
                 TYPE_ERR);
@@ -1055,13 +1408,13 @@ Cell* builtin_write_string(const Lex* e, const Cell* a)
 {
     Cell* err = CHECK_ARITY_RANGE(a, 1, 4, "write-string");
     if (err) return err;
-    if (a->cell[0]->type != CELL_STRING) {
+    if (cell_type(a->cell[0]) != CELL_STRING) {
         return make_cell_error(
             "write-string: arg1 must be a string",
             TYPE_ERR);
     }
     if (a->count >= 2) {
-        if (a->cell[1]->type != CELL_PORT) {
+        if (cell_type(a->cell[1]) != CELL_PORT) {
             return make_cell_error(
                 "write-string: arg2 must be a port",
                 TYPE_ERR);
@@ -1073,19 +1426,19 @@ Cell* builtin_write_string(const Lex* e, const Cell* a)
     int num_chars = a->cell[0]->char_count;
 
     if (a->count >= 3) {
-        if (a->cell[2]->type != CELL_INTEGER) {
+        if (cell_type(a->cell[2]) != CELL_INTEGER) {
             return make_cell_error(
                 "write-string: arg3 must be an integer",
                 TYPE_ERR);
         }
-        start = (int)a->cell[2]->integer_v;
+        start = (int)cell_int(a->cell[2]);
         if (a->count == 4) {
-            if (a->cell[3]->type != CELL_INTEGER) {
+            if (cell_type(a->cell[3]) != CELL_INTEGER) {
                 return make_cell_error(
                     "write-string: arg4 must be an integer",
                     TYPE_ERR);
             }
-            end = (int)a->cell[3]->integer_v;
+            end = (int)cell_int(a->cell[3]);
         }
     }
 
@@ -1122,9 +1475,9 @@ Cell* builtin_write_u8(const Lex* e, const Cell* a)
     if (err) return err;
 
     /* Ensure the argument is an unsigned byte. */
-    if (a->cell[0]->type != CELL_INTEGER ||
-        a->cell[0]->integer_v > 255 ||
-        a->cell[0]->integer_v < 0) {
+    if (cell_type(a->cell[0]) != CELL_INTEGER ||
+        cell_int(a->cell[0]) > 255 ||
+        cell_int(a->cell[0]) < 0) {
         return make_cell_error(
             "write-u8: argument must be an octet (0-255)",
             TYPE_ERR);
@@ -1132,10 +1485,10 @@ Cell* builtin_write_u8(const Lex* e, const Cell* a)
 
     /* write expects an array, so put the byte in an array of size 1. */
     uint8_t byte[1];
-    byte[0] = (uint8_t)a->cell[0]->integer_v;
+    byte[0] = (uint8_t)cell_int(a->cell[0]);
 
     if (a->count == 2) {
-        if (a->cell[1]->type != CELL_PORT) {
+        if (cell_type(a->cell[1]) != CELL_PORT) {
             return make_cell_error(
                 "write-u8: arg2 must be a port",
                 TYPE_ERR);
@@ -1182,14 +1535,14 @@ Cell* builtin_write_bytevector(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_RANGE(a, 1, 4, "write-bytevector");
     if (err) return err;
-    if (a->cell[0]->type != CELL_BYTEVECTOR) {
+    if (cell_type(a->cell[0]) != CELL_BYTEVECTOR) {
         return make_cell_error(
             "write-bytevector: arg1 must be a bytevector",
             TYPE_ERR);
     }
 
     if (a->count == 2) {
-        if (a->cell[1]->type != CELL_PORT) {
+        if (cell_type(a->cell[1]) != CELL_PORT) {
             return make_cell_error(
                 "write-bytevector: arg2 must be a port",
                 TYPE_ERR);
@@ -1201,19 +1554,19 @@ Cell* builtin_write_bytevector(const Lex* e, const Cell* a)
     int num_bytes = a->cell[0]->count;
 
     if (a->count >= 3) {
-        if (a->cell[2]->type != CELL_INTEGER) {
+        if (cell_type(a->cell[2]) != CELL_INTEGER) {
             return make_cell_error(
                 "write-bytevector: arg3 must be an integer",
                 TYPE_ERR);
         }
-        start = (int)a->cell[2]->integer_v;
+        start = (int)cell_int(a->cell[2]);
         if (a->count == 4) {
-            if (a->cell[3]->type != CELL_INTEGER) {
+            if (cell_type(a->cell[3]) != CELL_INTEGER) {
                 return make_cell_error(
                     "write-bytevector: arg4 must be an integer",
                     TYPE_ERR);
             }
-            end = (int)a->cell[3]->integer_v;
+            end = (int)cell_int(a->cell[3]);
         }
     }
 
@@ -1269,7 +1622,7 @@ Cell* builtin_newline(const Lex* e, const Cell* a)
         port = builtin_current_output_port(e, a);
     } else {
         port = a->cell[0];
-        if (port->type != CELL_PORT) {
+        if (cell_type(port) != CELL_PORT) {
             return make_cell_error(
                 "newline: arg must be a port",
                 FILE_ERR);
@@ -1324,7 +1677,7 @@ Cell* builtin_read_error(const Lex* e, const Cell* a)
     if (err) return err;
 
     const Cell* obj = a->cell[0];
-    if (obj->type != CELL_ERROR) {
+    if (cell_type(obj) != CELL_ERROR) {
         return False_Obj;
     }
 
@@ -1345,7 +1698,7 @@ Cell* builtin_file_error(const Lex* e, const Cell* a)
     if (err) return err;
 
     const Cell* obj = a->cell[0];
-    if (obj->type != CELL_ERROR) {
+    if (cell_type(obj) != CELL_ERROR) {
         return False_Obj;
     }
 
@@ -1396,19 +1749,6 @@ Cell* builtin_flush_output_port(const Lex* e, const Cell* a)
 }
 
 
-#if defined(__GLIBC__)
-/* glibc internal check */
-#define HAS_BUFFERED_DATA(fp) ((fp)->_IO_read_ptr < (fp)->_IO_read_end)
-#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
-/* BSD/Darwin internal check */
-#define HAS_BUFFERED_DATA(fp) ((fp)->_r > 0)
-#else
-/* Fallback: We don't know how to check the buffer for this LibC.
- * If we can't see the buffer, at least EOF counts as 'ready'. */
-#define HAS_BUFFERED_DATA(fp) (feof(fp))
-#endif
-
-
 /* A simple function to check if a character is ready on a FILE* stream.
  * This directly implements the logic for char-ready? and u8-ready? */
 static int is_stream_ready(FILE *fp)
@@ -1488,6 +1828,12 @@ Cell* builtin_char_ready(const Lex* e, const Cell* a)
             FILE_ERR);
     }
 
+    /* Mapped file ports are read from memory, so are always ready, as
+     * are file ports with characters read ahead. */
+    if (port->port->vtable == &MappedFileVTable || buffered(port) > 0) {
+        return True_Obj;
+    }
+
     /* Nothing left but an open text input port. */
     const int result = is_stream_ready(port->port->fh);
     if (result == -1) {
@@ -1537,6 +1883,11 @@ Cell* builtin_u8_ready(const Lex* e, const Cell* a)
             FILE_ERR);
     }
 
+    /* Mapped file ports are read from memory, so are always ready. */
+    if (port->port->vtable == &MappedFileVTable) {
+        return True_Obj;
+    }
+
     const int result = is_stream_ready(port->port->fh);
     if (result == -1) {
         return make_cell_error(
@@ -1568,7 +1919,7 @@ Cell* builtin_display(const Lex* e, const Cell* a)
     if (a->count == 1) {
         p = builtin_current_output_port(e, a);
     } else {
-        if (a->cell[1]->type != CELL_PORT) {
+        if (cell_type(a->cell[1]) != CELL_PORT) {
             return make_cell_error(
                 "display: arg2 must be a port",
                 TYPE_ERR);
@@ -1607,7 +1958,7 @@ Cell* builtin_displayln(const Lex* e, const Cell* a)
     if (a->count == 1) {
         p = builtin_current_output_port(e, a);
     } else {
-        if (a->cell[1]->type != CELL_PORT) {
+        if (cell_type(a->cell[1]) != CELL_PORT) {
             return make_cell_error(
                 "displayln: arg2 must be a port",
                 TYPE_ERR);
@@ -1658,7 +2009,7 @@ Cell* builtin_write(const Lex* e, const Cell* a)
     if (a->count == 1) {
         p = builtin_current_output_port(e, a);
     } else {
-        if (a->cell[1]->type != CELL_PORT) {
+        if (cell_type(a->cell[1]) != CELL_PORT) {
             return make_cell_error(
                 "write: arg1 must be a port",
                 TYPE_ERR);
@@ -1698,7 +2049,7 @@ Cell* builtin_writeln(const Lex* e, const Cell* a)
     if (a->count == 1) {
         p = builtin_current_output_port(e, a);
     } else {
-        if (a->cell[1]->type != CELL_PORT) {
+        if (cell_type(a->cell[1]) != CELL_PORT) {
             return make_cell_error(
                 "writeln: must be a port",
                 TYPE_ERR);
@@ -1727,6 +2078,24 @@ Cell* builtin_writeln(const Lex* e, const Cell* a)
 }
 
 
+/* Open path as an input file port. Regular files are mapped
+ * into memory, and read in place; anything else, such as a pipe or a
+ * device, is read through stdio. Returns null, with errno set, if the
+ * file cannot be opened. */
+static Cell* open_input_file_port(const char* path, const backend_t backend)
+{
+    struct stat st;
+    if (stat(path, &st) == 0 && S_ISREG(st.st_mode)) {
+        file_map_t* map = GC_MALLOC(sizeof(file_map_t));
+        if (!file_map_open(path, map)) return nullptr;
+        return make_cell_mapped_port(path, map, backend);
+    }
+    FILE* fp = fopen(path, "r");
+    if (!fp) return nullptr;
+    return make_cell_file_port(path, fp, INPUT_STREAM, backend);
+}
+
+
 /* (open-input-file string)
  * Takes a string for an existing file and returns an input port that is capable of delivering text data from the file.
  * If the file does not exist or cannot be opened, an error that satisfies file-error? is signalled. */
@@ -1739,23 +2108,17 @@ Cell* builtin_open_input_file(const Lex* e, const Cell* a)
     if (err) { return err; }
 
     const char* filename = a->cell[0]->str;
-    FILE *fp = fopen(filename, "r");
-    if (!fp) {
-        return make_cell_error(
-            fmt_err("open-input-file", strerror(errno)),
-            FILE_ERR);
-    }
     char *actual_path = GC_MALLOC(PATH_MAX);
     const char *path = realpath(filename, actual_path);
-    if (path == NULL) {
-        fclose(fp);
+    Cell* port = path ? open_input_file_port(path, BK_FILE_TEXT) : nullptr;
+    if (!port) {
         return make_cell_error(
             fmt_err("open-input-file", strerror(errno)),
             FILE_ERR);
     }
 
     /* Must be a text file port. */
-    return make_cell_file_port(path, fp, INPUT_STREAM, BK_FILE_TEXT);
+    return port;
 }
 
 
@@ -1771,23 +2134,17 @@ Cell* builtin_open_bin_input_file(const Lex* e, const Cell* a)
     if (err) { return err; }
 
     const char* filename = a->cell[0]->str;
-    FILE *fp = fopen(filename, "r");
-    if (!fp) {
-        return make_cell_error(
-            fmt_err("open-bin-input-file", strerror(errno)),
-            FILE_ERR);
-    }
     char *actual_path = GC_MALLOC(PATH_MAX);
     const char *path = realpath(filename, actual_path);
-    if (path == NULL) {
-        fclose(fp);
+    Cell* port = path ? open_input_file_port(path, BK_FILE_BINARY) : nullptr;
+    if (!port) {
         return make_cell_error(
             fmt_err("open-bin-input-file", strerror(errno)),
             FILE_ERR);
     }
 
     /* Must be a binary file port. */
-    return make_cell_file_port(path, fp, INPUT_STREAM, BK_FILE_BINARY);
+    return port;
 }
 
 
@@ -1805,7 +2162,7 @@ Cell* builtin_open_output_file(const Lex* e, const Cell* a)
 
     const char *mode = "a";
     const char* filename = a->cell[0]->str;
-    if (a->count == 2 && a->cell[1]->type == CELL_STRING) {
+    if (a->count == 2 && cell_type(a->cell[1]) == CELL_STRING) {
         mode = a->cell[1]->str;
     }
     FILE *fp = fopen(filename, mode);
@@ -1842,7 +2199,7 @@ Cell* builtin_open_bin_output_file(const Lex* e, const Cell* a)
 
     const char *mode = "a";
     const char* filename = a->cell[0]->str;
-    if (a->count == 2 && a->cell[1]->type == CELL_STRING) {
+    if (a->count == 2 && cell_type(a->cell[1]) == CELL_STRING) {
         mode = a->cell[1]->str;
     }
     FILE *fp = fopen(filename, mode);
@@ -1880,7 +2237,7 @@ Cell* builtin_open_and_trunc_output_file(const Lex* e, const Cell* a)
 
     const char *mode = "w";
     const char* filename = a->cell[0]->str;
-    if (a->count == 2 && a->cell[1]->type == CELL_STRING) {
+    if (a->count == 2 && cell_type(a->cell[1]) == CELL_STRING) {
         mode = a->cell[1]->str;
     }
     FILE *fp = fopen(filename, mode);
@@ -1918,7 +2275,7 @@ Cell* builtin_open_and_trunc_bin_output_file(const Lex* e, const Cell* a)
 
     const char *mode = "w";
     const char* filename = a->cell[0]->str;
-    if (a->count == 2 && a->cell[1]->type == CELL_STRING) {
+    if (a->count == 2 && cell_type(a->cell[1]) == CELL_STRING) {
         mode = a->cell[1]->str;
     }
     FILE *fp = fopen(filename, mode);
@@ -1960,8 +2317,8 @@ Cell* builtin_open_input_string(const Lex* e, const Cell* a) {
     Cell* err = CHECK_ARITY_EXACT(a, 1, "open-input-string");
     if (err) { return err; }
 
-    if (a->cell[0]->type != CELL_STRING) {
-        make_cell_error(
+    if (cell_type(a->cell[0]) != CELL_STRING) {
+        return make_cell_error(
             "open-input-string: arg must be a string",
             TYPE_ERR);
     }
@@ -1991,7 +2348,7 @@ Cell* builtin_get_output_string(const Lex* e, const Cell* a) {
     Cell* err = CHECK_ARITY_EXACT(a, 1, "get-output-string");
     if (err) { return err; }
 
-    if (a->cell[0]->type != CELL_PORT) {
+    if (cell_type(a->cell[0]) != CELL_PORT) {
         return make_cell_error("get-output-string: arg must be a port", TYPE_ERR);
     }
 
@@ -2021,8 +2378,8 @@ Cell* builtin_open_input_bytevector(const Lex* e, const Cell* a) {
     Cell* err = CHECK_ARITY_EXACT(a, 1, "open-input-bytevector");
     if (err) { return err; }
 
-    if (a->cell[0]->type != CELL_BYTEVECTOR || a->cell[0]->bv->type != BV_U8) {
-        make_cell_error(
+    if (cell_type(a->cell[0]) != CELL_BYTEVECTOR || a->cell[0]->bv->type != BV_U8) {
+        return make_cell_error(
             "open-input-bytevector: arg must be a u8 bytevector",
             TYPE_ERR);
     }
@@ -2048,7 +2405,7 @@ Cell* builtin_get_output_bytevector(const Lex* e, const Cell* a) {
     Cell* err = CHECK_ARITY_EXACT(a, 1, "get-output-bytevector");
     if (err) { return err; }
 
-    if (a->cell[0]->type != CELL_PORT) {
+    if (cell_type(a->cell[0]) != CELL_PORT) {
         return make_cell_error("get-output-bytevector: arg must be a port", TYPE_ERR);
     }
 
@@ -2075,12 +2432,12 @@ Cell* builtin_call_with_port(const Lex* e, const Cell* a) {
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 2, "call-with-port");
     if (err) { return err; }
-    if (a->cell[0]->type != CELL_PORT) {
+    if (cell_type(a->cell[0]) != CELL_PORT) {
         return make_cell_error(
             "call-with-port: arg1 must be a port",
             TYPE_ERR);
     }
-    if (a->cell[1]->type != CELL_PROC) {
+    if (cell_type(a->cell[1]) != CELL_PROC) {
         return make_cell_error(
             "call-with-port: arg2 must be a procedure",
             TYPE_ERR);
@@ -2114,14 +2471,14 @@ Cell* builtin_call_with_input_file(const Lex* e, const Cell* a) {
     Cell* err = CHECK_ARITY_EXACT(a, 2, "call-with-input-file");
     if (err) { return err; }
 
-    if (a->cell[0]->type != CELL_STRING) {
+    if (cell_type(a->cell[0]) != CELL_STRING) {
         return make_cell_error(
             "call-with-input-file: arg1 must be a string",
             TYPE_ERR);
     }
     const char* path = a->cell[0]->str;
 
-    if (a->cell[1]->type != CELL_PROC) {
+    if (cell_type(a->cell[1]) != CELL_PROC) {
         return make_cell_error(
             "call-with-input-file: arg2 must be a proc",
             TYPE_ERR);
@@ -2138,13 +2495,11 @@ Cell* builtin_call_with_input_file(const Lex* e, const Cell* a) {
     }
 
     /* Open the port for reading. */
-    FILE* fp = fopen(path, "r");
-    if (!fp) {
+    const Cell* p = open_input_file_port(path, BK_FILE_TEXT);
+    if (!p) {
         return make_cell_error(strerror(errno), FILE_ERR);
     }
 
-    const Cell* p = make_cell_file_port(path, fp, INPUT_STREAM, BK_FILE_TEXT);
-
     Cell* clos = make_sexpr_len2(proc, p);
     Cell* result = coz_eval((Lex*)e, clos);
 
@@ -2161,14 +2516,14 @@ Cell* builtin_call_with_output_file(const Lex* e, const Cell* a) {
     Cell* err = CHECK_ARITY_EXACT(a, 2, "call-with-output-file");
     if (err) { return err; }
 
-    if (a->cell[0]->type != CELL_STRING) {
+    if (cell_type(a->cell[0]) != CELL_STRING) {
         return make_cell_error(
             "call-with-output-file: arg1 must be a string",
             TYPE_ERR);
     }
     const char* path = a->cell[0]->str;
 
-    if (a->cell[1]->type != CELL_PROC) {
+    if (cell_type(a->cell[1]) != CELL_PROC) {
         return make_cell_error(
             "call-with-output-file: arg2 must be a proc",
             TYPE_ERR);
@@ -2209,14 +2564,14 @@ Cell* builtin_with_input_from_file(const Lex* e, const Cell* a) {
     Cell* err = CHECK_ARITY_EXACT(a, 2, "with-input-from-file");
     if (err) { return err; }
 
-    if (a->cell[0]->type != CELL_STRING) {
+    if (cell_type(a->cell[0]) != CELL_STRING) {
         return make_cell_error(
             "with-input-from-file: arg1 must be a string",
             TYPE_ERR);
     }
     const char* path = a->cell[0]->str;
 
-    if (a->cell[1]->type != CELL_PROC) {
+    if (cell_type(a->cell[1]) != CELL_PROC) {
         return make_cell_error(
             "with-input-from-file: arg2 must be a proc",
             TYPE_ERR);
@@ -2236,12 +2591,10 @@ Cell* builtin_with_input_from_file(const Lex* e, const Cell* a) {
     Cell* std_input_port = default_input_port;
 
     /* Open the port for reading, and bind to default input. */
-    FILE* fp = fopen(path, "r");
-    if (!fp) {
+    Cell* p = open_input_file_port(path, BK_FILE_TEXT);
+    if (!p) {
         return make_cell_error(strerror(errno), FILE_ERR);
     }
-
-    Cell* p = make_cell_file_port(path, fp, INPUT_STREAM, BK_FILE_TEXT);
     default_input_port = p;
     /* Pass the thunk to eval. */
     Cell* clos = make_sexpr_len1(proc);
@@ -2263,14 +2616,14 @@ Cell* builtin_with_output_to_file(const Lex* e, const Cell* a) {
     Cell* err = CHECK_ARITY_EXACT(a, 2, "with-output-to-file");
     if (err) { return err; }
 
-    if (a->cell[0]->type != CELL_STRING) {
+    if (cell_type(a->cell[0]) != CELL_STRING) {
         return make_cell_error(
             "with-output-to-file: arg1 must be a string",
             TYPE_ERR);
     }
     const char* path = a->cell[0]->str;
 
-    if (a->cell[1]->type != CELL_PROC) {
+    if (cell_type(a->cell[1]) != CELL_PROC) {
         return make_cell_error(
             "with-output-to-file: arg2 must be a proc",
             TYPE_ERR);
@@ -31,6 +31,7 @@
 /* */
 extern const PortInterface FileVTable;
 extern const PortInterface MemoryVTable;
+extern const PortInterface MappedFileVTable;
 
 
 /* Input/output and ports. */
@@ -38,7 +38,7 @@ Cell* builtin_number_pred(const Lex* e, const Cell* a)
 
     // ReSharper disable once CppVariableCanBeMadeConstexpr
     const int mask = CELL_INTEGER|CELL_REAL|CELL_RATIONAL|CELL_COMPLEX|CELL_BIGINT|CELL_BIGFLOAT;
-    if (a->cell[0]->type & mask) {
+    if (cell_type(a->cell[0]) & mask) {
         return True_Obj;
     }
     return False_Obj;
@@ -52,7 +52,7 @@ Cell* builtin_boolean_pred(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "boolean?");
     if (err) return err;
-    return make_cell_boolean(a->cell[0]->type == CELL_BOOLEAN);
+    return make_cell_boolean(cell_type(a->cell[0]) == CELL_BOOLEAN);
 }
 
 
@@ -63,7 +63,7 @@ Cell* builtin_null_pred(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "null?");
     if (err) return err;
-    return make_cell_boolean(a->cell[0]->type == CELL_NIL);
+    return make_cell_boolean(cell_type(a->cell[0]) == CELL_NIL);
 }
 
 
@@ -74,7 +74,7 @@ Cell *builtin_pair_pred(const Lex *e, const Cell *a)
     (void) e;
     Cell *err = CHECK_ARITY_EXACT(a, 1, "pair?");
     if (err) return err;
-    return make_cell_boolean(a->cell[0]->type == CELL_PAIR);
+    return make_cell_boolean(cell_type(a->cell[0]) == CELL_PAIR);
 }
 
 
@@ -87,23 +87,23 @@ Cell* builtin_list_pred(const Lex* e, const Cell* a)
     Cell* err = CHECK_ARITY_EXACT(a, 1, "list?");
     if (err) return err;
     /* '() is a list */
-    if (a->cell[0]->type == CELL_NIL) {
+    if (cell_type(a->cell[0]) == CELL_NIL) {
         return True_Obj;
     }
 
     /* If len is not -1, we can trust it's a proper list. */
-    if (a->cell[0]->type == CELL_PAIR && a->cell[0]->len > 0) {
+    if (cell_type(a->cell[0]) == CELL_PAIR && a->cell[0]->len > 0) {
         return True_Obj;
     }
 
     /* If len is -1, this could be an improper list or a proper list
      * built with `cons`. We need to traverse it to find out. */
     const Cell* p = a->cell[0];
-    while (p->type == CELL_PAIR) {
+    while (cell_type(p) == CELL_PAIR) {
         p = p->cdr;
     }
 
-    return p->type == CELL_NIL ? True_Obj : False_Obj;
+    return cell_type(p) == CELL_NIL ? True_Obj : False_Obj;
 }
 
 
@@ -114,7 +114,7 @@ Cell* builtin_proc_pred(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "procedure?");
     if (err) return err;
-    return make_cell_boolean(a->cell[0]->type == CELL_PROC);
+    return make_cell_boolean(cell_type(a->cell[0]) == CELL_PROC);
 }
 
 
@@ -125,7 +125,7 @@ Cell* builtin_sym_pred(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "symbol?");
     if (err) return err;
-    return make_cell_boolean(a->cell[0]->type == CELL_SYMBOL);
+    return make_cell_boolean(cell_type(a->cell[0]) == CELL_SYMBOL);
 }
 
 
@@ -136,7 +136,7 @@ Cell* builtin_string_pred(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "string?");
     if (err) return err;
-    return make_cell_boolean(a->cell[0]->type == CELL_STRING);
+    return make_cell_boolean(cell_type(a->cell[0]) == CELL_STRING);
 }
 
 
@@ -147,7 +147,7 @@ Cell* builtin_char_pred(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "char?");
     if (err) return err;
-    return make_cell_boolean(a->cell[0]->type == CELL_CHAR);
+    return make_cell_boolean(cell_type(a->cell[0]) == CELL_CHAR);
 }
 
 
@@ -158,7 +158,7 @@ Cell* builtin_vector_pred(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "vector?");
     if (err) return err;
-    return make_cell_boolean(a->cell[0]->type == CELL_VECTOR);
+    return make_cell_boolean(cell_type(a->cell[0]) == CELL_VECTOR);
 }
 
 
@@ -169,7 +169,7 @@ Cell* builtin_bytevector_pred(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "bytevector?");
     if (err) return err;
-    return make_cell_boolean(a->cell[0]->type == CELL_BYTEVECTOR);
+    return make_cell_boolean(cell_type(a->cell[0]) == CELL_BYTEVECTOR);
 }
 
 
@@ -180,7 +180,7 @@ Cell* builtin_port_pred(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "port?");
     if (err) return err;
-    return make_cell_boolean(a->cell[0]->type == CELL_PORT);
+    return make_cell_boolean(cell_type(a->cell[0]) == CELL_PORT);
 }
 
 
@@ -191,7 +191,7 @@ Cell* builtin_set_pred(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "set?");
     if (err) return err;
-    return make_cell_boolean(a->cell[0]->type == CELL_SET);
+    return make_cell_boolean(cell_type(a->cell[0]) == CELL_SET);
 }
 
 
@@ -202,7 +202,7 @@ Cell* builtin_hash_pred(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "hash?");
     if (err) return err;
-    return make_cell_boolean(a->cell[0]->type == CELL_HASH);
+    return make_cell_boolean(cell_type(a->cell[0]) == CELL_HASH);
 }
 
 
@@ -213,7 +213,7 @@ Cell* builtin_eof_pred(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "eof-object?");
     if (err) return err;
-    return make_cell_boolean(a->cell[0]->type == CELL_EOF);
+    return make_cell_boolean(cell_type(a->cell[0]) == CELL_EOF);
 }
 
 
@@ -232,10 +232,10 @@ Cell* builtin_exact_pred(const Lex* e, const Cell* a)
     if (err) { return err; }
     if ((err = CHECK_ARITY_EXACT(a, 1, "exact?"))) { return err; }
     const Cell* z = a->cell[0];
-    if (z->type == CELL_COMPLEX) {
-        return make_cell_boolean(z->real->exact && z->imag->exact);
+    if (cell_type(z) == CELL_COMPLEX) {
+        return make_cell_boolean(cell_exact(z->real) && cell_exact(z->imag));
     }
-    return make_cell_boolean(z->exact);
+    return make_cell_boolean(cell_exact(z));
 }
 
 
@@ -249,12 +249,12 @@ Cell* builtin_inexact_pred(const Lex* e, const Cell* a)
     if (err) { return err; }
     if ((err = CHECK_ARITY_EXACT(a, 1, "inexact?"))) { return err; }
 
-    if (a->cell[0]->type == CELL_COMPLEX) {
-        return a->cell[0]->real->exact && a->cell[0]->imag->exact ?
+    if (cell_type(a->cell[0]) == CELL_COMPLEX) {
+        return cell_exact(a->cell[0]->real) && cell_exact(a->cell[0]->imag) ?
         make_cell_boolean(false) : make_cell_boolean(true);
     }
 
-    if (a->cell[0]->exact) {
+    if (cell_exact(a->cell[0])) {
         return False_Obj;
     }
     return True_Obj;
@@ -271,7 +271,7 @@ Cell* builtin_complex(const Lex* e, const Cell* a)
     /* All numbers are complex numbers. */
     // ReSharper disable once CppVariableCanBeMadeConstexpr
     const int mask = CELL_INTEGER|CELL_RATIONAL|CELL_REAL|CELL_COMPLEX|CELL_BIGINT;
-    if (a->cell[0]->type & mask) {
+    if (cell_type(a->cell[0]) & mask) {
         return True_Obj;
     }
     return False_Obj;
@@ -286,7 +286,7 @@ Cell* builtin_real(const Lex* e, const Cell* a)
     if (err) return err;
 
     const Cell* arg = a->cell[0];
-    switch (arg->type) {
+    switch (cell_type(arg)) {
         case CELL_INTEGER:
         case CELL_BIGINT:
         case CELL_RATIONAL:
@@ -318,17 +318,17 @@ Cell* builtin_rational(const Lex* e, const Cell* a)
 
     /* A complex number is rational if its real part is exact
      * and its imaginary part is zero. */
-    if (arg->type == CELL_COMPLEX) {
-        return make_cell_boolean(arg->real->exact && cell_is_real_zero(arg->imag));
+    if (cell_type(arg) == CELL_COMPLEX) {
+        return make_cell_boolean(cell_exact(arg->real) && cell_is_real_zero(arg->imag));
     }
 
     /* Exact numbers are rational */
-    if (arg->exact) {
+    if (cell_exact(arg)) {
         return True_Obj;
     }
 
     /* Finite reals are rational */
-    if (!arg->exact) {
+    if (!cell_exact(arg)) {
         return make_cell_boolean(isfinite(cell_to_long_double(arg)));
     }
 
@@ -355,7 +355,7 @@ Cell* builtin_exact_integer(const Lex* e, const Cell* a)
 
     const Cell* arg = a->cell[0];
     /* The value must be an integer AND the number must be exact. */
-    return make_cell_boolean(cell_is_integer(arg) && arg->exact);
+    return make_cell_boolean(cell_is_integer(arg) && cell_exact(arg));
 }
 
 
@@ -365,7 +365,7 @@ Cell* builtin_bigint(const Lex* e, const Cell* a)
     Cell* err = CHECK_ARITY_EXACT(a, 1, "bigint?");
     if (err) return err;
 
-    if (a->cell[0]->type == CELL_BIGINT) {
+    if (cell_type(a->cell[0]) == CELL_BIGINT) {
         return True_Obj;
     }
     return False_Obj;
@@ -378,7 +378,7 @@ Cell* builtin_bigrat(const Lex* e, const Cell* a)
     Cell* err = CHECK_ARITY_EXACT(a, 1, "bigrat?");
     if (err) return err;
 
-    if (a->cell[0]->type == CELL_BIGRAT) {
+    if (cell_type(a->cell[0]) == CELL_BIGRAT) {
         return True_Obj;
     }
     return False_Obj;
@@ -391,7 +391,7 @@ Cell* builtin_bigfloat(const Lex* e, const Cell* a)
     Cell* err = CHECK_ARITY_EXACT(a, 1, "bigfloat?");
     if (err) return err;
 
-    if (a->cell[0]->type == CELL_BIGFLOAT) {
+    if (cell_type(a->cell[0]) == CELL_BIGFLOAT) {
         return True_Obj;
     }
     return False_Obj;
@@ -415,7 +415,7 @@ Cell* builtin_zero(const Lex* e, const Cell* a)
     const Cell* arg = a->cell[0];
     bool is_zero;
 
-    if (arg->type == CELL_COMPLEX) {
+    if (cell_type(arg) == CELL_COMPLEX) {
         is_zero = cell_is_real_zero(arg->real) && cell_is_real_zero(arg->imag);
     } else {
         is_zero = cell_is_real_zero(arg);
@@ -435,7 +435,7 @@ Cell* builtin_positive(const Lex* e, const Cell* a)
     if ((err = CHECK_ARITY_EXACT(a, 1, "positive?"))) { return err; }
 
     const Cell* val = a->cell[0];
-    if (val->type == CELL_COMPLEX) {
+    if (cell_type(val) == CELL_COMPLEX) {
         /* Must be a real number to be positive */
         if (!cell_is_real_zero(val->imag)) return make_cell_error(
             "positive?: expected real, got complex",
@@ -458,7 +458,7 @@ Cell* builtin_negative(const Lex* e, const Cell* a)
     if ((err = CHECK_ARITY_EXACT(a, 1, "negative?"))) { return err; }
 
     const Cell* val = a->cell[0];
-    if (val->type == CELL_COMPLEX) {
+    if (cell_type(val) == CELL_COMPLEX) {
         /* Must be a real number to be negative */
         if (!cell_is_real_zero(val->imag)) return make_cell_error(
             "negative?: expected real, got complex",
@@ -195,17 +195,17 @@ void repl(Lex* e)
     while (true) {
         /* Get the input. */
         const char* input = coz_read();
-        /* Run it through the lexer. */
-        TokenArray* ta = scan_all_tokens(input);
-        /* Debug print the token array. */
-        //debug_lexer(ta);
-        /* Run it through the parser and evaluate. */
-        Cell* result = parse_all_expressions(e, ta, true);
+        /* Debug print the tokens. */
+        //debug_lexer(input);
+        /* Read and evaluate each expression in turn. */
+        Reader r;
+        init_reader(&r, input);
+        Cell* result = parse_all_expressions(e, &r, true);
         /* Print either new prompt or error. */
         if (!result) {
             continue;
         }
-        if (result->type == CELL_ERROR) {
+        if (cell_type(result) == CELL_ERROR) {
             coz_print(result);
         }
     }
@@ -222,8 +222,8 @@ int run_repl(const lib_load_config load_libs)
     is_repl = 1;
     /* Initialize signal handler. */
     install_signal_handlers();
-    /* Initialize symbol table with initial size of 128. */
-    symbol_table = ht_create(128);
+    /* Initialize symbol table. */
+    symbol_table = ht_create(SYMBOL_TABLE_INITIAL_CAPACITY);
     /* Load readline history. */
     read_history_from_file();
     /* Initialize default ports. */
@@ -234,12 +234,14 @@ int run_repl(const lib_load_config load_libs)
     Lex* e = lex_initialize_global_env();
     /* Load base procedures into the environment. */
     lex_add_builtins(e);
+    /* Initialize special form lookup table */
+    init_special_forms();
     /* Loads the CLI-specified libraries into the environment. */
     load_initial_libraries(e, load_libs);
+    /* Evaluate any user preludes. */
+    load_preludes(e);
     /* Load tab-completion candidate array from symbols in the environment. */
     populate_dynamic_completions(e);
-    /* Initialize special form lookup table */
-    init_special_forms();
 
     /* Run until we don't. */
     repl(e);
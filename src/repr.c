@@ -51,6 +51,7 @@
 #include "bytevectors.h"
 #include "types.h"
 #include "hash_type.h"
+#include "float_io.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -73,17 +74,8 @@ static void cell_to_string_worker(const Cell* v, str_buf_t *sb, print_mode_t mod
 /* Formats reals . */
 static void repr_long_double(const long double x, str_buf_t *sb)
 {
-    char buf[128];
-    snprintf(buf, sizeof buf, "%.15Lg", x);
-
-    /* If there's no '.' or exponent marker, force a ".0". */
-    if (!strchr(buf, '.') && !strchr(buf, 'e') && !strchr(buf, 'E')) {
-        const size_t len = strlen(buf);
-        if (len < sizeof(buf) - 3) {
-            strcat(buf, ".0");
-        }
-    }
-
+    char buf[REAL_BUF_SIZE];
+    format_real_shortest(buf, x);
     sb_append_str(sb, buf);
 }
 
@@ -99,12 +91,12 @@ static void repr_pair(const Cell* v, str_buf_t *sb, const print_mode_t mode)
         cell_to_string_worker(cur->car, sb, mode);
 
         /* The list continues (cdr is another pair). */
-        if (cur->cdr->type == CELL_PAIR) {
+        if (cell_type(cur->cdr) == CELL_PAIR) {
             sb_append_char(sb, ' ');
             cur = cur->cdr;
         }
         /* This is the end of a proper list. */
-        else if (cur->cdr->type == CELL_NIL) {
+        else if (cell_type(cur->cdr) == CELL_NIL) {
             break;
         }
         /* This is an improper list. */
@@ -130,7 +122,7 @@ static void repr_sequence(const Cell* v,
     if (prefix) sb_append_fmt(sb, "%s", prefix);
     sb_append_fmt(sb, "%c", open);
 
-    if (v->type == CELL_SET) {
+    if (cell_type(v) == CELL_SET) {
         ghti it = ght_iterator(v->table);
         const size_t t_len = ght_length(v->table);
         size_t i = 0;
@@ -139,7 +131,7 @@ static void repr_sequence(const Cell* v,
             if (i != t_len - 1) sb_append_char(sb, ' ');
             i++;
         }
-    } else if (v->type == CELL_HASH) {
+    } else if (cell_type(v) == CELL_HASH) {
         ghti it = ght_iterator(v->table);
         const size_t t_len = ght_length(v->table);
         size_t i = 0;
@@ -167,14 +159,14 @@ static void cell_to_string_worker(const Cell* v,
 {
     if (v == NULL) return;
 
-    switch (v->type) {
+    switch (cell_type(v)) {
 
         case CELL_REAL:
             repr_long_double(v->real_v, sb);
             break;
 
         case CELL_INTEGER:
-            sb_append_fmt(sb, "%lld", v->integer_v);
+            sb_append_fmt(sb, "%lld", cell_int(v));
             break;
 
         case CELL_RATIONAL:
@@ -254,9 +246,9 @@ static void cell_to_string_worker(const Cell* v,
 
         case CELL_CHAR:
             if (mode == MODE_DISPLAY) {
-                sb_append_fmt(sb, "%C", v->char_v);
+                sb_append_fmt(sb, "%C", cell_char(v));
             } else {
-                switch (v->char_v) {
+                switch (cell_char(v)) {
                     case '\n': sb_append_str(sb, "#\\newline");   break;
                     case ' ':  sb_append_str(sb, "#\\space");     break;
                     case '\t': sb_append_str(sb, "#\\tab");       break;
@@ -267,7 +259,7 @@ static void cell_to_string_worker(const Cell* v,
                     case 0x7f: sb_append_str(sb, "#\\delete");    break;
                     case '\0': sb_append_str(sb, "#\\null");      break;
 
-                    default:   sb_append_fmt(sb, "#\\%lc", (wint_t)v->char_v); break;
+                    default:   sb_append_fmt(sb, "#\\%lc", (wint_t)cell_char(v)); break;
                 }
             }
             break;
@@ -420,7 +412,7 @@ static void cell_to_string_worker(const Cell* v,
             /* This code should never run, but it's here if a cell type gets
              * corrupted internally somehow. */
             fprintf(stderr, "%sError:%s cell_to_string_worker: unknown type: '%s%d%s'", ANSI_RED_B,
-                ANSI_RESET, ANSI_RED_B, v->type, ANSI_RESET);
+                ANSI_RESET, ANSI_RED_B, cell_type(v), ANSI_RESET);
         }
     }
 
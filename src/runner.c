@@ -22,9 +22,14 @@
 #include "special_forms.h"
 #include "parser.h"
 #include "eval.h"
+#include "analyzer.h"
+#include "vm.h"
 #include "repl.h"
 #include "repr.h"
 #include "transforms.h"
+#include "fold.h"
+#include "fasl.h"
+#include "file_map.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -48,56 +53,13 @@ static void check_and_warn_extension(const char *file_path)
 }
 
 
-char* read_file_to_string(const char* filename)
-{
-    FILE* file = fopen(filename, "r");
-    if (file == NULL) {
-        perror("Error opening file");
-        return nullptr;
-    }
-
-    /* Determine file size. */
-    fseek(file, 0, SEEK_END);
-    const int64_t file_size = ftell(file);
-    fseek(file, 0, SEEK_SET);
-
-    if (file_size == -1) {
-        perror("Error getting file size");
-        fclose(file);
-        return nullptr;
-    }
-
-    /* Allocate memory for the string (+1 for null terminator). */
-    char* buffer = GC_MALLOC_ATOMIC(file_size + 1);
-    if (buffer == NULL) {
-        perror("Error allocating memory");
-        fclose(file);
-        return nullptr;
-    }
-
-    /* Read file content into the buffer. */
-    const size_t bytes_read = fread(buffer, 1, file_size, file);
-    if (bytes_read != (size_t)file_size) {
-        perror("Error reading file");
-        fclose(file);
-        return nullptr;
-    }
-
-    /* Null-terminate the string. */
-    buffer[file_size] = '\0';
-
-    fclose(file);
-    return buffer;
-}
-
-
 int run_file_script(const char *file_path, const lib_load_config load_libs)
 {
     /* Check extension and issue non-fatal warning. */
     check_and_warn_extension(file_path);
 
-    /* Initialize symbol table with initial size of 128. */
-    symbol_table = ht_create(128);
+    /* Initialize symbol table. */
+    symbol_table = ht_create(SYMBOL_TABLE_INITIAL_CAPACITY);
     /* Initialize default ports. */
     init_default_ports();
     /* Initialize global singleton objects, nil, #t, #f, and EOF. */
@@ -110,21 +72,26 @@ int run_file_script(const char *file_path, const lib_load_config load_libs)
     init_special_forms();
     /* Loads the CLI-specified libraries into the environment. */
     load_initial_libraries(e, load_libs);
+    /* Evaluate any user preludes. */
+    load_preludes(e);
 
-    const char* input = read_file_to_string(file_path);
-    if (input == NULL) {
+    file_map_t source;
+    if (!file_map_open(file_path, &source)) {
+        perror("Error opening file");
         fprintf(stderr, "Fatal: could not open and read '%s'.\n", file_path);
         exit(EXIT_FAILURE);
     }
 
-    TokenArray* ta = scan_all_tokens(input);
-    const Cell* result = parse_all_expressions(e, ta, false);
+    fold_stats.folds = 0;
+    const Cell* result = eval_source(e, source.data);
+    file_map_close(&source);
+    fold_stats_report(file_path);
 
-    if (result->type == CELL_INTEGER) {
-        exit((int)result->integer_v);
+    if (cell_type(result) == CELL_INTEGER) {
+        exit((int)cell_int(result));
     }
 
-    if (result->type == CELL_ERROR) {
+    if (cell_type(result) == CELL_ERROR) {
         fprintf(stderr, "%s\n", cell_to_string(result, MODE_REPL));
         exit(EXIT_FAILURE);
     }
@@ -133,27 +100,93 @@ int run_file_script(const char *file_path, const lib_load_config load_libs)
 }
 
 
-Cell* parse_all_expressions(Lex* e, TokenArray* ta, const bool is_repl)
+/* Fold the constants in an expanded expression, then analyze
+ * or compile, and evaluate it. */
+static Cell* eval_expanded(Lex* e, Cell* expression)
+{
+    if (cell_type(expression) == CELL_SEXPR) {
+        expression = fold_constants(expression, e);
+    }
+    return coz_engine == ENGINE_VM
+        ? vm_run(e, compile(expression, e))
+        : coz_exec(e, analyze(expression, e));
+}
+
+
+/* Read and expand every expression in source. Returns null if
+ * there is an error in any of them. */
+static Cell* read_expanded(const char* source)
 {
-    /* Parse the token array and get each parsed expression. */
-    while (ta->position <= ta->count) {
-        Cell* expression = parse_tokens(ta);
+    Reader r;
+    init_reader(&r, source);
+    Cell* forms = make_cell_sexpr();
+    Cell* expression;
+    while ((expression = read_datum(&r))) {
+        if (cell_type(expression) == CELL_SEXPR) {
+            expression = expand(expression);
+        }
+        if (cell_type(expression) == CELL_ERROR) {
+            return nullptr;
+        }
+        cell_add(forms, expression);
+    }
+    return forms;
+}
+
+
+/* Evaluate the expressions in the source of a file, in turn. Their expanded
+ * forms are taken from the code cache if it holds them, and put in it if not.
+ * A source with a syntax error is not cached, and is evaluated as a stream up
+ * to the error. */
+Cell* eval_source(Lex* e, const char* source)
+{
+    Cell* forms = fasl_cache_load(source);
+    if (!forms && !fasl_cache.disabled) {
+        forms = read_expanded(source);
+        if (forms) {
+            fasl_cache_store(source, forms);
+        }
+    }
+    if (!forms) {
+        Reader r;
+        init_reader(&r, source);
+        return parse_all_expressions(e, &r, false);
+    }
+
+    for (int i = 0; i < forms->count; i++) {
+        const Cell* result = eval_expanded(e, forms->cell[i]);
+        if (!result) {
+            printf("EVAL RETURNED NULL!!!!");
+            break;
+        }
+        if (cell_type(result) == CELL_ERROR) {
+            return (Cell*)result;
+        }
+    }
+    return make_cell_integer(0);
+}
+
+
+Cell* parse_all_expressions(Lex* e, Reader* r, const bool is_repl)
+{
+    /* Read, then evaluate, one expression at a time. */
+    for (;;) {
+        Cell* expression = read_datum(r);
         if (!expression) {
             break;
         }
 
         /* Kick all S-expressions off to the transformer. */
-        if (expression->type == CELL_SEXPR) {
+        if (cell_type(expression) == CELL_SEXPR) {
             expression = expand(expression);
         }
 
         /* Raise error if generated in parsing or transforming. */
-        if (expression->type == CELL_ERROR) {
+        if (cell_type(expression) == CELL_ERROR) {
             return expression;
         }
 
-        /* Evaluate the expression. */
-        Cell* result = coz_eval(e, expression);
+        Cell* result = eval_expanded(e, expression);
 
         /* Want to try to eliminate these 'legitimate' null returns,
          * and make sure they're replaced with USP_Obj. */
@@ -162,16 +195,13 @@ Cell* parse_all_expressions(Lex* e, TokenArray* ta, const bool is_repl)
             break;
         }
 
-        if (result->type == CELL_ERROR) {
+        if (cell_type(result) == CELL_ERROR) {
             return result;
         }
 
         if (is_repl) {
             coz_print(result);
         }
-
-        /* Bump the token position. */
-        ta->position++;
     }
     /* No more expressions... */
     /* return null to get new REPL prompt. */
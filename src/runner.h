@@ -21,11 +21,11 @@
 #define COZENAGE_RUNNER_H
 
 #include "config.h"
-#include "lexer.h"
+#include "parser.h"
 
 
 int run_file_script(const char *file_path, lib_load_config load_libs);
-Cell* parse_all_expressions(Lex* e, TokenArray* ta, bool is_repl);
-char* read_file_to_string(const char* filename);
+Cell* parse_all_expressions(Lex* e, Reader* r, bool is_repl);
+Cell* eval_source(Lex* e, const char* source);
 
 #endif //COZENAGE_RUNNER_H
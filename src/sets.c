@@ -24,25 +24,14 @@
 #include "repr.h"
 
 #include <gc/gc.h>
-#include <string.h>
 
 
 /* Helper for fast copy of hash table structure. */
 Cell* copy_hash_table(const Cell* t)
 {
-    const uint32_t type = t->type;
-
-    const size_t cap = t->table->capacity;
     Cell* r = GC_MALLOC(sizeof(Cell));
-    r->type = type;
-    r->table = GC_MALLOC(sizeof(ght_table));
-    r->table->count = t->table->count;
-    r->table->capacity = t->table->capacity;
-    r->table->items = GC_MALLOC(sizeof(ght_item) * cap);
-
-    memcpy(r->table->items, t->table->items,
-        sizeof(ght_item) * t->table->capacity);
-
+    r->type = cell_type(t);
+    r->table = ght_copy(t->table);
     return r;
 }
 
@@ -50,10 +39,7 @@ Cell* copy_hash_table(const Cell* t)
 /* Helper for clearing hash table items. */
 Cell* clear_hash_table(Cell* t)
 {
-    t->table->count = 0;
-    t->table->capacity = 8; /* Default initial capacity. */
-    GC_FREE(t->table->items);
-    t->table->items = GC_MALLOC(sizeof(ght_item) * t->table->capacity);
+    ght_clear(t->table);
     return t;
 }
 
@@ -77,7 +63,7 @@ Cell* map_logic(const Cell* proc, const Cell* h_table, const Lex* e, const bool
                       coz_apply_and_get_val(proc, make_sexpr_len1(it.value), e);
         }
 
-        if (val && val->type == CELL_ERROR) return val;
+        if (val && cell_type(val) == CELL_ERROR) return val;
         if (ret_res) {
             /* Ignore unspecified results. */
             if (val == USP_Obj) continue;
@@ -106,7 +92,7 @@ Cell* builtin_set(const Lex* e, const Cell* a)
         if (!cell_is_hashable(a->cell[i])) {
             return make_cell_error(
             fmt_err("set: arg type '%s' is not a hashable",
-            cell_type_name(a->cell[i]->type)),
+            cell_type_name(cell_type(a->cell[i]))),
             TYPE_ERR);
         }
         cell_add(tmp, a->cell[i]);
@@ -124,7 +110,7 @@ Cell* builtin_set_copy(const Lex* e, const Cell* a)
     Cell* err = CHECK_ARITY_EXACT(a, 1, "set-copy");
     if (err) return err;
     const Cell* set = a->cell[0];
-    if (set->type != CELL_SET) {
+    if (cell_type(set) != CELL_SET) {
         return make_cell_error(
             "set-copy: arg must be a set",
             TYPE_ERR);
@@ -143,7 +129,7 @@ Cell* builtin_set_clear(const Lex* e, const Cell* a)
     if (err) return err;
 
     Cell* set = a->cell[0];
-    if (set->type != CELL_SET) {
+    if (cell_type(set) != CELL_SET) {
         return make_cell_error(
             "set-clear!: arg must be a set",
             TYPE_ERR);
@@ -163,7 +149,7 @@ Cell* builtin_set_add(const Lex* e, const Cell* a)
     if (err) return err;
 
     Cell* set = a->cell[0];
-    if (set->type != CELL_SET) {
+    if (cell_type(set) != CELL_SET) {
         return make_cell_error(
             "set-add!: arg1 must be a set",
             TYPE_ERR);
@@ -171,24 +157,24 @@ Cell* builtin_set_add(const Lex* e, const Cell* a)
 
     for (int i = 1; i < a->count; i++) {
         Cell* arg = a->cell[i];
-        if (arg->type == CELL_VECTOR) {
+        if (cell_type(arg) == CELL_VECTOR) {
             for (int j = 0; j < arg->count; j++) {
                 Cell* varg = arg->cell[j];
                 if (!cell_is_hashable(varg)) {
                     return make_cell_error(
                         fmt_err("set-add!: arg type '%s' is not a hashable",
-                            cell_type_name(varg->type)),
+                            cell_type_name(cell_type(varg))),
                         TYPE_ERR);
                 }
                 ght_set(set->table, varg, True_Obj);
             }
-        } else if (arg->type == CELL_PAIR) {
+        } else if (cell_type(arg) == CELL_PAIR) {
             const Cell* p = arg;
             while (p->cdr) {
                 if (!cell_is_hashable(p->car)) {
                     return make_cell_error(
                         fmt_err("set-add!: arg type '%s' is not a hashable",
-                            cell_type_name(p->car->type)),
+                            cell_type_name(cell_type(p->car))),
                         TYPE_ERR);
                 }
                 ght_set(set->table, p->car, True_Obj);
@@ -199,7 +185,7 @@ Cell* builtin_set_add(const Lex* e, const Cell* a)
             if (!cell_is_hashable(arg)) {
                 return make_cell_error(
                     fmt_err("set-add!: arg type '%s' is not a hashable",
-                        cell_type_name(arg->type)),
+                        cell_type_name(cell_type(arg))),
                     TYPE_ERR);
             }
             ght_set(set->table, arg, True_Obj);
@@ -221,7 +207,7 @@ Cell* builtin_set_remove(const Lex* e, const Cell* a)
     if (err) return err;
 
     Cell* set = a->cell[0];
-    if (set->type != CELL_SET) {
+    if (cell_type(set) != CELL_SET) {
         return make_cell_error(
             "set-remove!: arg 1 must be a set",
             TYPE_ERR);
@@ -234,7 +220,7 @@ Cell* builtin_set_remove(const Lex* e, const Cell* a)
             "set-remove!: arg 2 not member of set",
             INDEX_ERR);
     }
-    if (a->count == 3 && a->cell[2]->type != CELL_SYMBOL) {
+    if (a->count == 3 && cell_type(a->cell[2]) != CELL_SYMBOL) {
         return make_cell_error(
             "set-remove!: arg 3 must be a symbol",
             INDEX_ERR);
@@ -251,7 +237,7 @@ Cell* builtin_set_member(const Lex* e, const Cell* a)
     Cell* err = CHECK_ARITY_EXACT(a, 2, "set-member?");
     if (err) return err;
     const Cell* set = a->cell[0];
-    if (set->type != CELL_SET) {
+    if (cell_type(set) != CELL_SET) {
         return make_cell_error(
             "set-member?: arg 1 must be a set",
             TYPE_ERR);
@@ -547,12 +533,12 @@ Cell* builtin_set_map(const Lex* e, const Cell* a)
     const Cell* proc = a->cell[0];
     const Cell* set = a->cell[1];
 
-    if (proc->type != CELL_PROC) {
+    if (cell_type(proc) != CELL_PROC) {
         return make_cell_error(
             "set-map: arg1 must be a procedure",
             TYPE_ERR);
     }
-    if (set->type != CELL_SET) {
+    if (cell_type(set) != CELL_SET) {
         return make_cell_error(
             "set-map: arg2 must be a set",
             TYPE_ERR);
@@ -573,12 +559,12 @@ Cell* builtin_set_foreach(const Lex* e, const Cell* a)
     const Cell* proc = a->cell[0];
     const Cell* set = a->cell[1];
 
-    if (proc->type != CELL_PROC) {
+    if (cell_type(proc) != CELL_PROC) {
         return make_cell_error(
             "set-foreach: arg1 must be a procedure",
             TYPE_ERR);
     }
-    if (set->type != CELL_SET) {
+    if (cell_type(set) != CELL_SET) {
         return make_cell_error(
             "set-foreach: arg2 must be a set",
             TYPE_ERR);
@@ -594,7 +580,7 @@ Cell* builtin_list_to_set(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "list->set");
     if (err) return err;
-    if (a->cell[0]->type != CELL_PAIR || a->cell[0]->count == -1) {
+    if (cell_type(a->cell[0]) != CELL_PAIR || a->cell[0]->count == -1) {
         return make_cell_error(
             "list->set: arg must be a proper list",
             TYPE_ERR);
@@ -611,7 +597,7 @@ Cell* builtin_set_to_list(const Lex* e, const Cell* a)
     Cell* err = CHECK_ARITY_EXACT(a, 1, "set->list");
     if (err) return err;
     const Cell* set = a->cell[0];
-    if (set->type != CELL_SET) {
+    if (cell_type(set) != CELL_SET) {
         return make_cell_error(
             "set->list: arg must be a set",
             TYPE_ERR);
@@ -19,8 +19,10 @@
 
 #include "special_forms.h"
 #include "eval.h"
+#include "analyzer.h"
 #include "types.h"
 #include "symbols.h"
+#include "fold.h"
 #include "repr.h"
 #include "load_library.h"
 #include "line_edit.h"
@@ -46,7 +48,7 @@ extern int is_repl;
 int is_syntactic_keyword(const Cell* s)
 {
     /* Primitive and derived syntax keyword symbols have SF_ID > 0. */
-    if (s->type == CELL_SYMBOL && s->sf_id > 0) {
+    if (cell_type(s) == CELL_SYMBOL && s->sf_id > 0) {
         return 1;
     }
     return 0;
@@ -54,15 +56,19 @@ int is_syntactic_keyword(const Cell* s)
 
 
 /* This function binds formals to argument values in a local
- * environment. It is called when needed from coz_apply(). */
-Lex* build_lambda_env(const Lex* env, Cell* formals, Cell* args)
+ * environment. It is called when needed from coz_apply(). If
+ * 'pooled' is set the frame comes from the frame pool, and the
+ * caller must release it when the body returns. */
+Lex* build_lambda_env(const Lex* env, Cell* formals, Cell* args, const bool pooled)
 {
     /* Create a new child environment. */
-    Lex* local_env = new_child_env(env);
+    Lex* local_env = pooled
+        ? lex_acquire_frame(env, cell_type(formals) == CELL_SYMBOL ? 1 : formals->count)
+        : new_child_env(env);
 
     /* Bind formals to arguments. */
     /* Fully variadic (lambda args ...) */
-    if (formals->type == CELL_SYMBOL) {
+    if (cell_type(formals) == CELL_SYMBOL) {
         const Cell* arg_list = make_list_from_sexpr(args);
         lex_put_local(local_env, formals, arg_list);
         return local_env;
@@ -73,7 +79,7 @@ Lex* build_lambda_env(const Lex* env, Cell* formals, Cell* args)
     int arg_idx = 0;
 
     /* Iterate through positional arguments. */
-    while (lf->type == CELL_PAIR) {
+    while (cell_type(lf) == CELL_PAIR) {
         if (arg_idx >= args->count) {
             fprintf(stderr, "lambda: Arity error: wrong number of args for lambda call\n");
             return nullptr;
@@ -87,13 +93,13 @@ Lex* build_lambda_env(const Lex* env, Cell* formals, Cell* args)
     }
 
     /* Check what's at the end of the formal list. */
-    if (lf->type == CELL_NIL) {
+    if (cell_type(lf) == CELL_NIL) {
         if (arg_idx != args->count) {
             /* Too many arguments supplied for a non-variadic lambda. */
             fprintf(stderr, "lambda: Arity error: too many args for lambda call\n");
             return nullptr;
         }
-    } else if (lf->type == CELL_SYMBOL) {
+    } else if (cell_type(lf) == CELL_SYMBOL) {
         /* Dotted-tail: this is the 'rest' parameter. */
         Cell* rest = make_cell_sexpr();
         for (int i = arg_idx; i < args->count; i++) {
@@ -109,26 +115,6 @@ Lex* build_lambda_env(const Lex* env, Cell* formals, Cell* args)
 }
 
 
-/* Searches the local environment chain and returns the specific frame
- * where 'sym' is bound. Returns NULL if not found in any local frame. */
-static Ch_Env* lex_find_local_frame(const Lex* e, const char* sym)
-{
-    if (!e) return nullptr;
-
-    Ch_Env* current_frame = e->local;
-    while (current_frame != nullptr) {
-        for (int i = 0; i < current_frame->count; i++) {
-            if (strcmp(current_frame->syms[i], sym) == 0) {
-                /* Found it! Return a pointer to this frame. */
-                return current_frame;
-            }
-        }
-        current_frame = current_frame->parent;
-    }
-    /* Not found in any local frame. */
-    return nullptr;
-}
-
 /* These two functions are helpers that build the appropriate
  * return values (final result, or tail call) for code clarity
  * in the sf_* functions below. */
@@ -176,29 +162,29 @@ HandlerResult sf_define(Lex* e, Cell* a)
     }
 
     /* (define <symbol> <expr>) */
-    if (target->type == CELL_SYMBOL) {
+    if (cell_type(target) == CELL_SYMBOL) {
         Cell* val = coz_eval(e, a->cell[1]);
         /* Bail out if error encountered during evaluation. */
-        if (val->type == CELL_ERROR) {
+        if (cell_type(val) == CELL_ERROR) {
             return return_val(val);
         }
         /* Grab the name for the un-sugared define lambda. */
-        if (val->type == CELL_PROC) {
+        if (cell_type(val) == CELL_PROC && !val->is_builtin) {
             val->lambda->l_name = target->sym;
         }
         lex_put_global(e, target, val);
 
         /* For lambdas, return the lambda for REPL pretty-print.
          * For variable bindings, return the bound symbol. */
-        if (val->type == CELL_PROC) {
+        if (cell_type(val) == CELL_PROC) {
             return return_val(val);
         }
         return return_val(target);
     }
 
     /* (define (<f-name> <args>) <body>) */
-    if (target->type == CELL_SEXPR && target->count > 0 &&
-        target->cell[0]->type == CELL_SYMBOL) {
+    if (cell_type(target) == CELL_SEXPR && target->count > 0 &&
+        cell_type(target->cell[0]) == CELL_SYMBOL) {
 
         /* First element is function name. */
         const Cell* fname = target->cell[0];
@@ -206,7 +192,7 @@ HandlerResult sf_define(Lex* e, Cell* a)
         /* Rest are formal args. */
         Cell* formals = make_cell_sexpr();
         for (int i = 1; i < target->count; i++) {
-            if (target->cell[i]->type != CELL_SYMBOL) {
+            if (cell_type(target->cell[i]) != CELL_SYMBOL) {
                 Cell* err = make_cell_error(
                     "lambda: formals must be symbols",
                     TYPE_ERR);
@@ -218,6 +204,7 @@ HandlerResult sf_define(Lex* e, Cell* a)
         /* Build lambda with args + body. */
         Cell* body = a->cell[1];
         Cell* lam = lex_make_named_lambda(fname->sym, formals, body, e);
+        lam->lambda->code = analyze(body, scope_for_formals(e, formals));
 
         lex_put_global(e, fname, lam);
         return return_val(lam);
@@ -271,9 +258,9 @@ HandlerResult sf_lambda(Lex* e, Cell* a)
     Cell* body = a->cell[1];      /* remaining args */
 
     /* Formals should be a symbol or list of symbols. */
-    if (formals->type != CELL_SYMBOL) {
+    if (cell_type(formals) != CELL_SYMBOL) {
         for (int i = 0; i < formals->count; i++) {
-            if (formals->cell[i]->type != CELL_SYMBOL) {
+            if (cell_type(formals->cell[i]) != CELL_SYMBOL) {
                 Cell* err = make_cell_error(
                     "lambda: formals must be symbols",
                     TYPE_ERR);
@@ -284,6 +271,7 @@ HandlerResult sf_lambda(Lex* e, Cell* a)
 
     /* Build the lambda cell. */
     Cell* lambda = lex_make_lambda(formals, body, e);
+    lambda->lambda->code = analyze(body, scope_for_formals(e, formals));
     return return_val(lambda);
 }
 
@@ -300,12 +288,12 @@ HandlerResult sf_if(Lex* e, Cell* a)
     }
 
     Cell* test = coz_eval(e, a->cell[first]);
-    if (test->type == CELL_ERROR) {
+    if (cell_type(test) == CELL_ERROR) {
         return return_val(test);
     }
 
     /* Check if the result is TRUTHY */
-    if (!(test->type == CELL_BOOLEAN && test->boolean_v == 0)) {
+    if (!(cell_type(test) == CELL_BOOLEAN && test->boolean_v == 0)) {
         /* Test was true, so evaluate the consequent as a tail call. */
         return continue_with(a->cell[second], e);
     }
@@ -330,7 +318,7 @@ HandlerResult sf_if(Lex* e, Cell* a)
 HandlerResult sf_import(Lex* e, Cell* a)
 {
     Cell* import_set = make_cell_sexpr();
-    import_set->cell = GC_MALLOC(sizeof(Cell*) * a->count);
+    cell_reserve(import_set, a->count);
     /* Make a new sexpr which contains pairs of (library . name), */
     int i;
     for (i = 0; i < a->count; i++) {
@@ -389,7 +377,7 @@ HandlerResult sf_let(Lex* e, Cell* a) {
     }
 
     const Cell* bindings = a->cell[0];
-    if (bindings->type != CELL_SEXPR) {
+    if (cell_type(bindings) != CELL_SEXPR) {
         return return_val(make_cell_error(
             "let: Bindings must be a list",
             VALUE_ERR));
@@ -399,7 +387,7 @@ HandlerResult sf_let(Lex* e, Cell* a) {
     Lex* local_env = new_child_env(e);
     for (int i = 0; i < bindings->count; i++) {
         const Cell* b = bindings->cell[i];
-        if (b->type != CELL_SEXPR) {
+        if (cell_type(b) != CELL_SEXPR) {
             Cell* err = make_cell_error(
                 "let: Bindings must be a list",
                 VALUE_ERR);
@@ -411,7 +399,7 @@ HandlerResult sf_let(Lex* e, Cell* a) {
                 VALUE_ERR);
             return (HandlerResult) { .action = ACTION_RETURN, .value = err };
         }
-        if (b->cell[0]->type != CELL_SYMBOL) {
+        if (cell_type(b->cell[0]) != CELL_SYMBOL) {
             Cell* err = make_cell_error(
                 "let: first value in binding must be a symbol",
                 VALUE_ERR);
@@ -420,7 +408,7 @@ HandlerResult sf_let(Lex* e, Cell* a) {
 
         /* Evaluate the value in the parent environment. */
         Cell* val = coz_eval(e, b->cell[1]);
-        if (val->type == CELL_ERROR) return return_val(val);
+        if (cell_type(val) == CELL_ERROR) return return_val(val);
 
         lex_put_local(local_env, b->cell[0], val);
     }
@@ -433,7 +421,7 @@ HandlerResult sf_let(Lex* e, Cell* a) {
     /* Eval all but last body expression in local_env. */
     for (int i = 1; i < a->count - 1; i++) {
         Cell* res = coz_eval(local_env, a->cell[i]);
-        if (res->type == CELL_ERROR) return return_val(res);
+        if (cell_type(res) == CELL_ERROR) return return_val(res);
     }
 
     /* Tail call the last expression. */
@@ -463,7 +451,7 @@ HandlerResult sf_letrec(Lex* e, Cell* a)
         SYNTAX_ERR));
 
     const Cell* bindings = a->cell[0];
-    if (bindings->type != CELL_SEXPR) {
+    if (cell_type(bindings) != CELL_SEXPR) {
         return return_val(make_cell_error(
             "letrec: Bindings must be a list",
             VALUE_ERR));
@@ -483,7 +471,7 @@ HandlerResult sf_letrec(Lex* e, Cell* a)
         Cell* local_bind = bindings->cell[i]->cell[1];
         Cell* init_exp = coz_eval(local_env, local_bind);
 
-        if (init_exp->type == CELL_ERROR) return return_val(init_exp);
+        if (cell_type(init_exp) == CELL_ERROR) return return_val(init_exp);
         lex_put_local(local_env, variable, init_exp);
     }
 
@@ -495,7 +483,7 @@ HandlerResult sf_letrec(Lex* e, Cell* a)
     /* * Iterate over all but last body expression. */
     for (int i = 1; i < a->count - 1; i++) {
         Cell* result = coz_eval(local_env, a->cell[i]);
-        if (result->type == CELL_ERROR) return return_val(result);
+        if (cell_type(result) == CELL_ERROR) return return_val(result);
     }
 
     /* Tail call the last expression. */
@@ -513,47 +501,28 @@ HandlerResult sf_set_bang(Lex* e, Cell* a)
     if (err) return (HandlerResult){ .action = ACTION_RETURN, .value = err };
 
     const Cell* variable = a->cell[first];
-    if (variable->type != CELL_SYMBOL) {
+    if (cell_type(variable) != CELL_SYMBOL) {
         err = make_cell_error("set!: arg1 must be a symbol", TYPE_ERR);
         return (HandlerResult) { .action = ACTION_RETURN, .value = err };
     }
 
-    const char* sym_to_set = a->cell[0]->sym;
     Cell* value_to_set = coz_eval(e, a->cell[1]);
+    if (cell_type(value_to_set) == CELL_ERROR) {
+        return (HandlerResult) { .action = ACTION_RETURN, .value = value_to_set };
+    }
 
-    /* First, try to find the variable in the local environment chain. */
-    const Ch_Env* target_frame = lex_find_local_frame(e, sym_to_set);
-
-    if (target_frame != nullptr) {
-        /* We found the correct frame, now find the variable again in *this specific frame*
-         * and update its value directly. */
-        for (int i = 0; i < target_frame->count; i++) {
-            if (strcmp(target_frame->syms[i], sym_to_set) == 0) {
-                target_frame->vals[i] = value_to_set;
-                /* R7RS says the return from set! is unspecified.
-                 * Cozenage will return the value set, for visual
-                 * feedback that the operation was successful (REPL-only). */
-                if (is_repl) {
-                    fprintf(stderr, "%s\n", cell_to_string(value_to_set, MODE_REPL));
-                }
-                return (HandlerResult) { .action = ACTION_RETURN, .value = USP_Obj };
-            }
-        }
-    } else {
-        /* The variable was not in any local frame. Check global.
-         * Use ht_get to see if it *exists* before we set it. */
-        if (ht_get(e->global, sym_to_set)) {
-            /* It exists globally, so update it in the hash table. */
-            ht_set(e->global, sym_to_set, value_to_set);
-            if (is_repl) {
-                fprintf(stderr, "%s\n", cell_to_string(value_to_set, MODE_REPL));
-            }
-            return (HandlerResult) { .action = ACTION_RETURN, .value = USP_Obj };
+    if (lex_set(e, variable, value_to_set)) {
+        /* R7RS says the return from set! is unspecified.
+         * Cozenage will return the value set, for visual
+         * feedback that the operation was successful (REPL-only). */
+        if (is_repl) {
+            fprintf(stderr, "%s\n", cell_to_string(value_to_set, MODE_REPL));
         }
+        return (HandlerResult) { .action = ACTION_RETURN, .value = USP_Obj };
     }
 
     /* The variable was not found anywhere. This is an error. */
-    err = make_cell_error(fmt_err("set!: Unbound symbol: '%s'", sym_to_set), TYPE_ERR);
+    err = make_cell_error(fmt_err("set!: Unbound symbol: '%s'", variable->sym), TYPE_ERR);
     return (HandlerResult) { .action = ACTION_RETURN, .value = err };
 }
 
@@ -575,7 +544,7 @@ HandlerResult sf_begin(Lex* e, Cell* a)
         Cell *result = coz_eval(e, a->cell[i]);
         /* null return will segfault the error check. */
         if (!result) { continue; }
-        if (result->type == CELL_ERROR) {
+        if (cell_type(result) == CELL_ERROR) {
             return return_val(result);
         }
     }
@@ -602,11 +571,11 @@ HandlerResult sf_and(Lex* e, Cell* a) {
         }
 
         Cell* result = coz_eval(e, a->cell[i]);
-        if (result->type == CELL_ERROR)
+        if (cell_type(result) == CELL_ERROR)
             return (HandlerResult){.action = ACTION_RETURN, .value = result};
 
         /* Short-circuit if False. */
-        if (result->type == CELL_BOOLEAN && result->boolean_v == 0) {
+        if (cell_type(result) == CELL_BOOLEAN && result->boolean_v == 0) {
             return (HandlerResult){.action = ACTION_RETURN, .value = False_Obj};
         }
     }
@@ -661,9 +630,9 @@ HandlerResult sf_defmacro(Lex* e, Cell* a) {
     Cell* body = a->cell[2];       /* remaining args */
 
     /* Formals should be a symbol or list of symbols. */
-    if (formals->type != CELL_SYMBOL) {
+    if (cell_type(formals) != CELL_SYMBOL) {
         for (int i = 0; i < formals->count; i++) {
-            if (formals->cell[i]->type != CELL_SYMBOL) {
+            if (cell_type(formals->cell[i]) != CELL_SYMBOL) {
                 Cell* err = make_cell_error(
                     "defmacro: formals must be symbols",
                     TYPE_ERR);
@@ -704,3 +673,24 @@ HandlerResult sf_with_gc_stats(Lex* env, Cell* a) {
 
     return return_val(result);
 }
+
+
+/* (%fold value call op ...)
+ * A call folded in a procedure body by the fold pass. Yields value if each
+ * op is still bound to its builtin, or else runs call in its place. */
+HandlerResult sf_fold(Lex* e, Cell* a)
+{
+    if (a->count < 2) return return_val(make_cell_error(
+        "%fold: expected a value and a call",
+        SYNTAX_ERR));
+
+    for (int i = 2; i < a->count; i++) {
+        const Cell* op = a->cell[i];
+        const builtin_entry* b = cell_type(op) == CELL_SYMBOL ? builtin_lookup(op->sym) : nullptr;
+        const Cell* v = b ? lex_get(e, op) : nullptr;
+        if (!v || cell_type(v) != CELL_PROC || !v->is_builtin || v->builtin != b->func) {
+            return continue_with(a->cell[1], e);
+        }
+    }
+    return return_val(a->cell[0]);
+}
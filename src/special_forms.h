@@ -37,7 +37,7 @@ typedef struct {
 
 
 int is_syntactic_keyword(const Cell* s);
-Lex* build_lambda_env(const Lex* env, Cell* formals, Cell* args);
+Lex* build_lambda_env(const Lex* env, Cell* formals, Cell* args, bool pooled);
 
 
 /* Special form primitives. */
@@ -55,5 +55,6 @@ HandlerResult sf_delay(Lex* e, Cell* a);
 HandlerResult sf_stream(Lex* e, Cell* a);
 HandlerResult sf_defmacro(Lex* e, Cell* a);
 HandlerResult sf_with_gc_stats(Lex* env, Cell* a);
+HandlerResult sf_fold(Lex* e, Cell* a);
 
 #endif //COZENAGE_SPECIAL_FORMS_H
@@ -23,6 +23,7 @@
 #include "repr.h"
 #include "parser.h"
 #include "vectors.h"
+#include "float_io.h"
 
 #include <string.h>
 #include <stdlib.h>
@@ -103,7 +104,7 @@ Cell* builtin_string(const Lex* e, const Cell* a)
     int32_t is_ascii = true;
 
     for (int i = 0; i < char_count; i++) {
-        const int32_t cp = a->cell[i]->char_v;
+        const int32_t cp = cell_char(a->cell[i]);
 
         if (cp >= 0x80) is_ascii = false;
 
@@ -122,6 +123,7 @@ Cell* builtin_string(const Lex* e, const Cell* a)
     v->count = byte_idx;        /* Byte length. */
     v->char_count = char_count; /* Char length (already known). */
     v->ascii = is_ascii;
+    v->hash = 0;
 
     return v;
 }
@@ -134,7 +136,7 @@ Cell* builtin_string_length(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "string-length");
     if (err) return err;
-    if (a->cell[0]->type != CELL_STRING) {
+    if (cell_type(a->cell[0]) != CELL_STRING) {
         return make_cell_error(
             "string-length: arg 1 must be a string",
             TYPE_ERR);
@@ -301,6 +303,7 @@ Cell* builtin_string_append(const Lex* e, const Cell* a)
     v->count = (int)total_bytes;
     v->char_count = (int)total_chars;
     v->ascii = is_ascii;
+    v->hash = 0;
 
     return v;
 }
@@ -317,16 +320,16 @@ Cell* builtin_string_ref(const Lex* e, const Cell* a)
     if (err) return err;
 
     const Cell* s_cell = a->cell[0];
-    if (s_cell->type != CELL_STRING)
+    if (cell_type(s_cell) != CELL_STRING)
         return make_cell_error(
             "string-ref: arg 1 must be a string",
             TYPE_ERR);
-    if (a->cell[1]->type != CELL_INTEGER)
+    if (cell_type(a->cell[1]) != CELL_INTEGER)
         return make_cell_error(
             "string-ref: arg 2 must be an integer",
             TYPE_ERR);
 
-    const int32_t char_idx = (int32_t)a->cell[1]->integer_v;
+    const int32_t char_idx = (int32_t)cell_int(a->cell[1]);
 
     if (char_idx < 0 || char_idx >= s_cell->char_count) {
         return make_cell_error(
@@ -363,24 +366,24 @@ Cell* builtin_make_string(const Lex* e, const Cell* a)
     Cell* err = CHECK_ARITY_RANGE(a, 1, 2, "make-string");
     if (err) return err;
 
-    if (a->cell[0]->type != CELL_INTEGER)
+    if (cell_type(a->cell[0]) != CELL_INTEGER)
         return make_cell_error(
             "make-string: arg 1 must be an integer",
             TYPE_ERR);
 
-    const int32_t char_count = (int32_t)a->cell[0]->integer_v;
+    const int32_t char_count = (int32_t)cell_int(a->cell[0]);
     if (char_count < 0)
         return make_cell_error(
             "make-string: length cannot be negative",
             VALUE_ERR);
 
-    if (a->count == 2 && a->cell[1]->type != CELL_CHAR)
+    if (a->count == 2 && cell_type(a->cell[1]) != CELL_CHAR)
         return make_cell_error(
             "make-string: arg 2 must be a char",
             TYPE_ERR);
 
     /* Default to space (U+0020) if no char provided. */
-    const int32_t fill_cp = (a->count == 2) ? a->cell[1]->char_v : 0x0020;
+    const int32_t fill_cp = (a->count == 2) ? cell_char(a->cell[1]) : 0x0020;
 
     /* Allocate the Cell and the buffer. */
     Cell* v = GC_MALLOC_ATOMIC(sizeof(Cell));
@@ -412,6 +415,7 @@ Cell* builtin_make_string(const Lex* e, const Cell* a)
     v->count = total_bytes;
     v->char_count = char_count;
     v->ascii = is_ascii;
+    v->hash = 0;
 
     return v;
 }
@@ -428,7 +432,7 @@ Cell* builtin_string_list(const Lex* e, const Cell* a)
     if (err) return err;
 
     const Cell* s_cell = a->cell[0];
-    if (s_cell->type != CELL_STRING)
+    if (cell_type(s_cell) != CELL_STRING)
         return make_cell_error(
             "string->list: arg 1 must be a string",
             TYPE_ERR);
@@ -439,18 +443,18 @@ Cell* builtin_string_list(const Lex* e, const Cell* a)
     int32_t end = str_len;
 
     if (a->count >= 2) {
-        if (a->cell[1]->type != CELL_INTEGER)
+        if (cell_type(a->cell[1]) != CELL_INTEGER)
             return make_cell_error(
                 "string->list: start must be an integer",
                 TYPE_ERR);
-        start = (int32_t)a->cell[1]->integer_v;
+        start = (int32_t)cell_int(a->cell[1]);
     }
     if (a->count == 3) {
-        if (a->cell[2]->type != CELL_INTEGER)
+        if (cell_type(a->cell[2]) != CELL_INTEGER)
             return make_cell_error(
                 "string->list: end must be an integer",
                 TYPE_ERR);
-        end = (int32_t)a->cell[2]->integer_v;
+        end = (int32_t)cell_int(a->cell[2]);
     }
 
     if (start < 0 || end > str_len || start > end) {
@@ -482,7 +486,7 @@ Cell* builtin_string_list(const Lex* e, const Cell* a)
         Cell* new_pair = make_cell_pair(make_cell_char((int)cp), make_cell_nil());
         new_pair->len = remaining - i;
 
-        if (head->type == CELL_NIL) {
+        if (cell_type(head) == CELL_NIL) {
             head = new_pair;
             tail = new_pair;
         } else {
@@ -505,7 +509,7 @@ Cell* builtin_list_string(const Lex* e, const Cell* a)
     if (err) return err;
 
     const Cell* l = a->cell[0];
-    if (l->type != CELL_PAIR && l->type != CELL_NIL)
+    if (cell_type(l) != CELL_PAIR && cell_type(l) != CELL_NIL)
         return make_cell_error(
             "list->string: arg must be a list",
             TYPE_ERR);
@@ -516,13 +520,13 @@ Cell* builtin_list_string(const Lex* e, const Cell* a)
     int is_ascii = 1;
     const Cell* curr = l;
 
-    while (curr->type == CELL_PAIR) {
-        if (curr->car->type != CELL_CHAR)
+    while (cell_type(curr) == CELL_PAIR) {
+        if (cell_type(curr->car) != CELL_CHAR)
             return make_cell_error(
                 "list->string: all elements must be chars",
                 TYPE_ERR);
 
-        const uint32_t cp = (uint32_t)curr->car->char_v;
+        const uint32_t cp = (uint32_t)cell_char(curr->car);
         if (cp >= 0x80) is_ascii = 0;
         total_bytes += utf8_code_point_len(cp);
         char_count++;
@@ -534,8 +538,8 @@ Cell* builtin_list_string(const Lex* e, const Cell* a)
     int32_t byte_idx = 0;
     curr = l;
 
-    while (curr->type == CELL_PAIR) {
-        const int32_t cp = curr->car->char_v;
+    while (cell_type(curr) == CELL_PAIR) {
+        const int32_t cp = cell_char(curr->car);
 
         if (cp < 0x80) {
             buffer[byte_idx++] = (char)cp;
@@ -554,6 +558,7 @@ Cell* builtin_list_string(const Lex* e, const Cell* a)
     v->count = total_bytes;
     v->char_count = char_count;
     v->ascii = is_ascii;
+    v->hash = 0;
 
     return v;
 }
@@ -570,19 +575,19 @@ Cell* builtin_substring(const Lex* e, const Cell* a)
     if (err) return err;
 
     const Cell* s_cell = a->cell[0];
-    if (s_cell->type != CELL_STRING)
+    if (cell_type(s_cell) != CELL_STRING)
         return make_cell_error(
             "substring: arg 1 must be a string",
             TYPE_ERR);
 
-    if (a->cell[1]->type != CELL_INTEGER || a->cell[2]->type != CELL_INTEGER) {
+    if (cell_type(a->cell[1]) != CELL_INTEGER || cell_type(a->cell[2]) != CELL_INTEGER) {
         return make_cell_error(
             "substring: start/end args must be integers",
             TYPE_ERR);
     }
 
-    const int32_t start = (int32_t)a->cell[1]->integer_v;
-    const int32_t end   = (int32_t)a->cell[2]->integer_v;
+    const int32_t start = (int32_t)cell_int(a->cell[1]);
+    const int32_t end   = (int32_t)cell_int(a->cell[2]);
 
     /* Bounds validation. */
     if (start < 0 || end > s_cell->char_count || start > end)
@@ -615,6 +620,7 @@ Cell* builtin_substring(const Lex* e, const Cell* a)
     v->count = byte_len;
     v->char_count = end - start;
     v->ascii = s_cell->ascii;
+    v->hash = 0;
 
     /* If the parent wasn't ASCII, the substring MIGHT be ASCII */
     if (!v->ascii) {
@@ -635,21 +641,21 @@ Cell* builtin_string_set_bang(const Lex* e, const Cell* a)
     if (err) return err;
 
     Cell* s_cell = a->cell[0];
-    if (s_cell->type != CELL_STRING)
+    if (cell_type(s_cell) != CELL_STRING)
         return make_cell_error(
             "string-set!: arg 1 must be a string",
             TYPE_ERR);
-    if (a->cell[1]->type != CELL_INTEGER)
+    if (cell_type(a->cell[1]) != CELL_INTEGER)
         return make_cell_error(
             "string-set!: arg 2 must be an integer",
             TYPE_ERR);
-    if (a->cell[2]->type != CELL_CHAR)
+    if (cell_type(a->cell[2]) != CELL_CHAR)
         return make_cell_error(
             "string-set!: arg 3 must be a char",
             TYPE_ERR);
 
-    const int32_t char_idx = (int32_t)a->cell[1]->integer_v;
-    const int32_t new_cp = a->cell[2]->char_v;
+    const int32_t char_idx = (int32_t)cell_int(a->cell[1]);
+    const int32_t new_cp = cell_char(a->cell[2]);
 
     /* Bounds validation. */
     if (char_idx < 0 || char_idx >= s_cell->char_count)
@@ -657,6 +663,9 @@ Cell* builtin_string_set_bang(const Lex* e, const Cell* a)
             "string-set!: index out of range",
             INDEX_ERR);
 
+    /* The text is about to change, so any cached hash is stale. */
+    s_cell->hash = 0;
+
     /* ASCII to ASCII. */
     if (s_cell->ascii && new_cp < 128) {
         s_cell->str[char_idx] = (char)new_cp;
@@ -713,7 +722,7 @@ Cell* builtin_string_copy(const Lex* e, const Cell* a)
     if (err) return err;
 
     const Cell* s_cell = a->cell[0];
-    if (s_cell->type != CELL_STRING)
+    if (cell_type(s_cell) != CELL_STRING)
         return make_cell_error(
             "string-copy: arg 1 must be a string",
             TYPE_ERR);
@@ -723,18 +732,18 @@ Cell* builtin_string_copy(const Lex* e, const Cell* a)
     int32_t end = s_cell->char_count;
 
     if (a->count >= 2) {
-        if (a->cell[1]->type != CELL_INTEGER)
+        if (cell_type(a->cell[1]) != CELL_INTEGER)
             return make_cell_error(
                 "string-copy: arg 2 must be an integer",
                 TYPE_ERR);
-        start = (int32_t)a->cell[1]->integer_v;
+        start = (int32_t)cell_int(a->cell[1]);
     }
     if (a->count == 3) {
-        if (a->cell[2]->type != CELL_INTEGER)
+        if (cell_type(a->cell[2]) != CELL_INTEGER)
             return make_cell_error(
                 "string-copy: arg 3 must be an integer",
                 TYPE_ERR);
-        end = (int32_t)a->cell[2]->integer_v;
+        end = (int32_t)cell_int(a->cell[2]);
     }
 
     /* Validation. */
@@ -753,6 +762,7 @@ Cell* builtin_string_copy(const Lex* e, const Cell* a)
         v->count = s_cell->count;
         v->char_count = s_cell->char_count;
         v->ascii = s_cell->ascii;
+        v->hash = s_cell->hash;
         return v;
     }
 
@@ -772,6 +782,7 @@ Cell* builtin_string_copy(const Lex* e, const Cell* a)
     v->count = byte_len;
     v->char_count = end - start;
     v->ascii = s_cell->ascii;
+    v->hash = 0;
 
     /* Re-verify ASCII only if parent was UTF-8 (slice might be ASCII). */
     if (!v->ascii) {
@@ -799,33 +810,33 @@ Cell* builtin_string_copy_bang(const Lex* e, const Cell* a)
 
     Cell* to_cell = a->cell[0];
     const Cell* from_cell = a->cell[2];
-    if (to_cell->type != CELL_STRING || from_cell->type != CELL_STRING)
+    if (cell_type(to_cell) != CELL_STRING || cell_type(from_cell) != CELL_STRING)
         return make_cell_error(
             "string-copy!: arguments must be strings",
             TYPE_ERR);
 
-    if (a->cell[1]->type != CELL_INTEGER)
+    if (cell_type(a->cell[1]) != CELL_INTEGER)
         return make_cell_error(
             "string-copy!: arg 2 (at) must be an integer",
             TYPE_ERR);
-    const int32_t to_at = (int32_t)a->cell[1]->integer_v;
+    const int32_t to_at = (int32_t)cell_int(a->cell[1]);
 
     int32_t f_start = 0;
     if (a->count >= 4) {
-        if (a->cell[3]->type != CELL_INTEGER)
+        if (cell_type(a->cell[3]) != CELL_INTEGER)
             return make_cell_error(
                 "string-copy!: arg 4 (start) must be an integer",
                 TYPE_ERR);
-        f_start = (int32_t)a->cell[3]->integer_v;
+        f_start = (int32_t)cell_int(a->cell[3]);
     }
 
     int32_t f_end = from_cell->char_count;
     if (a->count == 5) {
-        if (a->cell[4]->type != CELL_INTEGER)
+        if (cell_type(a->cell[4]) != CELL_INTEGER)
             return make_cell_error(
                 "string-copy!: arg 5 (end) must be an integer",
                 TYPE_ERR);
-        f_end = (int32_t)a->cell[4]->integer_v;
+        f_end = (int32_t)cell_int(a->cell[4]);
     }
 
     /* Validation using char_count metadata. */
@@ -844,6 +855,13 @@ Cell* builtin_string_copy_bang(const Lex* e, const Cell* a)
             "string-copy!: target string too small",
             VALUE_ERR);
 
+    /* Nothing to copy. Return before touching the metadata, which may
+     * belong to the immortal empty string. */
+    if (num_chars == 0) return USP_Obj;
+
+    /* The text is about to change, so any cached hash is stale. */
+    to_cell->hash = 0;
+
     /* ASCII to ASCII */
     if (to_cell->ascii && from_cell->ascii) {
         /* No resizing needed, just a memmove (to handle overlap correctly). */
@@ -895,33 +913,40 @@ Cell* builtin_string_fill_bang(const Lex* e, const Cell* a) {
     if (err) return err;
 
     Cell* s = a->cell[0];
-    if (s->type != CELL_STRING) return make_cell_error(
+    if (cell_type(s) != CELL_STRING) return make_cell_error(
         "string-fill!: arg 1 must be string",
         TYPE_ERR);
 
-    if (a->cell[1]->type != CELL_CHAR) {
+    if (cell_type(a->cell[1]) != CELL_CHAR) {
         return make_cell_error(
             "string-fill!: arg 2 must be a character",
             TYPE_ERR);
     }
-    const int32_t fill_char = a->cell[1]->char_v;
+    const int32_t fill_char = cell_char(a->cell[1]);
 
     int32_t start = 0;
     int32_t end = s->char_count;
 
     if (a->count >= 3) {
-        start = (int32_t)a->cell[2]->integer_v;
+        start = (int32_t)cell_int(a->cell[2]);
         if (start < 0 || start > s->char_count) return make_cell_error(
             "string-fill!: start out of bounds",
             INDEX_ERR);
     }
     if (a->count == 4) {
-        end = (int32_t)a->cell[3]->integer_v;
+        end = (int32_t)cell_int(a->cell[3]);
         if (end < start || end > s->char_count) return make_cell_error(
             "string-fill!: end out of bounds",
             INDEX_ERR);
     }
 
+    /* Nothing to fill. Return before touching the metadata, which may
+     * belong to the immortal empty string. */
+    if (start == end) return USP_Obj;
+
+    /* The text is about to change, so any cached hash is stale. */
+    s->hash = 0;
+
     /* Determine fill character properties. */
     uint8_t encoded[4];
     const int32_t char_len = utf8_encode(fill_char, encoded);
@@ -984,7 +1009,7 @@ Cell* builtin_string_number(const Lex* e, const Cell* a)
     if (err) return err;
 
     const Cell* s_cell = a->cell[0];
-    if (s_cell->type != CELL_STRING)
+    if (cell_type(s_cell) != CELL_STRING)
         return make_cell_error(
             "string->number: arg 1 must be a string",
             TYPE_ERR);
@@ -992,11 +1017,11 @@ Cell* builtin_string_number(const Lex* e, const Cell* a)
     /* Validate radix. */
     int radix = 10;
     if (a->count == 2) {
-        if (a->cell[1]->type != CELL_INTEGER)
+        if (cell_type(a->cell[1]) != CELL_INTEGER)
             return make_cell_error(
                 "string->number: radix must be an integer",
                 TYPE_ERR);
-        radix = (int)a->cell[1]->integer_v;
+        radix = (int)cell_int(a->cell[1]);
         if (radix != 2 && radix != 8 && radix != 10 && radix != 16)
             return make_cell_error(
                 "string->number: invalid radix (must be 2, 8, 10, 16)",
@@ -1028,17 +1053,16 @@ Cell* builtin_string_number(const Lex* e, const Cell* a)
     }
 
     /* Use internal lexer/parser */
-    TokenArray* ta = scan_all_tokens(parse_buf);
-    if (!ta) return False_Obj;
-
-    Cell* result = parse_tokens(ta);
+    Reader r;
+    init_reader(&r, parse_buf);
+    Cell* result = read_datum(&r);
 
     /* Validation of result. */
-    if (result->type == CELL_ERROR) return False_Obj;
+    if (!result || cell_type(result) == CELL_ERROR) return False_Obj;
 
     // ReSharper disable once CppVariableCanBeMadeConstexpr
     const int num_mask = CELL_INTEGER|CELL_RATIONAL|CELL_REAL|CELL_COMPLEX;
-    if (!(result->type & num_mask)) return False_Obj;
+    if (!(cell_type(result) & num_mask)) return False_Obj;
 
     return result;
 }
@@ -1071,7 +1095,7 @@ Cell* builtin_number_string(const Lex* e, const Cell* a)
     const Cell* num = a->cell[0];
     // ReSharper disable once CppVariableCanBeMadeConstexpr
     const int num_mask = CELL_INTEGER|CELL_RATIONAL|CELL_REAL|CELL_COMPLEX|CELL_BIGINT;
-    if (!(num->type & num_mask)) {
+    if (!(cell_type(num) & num_mask)) {
         return make_cell_error(
             "number->string: arg 1 must be a number",
             TYPE_ERR);
@@ -1079,11 +1103,11 @@ Cell* builtin_number_string(const Lex* e, const Cell* a)
 
     int radix = 10;
     if (a->count == 2) {
-        if (a->cell[1]->type != CELL_INTEGER)
+        if (cell_type(a->cell[1]) != CELL_INTEGER)
             return make_cell_error(
                 "number->string: radix must be an integer",
                 TYPE_ERR);
-        radix = (int)a->cell[1]->integer_v;
+        radix = (int)cell_int(a->cell[1]);
         if (radix != 2 && radix != 8 && radix != 10 && radix != 16)
             return make_cell_error(
                 "number->string: invalid radix (2, 8, 10, 16)",
@@ -1094,13 +1118,17 @@ Cell* builtin_number_string(const Lex* e, const Cell* a)
     const char* result_str;
 
     /* Handle integers with radix. */
-    if (num->type == CELL_INTEGER && radix != 10) {
+    if (cell_type(num) == CELL_INTEGER && radix != 10) {
         if (radix == 2) {
-            integer_to_binary_string(num->integer_v, buf);
+            integer_to_binary_string(cell_int(num), buf);
         } else {
-            integer_to_oct_or_hex_string(num->integer_v, buf, radix);
+            integer_to_oct_or_hex_string(cell_int(num), buf, radix);
         }
         result_str = buf;
+    } else if (cell_type(num) == CELL_REAL) {
+        /* Display rounds reals to 15 digits; this has to round-trip. */
+        format_real_shortest(buf, num->real_v);
+        result_str = buf;
     } else {
         result_str = cell_to_string(num, MODE_DISPLAY);
     }
@@ -63,6 +63,7 @@ Cell* G_arrow_sym = nullptr;
 Cell* G_else_sym = nullptr;
 Cell* G_defmacro_sym = nullptr;
 Cell* G_debug_sym = nullptr;
+Cell* G_fold_sym = nullptr;
 Cell* G_quasiquote_sym = nullptr;
 Cell* G_unquote_sym = nullptr;
 Cell* G_unquote_splicing_sym = nullptr;
@@ -153,6 +154,10 @@ void init_special_forms(void) {
     G_debug_sym = make_cell_symbol("with-gc-stats");
     G_debug_sym->sf_id = SF_ID_DEBUG;
 
+    /* Guards a call folded in a procedure body (see fold.c). */
+    G_fold_sym = make_cell_symbol("%fold");
+    G_fold_sym->sf_id = SF_ID_FOLD;
+
     /* Not actually special forms - but symbols that should
      * be interned on startup - no SF_IDs */
     G_arrow_sym = make_cell_symbol("=>");
@@ -199,7 +204,7 @@ Cell* builtin_string_to_symbol(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "string->symbol");
     if (err) return err;
-    if (a->cell[0]->type != CELL_STRING) {
+    if (cell_type(a->cell[0]) != CELL_STRING) {
         return make_cell_error(
             "string->symbol: arg 1 must be a string",
             TYPE_ERR);
@@ -216,7 +221,7 @@ Cell* builtin_symbol_to_string(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 1, "symbol->string");
     if (err) return err;
-    if (a->cell[0]->type != CELL_SYMBOL) {
+    if (cell_type(a->cell[0]) != CELL_SYMBOL) {
         return make_cell_error(
             "symbol->string: arg 1 must be a symbol",
             TYPE_ERR);
@@ -43,6 +43,7 @@ typedef enum : int8_t {
     SF_ID_STREAM,
     SF_ID_DEFMACRO,
     SF_ID_DEBUG,
+    SF_ID_FOLD,
     /* These are the SFs implemented as transforms. */
     SF_ID_LET_STAR = 50,
     SF_ID_OR,
@@ -79,13 +80,16 @@ extern Cell* G_arrow_sym;
 extern Cell* G_else_sym;
 extern Cell* G_defmacro_sym;
 extern Cell* G_debug_sym;
+extern Cell* G_fold_sym;
 extern Cell* G_quasiquote_sym;
 extern Cell* G_unquote_sym;
 extern Cell* G_unquote_splicing_sym;
 
 
-/* The global symbol table. */
+/* The global symbol table, and its starting size, which holds the
+ * builtin and special form names with room to spare. */
 extern ht_table* symbol_table;
+#define SYMBOL_TABLE_INITIAL_CAPACITY 1024
 
 /* SF initialization function. */
 void init_special_forms(void);
@@ -58,14 +58,14 @@ static Cell* transform_defines_to_bindings(const Cell* inner_defines) {
            def->cell[1] is either the name OR (name args...). */
         Cell* target = def->cell[1];
 
-        if (target->type == CELL_SYMBOL) {
+        if (cell_type(target) == CELL_SYMBOL) {
             /* Case: (define name value) */
             cell_add(binding_pair, target);
             /* The value is the 3rd element: def->cell[2]
                We expand it in case it's a lambda or has its own inner defines. */
             cell_add(binding_pair, expand(def->cell[2]));
         }
-        else if (target->type == CELL_SEXPR) {
+        else if (cell_type(target) == CELL_SEXPR) {
             /* Case: (define (name args...) body...)
                The name is the first element of the signature S-expr. */
             cell_add(binding_pair, target->cell[0]);
@@ -98,7 +98,7 @@ Cell* expand_body_expressions(const Cell* body_elements, const int start_index)
     /* Collect all leading defines. */
     while (i < body_elements->count) {
         Cell* current = body_elements->cell[i];
-        if (current->type == CELL_SEXPR && current->count > 0 &&
+        if (cell_type(current) == CELL_SEXPR && current->count > 0 &&
             is_same_symbol(current->cell[0], G_define_sym)) {
             cell_add(inner_defines, current);
             i++;
@@ -663,7 +663,7 @@ static Cell* expand_case(const Cell* c) {
     /* Iterate through clauses starting at index 2. */
     for (int i = 2; i < c->count; i++) {
         const Cell* clause = c->cell[i];
-        if (clause->type != CELL_SEXPR || clause->count < 2) continue;
+        if (cell_type(clause) != CELL_SEXPR || clause->count < 2) continue;
 
         Cell* cond_clause = make_cell_sexpr();
         Cell* datalist = clause->cell[0];
@@ -750,7 +750,7 @@ Cell* transform_qq_list_logic(const Cell* input, const int depth) {
     for (int i = 0; i < input->count; i++) {
         const Cell* item = input->cell[i];
 
-        if (item->type == CELL_SEXPR &&
+        if (cell_type(item) == CELL_SEXPR &&
             item->count > 0 &&
             item->cell[0] == G_unquote_splicing_sym &&
             depth == 1) {
@@ -768,7 +768,7 @@ Cell* transform_qq_list_logic(const Cell* input, const int depth) {
 
 
 Cell* transform_qq(const Cell* input, const int depth) {
-    if (input->type == CELL_VECTOR) {
+    if (cell_type(input) == CELL_VECTOR) {
         /* Create an S-expression that will call (list->vector <the_expanded_list>). */
         const Cell* expanded_list = transform_qq_list_logic(input, depth);
         return make_sexpr_len2(
@@ -777,11 +777,11 @@ Cell* transform_qq(const Cell* input, const int depth) {
     }
 
     /* Atoms (non-S-expr) get quoted. */
-    if (input->type != CELL_SEXPR) {
+    if (cell_type(input) != CELL_SEXPR) {
         return make_sexpr_len2(G_quote_sym, input);
     }
 
-    if (input->type == CELL_SEXPR && input->count == 0) {
+    if (cell_type(input) == CELL_SEXPR && input->count == 0) {
         return (Cell*)input;
     }
 
@@ -816,7 +816,7 @@ Cell* transform_qq(const Cell* input, const int depth) {
         const Cell* item = input->cell[i];
 
         /* Check if this specific item is an (unquote-splicing ...) S-expr. */
-        if (item->type == CELL_SEXPR &&
+        if (cell_type(item) == CELL_SEXPR &&
             item->count > 0 &&
             item->cell[0] == G_unquote_splicing_sym &&
             depth == 1) {
@@ -844,13 +844,13 @@ Cell* transform_qq(const Cell* input, const int depth) {
 
 Cell* expand(Cell* c) {
     /* Base case: only S-expressions can be expanded */
-    if (c->type != CELL_SEXPR || c->count == 0) return c;
+    if (cell_type(c) != CELL_SEXPR || c->count == 0) return c;
 
     const Cell* head = c->cell[0];
 
-    if (head->type == CELL_SYMBOL) {
+    if (cell_type(head) == CELL_SYMBOL) {
         /* 'define' - primitive - transform nested 'define's into 'let's. */
-        if (is_same_symbol(head, G_define_sym) && c->count > 2 && c->cell[1]->type == CELL_SEXPR) {
+        if (is_same_symbol(head, G_define_sym) && c->count > 2 && cell_type(c->cell[1]) == CELL_SEXPR) {
             return expand_define(c);
         }
 
@@ -923,7 +923,7 @@ Cell* expand(Cell* c) {
         /* 'let' - primitive - and Named let - derived. */
         if (is_same_symbol(head, G_let_sym)) {
             /* Named let -> letrec. */
-            if (c->count > 1 && c->cell[1]->type == CELL_SYMBOL) {
+            if (c->count > 1 && cell_type(c->cell[1]) == CELL_SYMBOL) {
                 return expand(expand_named_let(c));
             }
             /* Standard let: Primitive. Just expand children. */
@@ -137,13 +137,13 @@ Cell* check_arg_types(const Cell* a, const int mask, const char* fname)
     for (int i = 0; i < a->count; i++) {
         const Cell* arg = a->cell[i];
 
-        /* bitwise AND: if arg->type isn't in mask, it's invalid. */
-        if (!(arg->type & mask)) {
+        /* bitwise AND: if cell_type(arg) isn't in mask, it's invalid. */
+        if (!(cell_type(arg) & mask)) {
             return make_cell_error(
             fmt_err("%s: bad type at arg %d: got %s, expected %s",
                      fname,
                      i+1,
-                     cell_type_name(arg->type),
+                     cell_type_name(cell_type(arg)),
                      cell_mask_types(mask)), TYPE_ERR);
         }
     }
@@ -175,7 +175,7 @@ Cell* check_arg_arity(const Cell* a, const int exact, const int min, const int m
 
 
 int check_lambda_arity(const Cell* proc, const int expected) {
-    if (proc->type != CELL_PROC) return 0;
+    if (cell_type(proc) != CELL_PROC) return 0;
 
     const Cell* formals = proc->lambda->formals;
 
@@ -183,13 +183,13 @@ int check_lambda_arity(const Cell* proc, const int expected) {
     if (formals->count == 0) return 0;
 
     /* If formals is a symbol (variadic), it accepts anything. */
-    if (formals->type == CELL_SYMBOL) return 1;
+    if (cell_type(formals) == CELL_SYMBOL) return 1;
 
     int positional_count = 0;
     bool is_variadic = false;
 
     for (int i = 0; i < formals->count; i++) {
-        if (formals->cell[i]->type == CELL_SYMBOL &&
+        if (cell_type(formals->cell[i]) == CELL_SYMBOL &&
             strcmp(formals->cell[i]->sym, ".") == 0) {
                 is_variadic = true;
                 break;
@@ -215,13 +215,13 @@ int check_lambda_arity(const Cell* proc, const int expected) {
 /* Convertors. */
 static Cell* int_to_rat(const Cell* v)
 {
-    return make_cell_rational(v->integer_v, 1, 0);
+    return make_cell_rational(cell_int(v), 1, 0);
 }
 
 
 static Cell* int_to_real(const Cell* v)
 {
-    return make_cell_real((long double)v->integer_v);
+    return make_cell_real((long double)cell_int(v));
 }
 
 
@@ -249,32 +249,32 @@ void numeric_promote(Cell** lhs, Cell** rhs)
     Cell* a = *lhs;
     Cell* b = *rhs;
 
-    if (a->type == CELL_BIGINT || b->type == CELL_BIGINT) {
-        if (a->type != CELL_BIGINT) {
+    if (cell_type(a) == CELL_BIGINT || cell_type(b) == CELL_BIGINT) {
+        if (cell_type(a) != CELL_BIGINT) {
             a = to_bigint(a);
         }
-        if (b->type != CELL_BIGINT) {
+        if (cell_type(b) != CELL_BIGINT) {
             b = to_bigint(b);
         }
-    } else if (a->type == CELL_COMPLEX || b->type == CELL_COMPLEX) {
-        if (a->type != CELL_COMPLEX) {
+    } else if (cell_type(a) == CELL_COMPLEX || cell_type(b) == CELL_COMPLEX) {
+        if (cell_type(a) != CELL_COMPLEX) {
             a = to_complex(a);
         }
-        if (b->type != CELL_COMPLEX) {
+        if (cell_type(b) != CELL_COMPLEX) {
             b = to_complex(b);
         }
-    } else if (a->type == CELL_REAL || b->type == CELL_REAL) {
-        if (a->type == CELL_INTEGER || a->type == CELL_RATIONAL) {
-            a = a->type == CELL_INTEGER ? int_to_real(a) : rat_to_real(a);
+    } else if (cell_type(a) == CELL_REAL || cell_type(b) == CELL_REAL) {
+        if (cell_type(a) == CELL_INTEGER || cell_type(a) == CELL_RATIONAL) {
+            a = cell_type(a) == CELL_INTEGER ? int_to_real(a) : rat_to_real(a);
         }
-        if (b->type == CELL_INTEGER || b->type == CELL_RATIONAL) {
-            b = b->type == CELL_INTEGER ? int_to_real(b) : rat_to_real(b);
+        if (cell_type(b) == CELL_INTEGER || cell_type(b) == CELL_RATIONAL) {
+            b = cell_type(b) == CELL_INTEGER ? int_to_real(b) : rat_to_real(b);
         }
-    } else if (a->type == CELL_RATIONAL || b->type == CELL_RATIONAL) {
-        if (a->type == CELL_INTEGER) {
+    } else if (cell_type(a) == CELL_RATIONAL || cell_type(b) == CELL_RATIONAL) {
+        if (cell_type(a) == CELL_INTEGER) {
             a = int_to_rat(a);
         }
-        if (b->type == CELL_INTEGER) {
+        if (cell_type(b) == CELL_INTEGER) {
             b = int_to_rat(b);
         }
     }
@@ -292,6 +292,7 @@ Cell* make_sexpr_len1(const Cell* a)
     Cell* v = make_cell_sexpr();
     v->count = 1;
     v->cell = GC_MALLOC(sizeof(Cell*));
+    v->capacity = 1;
     v->cell[0] = cell_copy(a);
     return v;
 }
@@ -303,6 +304,7 @@ Cell* make_sexpr_len2(const Cell* a, const Cell* b)
     Cell* v = make_cell_sexpr();
     v->count = 2;
     v->cell = GC_MALLOC(sizeof(Cell*) * 2);
+    v->capacity = 2;
     v->cell[0] = cell_copy(a);
     v->cell[1] = cell_copy(b);
     return v;
@@ -315,6 +317,7 @@ Cell* make_sexpr_len3(const Cell* a, const Cell* b, const Cell* c)
     Cell* v = make_cell_sexpr();
     v->count = 3;
     v->cell = GC_MALLOC(sizeof(Cell*) * 3);
+    v->capacity = 3;
     v->cell[0] = cell_copy(a);
     v->cell[1] = cell_copy(b);
     v->cell[2] = cell_copy(c);
@@ -328,6 +331,7 @@ Cell* make_sexpr_len4(const Cell* a, const Cell* b, const Cell* c, const Cell* d
     Cell* v = make_cell_sexpr();
     v->count = 4;
     v->cell = GC_MALLOC(sizeof(Cell*) * 4);
+    v->capacity = 4;
     v->cell[0] = cell_copy(a);
     v->cell[1] = cell_copy(b);
     v->cell[2] = cell_copy(c);
@@ -340,15 +344,15 @@ Cell* make_sexpr_len4(const Cell* a, const Cell* b, const Cell* c, const Cell* d
 Cell* make_list_from_sexpr(Cell* c)
 {
 
-    /* Direct-return all the atomic types, and if it's already a list. */
-    if (c->type & (CELL_INTEGER|CELL_REAL|CELL_RATIONAL|CELL_COMPLEX|CELL_PAIR|
-                      CELL_BOOLEAN|CELL_CHAR|CELL_STRING|CELL_NIL|CELL_EOF|
-                      CELL_PROC|CELL_PORT|CELL_ERROR|CELL_SYMBOL)) {
+    /* Only S-expressions are converted, and vectors searched for them.
+     * Direct-return everything else: atoms, lists already built, and
+     * self-contained types such as bigints, bytevectors, sets and hashes. */
+    if (!(cell_type(c) & (CELL_SEXPR|CELL_VECTOR))) {
         return c;
     }
 
     /* Leave the top-level vector be, but convert internal members. */
-    if (c->type == CELL_VECTOR) {
+    if (cell_type(c) == CELL_VECTOR) {
         Cell* result = make_cell_vector();
         for (int i = 0; i < c->count; i++) {
             cell_add(result, make_list_from_sexpr(c->cell[i]));
@@ -360,7 +364,7 @@ Cell* make_list_from_sexpr(Cell* c)
     int dot_pos = -1;
     if (c->count > 1) {
         const Cell* dot_candidate = c->cell[c->count - 2];
-        if (dot_candidate->type == CELL_SYMBOL && strcmp(dot_candidate->sym, ".") == 0) {
+        if (cell_type(dot_candidate) == CELL_SYMBOL && strcmp(dot_candidate->sym, ".") == 0) {
             dot_pos = c->count - 2;
         }
     }
@@ -404,10 +408,10 @@ Cell* make_sexpr_from_list(Cell* v, const bool recurse)
     /* A proper list is the simple case. */
     if (v->len != -1) {
         count = v->len;
-        result->cell = GC_MALLOC(sizeof(Cell*) * count);
+        cell_reserve(result, count);
         const Cell* p = v;
         for (int i = 0; i < count; i++) {
-            if (recurse && p->car->type == CELL_PAIR) {
+            if (recurse && cell_type(p->car) == CELL_PAIR) {
                 cell_add(result, make_sexpr_from_list(p->car, true));
             } else {
                 cell_add(result, p->car);
@@ -422,20 +426,20 @@ Cell* make_sexpr_from_list(Cell* v, const bool recurse)
     const Cell* traverser = v;
 
     /* Count the number of pairs in the chain. */
-    while (traverser != NULL && traverser->type == CELL_PAIR) {
+    while (traverser != NULL && cell_type(traverser) == CELL_PAIR) {
         count++;
         traverser = traverser->cdr;
     }
 
     /* Allocate space for all the cars from the pairs PLUS the final `cdr`. */
-    result->cell = GC_MALLOC(sizeof(Cell*) * (count + 1));
+    cell_reserve(result, count + 1);
 
     /* Copy the car of each pair. */
     Cell* p = v;
     for (int i = 0; i < count; i++) {
         Cell* item = p->car;
 
-        if (recurse && item->type == CELL_PAIR) {
+        if (recurse && cell_type(item) == CELL_PAIR) {
             cell_add(result, make_sexpr_from_list(item, true));
         } else {
             cell_add(result, item);
@@ -446,15 +450,15 @@ Cell* make_sexpr_from_list(Cell* v, const bool recurse)
     /* Handling the tail of an improper list. */
     if (v->len == -1) {
         /* Found a dot. p is the tail. */
-        if (recurse && (p->type == CELL_PAIR || p->type == CELL_SEXPR)) {
+        if (recurse && (cell_type(p) == CELL_PAIR || cell_type(p) == CELL_SEXPR)) {
 
             const int old_count = result->count;
-            const int tail_count = p->type == CELL_SEXPR ? p->count : p->len;
+            const int tail_count = cell_type(p) == CELL_SEXPR ? p->count : p->len;
             const int new_total = old_count + tail_count;
 
-            result->cell = GC_REALLOC(result->cell, sizeof(Cell*) * new_total);
+            cell_reserve(result, new_total);
 
-            if (p->type == CELL_SEXPR) {
+            if (cell_type(p) == CELL_SEXPR) {
                 /* Dissolve the S-expression directly into the result. */
                 for (int i = 0; i < tail_count; i++) {
                     result->cell[old_count + i] = p->cell[i];
@@ -482,6 +486,7 @@ Cell* make_sexpr_from_array(const int count, Cell** cells)
     Cell* v = make_cell_sexpr();
     v->count = count;
     v->cell = GC_MALLOC(sizeof(Cell*) * count);
+    v->capacity = count;
 
     /* Copy each cell pointer from the source array. */
     for (int i = 0; i < count; i++) {
@@ -497,7 +502,7 @@ Cell* flatten_sexpr(const Cell* sexpr)
     int new_count = 0;
     for (int i = 0; i < sexpr->count; i++) {
         const Cell* current_item = sexpr->cell[i];
-        if (current_item->type == CELL_SEXPR) {
+        if (cell_type(current_item) == CELL_SEXPR) {
             /* If the item is an inner s-expr, add the count of its children. */
             new_count += current_item->count;
         } else {
@@ -512,12 +517,13 @@ Cell* flatten_sexpr(const Cell* sexpr)
         return result;
     }
     result->cell = GC_MALLOC(sizeof(Cell*) * new_count);
+    result->capacity = new_count;
 
     /* Populate the new S-expression's cell array. */
     int result_idx = 0;
     for (int i = 0; i < sexpr->count; i++) {
         const Cell* current_item = sexpr->cell[i];
-        if (current_item->type == CELL_SEXPR) {
+        if (cell_type(current_item) == CELL_SEXPR) {
             /* It's an inner s-expr, so copy its children over. */
             for (int j = 0; j < current_item->count; j++) {
                 result->cell[result_idx] = cell_copy(current_item->cell[j]);
@@ -544,14 +550,14 @@ Cell* list_get_nth_cell_ptr(const Cell* list, const long n, const bool tail)
     const Cell* current = list;
     for (long i = 0; i < n; i++) {
         /* Make sure we are still on a pair before trying to get the cdr. */
-        if (current->type != CELL_PAIR) {
+        if (cell_type(current) != CELL_PAIR) {
             return nullptr;
         }
         current = current->cdr;
     }
 
     /* After the loop, `current` is the pair holding our desired element. */
-    if (current->type != CELL_PAIR) {
+    if (cell_type(current) != CELL_PAIR) {
         return nullptr;
     }
     /* If tail=false, the value we want is the CAR of this final pair.
@@ -577,12 +583,12 @@ long double complex cell_to_c_complex(const Cell* c)
 bool cell_is_real_zero(const Cell* c)
 {
     if (!c) return false;
-    switch (c->type) {
+    switch (cell_type(c)) {
         case CELL_BIGINT:
             if (mpz_cmp_si(*c->bi, 0) == 0) return true;
             return false;
         case CELL_INTEGER:
-            return c->integer_v == 0;
+            return cell_int(c) == 0;
         case CELL_RATIONAL:
             /* Assumes simplified rational where numerator would be 0. */
             return c->num == 0;
@@ -604,7 +610,7 @@ bool cell_is_integer(const Cell* c)
         return false;
     }
 
-    switch (c->type) {
+    switch (cell_type(c)) {
         case CELL_INTEGER:
         case CELL_BIGINT:
             return true;
@@ -634,7 +640,7 @@ bool cell_is_real(const Cell* c)
         return false;
     }
 
-    switch (c->type) {
+    switch (cell_type(c)) {
         case CELL_INTEGER:
         case CELL_BIGINT:
         case CELL_RATIONAL:
@@ -655,7 +661,7 @@ bool cell_is_positive(const Cell* c)
 {
     if (!c) return false;
 
-    if (c->type == CELL_BIGINT) {
+    if (cell_type(c) == CELL_BIGINT) {
         return mpz_sgn(*c->bi) == 1 ? true : false;
     }
 
@@ -669,7 +675,7 @@ bool cell_is_negative(const Cell* c)
 {
     if (!c) return false;
 
-    if (c->type == CELL_BIGINT) {
+    if (cell_type(c) == CELL_BIGINT) {
         return mpz_sgn(*c->bi) == -1 ? true : false;
     }
 
@@ -692,14 +698,14 @@ bool cell_is_odd(const Cell* c)
     }
 
     /* Already determined c is an integer represented as a complex. */
-    if (c->type == CELL_COMPLEX) {
+    if (cell_type(c) == CELL_COMPLEX) {
         c = c->real;
     }
 
     long long val;
-    switch (c->type) {
+    switch (cell_type(c)) {
         case CELL_BIGINT: return mpz_odd_p(*c->bi) == 1 ? true : false;
-        case CELL_INTEGER:  val = c->integer_v; break;
+        case CELL_INTEGER:  val = cell_int(c); break;
         case CELL_REAL: val = (long long)c->real_v; break;
         case CELL_RATIONAL:  val = c->num; break; /* Denominator is 1 if it's an integer. */
         default: return false; /* Unreachable. */
@@ -722,14 +728,14 @@ bool cell_is_even(const Cell* c)
     }
 
     /* Already determined c is an integer represented as a complex. */
-    if (c->type == CELL_COMPLEX) {
+    if (cell_type(c) == CELL_COMPLEX) {
         c = c->real;
     }
 
     long long val;
-    switch (c->type) {
+    switch (cell_type(c)) {
         case CELL_BIGINT: return mpz_even_p(*c->bi) == 1 ? true : false;
-        case CELL_INTEGER:  val = c->integer_v; break;
+        case CELL_INTEGER:  val = cell_int(c); break;
         case CELL_REAL: val = (long long)c->real_v; break;
         case CELL_RATIONAL:  val = c->num; break; /* Denominator is 1 if it's an integer. */
         default: return false; /* Unreachable. */
@@ -740,11 +746,11 @@ bool cell_is_even(const Cell* c)
 
 Cell* negate_numeric(const Cell* x)
 {
-    switch (x->type) {
+    switch (cell_type(x)) {
         case CELL_INTEGER:
-            return make_cell_integer(-x->integer_v);
+            return make_cell_integer(-cell_int(x));
         case CELL_RATIONAL:
-            return make_cell_rational(-x->num, x->den, 1);
+            return cell_set_exact(make_cell_rational(-x->num, x->den, 1), cell_exact(x));
         case CELL_REAL:
             return make_cell_real(-x->real_v);
         case CELL_COMPLEX:
@@ -779,7 +785,7 @@ static long int gcd_ll(long int a, long int b)
 /* Simplify rational: reduce to the lowest terms, normalize sign. */
 Cell* simplify_rational(Cell* v)
 {
-    if (v->type != CELL_RATIONAL) {
+    if (cell_type(v) != CELL_RATIONAL) {
         return v; /* Nothing to do. */
     }
 
@@ -891,9 +897,9 @@ void complex_apply(const BuiltinFn fn, const Lex* e, Cell* result, const Cell* r
 /* Helper to convert any real-valued cell to a C long double. */
 long double cell_to_long_double(const Cell* c)
 {
-    switch (c->type) {
+    switch (cell_type(c)) {
         case CELL_INTEGER:
-            return (long double)c->integer_v;
+            return (long double)cell_int(c);
         case CELL_RATIONAL:
             return (long double)c->num / c->den;
         case CELL_REAL:
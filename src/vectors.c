@@ -20,6 +20,7 @@
 #include "vectors.h"
 #include "types.h"
 
+#include <limits.h>
 #include <string.h>
 #include <gc/gc.h>
 #include <unicode/utf8.h>
@@ -40,6 +41,7 @@ Cell* builtin_vector(const Lex* e, const Cell* a)
     }
 
     Cell *vec = make_cell_vector();
+    cell_reserve(vec, a->count);
     for (int i = 0; i < a->count; i++) {
         cell_add(vec, a->cell[i]);
     }
@@ -68,17 +70,17 @@ Cell* builtin_vector_ref(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 2, "vector-ref");
     if (err) return err;
-    if (a->cell[0]->type != CELL_VECTOR) {
+    if (cell_type(a->cell[0]) != CELL_VECTOR) {
         return make_cell_error(
             "vector-ref: arg 1 must be a vector",
             TYPE_ERR);
     }
-    if (a->cell[1]->type != CELL_INTEGER) {
+    if (cell_type(a->cell[1]) != CELL_INTEGER) {
         return make_cell_error(
             "vector-ref: arg 2 must be an exact integer",
             TYPE_ERR);
     }
-    const int i = (int)a->cell[1]->integer_v;
+    const int i = (int)cell_int(a->cell[1]);
 
     if (i >= a->cell[0]->count || i < 0) {
         return make_cell_error(
@@ -98,12 +100,12 @@ Cell* builtin_make_vector(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_RANGE(a, 1, 2, "make-vector");
     if (err) return err;
-    if (a->cell[0]->type != CELL_INTEGER) {
+    if (cell_type(a->cell[0]) != CELL_INTEGER) {
         return make_cell_error(
             "make-vector: arg 1 must be an integer",
             TYPE_ERR);
     }
-    const long long n = a->cell[0]->integer_v;
+    const long long n = cell_int(a->cell[0]);
     /* (make-vector 0) -> #() */
     if (n == 0) {
         return make_cell_vector();
@@ -120,6 +122,7 @@ Cell* builtin_make_vector(const Lex* e, const Cell* a)
         fill = make_cell_integer(0);
     }
     Cell *vec = make_cell_vector();
+    cell_reserve(vec, (int)n);
     for (int i = 0; i < n; i++) {
         cell_add(vec, fill);
     }
@@ -136,22 +139,36 @@ Cell* builtin_list_to_vector(const Lex* e, const Cell* a)
     Cell* err = CHECK_ARITY_EXACT(a, 1, "list->vector");
     if (err) return err;
     /* '() -> #() */
-    if (a->cell[0]->type == CELL_NIL) {
+    if (cell_type(a->cell[0]) == CELL_NIL) {
         return make_cell_vector();
     }
-    if (a->cell[0]->type != CELL_PAIR) {
+    if (cell_type(a->cell[0]) != CELL_PAIR) {
         return make_cell_error(
             "list->vector: arg 1 must be a list",
             TYPE_ERR);
     }
-    const int list_len = a->cell[0]->len;
+    /* Pairs made by cons don't know their list length, so count it. */
+    int list_len = a->cell[0]->len;
     if (list_len == -1) {
-        return make_cell_error(
-            "list->vector: arg 1 must be a proper list",
-            TYPE_ERR);
+        list_len = 0;
+        const Cell* p = a->cell[0];
+        const Cell* slow = p;
+        for (; cell_type(p) == CELL_PAIR; p = p->cdr) {
+            /* slow moves at half speed, and only meets p on a cycle. */
+            if (++list_len % 2 == 0) {
+                slow = slow->cdr;
+                if (slow == p->cdr) break;
+            }
+        }
+        if (cell_type(p) != CELL_NIL) {
+            return make_cell_error(
+                "list->vector: arg 1 must be a proper list",
+                TYPE_ERR);
+        }
     }
     const Cell* lst = a->cell[0];
     Cell *vec = make_cell_vector();
+    cell_reserve(vec, list_len);
     for (int i = 0; i < list_len; i++) {
         cell_add(vec, lst->car);
         lst = lst->cdr;
@@ -170,7 +187,7 @@ Cell* builtin_vector_to_list(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_RANGE(a, 1, 3, "vector->list");
     if (err) return err;
-    if (a->cell[0]->type != CELL_VECTOR) {
+    if (cell_type(a->cell[0]) != CELL_VECTOR) {
         return make_cell_error(
             "vector->list: arg 1 must be a vector",
             TYPE_ERR);
@@ -179,12 +196,12 @@ Cell* builtin_vector_to_list(const Lex* e, const Cell* a)
     int end = a->cell[0]->count;
 
     if (a->count == 2) {
-        if (a->cell[1]->type != CELL_INTEGER) {
+        if (cell_type(a->cell[1]) != CELL_INTEGER) {
             return make_cell_error(
                 "vector->list: arg 2 must be an integer",
                 TYPE_ERR);
         }
-        start = (int)a->cell[1]->integer_v;
+        start = (int)cell_int(a->cell[1]);
         if (start < 0) {
             return make_cell_error(
                 "vector->list: arg 2 must be non-negative",
@@ -193,13 +210,13 @@ Cell* builtin_vector_to_list(const Lex* e, const Cell* a)
     }
 
     if (a->count == 3) {
-        if (a->cell[2]->type != CELL_INTEGER) {
+        if (cell_type(a->cell[2]) != CELL_INTEGER) {
             return make_cell_error(
                 "vector->list: arg 3 must be an integer",
                 TYPE_ERR);
         }
-        start = (int)a->cell[1]->integer_v;
-        end = (int)a->cell[2]->integer_v;
+        start = (int)cell_int(a->cell[1]);
+        end = (int)cell_int(a->cell[2]);
         if (start < 0 || end < 0) {
             return make_cell_error(
                 "vector->list: start/end args must be non-negative",
@@ -232,7 +249,7 @@ Cell* builtin_vector_copy(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_RANGE(a, 1, 3, "vector-copy");
     if (err) return err;
-    if (a->cell[0]->type != CELL_VECTOR) {
+    if (cell_type(a->cell[0]) != CELL_VECTOR) {
         return make_cell_error(
             "vector->copy: arg 1 must be a vector",
             TYPE_ERR);
@@ -241,23 +258,24 @@ Cell* builtin_vector_copy(const Lex* e, const Cell* a)
     int end = a->cell[0]->count;
 
     if (a->count == 2) {
-        if (a->cell[1]->type != CELL_INTEGER) {
+        if (cell_type(a->cell[1]) != CELL_INTEGER) {
             return make_cell_error(
                 "vector-copy: start arg must be an integer",
                 TYPE_ERR);
         }
-        start = (int)a->cell[1]->integer_v;
+        start = (int)cell_int(a->cell[1]);
     }
     if (a->count == 3) {
-        if (a->cell[1]->type != CELL_INTEGER || a->cell[2]->type != CELL_INTEGER) {
+        if (cell_type(a->cell[1]) != CELL_INTEGER || cell_type(a->cell[2]) != CELL_INTEGER) {
             return make_cell_error(
                 "vector-copy: start/end args must be integers",
                 TYPE_ERR);
         }
-        start = (int)a->cell[1]->integer_v;
-        end = (int)a->cell[2]->integer_v;
+        start = (int)cell_int(a->cell[1]);
+        end = (int)cell_int(a->cell[2]);
     }
     Cell* vec = make_cell_vector();
+    cell_reserve(vec, end - start);
     for (int i = start; i < end; i++) {
         cell_add(vec, a->cell[0]->cell[i]);
     }
@@ -275,7 +293,7 @@ Cell* builtin_vector_to_string(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_RANGE(a, 1, 3, "vector->string");
     if (err) return err;
-    if (a->cell[0]->type != CELL_VECTOR) {
+    if (cell_type(a->cell[0]) != CELL_VECTOR) {
         return make_cell_error(
             "vector->string: arg must be a vector",
             TYPE_ERR);
@@ -284,31 +302,31 @@ Cell* builtin_vector_to_string(const Lex* e, const Cell* a)
     int end = a->cell[0]->count;
     char* the_string = GC_MALLOC_ATOMIC(end * 4 + 1);
     if (a->count == 2) {
-        if (a->cell[1]->type != CELL_INTEGER) {
+        if (cell_type(a->cell[1]) != CELL_INTEGER) {
             return make_cell_error(
                 "vector->string: arg2 must be an integer",
                 TYPE_ERR);
         }
-        start = (int)a->cell[1]->integer_v;
+        start = (int)cell_int(a->cell[1]);
     }
     if (a->count == 3) {
-        if (a->cell[1]->type != CELL_INTEGER || a->cell[2]->type != CELL_INTEGER) {
+        if (cell_type(a->cell[1]) != CELL_INTEGER || cell_type(a->cell[2]) != CELL_INTEGER) {
             return make_cell_error(
                 "vector->string: start/end args must be integers",
                 TYPE_ERR);
         }
-        end = (int)a->cell[2]->integer_v;
+        end = (int)cell_int(a->cell[2]);
     }
 
     int32_t j = 0;
     for (int i = start; i < end; i++) {
         const Cell* char_cell = a->cell[0]->cell[i];
-        if (char_cell->type != CELL_CHAR) {
+        if (cell_type(char_cell) != CELL_CHAR) {
             return make_cell_error(
                 "vector->string: vector must have only chars as members",
                 TYPE_ERR);
         }
-        const UChar32 code_point = char_cell->char_v;
+        const UChar32 code_point = cell_char(char_cell);
         U8_APPEND_UNSAFE(the_string, j, code_point);
     }
     the_string[j] = '\0';
@@ -327,7 +345,7 @@ Cell* builtin_string_to_vector(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_RANGE(a, 1, 3, "string->vector");
     if (err) return err;
-    if (a->cell[0]->type != CELL_STRING) {
+    if (cell_type(a->cell[0]) != CELL_STRING) {
         return make_cell_error(
             "string->vector: arg1 must be a string",
             TYPE_ERR);
@@ -341,23 +359,29 @@ Cell* builtin_string_to_vector(const Lex* e, const Cell* a)
     int end_char_idx = -1; /* Use -1 to signify 'to the end'. */
 
     if (a->count >= 2) {
-        if (a->cell[1]->type != CELL_INTEGER) {
+        if (cell_type(a->cell[1]) != CELL_INTEGER) {
             return make_cell_error(
                 "string->vector: arg2 must be an integer",
                 TYPE_ERR);
         }
-        start_char_idx = (int)a->cell[1]->integer_v;
+        start_char_idx = (int)cell_int(a->cell[1]);
     }
     if (a->count == 3) {
-        if (a->cell[2]->type != CELL_INTEGER) {
+        if (cell_type(a->cell[2]) != CELL_INTEGER) {
             return make_cell_error(
                 "string->vector: arg3 must be an integer",
                 TYPE_ERR);
         }
-        end_char_idx = (int)a->cell[2]->integer_v;
+        end_char_idx = (int)cell_int(a->cell[2]);
     }
 
+    /* Size the vector for the whole range up front. */
+    int n_chars = a->cell[0]->char_count;
+    if (end_char_idx != -1 && end_char_idx < n_chars) {
+        n_chars = end_char_idx;
+    }
     Cell* vec = make_cell_vector();
+    cell_reserve(vec, n_chars - start_char_idx);
     int32_t byte_idx = 0;
     int32_t char_idx = 0;
     UChar32 code_point;
@@ -391,18 +415,18 @@ Cell* builtin_vector_set_bang(const Lex* e, const Cell* a)
     (void)e;
     Cell* err = CHECK_ARITY_EXACT(a, 3, "vector-set!");
     if (err) return err;
-    if (a->cell[0]->type != CELL_VECTOR) {
+    if (cell_type(a->cell[0]) != CELL_VECTOR) {
         return make_cell_error(
             "vector-set!: arg must be a vector",
             TYPE_ERR);
     }
-    if (a->cell[1]->type != CELL_INTEGER) {
+    if (cell_type(a->cell[1]) != CELL_INTEGER) {
         return make_cell_error(
             "vector-set!: arg must be an integer",
             TYPE_ERR);
     }
 
-    const long long idx = a->cell[1]->integer_v;
+    const long long idx = cell_int(a->cell[1]);
     const Cell* vec = a->cell[0];
     Cell* obj = a->cell[2];
 
@@ -437,7 +461,12 @@ Cell* builtin_vector_append(const Lex* e, const Cell* a)
     }
 
     /* Deal with multiple args. */
+    int total = 0;
+    for (int i = 0; i < (int)a->count; i++) {
+        total += a->cell[i]->count;
+    }
     Cell* result = make_cell_vector();
+    cell_reserve(result, total);
     /* For each vector argument... */
     for (int i = 0; i < (int)a->count; i++) {
         const Cell* this_vec = a->cell[i];
@@ -462,16 +491,16 @@ Cell* builtin_vector_copy_bang(const Lex* e, const Cell* a)
     Cell* err = CHECK_ARITY_RANGE(a, 3, 5, "vector-copy!");
     if (err) return err;
 
-    if (a->cell[0]->type != CELL_VECTOR)
+    if (cell_type(a->cell[0]) != CELL_VECTOR)
         return make_cell_error("vector-copy!: arg 1 must be a vector (to)", TYPE_ERR);
-    if (a->cell[1]->type != CELL_INTEGER)
+    if (cell_type(a->cell[1]) != CELL_INTEGER)
         return make_cell_error("vector-copy!: arg 2 must be an integer (at)", TYPE_ERR);
-    if (a->cell[2]->type != CELL_VECTOR)
+    if (cell_type(a->cell[2]) != CELL_VECTOR)
         return make_cell_error("vector-copy!: arg 3 must be a vector (from)", TYPE_ERR);
 
     const Cell* to_vec = a->cell[0];
     const int32_t to_vec_len = to_vec->count;
-    const int32_t to_start_idx = (int32_t)a->cell[1]->integer_v;
+    const int32_t to_start_idx = (int32_t)cell_int(a->cell[1]);
 
     const Cell* from_vec = a->cell[2];
     const int32_t from_vec_len = from_vec->count;
@@ -480,18 +509,18 @@ Cell* builtin_vector_copy_bang(const Lex* e, const Cell* a)
     int32_t from_end_idx = from_vec_len;
 
     if (a->count >= 4) {
-        if (a->cell[3]->type != CELL_INTEGER)
+        if (cell_type(a->cell[3]) != CELL_INTEGER)
             return make_cell_error(
                 "vector-copy!: arg 4 must be an integer (start)",
                 TYPE_ERR);
-        from_start_idx = (int32_t)a->cell[3]->integer_v;
+        from_start_idx = (int32_t)cell_int(a->cell[3]);
     }
     if (a->count == 5) {
-        if (a->cell[4]->type != CELL_INTEGER)
+        if (cell_type(a->cell[4]) != CELL_INTEGER)
             return make_cell_error(
                 "vector-copy!: arg 5 must be an integer (end)",
                 TYPE_ERR);
-        from_end_idx = (int32_t)a->cell[4]->integer_v;
+        from_end_idx = (int32_t)cell_int(a->cell[4]);
     }
 
     /* Index and range validation. */
@@ -540,7 +569,7 @@ Cell* builtin_vector_fill_bang(const Lex* e, const Cell* a)
     if (err) return err;
 
     const Cell* vec = a->cell[0];
-    if (vec->type != CELL_VECTOR) {
+    if (cell_type(vec) != CELL_VECTOR) {
         return make_cell_error(
             "vector-fill!: arg 1 must be a vector",
             TYPE_ERR);
@@ -553,12 +582,12 @@ Cell* builtin_vector_fill_bang(const Lex* e, const Cell* a)
 
     /* Validate start. */
     if (a->count >= 3) {
-        if (a->cell[2]->type != CELL_INTEGER)
+        if (cell_type(a->cell[2]) != CELL_INTEGER)
             return make_cell_error(
                 "vector-fill!: start must be an integer",
                 TYPE_ERR);
 
-        start = (int32_t)a->cell[2]->integer_v;
+        start = (int32_t)cell_int(a->cell[2]);
         /* start can be equal to len if end is also len (empty range) */
         if (start < 0 || start > len)
             return make_cell_error(
@@ -568,12 +597,12 @@ Cell* builtin_vector_fill_bang(const Lex* e, const Cell* a)
 
     /* Validate end. */
     if (a->count == 4) {
-        if (a->cell[3]->type != CELL_INTEGER)
+        if (cell_type(a->cell[3]) != CELL_INTEGER)
             return make_cell_error(
                 "vector-fill!: end must be an integer",
                 TYPE_ERR);
 
-        end = (int32_t)a->cell[3]->integer_v;
+        end = (int32_t)cell_int(a->cell[3]);
         if (end < 0 || end > len || end < start)
             return make_cell_error(
                 "vector-fill!: end index out of range",
@@ -587,3 +616,85 @@ Cell* builtin_vector_fill_bang(const Lex* e, const Cell* a)
 
     return USP_Obj;
 }
+
+
+/* (vector-push! vector obj ...)
+ * Appends each obj to the end of vector, in order, increasing its length by the number of objs
+ * given. Room is made geometrically, so that pushing n objects one at a time takes O(n) time
+ * overall. Returns an unspecified value. */
+Cell* builtin_vector_push_bang(const Lex* e, const Cell* a)
+{
+    (void)e;
+    Cell* err = CHECK_ARITY_MIN(a, 2, "vector-push!");
+    if (err) return err;
+    Cell* vec = a->cell[0];
+    if (cell_type(vec) != CELL_VECTOR) {
+        return make_cell_error(
+            "vector-push!: arg 1 must be a vector",
+            TYPE_ERR);
+    }
+    if (a->count > 2) {
+        cell_reserve(vec, vec->count + a->count - 1);
+    }
+    for (int i = 1; i < a->count; i++) {
+        cell_add(vec, a->cell[i]);
+    }
+    return USP_Obj;
+}
+
+
+/* (vector-pop! vector)
+ * It is an error if vector is empty. Removes the last element of vector and returns it, decreasing
+ * the length of vector by one. The space it used is kept for later pushes. */
+Cell* builtin_vector_pop_bang(const Lex* e, const Cell* a)
+{
+    (void)e;
+    Cell* err = CHECK_ARITY_EXACT(a, 1, "vector-pop!");
+    if (err) return err;
+    Cell* vec = a->cell[0];
+    if (cell_type(vec) != CELL_VECTOR) {
+        return make_cell_error(
+            "vector-pop!: arg must be a vector",
+            TYPE_ERR);
+    }
+    if (vec->count == 0) {
+        return make_cell_error(
+            "vector-pop!: vector is empty",
+            INDEX_ERR);
+    }
+    Cell* obj = vec->cell[--vec->count];
+    /* Drop the reference, so the GC can reclaim obj once it's unused. */
+    vec->cell[vec->count] = nullptr;
+    return obj;
+}
+
+
+/* (vector-reserve! vector k)
+ * Makes room in vector for at least k elements in total, so that pushing up to that many takes no
+ * further allocation. The length and contents of vector are unchanged. Returns an unspecified
+ * value. */
+Cell* builtin_vector_reserve_bang(const Lex* e, const Cell* a)
+{
+    (void)e;
+    Cell* err = CHECK_ARITY_EXACT(a, 2, "vector-reserve!");
+    if (err) return err;
+    Cell* vec = a->cell[0];
+    if (cell_type(vec) != CELL_VECTOR) {
+        return make_cell_error(
+            "vector-reserve!: arg 1 must be a vector",
+            TYPE_ERR);
+    }
+    if (cell_type(a->cell[1]) != CELL_INTEGER) {
+        return make_cell_error(
+            "vector-reserve!: arg 2 must be an integer",
+            TYPE_ERR);
+    }
+    const long long k = cell_int(a->cell[1]);
+    if (k < 0 || k > INT_MAX) {
+        return make_cell_error(
+            "vector-reserve!: arg 2 out of range",
+            VALUE_ERR);
+    }
+    cell_reserve(vec, (int)k);
+    return USP_Obj;
+}
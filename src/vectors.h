@@ -37,5 +37,8 @@ Cell* builtin_vector_set_bang(const Lex* e, const Cell* a);
 Cell* builtin_vector_append(const Lex* e, const Cell* a);
 Cell* builtin_vector_copy_bang(const Lex* e, const Cell* a);
 Cell* builtin_vector_fill_bang(const Lex* e, const Cell* a);
+Cell* builtin_vector_push_bang(const Lex* e, const Cell* a);
+Cell* builtin_vector_pop_bang(const Lex* e, const Cell* a);
+Cell* builtin_vector_reserve_bang(const Lex* e, const Cell* a);
 
 #endif //COZENAGE_VECTORS_H
@@ -0,0 +1,622 @@
+/*
+ * 'src/vm.c'
+ * This file is part of Cozenage - https://github.com/DarrenKirby/cozenage
+ * Copyright © 2025 - 2026 Darren Kirby <darren@dragonbyte.ca>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* This file implements the stack VM which runs the bytecode produced by
+ * bytecode.c. It is selected with the '--engine vm' command line option.
+ *
+ * The VM keeps three stacks: a value stack of Cell pointers for arguments
+ * and temporaries, a frame stack with one Frame per active lambda call, and
+ * an env stack which saves the enclosing environment while a let or letrec
+ * body runs. Calling a lambda binds its arguments straight from the value
+ * stack, and pushes a Frame instead of recursing in C. A tail call re-uses
+ * the current Frame. Builtins are applied to a view of their arguments on the
+ * value stack, which stay there until the builtin returns.
+ *
+ * The stacks are global, so that the VM can be re-entered when a builtin
+ * (ie: map, for-each, sort) calls back into a lambda through vm_apply().
+ * Each entry runs until its own first Frame returns. Errors abort every
+ * Frame belonging to the entry, which matches how the tree-walker returns
+ * an error value to the top level.
+ */
+
+#include "vm.h"
+#include "analyzer.h"
+#include "eval.h"
+#include "fold.h"
+#include "special_forms.h"
+#include "transforms.h"
+#include "types.h"
+#include "repr.h"
+
+#include <gc/gc.h>
+#include <string.h>
+
+
+/* Default to the closure tree; main.c may change this. */
+engine_t coz_engine = ENGINE_TREE;
+
+/* set! needs to know if we're in the REPL. */
+extern int is_repl;
+
+#define VM_INITIAL_STACK  256
+#define VM_INITIAL_FRAMES 64
+
+/* One active lambda call or top-level expression. */
+typedef struct Frame {
+    const Chunk* chunk;  /* The code being run. */
+    int ip;              /* Index of the next code word. */
+    Lex* env;            /* Current environment. */
+    int base;            /* Value stack height at frame entry. */
+    int env_base;        /* Env stack height at frame entry. */
+    const Ch_Env* floor; /* Frames from here up are not this frame's to release. */
+} Frame;
+
+/* The VM stacks. These live in static storage, so the GC scans them. */
+static struct {
+    Cell** stack;
+    int sp;
+    int stack_cap;
+    Frame* frames;
+    int fp;
+    int frames_cap;
+    Lex** envs;
+    int ep;
+    int envs_cap;
+} vm;
+
+
+/* -----------------------------*
+ *        Stack management      *
+ * -----------------------------*/
+
+
+/* The old stack is copied rather than reallocated, and left to the GC, as a
+ * builtin further down the C stack may still be reading its args from it. */
+static void grow_stack(void)
+{
+    const int old_cap = vm.stack_cap;
+    vm.stack_cap = vm.stack_cap ? vm.stack_cap * 2 : VM_INITIAL_STACK;
+    Cell** stack = GC_MALLOC(sizeof(Cell*) * vm.stack_cap);
+    if (old_cap > 0) {
+        memcpy(stack, vm.stack, sizeof(Cell*) * old_cap);
+    }
+    vm.stack = stack;
+}
+
+
+static void grow_envs(void)
+{
+    vm.envs_cap = vm.envs_cap ? vm.envs_cap * 2 : VM_INITIAL_FRAMES;
+    vm.envs = GC_REALLOC(vm.envs, sizeof(Lex*) * vm.envs_cap);
+}
+
+
+static void push_frame(const Chunk* c, Lex* env, const Ch_Env* floor)
+{
+    if (vm.fp == vm.frames_cap) {
+        vm.frames_cap = vm.frames_cap ? vm.frames_cap * 2 : VM_INITIAL_FRAMES;
+        vm.frames = GC_REALLOC(vm.frames, sizeof(Frame) * vm.frames_cap);
+    }
+    vm.frames[vm.fp++] = (Frame){ .chunk = c, .ip = 0, .env = env, .base = vm.sp, .env_base = vm.ep,
+                                    .floor = floor };
+}
+
+
+#define PUSH(v) do { if (vm.sp == vm.stack_cap) grow_stack(); vm.stack[vm.sp++] = (v); } while (0)
+#define POP()   (vm.stack[--vm.sp])
+#define TOP()   (vm.stack[vm.sp - 1])
+#define IS_FALSE(v) (cell_type((v)) == CELL_BOOLEAN && (v)->boolean_v == 0)
+
+
+/* -----------------------------*
+ *            Helpers           *
+ * -----------------------------*/
+
+
+/* Compile a lambda body the first time the VM calls it. */
+static const Chunk* lambda_chunk(const Cell* f)
+{
+    if (!f->lambda->chunk) {
+        f->lambda->chunk = compile_lambda(f->lambda->formals, f->lambda->body, f->lambda->l_name,
+                                          f->lambda->env);
+    }
+    return f->lambda->chunk;
+}
+
+
+/* Run a builtin. If it hands back a CELL_TCS (only 'apply' does this), follow
+ * it: a builtin target is run in turn, and a lambda target is returned through
+ * *f and *args with a null return, for the caller to push a frame for. */
+static Cell* run_builtin(const Cell** f, Cell** args, const Lex* env)
+{
+    while ((*f)->is_builtin) {
+        Cell* result = (*f)->builtin(env, *args);
+        if (cell_type(result) != CELL_TCS) {
+            return result;
+        }
+        *f = result->cell[0];
+        Cell* next_args = make_cell_sexpr();
+        next_args->count = result->count - 1;
+        next_args->cell = result->cell + 1;
+        *args = next_args;
+    }
+    return nullptr;
+}
+
+
+/* Bind a lambda's formals to args in a new child of its closing env. The
+ * frame is pooled unless the body may capture it. */
+static Cell* bind_lambda(const Cell* f, Cell* args, Lex** env_out)
+{
+    Lex* le = build_lambda_env(f->lambda->env, f->lambda->formals, args, !lambda_chunk(f)->captures);
+    if (le == nullptr) {
+        /* We cannot return a specific error message from build_lambda_env(),
+         * so we have to return this generic error. */
+        return make_cell_error(
+            "bad lambda expression",
+            SYNTAX_ERR);
+    }
+    *env_out = le;
+    return nullptr;
+}
+
+
+/* Run a macro transformer over the raw call, and compile the expansion into
+ * the call site's cache, unless it already holds this macro's expansion.
+ * Macros are expected to be pure functions of their arguments, and a call
+ * site always runs in frames of the same shape, so the chunk can be reused. */
+static Cell* expand_macro(const Cell* macro, const Cell* call, const Lex* env, macro_cache* mc)
+{
+    if (mc->macro == macro) {
+        return nullptr;
+    }
+    Cell* raw_args = make_cell_sexpr();
+    raw_args->count = call->count - 1;
+    raw_args->cell = call->cell + 1;
+    Cell* result = coz_apply_and_get_val(macro, raw_args, env);
+    if (cell_type(result) == CELL_ERROR) {
+        return result;
+    }
+    mc->chunk = compile(expand(make_sexpr_from_list(result, true)), env);
+    mc->macro = macro;
+    return nullptr;
+}
+
+
+/* -----------------------------*
+ *          The VM loop         *
+ * -----------------------------*/
+
+
+/* Computed goto where the compiler supports it, otherwise a switch. */
+#if defined(__GNUC__) || defined(__clang__)
+#define VM_COMPUTED_GOTO 1
+#else
+#define VM_COMPUTED_GOTO 0
+#endif
+
+#if VM_COMPUTED_GOTO
+#define TARGET(op) L_##op:
+#define DISPATCH() goto *dispatch_table[code[ip++]]
+#else
+#define TARGET(op) case op:
+#define DISPATCH() goto dispatch
+#endif
+
+/* Save the running frame's registers before pushing another frame. */
+#define SAVE_FRAME() do { vm.frames[vm.fp - 1].ip = ip; vm.frames[vm.fp - 1].env = env; } while (0)
+
+/* Load the registers of the (new) top frame. */
+#define LOAD_FRAME() do {                        \
+        const Frame* fr_ = &vm.frames[vm.fp - 1]; \
+        chunk = fr_->chunk;                       \
+        code = chunk->code;                       \
+        ip = fr_->ip;                             \
+        env = fr_->env;                           \
+    } while (0)
+
+#define CHECK_ERR(v) do { if (cell_type((v)) == CELL_ERROR) { result = (v); goto error; } } while (0)
+
+
+/* Run frames until the frame at index vm.fp - 1 on entry returns. */
+static Cell* run(void)
+{
+    const int entry_fp = vm.fp - 1;
+    const int entry_sp = vm.frames[entry_fp].base;
+    const int entry_ep = vm.frames[entry_fp].env_base;
+
+    const Chunk* chunk;
+    const uint32_t* code;
+    int ip;
+    Lex* env;
+    Cell* result;
+    LOAD_FRAME();
+
+#if VM_COMPUTED_GOTO
+    static void* dispatch_table[OP_MAX] = {
+        [OP_CONST]      = &&L_OP_CONST,
+        [OP_REF]        = &&L_OP_REF,
+        [OP_LOCAL]      = &&L_OP_LOCAL,
+        [OP_GLOBAL]     = &&L_OP_GLOBAL,
+        [OP_SET]        = &&L_OP_SET,
+        [OP_SET_LOCAL]  = &&L_OP_SET_LOCAL,
+        [OP_DEFINE]     = &&L_OP_DEFINE,
+        [OP_POP]        = &&L_OP_POP,
+        [OP_JUMP]       = &&L_OP_JUMP,
+        [OP_JUMP_FALSE] = &&L_OP_JUMP_FALSE,
+        [OP_AND]        = &&L_OP_AND,
+        [OP_BUILTIN]    = &&L_OP_BUILTIN,
+        [OP_CLOSURE]    = &&L_OP_CLOSURE,
+        [OP_LET]        = &&L_OP_LET,
+        [OP_LETREC]     = &&L_OP_LETREC,
+        [OP_BIND]       = &&L_OP_BIND,
+        [OP_POP_ENV]    = &&L_OP_POP_ENV,
+        [OP_MACRO]      = &&L_OP_MACRO,
+        [OP_MACRO_TAIL] = &&L_OP_MACRO_TAIL,
+        [OP_CALL]       = &&L_OP_CALL,
+        [OP_TAIL_CALL]  = &&L_OP_TAIL_CALL,
+        [OP_EVAL]       = &&L_OP_EVAL,
+        [OP_RETURN]     = &&L_OP_RETURN
+    };
+    DISPATCH();
+#else
+dispatch:
+    switch (code[ip++]) {
+#endif
+
+    TARGET(OP_CONST) {
+        PUSH(chunk->consts[code[ip++]]);
+        DISPATCH();
+    }
+
+    TARGET(OP_REF) {
+        Cell* v = lex_get(env, chunk->consts[code[ip++]]);
+        CHECK_ERR(v);
+        PUSH(v);
+        DISPATCH();
+    }
+
+    TARGET(OP_LOCAL) {
+        const Cell* sym = chunk->consts[code[ip]];
+        Cell* v = lex_get_at(env, sym, (int)code[ip + 1], (int)code[ip + 2]);
+        ip += 3;
+        CHECK_ERR(v);
+        PUSH(v);
+        DISPATCH();
+    }
+
+    TARGET(OP_GLOBAL) {
+        Cell* v = lex_get_global(env, chunk->consts[code[ip]], &chunk->caches[code[ip + 1]]);
+        ip += 2;
+        CHECK_ERR(v);
+        PUSH(v);
+        DISPATCH();
+    }
+
+    TARGET(OP_SET) {
+        const Cell* sym = chunk->consts[code[ip++]];
+        Cell* v = POP();
+        if (!lex_set(env, sym, v)) {
+            result = make_cell_error(fmt_err("set!: Unbound symbol: '%s'", sym->sym), TYPE_ERR);
+            goto error;
+        }
+        if (is_repl) {
+            fprintf(stderr, "%s\n", cell_to_string(v, MODE_REPL));
+        }
+        PUSH(USP_Obj);
+        DISPATCH();
+    }
+
+    TARGET(OP_SET_LOCAL) {
+        const Cell* sym = chunk->consts[code[ip]];
+        Cell* v = POP();
+        if (!lex_set_at(env, sym, (int)code[ip + 1], (int)code[ip + 2], v)) {
+            result = make_cell_error(fmt_err("set!: Unbound symbol: '%s'", sym->sym), TYPE_ERR);
+            goto error;
+        }
+        ip += 3;
+        if (is_repl) {
+            fprintf(stderr, "%s\n", cell_to_string(v, MODE_REPL));
+        }
+        PUSH(USP_Obj);
+        DISPATCH();
+    }
+
+    TARGET(OP_DEFINE) {
+        Cell* sym = chunk->consts[code[ip++]];
+        Cell* v = POP();
+        /* Grab the name for the un-sugared define lambda. */
+        if (cell_type(v) == CELL_PROC && !v->is_builtin) {
+            v->lambda->l_name = sym->sym;
+        }
+        lex_put_global(env, sym, v);
+        PUSH(cell_type(v) == CELL_PROC ? v : sym);
+        DISPATCH();
+    }
+
+    TARGET(OP_POP) {
+        vm.sp--;
+        DISPATCH();
+    }
+
+    TARGET(OP_JUMP) {
+        ip = (int)code[ip];
+        DISPATCH();
+    }
+
+    TARGET(OP_JUMP_FALSE) {
+        const int target = (int)code[ip++];
+        const Cell* v = POP();
+        if (IS_FALSE(v)) ip = target;
+        DISPATCH();
+    }
+
+    TARGET(OP_AND) {
+        const int target = (int)code[ip++];
+        if (IS_FALSE(TOP())) {
+            ip = target;
+        } else {
+            vm.sp--;
+        }
+        DISPATCH();
+    }
+
+    TARGET(OP_BUILTIN) {
+        const Cell* v = lex_get_global(env, chunk->consts[code[ip]], &chunk->caches[code[ip + 2]]);
+        ip = fold_bound_to(v, chunk->consts[code[ip + 1]]) ? ip + 4 : (int)code[ip + 3];
+        DISPATCH();
+    }
+
+    TARGET(OP_CLOSURE) {
+        const Chunk* proto = chunk->protos[code[ip++]];
+        Cell* lam = lex_make_lambda(proto->formals, proto->body, env);
+        lam->lambda->l_name = proto->name;
+        lam->lambda->chunk = (Chunk*)proto;
+        PUSH(lam);
+        DISPATCH();
+    }
+
+    TARGET(OP_LET) {
+        const Cell* bindings = chunk->consts[code[ip++]];
+        const int n = bindings->count;
+        Lex* le = chunk->captures ? new_child_env(env) : lex_acquire_frame(env, n);
+        for (int i = 0; i < n; i++) {
+            lex_put_local(le, bindings->cell[i]->cell[0], vm.stack[vm.sp - n + i]);
+        }
+        vm.sp -= n;
+        if (vm.ep == vm.envs_cap) grow_envs();
+        vm.envs[vm.ep++] = env;
+        env = le;
+        DISPATCH();
+    }
+
+    TARGET(OP_LETREC) {
+        const Cell* bindings = chunk->consts[code[ip++]];
+        Lex* le = chunk->captures ? new_child_env(env) : lex_acquire_frame(env, bindings->count);
+        for (int i = 0; i < bindings->count; i++) {
+            lex_put_local(le, bindings->cell[i]->cell[0], USP_Obj);
+        }
+        if (vm.ep == vm.envs_cap) grow_envs();
+        vm.envs[vm.ep++] = env;
+        env = le;
+        DISPATCH();
+    }
+
+    TARGET(OP_BIND) {
+        const Cell* sym = chunk->consts[code[ip++]];
+        lex_put_local(env, sym, POP());
+        DISPATCH();
+    }
+
+    TARGET(OP_POP_ENV) {
+        const Lex* inner = env;
+        env = vm.envs[--vm.ep];
+        lex_release_frames(inner, env->local, nullptr);
+        DISPATCH();
+    }
+
+    TARGET(OP_MACRO) {
+        const Cell* call = chunk->consts[code[ip++]];
+        macro_cache* mc = &chunk->expansions[code[ip++]];
+        const int landing = (int)code[ip++];
+        if (cell_type(TOP()) == CELL_MACRO) {
+            Cell* err = expand_macro(POP(), call, env, mc);
+            if (err) { result = err; goto error; }
+            const Chunk* expansion = mc->chunk;
+            /* Run the expansion in its own frame; it returns to the landing. */
+            SAVE_FRAME();
+            vm.frames[vm.fp - 1].ip = landing;
+            push_frame(expansion, env, env->local);
+            LOAD_FRAME();
+        }
+        DISPATCH();
+    }
+
+    TARGET(OP_MACRO_TAIL) {
+        const Cell* call = chunk->consts[code[ip++]];
+        macro_cache* mc = &chunk->expansions[code[ip++]];
+        if (cell_type(TOP()) == CELL_MACRO) {
+            Cell* err = expand_macro(POP(), call, env, mc);
+            if (err) { result = err; goto error; }
+            const Chunk* expansion = mc->chunk;
+            /* The expansion replaces the current frame. */
+            Frame* fr = &vm.frames[vm.fp - 1];
+            vm.sp = fr->base;
+            fr->chunk = expansion;
+            chunk = expansion;
+            code = chunk->code;
+            ip = 0;
+        }
+        DISPATCH();
+    }
+
+    TARGET(OP_CALL) {
+        const int argc = (int)code[ip++];
+        const Cell* f = vm.stack[vm.sp - argc - 1];
+
+        if (cell_type(f) != CELL_PROC) {
+            result = make_cell_error(
+                fmt_err("bad identifier: '%s'. Expression must start with a procedure",
+                    cell_to_string(f, MODE_REPL)),
+                TYPE_ERR);
+            goto error;
+        }
+
+        Cell* args;
+        if (f->is_builtin) {
+            Cell view = { .type = CELL_SEXPR, .count = argc, .cell = &vm.stack[vm.sp - argc] };
+            args = &view;
+            Cell* v = run_builtin(&f, &args, env);
+            vm.sp -= argc + 1;
+            if (v) {
+                CHECK_ERR(v);
+                PUSH(v);
+                DISPATCH();
+            }
+        } else {
+            /* Bind straight from the value stack. */
+            Cell view = { .type = CELL_SEXPR, .count = argc, .cell = &vm.stack[vm.sp - argc] };
+            args = &view;
+            Lex* le;
+            Cell* err = bind_lambda(f, args, &le);
+            if (err) { result = err; goto error; }
+            vm.sp -= argc + 1;
+            SAVE_FRAME();
+            push_frame(lambda_chunk(f), le, f->lambda->env->local);
+            LOAD_FRAME();
+            DISPATCH();
+        }
+
+        /* A builtin ('apply') handed back a lambda to call. */
+        Lex* le;
+        Cell* err = bind_lambda(f, args, &le);
+        if (err) { result = err; goto error; }
+        SAVE_FRAME();
+        push_frame(lambda_chunk(f), le, f->lambda->env->local);
+        LOAD_FRAME();
+        DISPATCH();
+    }
+
+    TARGET(OP_TAIL_CALL) {
+        const int argc = (int)code[ip++];
+        const Cell* f = vm.stack[vm.sp - argc - 1];
+
+        if (cell_type(f) != CELL_PROC) {
+            result = make_cell_error(
+                fmt_err("bad identifier: '%s'. Expression must start with a procedure",
+                    cell_to_string(f, MODE_REPL)),
+                TYPE_ERR);
+            goto error;
+        }
+
+        Lex* le;
+        if (f->is_builtin) {
+            Cell view = { .type = CELL_SEXPR, .count = argc, .cell = &vm.stack[vm.sp - argc] };
+            Cell* args = &view;
+            Cell* v = run_builtin(&f, &args, env);
+            vm.sp -= argc + 1;
+            if (v) {
+                /* A builtin in tail position returns its value. */
+                CHECK_ERR(v);
+                PUSH(v);
+                goto do_return;
+            }
+            Cell* err = bind_lambda(f, args, &le);
+            if (err) { result = err; goto error; }
+        } else {
+            Cell view = { .type = CELL_SEXPR, .count = argc, .cell = &vm.stack[vm.sp - argc] };
+            Cell* err = bind_lambda(f, &view, &le);
+            if (err) { result = err; goto error; }
+        }
+
+        /* Re-use the current frame. */
+        Frame* fr = &vm.frames[vm.fp - 1];
+        lex_release_frames(env, fr->floor, le->local);
+        fr->floor = f->lambda->env->local;
+        vm.sp = fr->base;
+        vm.ep = fr->env_base;
+        fr->chunk = lambda_chunk(f);
+        chunk = fr->chunk;
+        code = chunk->code;
+        ip = 0;
+        env = le;
+        DISPATCH();
+    }
+
+    TARGET(OP_EVAL) {
+        Cell* v = coz_exec(env, chunk->nodes[code[ip++]]);
+        if (!v) v = USP_Obj;
+        CHECK_ERR(v);
+        PUSH(v);
+        DISPATCH();
+    }
+
+    TARGET(OP_RETURN) {
+    do_return:;
+        Cell* v = POP();
+        const Frame done = vm.frames[--vm.fp];
+        lex_release_frames(env, done.floor, nullptr);
+        vm.sp = done.base;
+        vm.ep = done.env_base;
+        if (vm.fp == entry_fp) {
+            return v;
+        }
+        PUSH(v);
+        LOAD_FRAME();
+        DISPATCH();
+    }
+
+#if !VM_COMPUTED_GOTO
+    default:
+        result = make_cell_error("vm: bad opcode", GEN_ERR);
+        goto error;
+    }
+#endif
+
+error:
+    /* Unwind every frame belonging to this entry. */
+    vm.fp = entry_fp;
+    vm.sp = entry_sp;
+    vm.ep = entry_ep;
+    return result;
+}
+
+
+/* Run a compiled top-level expression in env. */
+Cell* vm_run(Lex* env, const Chunk* c)
+{
+    push_frame(c, env, env->local);
+    return run();
+}
+
+
+/* Apply a procedure to already evaluated args, and return the final value.
+ * This is the VM counterpart of coz_apply_and_get_val(). */
+Cell* vm_apply(const Cell* proc, Cell* args, const Lex* env)
+{
+    Cell* result = run_builtin(&proc, &args, env);
+    if (result) {
+        return result;
+    }
+    Lex* le;
+    Cell* err = bind_lambda(proc, args, &le);
+    if (err) return err;
+    push_frame(lambda_chunk(proc), le, proc->lambda->env->local);
+    return run();
+}
@@ -0,0 +1,37 @@
+/*
+ * 'src/vm.h'
+ * This file is part of Cozenage - https://github.com/DarrenKirby/cozenage
+ * Copyright © 2025 - 2026 Darren Kirby <darren@dragonbyte.ca>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COZENAGE_VM_H
+#define COZENAGE_VM_H
+
+#include "bytecode.h"
+
+
+/* Which engine runs top-level code, and lambdas called from C. */
+typedef enum Engine_t : uint8_t {
+    ENGINE_TREE,  /* Closure tree (analyzer.c) - the default. */
+    ENGINE_VM     /* Bytecode VM (vm.c). */
+} engine_t;
+
+extern engine_t coz_engine;
+
+Cell* vm_run(Lex* env, const Chunk* c);
+Cell* vm_apply(const Cell* proc, Cell* args, const Lex* env);
+
+#endif //COZENAGE_VM_H
@@ -0,0 +1,141 @@
+#include "test_meta.h"
+#include <criterion/criterion.h>
+#include <stdio.h>
+
+TestSuite(end_to_end_bytevectors);
+
+Test(end_to_end_bytevectors, test_float_bytevector_literals, .init = setup_each_test, .fini = teardown_each_test) {
+    // ## Literals read and print back ##
+    cr_assert_str_eq(t_eval("#f64(1.5 -2 0.1)"), "#f64(1.5 -2.0 0.1)");
+    cr_assert_str_eq(t_eval("#f32(0.1 3)"), "#f32(0.1 3.0)");
+    cr_assert_str_eq(t_eval("#f64()"), "#f64()");
+
+    // ## #f and #false are still booleans ##
+    cr_assert_str_eq(t_eval("(list #f #false)"), "(#false #false)");
+
+    // ## Only numbers in float literals ##
+    cr_assert_str_eq(t_eval("#f64(1 a)"), " Type error: Line 1: bad value: 'a'. f64 literals can only contain real numbers");
+}
+
+Test(end_to_end_bytevectors, test_float_bytevector_procedures, .init = setup_each_test, .fini = teardown_each_test) {
+    // ## Generic bytevector procedures take float types ##
+    cr_assert_str_eq(t_eval("(bytevector 1 2.5 'f64)"), "#f64(1.0 2.5)");
+    cr_assert_str_eq(t_eval("(make-bytevector 2 0.5 'f32)"), "#f32(0.5 0.5)");
+    cr_assert_str_eq(t_eval("(bytevector-ref #f64(1.5 2.5) 1)"), "2.5");
+    cr_assert_str_eq(t_eval("(begin (define v (make-bytevector 2 0 'f64)) (bytevector-set! v 1 1/4) v)"), "#f64(0.0 0.25)");
+    cr_assert_str_eq(t_eval("(bytevector-append #f32(1 2) #f32(3))"), "#f32(1.0 2.0 3.0)");
+    cr_assert_str_eq(t_eval("(bytevector-copy #f64(1 2 3) 1)"), "#f64(2.0 3.0)");
+    cr_assert_str_eq(t_eval("(equal? #f64(1 2) (bytevector 1 2 'f64))"), "#true");
+    cr_assert_str_eq(t_eval("(bytevector-set! #f64(1) 0 'a)"), " Value error: bytevector-set!: value arg must be a real number");
+}
+
+Test(end_to_end_bytevectors, test_srfi4_float_vectors, .init = setup_each_test, .fini = teardown_each_test) {
+    cr_assert_str_eq(t_eval("(f64vector 1 2.5 -3)"), "#f64(1.0 2.5 -3.0)");
+    cr_assert_str_eq(t_eval("(make-f64vector 3 1.5)"), "#f64(1.5 1.5 1.5)");
+    cr_assert_str_eq(t_eval("(make-f32vector 2)"), "#f32(0.0 0.0)");
+    cr_assert_str_eq(t_eval("(f64vector-length (make-f64vector 7))"), "7");
+    cr_assert_str_eq(t_eval("(f64vector-ref #f64(1 2 3) 2)"), "3.0");
+    cr_assert_str_eq(t_eval("(begin (define v (f64vector 1 2 3)) (f64vector-set! v 0 9) v)"), "#f64(9.0 2.0 3.0)");
+    cr_assert_str_eq(t_eval("(f32vector->list #f32(0.5 1.5))"), "(0.5 1.5)");
+    cr_assert_str_eq(t_eval("(list->f64vector '(1 2 3))"), "#f64(1.0 2.0 3.0)");
+    cr_assert_str_eq(t_eval("(list (f64vector? #f64()) (f64vector? #f32()) (f32vector? #f32()) (f64vector? #u8()))"), "(#true #false #true #false)");
+
+    // ## f32 elements are rounded to single precision ##
+    cr_assert_str_eq(t_eval("(= (f32vector-ref (f32vector 0.1) 0) 0.1)"), "#false");
+    cr_assert_str_eq(t_eval("(= (f64vector-ref (f64vector 0.1) 0) 0.1)"), "#false");
+
+    // ## Errors ##
+    cr_assert_str_eq(t_eval("(f64vector-ref #f64(1) 1)"), " Index error: f64vector-ref: index out of bounds");
+    cr_assert_str_eq(t_eval("(f64vector-ref #f32(1) 0)"), " Type error: f64vector-ref: arg 1 must be an f64vector");
+    cr_assert_str_eq(t_eval("(f64vector 1 'a)"), " Type error: f64vector: arg 2 must be a real number");
+    cr_assert_str_eq(t_eval("(list->f32vector '(1 . 2))"), " Type error: list->f32vector: arg 1 must be a proper list");
+    cr_assert_str_eq(t_eval("(make-f64vector -1)"), " Value error: make-f64vector: arg 1 must be non-negative");
+}
+
+Test(end_to_end_bytevectors, test_float_vector_kernels, .init = setup_each_test, .fini = teardown_each_test) {
+    // ## Reductions, over lengths on both sides of a block of 8 ##
+    cr_assert_str_eq(t_eval("(f64vector-sum #f64())"), "0.0");
+    cr_assert_str_eq(t_eval("(f64vector-sum #f64(1 2 3))"), "6.0");
+    cr_assert_str_eq(t_eval("(f64vector-sum (make-f64vector 1001 0.5))"), "500.5");
+    cr_assert_str_eq(t_eval("(f32vector-sum (make-f32vector 19 2))"), "38.0");
+    cr_assert_str_eq(t_eval("(f64vector-dot #f64(1 2 3 4 5 6 7 8 9) #f64(1 1 1 1 1 1 1 1 2))"), "54.0");
+    cr_assert_str_eq(t_eval("(f32vector-dot #f32(1 2 3) #f32(4 5 6))"), "32.0");
+    cr_assert_str_eq(t_eval("(f64vector-min #f64(3 1 2 5 6 7 8 9 0.5 -1))"), "-1.0");
+    cr_assert_str_eq(t_eval("(f64vector-max #f64(3 1 2 5 6 7 8 9 0.5 -1))"), "9.0");
+    cr_assert_str_eq(t_eval("(f32vector-max #f32(-3 -1 -2))"), "-1.0");
+
+    // ## NaNs are skipped by min and max ##
+    cr_assert_str_eq(t_eval("(f64vector-max (f64vector (/ 0. 0.) 3 (/ 0. 0.)))"), "3.0");
+    cr_assert_str_eq(t_eval("(nan? (f64vector-min (f64vector (/ 0. 0.))))"), "#true");
+    // wherever they are: first, in the vector lanes, or in the scalar tail
+    for (int i = 0; i < 2; i++) {
+        const char* t = i == 0 ? "f64" : "f32";
+        char src[512];
+        snprintf(src, sizeof src,
+            "(let loop ((k 0) (bad '())) (if (= k 19) bad "
+            "(let ((v (%1$svector 5 4 1 6 3 7 9 2 8 5 4 6 1 3 7 2 9 8 5))) "
+            "(%1$svector-set! v k (/ 0. 0.)) "
+            "(loop (+ k 1) (if (and (= (%1$svector-min v) 1) (= (%1$svector-max v) 9)) bad (cons k bad))))))", t);
+        cr_assert_str_eq(t_eval(src), "()");
+    }
+    cr_assert_str_eq(t_eval("(f64vector-min (f64vector (/ 0. 0.) (/ 0. 0.) (/ 0. 0.) (/ 0. 0.) (/ 0. 0.) "
+                            "(/ 0. 0.) (/ 0. 0.) (/ 0. 0.) (/ 0. 0.) 2 (/ 0. 0.)))"), "2.0");
+
+    // ## In-place updates ##
+    cr_assert_str_eq(t_eval("(begin (define v (make-f64vector 9 1.5)) (f64vector-scale! v 2) v)"), "#f64(3.0 3.0 3.0 3.0 3.0 3.0 3.0 3.0 3.0)");
+    cr_assert_str_eq(t_eval("(begin (define y (f32vector 1 2 3 4 5)) (f32vector-axpy! 2 (f32vector 1 1 1 1 1) y) y)"), "#f32(3.0 4.0 5.0 6.0 7.0)");
+
+    // ## Errors ##
+    cr_assert_str_eq(t_eval("(f64vector-min #f64())"), " Value error: f64vector-min: vector is empty");
+    cr_assert_str_eq(t_eval("(f64vector-dot #f64(1) #f64(1 2))"), " Value error: f64vector-dot: vectors must be the same length");
+    cr_assert_str_eq(t_eval("(f64vector-sum #f32(1))"), " Type error: f64vector-sum: arg 1 must be an f64vector");
+    cr_assert_str_eq(t_eval("(f64vector-axpy! 'a #f64(1) #f64(1))"), " Type error: f64vector-axpy!: arg 1 must be a real number");
+}
+
+Test(end_to_end_bytevectors, test_large_and_shared_bytevectors, .init = setup_each_test, .fini = teardown_each_test) {
+    // ## No 65535 element limit ##
+    cr_assert_str_eq(t_eval("(bytevector-length (make-bytevector 100000 7))"), "100000");
+    cr_assert_str_eq(t_eval("(bytevector-ref (make-bytevector 70000 7 'u32) 69999)"), "7");
+    cr_assert_str_eq(t_eval("(bytevector-length (read-bytevector 70000 (open-input-bytevector (make-bytevector 70000 1))))"), "70000");
+
+    // ## Slices share storage ##
+    cr_assert_str_eq(t_eval("(bytevector-slice #u8(1 2 3 4 5) 1 3)"), "#u8(2 3)");
+    cr_assert_str_eq(t_eval("(bytevector-slice #u16(1 2 3) 1)"), "#u16(2 3)");
+    cr_assert_str_eq(t_eval("(begin (define v (bytevector 1 2 3 4 5)) (bytevector-set! (bytevector-slice v 2) 0 9) v)"), "#u8(1 2 9 4 5)");
+    cr_assert_str_eq(t_eval("(begin (define v (bytevector 1 2 3 4 5)) (bytevector-slice (bytevector-slice v 1 4) 1 2))"), "#u8(3)");
+    cr_assert_str_eq(t_eval("(bytevector-slice #u8(1 2) 2 1)"), " Index error: bytevector-slice: start index cannot be greater than end index");
+
+    // ## Overlapping copies ##
+    cr_assert_str_eq(t_eval("(begin (define v (bytevector 1 2 3 4 5)) (bytevector-copy! v 1 v 0 4) v)"), "#u8(1 1 2 3 4)");
+    cr_assert_str_eq(t_eval("(begin (define v (bytevector 1 2 3 4 5)) (bytevector-copy! v 0 v 1) v)"), "#u8(2 3 4 5 5)");
+    cr_assert_str_eq(t_eval("(bytevector-copy! (bytevector 1 2) 1 #u8(1 2))"), " Index error: bytevector-copy!: not enough room in 'to' bytevector");
+}
+
+Test(end_to_end_bytevectors, test_mmap_bytevector, .init = setup_each_test, .fini = teardown_each_test) {
+    t_eval("(begin (define p (open-binary-output-file \"/tmp/cozenage_test_mmap.bin\" \"w\")) "
+           "(write-bytevector #u8(104 105 0 0 0 1 2) p) (close-port p))");
+
+    cr_assert_str_eq(t_eval("(mmap-bytevector \"/tmp/cozenage_test_mmap.bin\")"), "#u8(104 105 0 0 0 1 2)");
+    cr_assert_str_eq(t_eval("(mmap-bytevector \"/tmp/cozenage_test_mmap.bin\" 'u16)"), "#u16(26984 0 256)");
+    cr_assert_str_eq(t_eval("(utf8->string (bytevector-slice (mmap-bytevector \"/tmp/cozenage_test_mmap.bin\") 0 2))"), "\"hi\"");
+
+    // ## Read-only by default, private writes with copy-on-write ##
+    cr_assert_str_eq(t_eval("(bytevector-set! (mmap-bytevector \"/tmp/cozenage_test_mmap.bin\") 0 1)"), " Value error: bytevector-set!: bytevector is read-only");
+    cr_assert_str_eq(t_eval("(bytevector-set! (bytevector-slice (mmap-bytevector \"/tmp/cozenage_test_mmap.bin\") 1) 0 1)"), " Value error: bytevector-set!: bytevector is read-only");
+    cr_assert_str_eq(t_eval("(begin (define v (mmap-bytevector \"/tmp/cozenage_test_mmap.bin\" 'u8 'copy-on-write)) (bytevector-set! v 0 72) (bytevector-ref v 0))"), "72");
+    cr_assert_str_eq(t_eval("(bytevector-ref (mmap-bytevector \"/tmp/cozenage_test_mmap.bin\") 0)"), "104");
+
+    // ## Windows of the file, from any byte offset ##
+    cr_assert_str_eq(t_eval("(mmap-bytevector \"/tmp/cozenage_test_mmap.bin\" 'u8 'read-only 1 2)"), "#u8(105 0)");
+    cr_assert_str_eq(t_eval("(mmap-bytevector \"/tmp/cozenage_test_mmap.bin\" 'u8 'read-only 4)"), "#u8(0 1 2)");
+    cr_assert_str_eq(t_eval("(mmap-bytevector \"/tmp/cozenage_test_mmap.bin\" 'u16 'read-only 1)"), "#u16(105 0 513)");
+    cr_assert_str_eq(t_eval("(mmap-bytevector \"/tmp/cozenage_test_mmap.bin\" 'u8 'read-only 7)"), "#u8()");
+    cr_assert_str_eq(t_eval("(begin (define v (mmap-bytevector \"/tmp/cozenage_test_mmap.bin\" 'u8 'copy-on-write 5 1)) (bytevector-set! v 0 9) v)"), "#u8(9)");
+
+    // ## Errors ##
+    cr_assert_str_eq(t_eval("(mmap-bytevector \"/tmp\")"), " File error: mmap-bytevector: /tmp: not a regular file");
+    cr_assert_str_eq(t_eval("(mmap-bytevector \"/tmp/cozenage_test_mmap.bin\" 'u8 'read-only 8)"), " Index error: mmap-bytevector: /tmp/cozenage_test_mmap.bin: offset is past the end of the file");
+    cr_assert_str_eq(t_eval("(mmap-bytevector \"/tmp/cozenage_test_mmap.bin\" 'u16 'read-only 2 3)"), " Index error: mmap-bytevector: /tmp/cozenage_test_mmap.bin: count runs past the end of the file");
+    cr_assert_str_eq(t_eval("(mmap-bytevector \"/tmp/cozenage_test_mmap.bin\" 'u8 'read-only -1)"), " Type error: mmap-bytevector: arg 4 must be a non-negative integer");
+    cr_assert_str_eq(t_eval("(mmap-bytevector \"/tmp/cozenage_test_mmap.bin\" 'u8 'write)"), " Value error: mmap-bytevector: arg 3 must be one of 'read-only or 'copy-on-write");
+}
@@ -34,8 +34,9 @@ Test(end_to_end_equivalence, test_eq_procedure, .init = setup_each_test, .fini =
 
     // ## Numbers ##
     // `eq?` on numbers may be true for small integers (implementation-defined), but false for others.
-    cr_assert_str_eq(t_eval("(eq? 2 2)"), "#false"); // No integer interning
-    cr_assert_str_eq(t_eval("(eq? 1000000 1000000)"), "#false"); // test with larger integers as well
+    cr_assert_str_eq(t_eval("(eq? 2 2)"), "#true"); // fixnums are immediates
+    cr_assert_str_eq(t_eval("(eq? 1000000 1000000)"), "#true"); // test with larger integers as well
+    cr_assert_str_eq(t_eval("(eq? 100000000000000000000 100000000000000000000)"), "#false"); // bigints are boxed
     cr_assert_str_eq(t_eval("(eq? 2 3)"), "#false");
     cr_assert_str_eq(t_eval("(eq? 2 2.0)"), "#false"); // Different types
     cr_assert_str_eq(t_eval("(eq? 3.14 3.14)"), "#false"); // Inexacts are generally not `eq?`
@@ -43,7 +44,7 @@ Test(end_to_end_equivalence, test_eq_procedure, .init = setup_each_test, .fini =
     cr_assert_str_eq(t_eval("(begin (define y 3.14) (eq? y y))"), "#true");
 
     // ## Characters ##
-    cr_assert_str_eq(t_eval("(eq? #\\a #\\a)"), "#false"); // no character interning
+    cr_assert_str_eq(t_eval("(eq? #\\a #\\a)"), "#true"); // characters are immediates
     cr_assert_str_eq(t_eval("(eq? #\\a #\\b)"), "#false");
     cr_assert_str_eq(t_eval("(begin (define my-char #\\λ) (eq? my-char my-char))"), "#true");
 
@@ -0,0 +1,52 @@
+#include "test_meta.h"
+#include <criterion/criterion.h>
+
+TestSuite(end_to_end_hashes);
+
+Test(end_to_end_hashes, test_hash_basics, .init = setup_each_test, .fini = teardown_each_test) {
+    cr_assert_str_eq(t_eval("(hash-keys (hash))"), "()");
+    cr_assert_str_eq(t_eval("(hash-get (hash 'a 1 \"a\" 2) 'a)"), "1");
+    cr_assert_str_eq(t_eval("(hash-get (hash 'a 1 \"a\" 2) \"a\")"), "2");
+    cr_assert_str_eq(t_eval("(hash-get (hash 1 'x) 1.0 'none)"), "none");
+    cr_assert_str_eq(t_eval("(begin (define h (hash 'a 1)) (hash-add! h 'a 5) (hash-get h 'a))"), "5");
+    cr_assert_str_eq(t_eval("(begin (define h (hash 'a 1 'b 2)) (hash-remove! h 'a) (hash-keys h))"), "(b)");
+    cr_assert_str_eq(t_eval("(begin (define h (hash 'a 1)) (define c (hash-copy h)) (hash-add! c 'b 2) (list (length (hash-keys h)) (hash-get c 'a)))"), "(1 1)");
+    cr_assert_str_eq(t_eval("(begin (define h (hash 'a 1)) (hash-clear! h) (hash-add! h 'b 2) (hash-keys h))"), "(b)");
+}
+
+Test(end_to_end_hashes, test_hash_growth_and_deletion, .init = setup_each_test, .fini = teardown_each_test) {
+    // ## Many keys, across several resizes ##
+    cr_assert_str_eq(t_eval(
+        "(begin (define h (hash)) "
+        "(do ((i 0 (+ i 1))) ((= i 5000)) (hash-add! h i (* i i))) "
+        "(list (length (hash-keys h)) (hash-get h 4999) (hash-get h 5000 #f)))"),
+        "(5000 24990001 #false)");
+
+    // ## Deleting every other key, then adding them back ##
+    cr_assert_str_eq(t_eval(
+        "(begin (define h (hash)) "
+        "(do ((i 0 (+ i 1))) ((= i 2000)) (hash-add! h (number->string i) i)) "
+        "(do ((i 0 (+ i 2))) ((>= i 2000)) (hash-remove! h (number->string i))) "
+        "(define after-delete (list (length (hash-keys h)) (hash-get h \"10\" #f) (hash-get h \"11\"))) "
+        "(do ((i 0 (+ i 2))) ((>= i 2000)) (hash-add! h (number->string i) (- i))) "
+        "(list after-delete (length (hash-keys h)) (hash-get h \"10\") (hash-get h \"11\")))"),
+        "((1000 #false 11) 2000 -10 11)");
+
+    // ## Removing set members while iterating over them ##
+    cr_assert_str_eq(t_eval(
+        "(begin (define a (list->set '(1 2 3 4 5 6))) "
+        "(set-difference! a (set 2 4 6)) (list (set-member? a 3) (set-member? a 4) (apply + (set->list a))))"),
+        "(#true #false 9)");
+}
+
+Test(end_to_end_hashes, test_hash_string_keys_after_mutation, .init = setup_each_test, .fini = teardown_each_test) {
+    // ## A key hashed before mutation is found by its new text ##
+    cr_assert_str_eq(t_eval("(begin (define k (string-copy \"abc\")) (hash-get (hash k 1) k) (string-set! k 0 #\\x) (hash-get (hash k 2) \"xbc\"))"), "2");
+    cr_assert_str_eq(t_eval("(begin (define k (string-copy \"abc\")) (hash-get (hash k 1) k) (string-set! k 1 #\\λ) (hash-get (hash k 2) \"aλc\"))"), "2");
+    cr_assert_str_eq(t_eval("(begin (define k (make-string 3 #\\a)) (hash-get (hash k 1) k) (string-fill! k #\\b) (hash-get (hash k 2) \"bbb\"))"), "2");
+    cr_assert_str_eq(t_eval("(begin (define k (string-copy \"abc\")) (hash-get (hash k 1) k) (string-copy! k 0 \"zz\") (hash-get (hash k 2) \"zzc\"))"), "2");
+
+    // ## Copies of a hashed string stay equal to it ##
+    cr_assert_str_eq(t_eval("(begin (define k \"a long key, such as a path or a URL\") (define h (hash k 1)) (hash-get h (string-copy k)))"), "1");
+    cr_assert_str_eq(t_eval("(hash-get (hash (symbol->string 'abc) 1) \"abc\")"), "1");
+}
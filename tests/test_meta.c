@@ -2,13 +2,18 @@
 #include "test_meta.h"
 #include "load_library.h"
 #include "../src/eval.h"
+#include "../src/analyzer.h"
+#include "../src/vm.h"
 #include "../src/parser.h"
 #include "../src/repr.h"
 #include "../src/symbols.h"
 #include "../src/transforms.h"
+#include "../src/fold.h"
 
 #include <assert.h>
 #include <locale.h>
+#include <stdlib.h>
+#include <string.h>
 #include <gc/gc.h>
 
 /* Define the global test environment variable. */
@@ -37,9 +42,14 @@ static bool engine_prepped = false;
 char* t_eval(const char* input) {
     if (!engine_prepped) {
         GC_INIT(); // Only call this ONCE per process
-        symbol_table = ht_create(128);
+        symbol_table = ht_create(SYMBOL_TABLE_INITIAL_CAPACITY);
         init_global_singletons();
         init_special_forms();
+        // COZENAGE_ENGINE=vm runs the whole suite on the bytecode VM
+        const char* engine = getenv("COZENAGE_ENGINE");
+        if (engine && strcmp(engine, "vm") == 0) {
+            coz_engine = ENGINE_VM;
+        }
         engine_prepped = true;
     }
 
@@ -48,10 +58,13 @@ char* t_eval(const char* input) {
     test_env = lex_initialize_global_env();
     lex_add_builtins(test_env);
 
-    TokenArray* ta = scan_all_tokens(input);
-    Cell* parsed = parse_tokens(ta);
-    Cell* expr = expand(parsed);
-    const Cell *result = coz_eval(test_env, expr);
+    Reader r;
+    init_reader(&r, input);
+    Cell* parsed = read_datum(&r);
+    Cell* expr = fold_constants(expand(parsed), test_env);
+    const Cell *result = coz_engine == ENGINE_VM
+        ? vm_run(test_env, compile(expr, test_env))
+        : coz_exec(test_env, analyze(expr, test_env));
 
     return cell_to_string(result, MODE_WRITE);
 }
@@ -59,7 +72,7 @@ char* t_eval(const char* input) {
 long double t_eval_math_lib(const char* input) {
     if (!engine_prepped) {
         GC_INIT(); // Only call this ONCE per process
-        symbol_table = ht_create(128);
+        symbol_table = ht_create(SYMBOL_TABLE_INITIAL_CAPACITY);
         init_global_singletons();
         init_special_forms();
         engine_prepped = true;
@@ -77,12 +90,13 @@ long double t_eval_math_lib(const char* input) {
         return -1;
     }
 
-    TokenArray* ta = scan_all_tokens(input);
-    Cell* parsed = parse_tokens(ta);
+    Reader r;
+    init_reader(&r, input);
+    Cell* parsed = read_datum(&r);
     //Cell* expr = expand(parsed);
 
     Cell* result = coz_eval(test_env, parsed);
-    //assert(result->type == CELL_REAL);
+    //assert(cell_type(result) == CELL_REAL);
 
     return result->real_v;
 }
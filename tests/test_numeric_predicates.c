@@ -49,6 +49,12 @@ Test(end_to_end_numeric_predicates, test_inexact_predicate, .init = setup_each_t
     cr_assert_str_eq(t_eval("(inexact? #i#b101)"), "#true");
     cr_assert_str_eq(t_eval("(inexact? #i#o77)"), "#true");
 
+    // Inexact rationals which reduce to integers
+    cr_assert_str_eq(t_eval("(inexact? #i4/2)"), "#true");
+    cr_assert_str_eq(t_eval("(inexact? (string->number \"#i-6/3\"))"), "#true");
+    cr_assert_str_eq(t_eval("(= #i4/2 2)"), "#true");
+    cr_assert_str_eq(t_eval("(list (inexact? (/ #i3/4)) (inexact? (- #i3/4)))"), "(#true #true)");
+
     // ## Exact Numbers ##
     cr_assert_str_eq(t_eval("(inexact? 5)"), "#false");
     cr_assert_str_eq(t_eval("(inexact? 3/4)"), "#false");
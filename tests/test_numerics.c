@@ -1,9 +1,19 @@
 #include "test_meta.h"
+#include "../src/float_io.h"
 #include <criterion/criterion.h>
 
 
 TestSuite(end_to_end_numerics);
 
+/* How a real computed in C is printed. Inexact sums and quotients print all
+ * the digits needed to read them back, which depends on the long double. */
+static const char* real_str(const long double x)
+{
+    static char buf[REAL_BUF_SIZE];
+    format_real_shortest(buf, x);
+    return buf;
+}
+
 Test(end_to_end_numerics, test_add_integer, .init = setup_each_test, .fini = teardown_each_test) {
     cr_assert_str_eq(t_eval("(+)"), "0");
     cr_assert_str_eq(t_eval("(+ 1)"), "1");
@@ -40,7 +50,7 @@ Test(end_to_end_numerics, test_add_real, .init = setup_each_test, .fini = teardo
     cr_assert_str_eq(t_eval("(+ 2.5 3.5)"), "6.0");
     cr_assert_str_eq(t_eval("(+ 0.5 0.25)"), "0.75");
     cr_assert_str_eq(t_eval("(+ 1.0)"), "1.0");
-    cr_assert_str_eq(t_eval("(+ 1.1 2.2 3.3)"), "6.6");
+    cr_assert_str_eq(t_eval("(+ 1.1 2.2 3.3)"), real_str(1.1L + 2.2L + 3.3L));
     cr_assert_str_eq(t_eval("(+ 1.0 2.0 3.0 4.0 5.0)"), "15.0");
     cr_assert_str_eq(t_eval("(+)"), "0");
     cr_assert_str_eq(t_eval("(+ 0.0 5.5)"), "5.5");
@@ -156,8 +166,8 @@ Test(end_to_end_numerics, test_sub_real, .init = setup_each_test, .fini = teardo
     cr_assert_str_eq(t_eval("(- 20.0 5.0 -2.5 1.5)"), "16.0");
     cr_assert_str_eq(t_eval("(- 0.0 5.5 4.5)"), "-10.0");
     cr_assert_str_eq(t_eval("(- 10.0 1.0 2.0 3.0 4.0)"), "0.0");
-    cr_assert_str_eq(t_eval("(- 0.3 0.1)"), "0.2");
-    cr_assert_str_eq(t_eval("(- 5.000008 3.000002)"), "2.000006");
+    cr_assert_str_eq(t_eval("(- 0.3 0.1)"), real_str(0.3L - 0.1L));
+    cr_assert_str_eq(t_eval("(- 5.000008 3.000002)"), real_str(5.000008L - 3.000002L));
     cr_assert_str_eq(t_eval("(- 100.0 (- 50.0 25.0))"), "75.0");
     cr_assert_str_eq(t_eval("(- (- 100.0 50.0) 25.0)"), "25.0");
 }
@@ -325,7 +335,7 @@ Test(end_to_end_numerics, test_div_rational, .init = setup_each_test, .fini = te
 Test(end_to_end_numerics, test_div_real, .init = setup_each_test, .fini = teardown_each_test) {
     cr_assert_str_eq(t_eval("(/ 2.0)"), "0.5");
     cr_assert_str_eq(t_eval("(/ -4.0)"), "-0.25");
-    cr_assert_str_eq(t_eval("(/ 5.5)"), "0.181818181818182");
+    cr_assert_str_eq(t_eval("(/ 5.5)"), real_str(1.0L / 5.5L));
     cr_assert_str_eq(t_eval("(/ 10.0 4.0)"), "2.5");
     cr_assert_str_eq(t_eval("(/ 5.0 2.0)"), "2.5");
     cr_assert_str_eq(t_eval("(/ -10.0 4.0)"), "-2.5");
@@ -360,6 +370,32 @@ Test(end_to_end_numerics, test_div_mixed, .init = setup_each_test, .fini = teard
     cr_assert_str_eq(t_eval("(/ 40+0i 2.0 5)"), "4.0+0.0i");
 }
 
+Test(end_to_end_numerics, test_fixnum_boundaries, .init = setup_each_test, .fini = teardown_each_test) {
+    // integers beyond the 62-bit fixnum range are boxed, and arithmetic crosses over both ways
+    cr_assert_str_eq(t_eval("(+ 4611686018427387903 1)"), "4611686018427387904");
+    cr_assert_str_eq(t_eval("(- -4611686018427387904 1)"), "-4611686018427387905");
+    cr_assert_str_eq(t_eval("(- 4611686018427387904 1)"), "4611686018427387903");
+    cr_assert_str_eq(t_eval("(* 4611686018427387903 2)"), "9223372036854775806");
+    cr_assert_str_eq(t_eval("(eqv? 4611686018427387904 4611686018427387904)"), "#true");
+    // inexact integers are boxed too
+    cr_assert_str_eq(t_eval("(exact? #i5)"), "#false");
+    cr_assert_str_eq(t_eval("(exact #i5)"), "5");
+    cr_assert_str_eq(t_eval("(exact? (exact #i5))"), "#true");
+}
+
+Test(end_to_end_numerics, test_arith_fast_paths, .init = setup_each_test, .fini = teardown_each_test) {
+    // two-argument fixnum and real operations, and where they fall back to the generic paths
+    cr_assert_str_eq(t_eval("(let ((x 2305843009213693951)) (+ x x))"), "4611686018427387902");
+    cr_assert_str_eq(t_eval("(let ((x -2305843009213693952)) (- x 1))"), "-2305843009213693953");
+    cr_assert_str_eq(t_eval("(let ((x 3037000500)) (* x x))"), "9223372037000250000");
+    cr_assert_str_eq(t_eval("(let ((x 1.5) (y 2.25)) (list (+ x y) (- x y) (* x y)))"), "(3.75 -0.75 3.375)");
+    cr_assert_str_eq(t_eval("(let ((x #i5) (y 1)) (exact? (+ x y)))"), "#false");
+    cr_assert_str_eq(t_eval("(let ((x 2) (y 3)) (list (= x y) (< x y) (> x y) (<= x x) (>= x y)))"),
+        "(#false #true #false #true #false)");
+    cr_assert_str_eq(t_eval("(let ((x 2.0) (y +nan.0)) (list (= x x) (< x y) (> y x)))"), "(#true #false #false)");
+    cr_assert_str_eq(t_eval("(< 1 'a)"), " Type error: <: bad type at arg 2: got symbol, expected integer|real|rational|bigint");
+}
+
 Test(end_to_end_numerics, test_numeric_equals, .init = setup_each_test, .fini = teardown_each_test) {
     /* Test = */
     // Basic integers
@@ -1,6 +1,12 @@
 #include <criterion/criterion.h>
 
 #include "test_meta.h"
+#include "../src/fold.h"
+#include "../src/fasl.h"
+#include "../src/parser.h"
+#include "../src/transforms.h"
+#include "../src/repr.h"
+#include "../src/runner.h"
 /////#include <gc/gc.h>
 
 TestSuite(end_to_end_sf);
@@ -129,6 +135,156 @@ Test(end_to_end_sf, test_internal_defines, .init = setup_each_test, .fini = tear
     cr_assert_str_eq(t_eval("(unless #f (define z \"ok\") z)"), "\"ok\"");
 }
 
+Test(end_to_end_sf, test_analyzed_calls, .init = setup_each_test, .fini = teardown_each_test) {
+    // apply must not re-evaluate its already evaluated arguments
+    cr_assert_str_eq(t_eval("(apply list '(a b c))"), "(a b c)");
+    cr_assert_str_eq(t_eval("(apply apply (list + (list 1 2)))"), "3");
+
+    // deep tail recursion through analyzed lambda bodies
+    cr_assert_str_eq(t_eval(
+        "(begin (define (count n) (if (= n 0) 'done (count (- n 1)))) "
+        "       (count 100000))"), "done");
+
+    // set! propagates errors instead of binding them
+    cr_assert_str_eq(t_eval("(begin (define x 1) (set! x (vector-ref (vector) 1)) x)"),
+        " Index error: vector-ref: index out of bounds");
+
+    // naming a builtin must not rename it
+    cr_assert_str_eq(t_eval("(begin (define plus +) plus)"), "#<builtin procedure '+'>");
+}
+
+Test(end_to_end_sf, test_lexical_addressing, .init = setup_each_test, .fini = teardown_each_test) {
+    // shadowing, and references several frames up
+    cr_assert_str_eq(t_eval("(let* ((a 1) (b 2) (a 10) (c (+ a b))) (list a b c))"), "(10 2 12)");
+    cr_assert_str_eq(t_eval("((lambda (x) ((lambda (y) ((lambda (x) (list x y)) 3)) x)) 1)"), "(3 1)");
+
+    // dotted and variadic formals, and duplicate let bindings
+    cr_assert_str_eq(t_eval("((lambda (a b . c) (list c b a)) 1 2 3 4)"), "((3 4) 2 1)");
+    cr_assert_str_eq(t_eval("((lambda x (let ((y x)) y)) 1 2)"), "(1 2)");
+    cr_assert_str_eq(t_eval("(let ((a 1) (a 2)) a)"), "2");
+
+    // set! on a closed-over local, and on a global from a local scope
+    cr_assert_str_eq(t_eval(
+        "(begin (define (make-acc n) (lambda (d) (let ((old n)) (set! n (+ n d)) (list old n)))) "
+        "       (define acc (make-acc 10)) (acc 1) (acc 2))"), "(11 13)");
+    cr_assert_str_eq(t_eval("(begin (define g 1) (let ((x 5)) (set! g x)) g)"), "5");
+
+    // free variables are global, even when defined after the reference is analyzed
+    cr_assert_str_eq(t_eval("(begin (define (f) later) (define later 'ok) (f))"), "ok");
+    cr_assert_str_eq(t_eval("(let ((x 1)) undefined-var)"), " Value error: Unbound symbol: 'undefined-var'");
+}
+
+Test(end_to_end_sf, test_arg_stack, .init = setup_each_test, .fini = teardown_each_test) {
+    // builtins which call back into the evaluator keep reading their own args
+    cr_assert_str_eq(t_eval(
+        "(map (lambda (x) (+ x (length (map (lambda (y) (* y y)) '(1 2 3))))) '(10 20))"), "(13 23)");
+    cr_assert_str_eq(t_eval(
+        "(apply + 1 2 (map (lambda (x) (apply max x)) '((1 5) (7 2))))"), "15");
+    // deep non-tail recursion spans several argument stack segments
+    cr_assert_str_eq(t_eval(
+        "(begin (define (depth n) (if (= n 0) 0 (+ 1 (depth (- n 1))))) (depth 2000))"), "2000");
+    // an error while evaluating args releases the reserved slots
+    cr_assert_str_eq(t_eval("(list 1 (vector-ref (vector) 1) 3)"), " Index error: vector-ref: index out of bounds");
+}
+
+Test(end_to_end_sf, test_global_caches, .init = setup_each_test, .fini = teardown_each_test) {
+    // cached global references see redefinition and set!
+    cr_assert_str_eq(t_eval(
+        "(begin (define (g) 1) (define (f) (g)) (f) (define (g) 2) (f))"), "2");
+    cr_assert_str_eq(t_eval(
+        "(begin (define x 1) (define (get) x) (get) (set! x 5) (get))"), "5");
+}
+
+Test(end_to_end_sf, test_frame_pool, .init = setup_each_test, .fini = teardown_each_test) {
+    // frames of non-capturing bodies are recycled between calls and tail calls
+    cr_assert_str_eq(t_eval(
+        "(begin (define (f a b) (let ((c (+ a b))) (list a b c))) (list (f 1 2) (f 3 4)))"), "((1 2 3) (3 4 7))");
+    cr_assert_str_eq(t_eval(
+        "(begin (define (loop n acc) (if (= n 0) acc (let ((k n)) (loop (- n 1) (+ acc k))))) (loop 1000 0))"),
+        "500500");
+    // closures made by a macro expansion in a non-capturing body keep their frame
+    cr_assert_str_eq(t_eval(
+        "(begin (defmacro thunk (v) `(lambda args ,v)) (define (mk x) (let ((y (* x 2))) (thunk (+ x y)))) "
+        "       (define t1 (mk 1)) (define t2 (mk 2)) (list (t1) (t2)))"), "(3 6)");
+}
+
+Test(end_to_end_sf, test_macro_memoization, .init = setup_each_test, .fini = teardown_each_test) {
+    // a call site runs its macro's transformer once, until the macro is redefined
+    cr_assert_str_eq(t_eval(
+        "(begin (define n 0) (defmacro add2 (x) (begin (set! n (+ n 1)) `(+ ,x 2))) "
+        "       (define (f x) (add2 x)) (define a (list (f 1) (f 2) (f 3) n)) "
+        "       (defmacro add2 (x) (begin (set! n (+ n 1)) `(* ,x 2))) "
+        "       (list a (f 5) (f 6) n))"), "((3 4 5 1) 10 12 2)");
+    // and a redefinition as a procedure is seen too
+    cr_assert_str_eq(t_eval(
+        "(begin (defmacro m (x) `(list ,x)) (define (g) (m 1)) (g) (define (m x) x) (g))"), "1");
+}
+
+Test(end_to_end_sf, test_constant_folding, .init = setup_each_test, .fini = teardown_each_test) {
+    fold_stats.folds = 0;
+    cr_assert_str_eq(t_eval("(* 2 (+ 1 2) (if (< 1 2) 10 20))"), "60");
+    cr_assert(fold_stats.folds == 4);
+    cr_assert_str_eq(t_eval("(let () (let ((x (- 5 1))) x))"), "4");
+    cr_assert_str_eq(t_eval("(if #f 1)"), "");
+    // shadowed and redefined operators are not folded
+    cr_assert_str_eq(t_eval("(let ((+ -)) (+ 5 2))"), "3");
+    cr_assert_str_eq(t_eval("((lambda (max) (max 5 2)) min)"), "2");
+    cr_assert_str_eq(t_eval("(begin (define (f) (* 3 3)) (set! * +) (f))"), "6");
+    // including when the redefinition is a later form than the procedure
+    t_eval("0");
+    const bool cache_disabled = fasl_cache.disabled;
+    fasl_cache.disabled = true;
+    eval_source(test_env,
+        "(define (add) (+ 1 2)) (define (less) (if (< 1 2) 'yes 'no)) "
+        "(define + -) (define < >) (define result (list (add) (less)))");
+    fasl_cache.disabled = cache_disabled;
+    cr_assert_str_eq(cell_to_string(lex_get(test_env, make_cell_symbol("result")), MODE_WRITE), "(-1 no)");
+    // calls in loop bodies are folded, and fall back to the call once rebound
+    t_eval("0");
+    fasl_cache.disabled = true;
+    fold_stats.folds = 0;
+    eval_source(test_env,
+        "(define (loop n acc) (if (= n 0) acc (loop (- n 1) (+ acc (* 2 (+ 1 2)))))) "
+        "(define (sum) (do ((i 0 (+ i 1)) (s 0 (+ s (* 3 4)))) ((= i 3) s))) "
+        "(define before (list (loop 10 0) (sum))) "
+        "(define * +) (define result (list before (loop 10 0) (sum)))");
+    fasl_cache.disabled = cache_disabled;
+    cr_assert(fold_stats.folds == 3);
+    cr_assert_str_eq(cell_to_string(lex_get(test_env, make_cell_symbol("result")), MODE_WRITE), "((60 36) 50 21)");
+    // errors are raised when the call runs, not when it is read
+    cr_assert_str_eq(t_eval("(if #t 1 (/ 1 0))"), "1");
+    // macro args are left as written
+    cr_assert_str_eq(t_eval("(begin (defmacro q (x) `',x) (q (+ 1 2)))"), "(+ 1 2)");
+    // a let whose body may define is kept
+    cr_assert_str_eq(t_eval("(begin (let () (define zz 1)) 2)"), "2");
+}
+
+Test(end_to_end_sf, test_fasl_round_trip, .init = setup_each_test, .fini = teardown_each_test) {
+    const char* source =
+        "(define (f x) (cond ((< x 1) 'low) (else (list x 1/2 #i2 2.5 1+2i #\\a \"s\" #(1 2) #u8(3 4)))))"
+        " 123456789012345678901234567890 (f 0)";
+    Reader r;
+    init_reader(&r, source);
+    Cell* forms = make_cell_sexpr();
+    Cell* form;
+    while ((form = read_datum(&r))) {
+        cell_add(forms, expand(form));
+    }
+
+    str_buf_t* sb = sb_new();
+    cr_assert(fasl_write(sb, source, forms));
+    const Cell* loaded = fasl_read(sb->buffer, sb->length, source);
+    cr_assert(loaded && loaded->count == 3);
+    for (int i = 0; i < forms->count; i++) {
+        cr_assert_str_eq(cell_to_string(loaded->cell[i], MODE_WRITE), cell_to_string(forms->cell[i], MODE_WRITE));
+    }
+    // symbols come back interned
+    cr_assert(loaded->cell[0]->cell[0] == make_cell_symbol("define"));
+    // data made from another source, or cut short, is not loaded
+    cr_assert(fasl_read(sb->buffer, sb->length, "(f 1)") == nullptr);
+    cr_assert(fasl_read(sb->buffer, sb->length - 1, source) == nullptr);
+}
+
 // Test(end_to_end_sf, test_gc_stress, .init = setup_each_test, .fini = teardown_each_test) {
 //     GC_gcollect(); // Force a collection before we start
 //     const size_t heap_before = GC_get_heap_size();
@@ -503,6 +503,18 @@ Test(end_to_end_strings, test_number_to_string, .init = setup_each_test, .fini =
     /* 6. Floating Point (if supported by your tower) */
     /* Note: formatting of floats can vary slightly between implementations. */
     cr_assert_str_eq(t_eval("(number->string 3.14)"), "\"3.14\"");
+    cr_assert_str_eq(t_eval("(number->string 2.0)"), "\"2.0\"");
+    cr_assert_str_eq(t_eval("(number->string -1.5e-7)"), "\"-1.5e-07\"");
+
+    /* Reals read back as the same number, and display and write print the
+     * same digits. */
+    cr_assert_str_eq(t_eval("(let ((x (/ 1.0 3)) (p (open-output-string))) (display x p) (write x p) "
+                            "(string=? (get-output-string p) (string-append (number->string x) (number->string x))))"), "#true");
+    cr_assert_str_eq(t_eval("(let ((x (sqrt 2)) (p (open-output-string))) (display x p) "
+                            "(list (= x (string->number (get-output-string p))) "
+                            "(> (string-length (get-output-string p)) 16)))"), "(#true #true)");
+    cr_assert_str_eq(t_eval("(let ((x (/ 1.0 3))) (= x (string->number (number->string x))))"), "#true");
+    cr_assert_str_eq(t_eval("(let ((x (+ 0.1 0.2))) (= x (string->number (number->string x))))"), "#true");
 
     /* 7. Large Numbers (Checking buffer limits) */
     /* If you support 64-bit integers, this tests the maximum digits. */
@@ -510,6 +522,31 @@ Test(end_to_end_strings, test_number_to_string, .init = setup_each_test, .fini =
 }
 
 
+Test(end_to_end_strings, test_read_string_port, .init = setup_each_test, .fini = teardown_each_test) {
+    /* Lines and characters are sliced straight out of the port's store. */
+    cr_assert_str_eq(t_eval("(read-line (open-input-string \"one\\ntwo\"))"), "\"one\"");
+    cr_assert_str_eq(t_eval("(let ((p (open-input-string \"one\\ntwo\"))) (read-line p) (read-line p))"), "\"two\"");
+    cr_assert_str_eq(t_eval("(let ((p (open-input-string \"one\\n\"))) (read-line p) (eof-object? (read-line p)))"), "#true");
+    cr_assert_str_eq(t_eval("(read-lines (open-input-string \"a\\n\\nb\"))"), "(\"a\" \"\" \"b\")");
+
+    /* read-string counts characters, not bytes. */
+    cr_assert_str_eq(t_eval("(read-string 2 (open-input-string \"λμν\"))"), "\"λμ\"");
+    cr_assert_str_eq(t_eval("(let ((p (open-input-string \"λμν\"))) (read-string 2 p) (read-char p))"), "#\\ν");
+    cr_assert_str_eq(t_eval("(eof-object? (read-string 3 (open-input-string \"\")))"), "#true");
+    cr_assert_str_eq(t_eval("(read-string 10 (open-input-string \"abcdefghijklmnop\"))"), "\"abcdefghij\"");
+    cr_assert_str_eq(t_eval("(read-string 12 (open-input-string \"abcdefghijλμν\"))"), "\"abcdefghijλμ\"");
+    cr_assert_str_eq(t_eval("(read-string 20 (open-input-string \"abcλ\"))"), "\"abcλ\"");
+
+    /* peek-char leaves the character to be read. */
+    cr_assert_str_eq(t_eval("(let ((p (open-input-string \"λx\"))) (peek-char p) (peek-char p) (read-char p))"), "#\\λ");
+    cr_assert_str_eq(t_eval("(let ((p (open-input-string \"λx\"))) (read-char p) (peek-char p))"), "#\\x");
+    cr_assert_str_eq(t_eval("(eof-object? (peek-char (open-input-string \"\")))"), "#true");
+
+    /* read picks up where read-line left off. */
+    cr_assert_str_eq(t_eval("(let ((p (open-input-string \"skip\\n(a b)\"))) (read-line p) (read p))"), "(a b)");
+}
+
+
 Test(end_to_end_strings, test_string_downcase, .init = setup_each_test, .fini = teardown_each_test) {
     /* 1. Basic ASCII downcasing */
     cr_assert_str_eq(t_eval("(string-downcase \"HELLO WORLD\")"), "\"hello world\"");
@@ -634,3 +671,26 @@ Test(end_to_end_strings, test_string_ci_ordering, .init = setup_each_test, .fini
     cr_assert_str_eq(t_eval("(string-ci<? \"App\" \"apple\")"), "#true");
 }
 
+
+Test(end_to_end_strings, test_empty_string, .init = setup_each_test, .fini = teardown_each_test) {
+    /* Empty string literals are one shared immortal cell... */
+    cr_assert_str_eq(t_eval("(eq? \"\" \"\")"), "#true");
+    /* ...but the procedures R7RS says return a newly allocated string do. */
+    cr_assert_str_eq(t_eval("(eq? \"\" (string-copy \"\"))"), "#false");
+    cr_assert_str_eq(t_eval("(eq? \"\" (string-append))"), "#false");
+    cr_assert_str_eq(t_eval("(eq? (string-append) (string-append))"), "#false");
+    cr_assert_str_eq(t_eval("(eq? \"\" (make-string 0))"), "#false");
+    cr_assert_str_eq(t_eval("(eq? \"\" (string))"), "#false");
+    cr_assert_str_eq(t_eval("(eq? \"\" (list->string '()))"), "#false");
+    cr_assert_str_eq(t_eval("(eq? \"\" (substring \"abc\" 1 1))"), "#false");
+    /* Having no characters, it cannot be changed by the mutators. */
+    cr_assert_str_eq(t_eval("(let ((s \"\")) (string-fill! s #\\a) (string-copy! s 0 \"\") (list s (string-length \"\")))"),
+        "(\"\" 0)");
+    cr_assert_str_eq(t_eval("(string-set! \"\" 0 #\\a)"), " Index error: string-set!: index out of range");
+    /* Nor do a non-ASCII fill or source change its flags or storage. */
+    const char* str = Empty_String_Obj->str;
+    t_eval("(string-fill! \"\" #\\λ)");
+    t_eval("(string-copy! \"\" 0 \"λμ\" 1 1)");
+    t_eval("(string-copy! (string-copy \"ab\") 1 \"λ\" 0 0)");
+    cr_assert(Empty_String_Obj->ascii && Empty_String_Obj->str == str && Empty_String_Obj->count == 0);
+}
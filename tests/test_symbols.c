@@ -18,6 +18,8 @@
 */
 
 #include "test_meta.h"
+#include "../src/parser.h"
+#include "../src/builtin_hash.h"
 #include <criterion/criterion.h>
 
 
@@ -73,3 +75,92 @@ Test(end_to_end_symbols, test_symbol_conversion, .init = setup_each_test, .fini
     cr_assert_str_eq(t_eval("(symbol->string (string->symbol \"a b c\"))"), "\"a b c\"");
 }
 
+
+Test(end_to_end_symbols, test_streaming_reader, .init = setup_each_test, .fini = teardown_each_test) {
+    /* 1. One datum per call, and null once the source is exhausted */
+    Reader r;
+    init_reader(&r, "(a (b c)) sym \"str\" ; comment\n#(1 2)");
+    Cell* list = read_datum(&r);
+    cr_assert(cell_type(list) == CELL_SEXPR && list->count == 2);
+    /* Symbols interned from the source text are the same cell as any other */
+    cr_assert(list->cell[0] == make_cell_symbol("a"));
+    cr_assert(read_datum(&r) == make_cell_symbol("sym"));
+    cr_assert(cell_type(read_datum(&r)) == CELL_STRING);
+    cr_assert(cell_type(read_datum(&r)) == CELL_VECTOR);
+    cr_assert(read_datum(&r) == nullptr);
+
+    /* 2. A datum cut off by the end of the source, or a stray ')' */
+    init_reader(&r, "(a (b)");
+    cr_assert(cell_type(read_datum(&r)) == CELL_ERROR);
+    init_reader(&r, "a )");
+    cr_assert(read_datum(&r) == make_cell_symbol("a"));
+    cr_assert(cell_type(read_datum(&r)) == CELL_ERROR);
+}
+
+Test(end_to_end_symbols, test_port_read, .init = setup_each_test, .fini = teardown_each_test) {
+    /* 1. Data spanning lines, and text after a datum kept for the next read */
+    cr_assert_str_eq(t_eval(
+        "(let ((p (open-input-string \"(a (b)\\n c) d #(1\\n 2)\\n\"))) "
+        "  (list (read p) (read p) (read p) (eof-object? (read p))))"), "((a (b) c) d #(1 2) #true)");
+
+    /* 2. The datum read is a list, like a quoted one */
+    cr_assert_str_eq(t_eval("(length (read (open-input-string \"(1 2 3)\")))"), "3");
+
+    /* 3. Text after a datum is left in the port for the other input procedures */
+    cr_assert_str_eq(t_eval(
+        "(let ((p (open-input-string \"héllo λ\\nsecond\"))) "
+        "  (list (read p) (read-char p) (read p) (read-line p) (read p)))"), "(héllo #\\space λ \"\" second)");
+    cr_assert_str_eq(t_eval(
+        "(let ((p (open-input-string \"(1 2) rest of line\\n(3)\"))) "
+        "  (list (read p) (peek-char p) (read-line p) (read p) (eof-object? (read-char p))))"),
+        "((1 2) #\\space \" rest of line\" (3) #true)");
+
+    /* 4. Bigints, bytevectors and sets read back whole, alone and in a list */
+    cr_assert_str_eq(t_eval("(read (open-input-string \"123456789012345678901234567890\"))"), "123456789012345678901234567890");
+    cr_assert_str_eq(t_eval("(read (open-input-string \"#u8(1 2)\"))"), "#u8(1 2)");
+    cr_assert_str_eq(t_eval("(read (open-input-string \"(1 #u8(1 2))\"))"), "(1 #u8(1 2))");
+    cr_assert_str_eq(t_eval("(read (open-input-string \"#f64(1.5 2)\"))"), "#f64(1.5 2.0)");
+    cr_assert_str_eq(t_eval("(read (open-input-string \"#(#f32(1) (a))\"))"), "#(#f32(1.0) (a))");
+    cr_assert_str_eq(t_eval("(set->list (read (open-input-string \"#{1}\")))"), "(1)");
+}
+
+Test(end_to_end_symbols, test_builtin_lookup, .init = setup_each_test, .fini = teardown_each_test) {
+    /* 1. Every builtin is found in the perfect hash, and bound to its function */
+    t_eval("0");
+    for (int i = 0; i < BUILTIN_HASH_COUNT; i++) {
+        const builtin_entry* b = builtin_lookup(builtin_table[i].name);
+        cr_assert(b == &builtin_table[i]);
+        const Cell* v = lex_get(test_env, make_cell_symbol(b->name));
+        cr_assert(v && v->is_builtin && v->builtin == b->func);
+    }
+
+    /* 2. Other names are not */
+    cr_assert(builtin_lookup("not-a-builtin") == nullptr);
+    cr_assert(builtin_lookup("") == nullptr);
+    cr_assert(builtin_lookup("car ") == nullptr);
+
+    /* 3. Purity, as the constant folder sees it */
+    cr_assert(builtin_lookup("+")->pure);
+    cr_assert(!builtin_lookup("display")->pure);
+}
+
+Test(end_to_end_symbols, test_lexer_runs, .init = setup_each_test, .fini = teardown_each_test) {
+    /* 1. Runs longer than a scanning block, and the lines they span */
+    Scanner s;
+    init_scanner(&s, "   \n\t  ; a line comment which is longer than one block of bytes\n"
+                     "#| a block comment | with a bar,\n and another line |# "
+                     "\"a string with an \\\" escape, which spans\nlines\" "
+                     "a-rather-long-identifier-of-more-than-thirty-two-bytes)");
+    Token t = lex_token(&s);
+    cr_assert(t.type == T_STRING && t.line == 5 && t.length == 47);
+    t = lex_token(&s);
+    cr_assert(t.type == T_SYMBOL && t.line == 5 && t.length == 54);
+    cr_assert(lex_token(&s).type == T_RIGHT_PAREN);
+    cr_assert(lex_token(&s).type == T_EOF);
+
+    /* 2. Unterminated runs stop at the end of the source */
+    init_scanner(&s, "#| never closed |");
+    cr_assert(lex_token(&s).type == T_EOF);
+    init_scanner(&s, "\"never closed \\");
+    cr_assert(lex_token(&s).type == T_ERROR);
+}
@@ -153,9 +153,12 @@ Test(end_to_end_vectors, test_list_to_vector, .init = setup_each_test, .fini = t
     cr_assert_str_eq(t_eval("(list->vector '(1 2 3))"), "#(1 2 3)");
     cr_assert_str_eq(t_eval("(list->vector '())"), "#()");
     cr_assert_str_eq(t_eval("(list->vector (list 1 #true \"s\"))"), "#(1 #true \"s\")");
+    cr_assert_str_eq(t_eval("(list->vector (cons 1 (cons 2 '())))"), "#(1 2)");
 
     // ## Type Errors ##
     cr_assert_str_eq(t_eval("(list->vector '(a . b))"), " Type error: list->vector: arg 1 must be a proper list");
+    cr_assert_str_eq(t_eval("(list->vector (cons 1 (cons 2 3)))"), " Type error: list->vector: arg 1 must be a proper list");
+    cr_assert_str_eq(t_eval("(begin (define c (cons 1 (cons 2 '()))) (set-cdr! (cdr c) c) (list->vector c))"), " Type error: list->vector: arg 1 must be a proper list");
     cr_assert_str_eq(t_eval("(list->vector 'a)"), " Type error: list->vector: arg 1 must be a list");
 
     // ## Arity ##
@@ -198,3 +201,30 @@ Test(end_to_end_vectors, test_vector_to_string, .init = setup_each_test, .fini =
     // ## Arity ##
     cr_assert_str_eq(t_eval("(vector->string)"), " Arity error: vector->string: expected at least 1 arg, got 0");
 }
+
+Test(end_to_end_vectors, test_vector_push_pop, .init = setup_each_test, .fini = teardown_each_test) {
+    // ## Push one, then several ##
+    cr_assert_str_eq(t_eval("(begin (define v (vector)) (vector-push! v 1) (vector-push! v 2 3 4) v)"), "#(1 2 3 4)");
+
+    // ## Pop returns the last element and shortens the vector ##
+    cr_assert_str_eq(t_eval("(begin (define v (vector 1 2 3)) (vector-pop! v))"), "3");
+    cr_assert_str_eq(t_eval("(begin (define v (vector 1 2 3)) (vector-pop! v) v)"), "#(1 2)");
+
+    // ## Push after pop reuses the freed slot ##
+    cr_assert_str_eq(t_eval("(begin (define v (vector 1 2 3)) (vector-pop! v) (vector-push! v 'x) v)"), "#(1 2 x)");
+
+    // ## Many pushes grow the vector ##
+    cr_assert_str_eq(t_eval("(begin (define v (make-vector 2 0)) (do ((i 0 (+ i 1))) ((= i 1000)) (vector-push! v i)) (list (vector-length v) (vector-ref v 1001)))"), "(1002 999)");
+
+    // ## Reserve leaves length and contents alone ##
+    cr_assert_str_eq(t_eval("(begin (define v #(a b)) (vector-reserve! v 100) (vector-reserve! v 0) v)"), "#(a b)");
+
+    // ## Errors ##
+    cr_assert_str_eq(t_eval("(vector-pop! (vector))"), " Index error: vector-pop!: vector is empty");
+    cr_assert_str_eq(t_eval("(vector-push! '(1) 2)"), " Type error: vector-push!: arg 1 must be a vector");
+    cr_assert_str_eq(t_eval("(vector-reserve! #(1) -1)"), " Value error: vector-reserve!: arg 2 out of range");
+
+    // ## Arity ##
+    cr_assert_str_eq(t_eval("(vector-push! #(1))"), " Arity error: vector-push!: expected at least 2 args, got 1");
+    cr_assert_str_eq(t_eval("(vector-pop!)"), " Arity error: vector-pop!: expected exactly 1 arg, got 0");
+}
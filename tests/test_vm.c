@@ -0,0 +1,71 @@
+#include "test_meta.h"
+#include "../src/vm.h"
+#include <criterion/criterion.h>
+
+TestSuite(end_to_end_vm);
+
+static engine_t saved_engine;
+
+static void setup_vm_test(void) {
+    setup_each_test();
+    saved_engine = coz_engine;
+    coz_engine = ENGINE_VM;
+}
+
+static void teardown_vm_test(void) {
+    coz_engine = saved_engine;
+    teardown_each_test();
+}
+
+Test(end_to_end_vm, test_vm_calls, .init = setup_vm_test, .fini = teardown_vm_test) {
+    cr_assert_str_eq(t_eval("((lambda (x y) (+ x y)) 2 3)"), "5");
+    cr_assert_str_eq(t_eval("((lambda args args) 1 2 3)"), "(1 2 3)");
+    cr_assert_str_eq(t_eval("((lambda (a . rest) rest) 1 2 3)"), "(2 3)");
+    cr_assert_str_eq(t_eval(
+        "(begin (define (fib n) (if (< n 2) n (+ (fib (- n 1)) (fib (- n 2))))) "
+        "       (fib 15))"), "610");
+    // builtins calling back into the VM
+    cr_assert_str_eq(t_eval("(map (lambda (x) (* x x)) '(1 2 3))"), "(1 4 9)");
+    cr_assert_str_eq(t_eval("(apply (lambda (a b) (- a b)) '(10 4))"), "6");
+}
+
+Test(end_to_end_vm, test_vm_tail_calls, .init = setup_vm_test, .fini = teardown_vm_test) {
+    cr_assert_str_eq(t_eval(
+        "(begin (define (count n) (if (= n 0) 'done (count (- n 1)))) "
+        "       (count 100000))"), "done");
+    cr_assert_str_eq(t_eval("(let loop ((i 100000) (acc 0)) (if (= i 0) acc (loop (- i 1) (+ acc 1))))"),
+        "100000");
+    // mutual recursion through letrec
+    cr_assert_str_eq(t_eval(
+        "(letrec ((ev? (lambda (n) (if (= n 0) #t (od? (- n 1))))) "
+        "         (od? (lambda (n) (if (= n 0) #f (ev? (- n 1)))))) "
+        "(ev? 10001))"), "#false");
+}
+
+Test(end_to_end_vm, test_vm_bindings, .init = setup_vm_test, .fini = teardown_vm_test) {
+    cr_assert_str_eq(t_eval("(let ((x 1) (y 2)) (let ((x 10)) (+ x y)))"), "12");
+    cr_assert_str_eq(t_eval("(+ (let ((x 1)) x) (let ((x 2)) x))"), "3");
+    cr_assert_str_eq(t_eval(
+        "(begin (define counter ((lambda (n) (lambda () (set! n (+ n 1)) n)) 0)) "
+        "       (counter) (counter))"), "2");
+    cr_assert_str_eq(t_eval("(and 1 #f (car '()))"), "#false");
+    cr_assert_str_eq(t_eval("(cond ((assv 2 '((1 . a) (2 . b))) => cdr) (else 'none))"), "b");
+}
+
+Test(end_to_end_vm, test_vm_macros, .init = setup_vm_test, .fini = teardown_vm_test) {
+    cr_assert_str_eq(t_eval(
+        "(begin (defmacro swap! (a b) `(let ((tmp ,a)) (set! ,a ,b) (set! ,b tmp))) "
+        "       (define p 1) (define q 2) (swap! p q) (list p q))"), "(2 1)");
+    // expansions are memoized per call site, and redone when the macro is redefined
+    cr_assert_str_eq(t_eval(
+        "(begin (define n 0) (defmacro add2 (x) (begin (set! n (+ n 1)) `(+ ,x 2))) "
+        "       (define (f x) (let ((y (add2 x))) y)) (define (h x) (add2 x)) "
+        "       (define a (list (f 1) (f 2) (h 3) (h 4) n)) "
+        "       (defmacro add2 (x) (begin (set! n (+ n 1)) `(* ,x 2))) "
+        "       (list a (f 5) (h 6) n))"), "((3 4 5 6 2) 10 12 4)");
+}
+
+Test(end_to_end_vm, test_vm_disassemble, .init = setup_vm_test, .fini = teardown_vm_test) {
+    cr_assert_str_eq(t_eval("(disassemble car)"),
+        " Type error: disassemble: arg must be a lambda procedure");
+}
@@ -0,0 +1,39 @@
+#!/bin/sh
+#
+# Check the builtin list in src/builtins.def against the builtin procedures
+# declared in the headers under src/, and check that the perfect hash in
+# src/builtin_hash.h was generated from the current list.
+#
+# Run as 'make check-builtins', or from the CMake build as
+# 'cmake --build build --target check_builtins'.
+
+cd "$(dirname "$0")/.." || exit 1
+CC=${CC:-cc}
+tmp=$(mktemp -d) || exit 1
+trap 'rm -rf "$tmp"' EXIT
+
+sed -n 's/^Cell\* *\(builtin_[A-Za-z0-9_]*\)(.*/\1/p' src/*.h | sort -u > "$tmp/declared"
+sed -n 's/^BUILTIN("[^"]*", *\([A-Za-z0-9_]*\),.*/\1/p' src/builtins.def | sort -u > "$tmp/listed"
+
+status=0
+for f in $(comm -23 "$tmp/declared" "$tmp/listed"); do
+    echo "check-builtins: $f is declared, but not in src/builtins.def"
+    status=1
+done
+for f in $(comm -13 "$tmp/declared" "$tmp/listed"); do
+    echo "check-builtins: $f is in src/builtins.def, but not declared in a header"
+    status=1
+done
+
+if ! $CC -o "$tmp/gen_builtin_hash" tools/gen_builtin_hash.c ||
+   ! "$tmp/gen_builtin_hash" > "$tmp/builtin_hash.h"; then
+    echo "check-builtins: could not generate the builtin hash"
+    exit 1
+fi
+if ! cmp -s "$tmp/builtin_hash.h" src/builtin_hash.h; then
+    echo "check-builtins: src/builtin_hash.h is out of date; run 'make builtin-hash'"
+    status=1
+fi
+
+[ $status -eq 0 ] && echo "check-builtins: $(wc -l < "$tmp/listed") builtins OK"
+exit $status
@@ -0,0 +1,156 @@
+/*
+ * 'tools/gen_builtin_hash.c'
+ * This file is part of Cozenage - https://github.com/DarrenKirby/cozenage
+ * Copyright © 2026 Darren Kirby <darren@dragonbyte.ca>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Generate src/builtin_hash.h, a perfect hash of the builtin names listed in
+ * src/builtins.def, on stdout. It is built and run by 'make builtin-hash':
+ *
+ *     $ cc -o gen_builtin_hash tools/gen_builtin_hash.c
+ *     $ ./gen_builtin_hash > src/builtin_hash.h
+ *
+ * The hash is 'hash and displace': each name's 64-bit FNV-1a hash picks a
+ * bucket, and every bucket gets the smallest displacement which puts all of
+ * its names in free slots. Buckets are placed largest first. A lookup is then
+ * one hash, two table reads and one strcmp(), with no probing.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BUCKETS 128
+#define SLOTS 512
+#define MAX_DISP 65535
+
+/* Must match BUILTIN_HASH_SLOT() below. */
+#define SLOT(h, d) ((((h) >> 20) + (uint64_t)(d) * (((h) >> 40) | 1)) & (SLOTS - 1))
+
+#define BUILTIN(name, func, flags) name,
+static const char* names[] = {
+#include "../src/builtins.def"
+};
+#undef BUILTIN
+
+#define N_NAMES (int)(sizeof(names) / sizeof(names[0]))
+
+
+/* Must match hash_string_key() in src/hash.c. */
+static uint64_t fnv1a(const char* key)
+{
+    uint64_t hash = 14695981039346656037UL;
+    for (const char* p = key; *p; p++) {
+        hash ^= (uint64_t)(unsigned char)*p;
+        hash *= 1099511628211UL;
+    }
+    return hash;
+}
+
+
+static uint64_t hashes[N_NAMES];
+static int bucket_size[BUCKETS];
+static int order[BUCKETS];
+static int disp[BUCKETS];
+static int slot_index[SLOTS];
+
+
+static int by_size(const void* a, const void* b)
+{
+    const int x = *(const int*)a, y = *(const int*)b;
+    if (bucket_size[x] != bucket_size[y]) return bucket_size[y] - bucket_size[x];
+    return x - y;
+}
+
+
+/* Try to put every name of bucket b in a free slot at displacement d,
+ * and undo the names already placed if one of them clashes. */
+static int place(const int b, const int d)
+{
+    int taken[N_NAMES];
+    int n = 0;
+    for (int i = 0; i < N_NAMES; i++) {
+        if ((int)(hashes[i] & (BUCKETS - 1)) != b) continue;
+        const int s = (int)SLOT(hashes[i], d);
+        if (slot_index[s] != -1) {
+            while (n > 0) slot_index[taken[--n]] = -1;
+            return 0;
+        }
+        taken[n++] = s;
+        slot_index[s] = i;
+    }
+    return 1;
+}
+
+
+int main(void)
+{
+    if (N_NAMES > SLOTS * 3 / 4) {
+        fprintf(stderr, "gen_builtin_hash: %d names is too many for %d slots\n", N_NAMES, SLOTS);
+        return EXIT_FAILURE;
+    }
+    for (int i = 0; i < N_NAMES; i++) {
+        hashes[i] = fnv1a(names[i]);
+        for (int j = 0; j < i; j++) {
+            if (strcmp(names[i], names[j]) == 0) {
+                fprintf(stderr, "gen_builtin_hash: '%s' is listed twice\n", names[i]);
+                return EXIT_FAILURE;
+            }
+        }
+        bucket_size[hashes[i] & (BUCKETS - 1)]++;
+    }
+    for (int s = 0; s < SLOTS; s++) slot_index[s] = -1;
+    for (int b = 0; b < BUCKETS; b++) order[b] = b;
+    qsort(order, BUCKETS, sizeof(int), by_size);
+
+    for (int k = 0; k < BUCKETS; k++) {
+        const int b = order[k];
+        int d = 0;
+        while (d <= MAX_DISP && !place(b, d)) d++;
+        if (d > MAX_DISP) {
+            fprintf(stderr, "gen_builtin_hash: no displacement for bucket %d\n", b);
+            return EXIT_FAILURE;
+        }
+        disp[b] = d;
+    }
+
+    printf("/* Generated by tools/gen_builtin_hash.c from src/builtins.def - do not edit.\n");
+    printf(" * Regenerate with 'make builtin-hash'. */\n\n");
+    printf("#ifndef COZENAGE_BUILTIN_HASH_H\n#define COZENAGE_BUILTIN_HASH_H\n\n");
+    printf("#include <stdint.h>\n\n");
+    printf("#define BUILTIN_HASH_COUNT %d\n", N_NAMES);
+    printf("#define BUILTIN_HASH_BUCKETS %d\n", BUCKETS);
+    printf("#define BUILTIN_HASH_SLOTS %d\n\n", SLOTS);
+    printf("/* The slot of a name with FNV-1a hash h, in a bucket with displacement d. */\n");
+    printf("#define BUILTIN_HASH_SLOT(h, d) \\\n");
+    printf("    ((((h) >> 20) + (uint64_t)(d) * (((h) >> 40) | 1)) & (BUILTIN_HASH_SLOTS - 1))\n\n");
+
+    printf("/* Displacement of each bucket, indexed by h & (BUILTIN_HASH_BUCKETS - 1). */\n");
+    printf("static const uint16_t builtin_hash_disp[BUILTIN_HASH_BUCKETS] = {");
+    for (int b = 0; b < BUCKETS; b++) {
+        printf("%s%5d,", b % 10 ? "" : "\n   ", disp[b]);
+    }
+    printf("\n};\n\n");
+
+    printf("/* Index into the builtin table of the name in each slot, or -1. */\n");
+    printf("static const int16_t builtin_hash_index[BUILTIN_HASH_SLOTS] = {");
+    for (int s = 0; s < SLOTS; s++) {
+        printf("%s%4d,", s % 12 ? "" : "\n   ", slot_index[s]);
+    }
+    printf("\n};\n\n#endif //COZENAGE_BUILTIN_HASH_H\n");
+    return EXIT_SUCCESS;
+}